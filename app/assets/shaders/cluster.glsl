@@ -0,0 +1,18 @@
+// clustered forward shading: froxel cluster of a fragment. must match LightClusters (CLUSTERS_X/Y/Z, DEPTH_NEAR/FAR)
+const uint CLUSTERS_X = 16;
+const uint CLUSTERS_Y = 9;
+const uint CLUSTERS_Z = 16;
+const float CLUSTER_DEPTH_NEAR = 0.1;
+const float CLUSTER_DEPTH_FAR = 10.0;
+
+// screen grid cell of the pixel, exponential slice of the view depth (LightClusters::getSlice)
+uint clusterIndex(vec2 fragCoord, vec2 res, float viewDepth) {
+	uvec2 tileSize = (uvec2(res) + uvec2(CLUSTERS_X, CLUSTERS_Y) - 1) / uvec2(CLUSTERS_X, CLUSTERS_Y);
+	uvec2 tile = min(uvec2(fragCoord) / tileSize, uvec2(CLUSTERS_X, CLUSTERS_Y) - 1);
+	uint slice = 0;
+	if (viewDepth > CLUSTER_DEPTH_NEAR) {
+		float sliceF = log(viewDepth / CLUSTER_DEPTH_NEAR) / log(CLUSTER_DEPTH_FAR / CLUSTER_DEPTH_NEAR) * float(CLUSTERS_Z);
+		slice = min(uint(sliceF), CLUSTERS_Z - 1);
+	}
+	return (slice * CLUSTERS_Y + tile.y) * CLUSTERS_X + tile.x;
+}
@@ -4,6 +4,41 @@ C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderFX.vert -o vertFX.spv
 C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderFX.frag -o fragFX.spv
 C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderDecal.vert -o vertDecal.spv
 C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderDecal.frag -o fragDecal.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderDecalTiles.vert -o vertDecalTiles.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderDecalTiles.frag -o fragDecalTiles.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderFxSort.comp -o compFxSort.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderFxCull.comp -o compFxCull.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DHI_Z shaderFxCull.comp -o compFxCullHiZ.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderHiZ.comp -o compHiZ.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderOcclusionProxy.vert -o vertOcclusionProxy.spv
 C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderScreen.vert -o vertScreen.spv
 C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderScreen.frag -o fragScreen.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderOitResolve.frag -o fragOitResolve.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderLighting.vert -o vertLighting.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderLighting.frag -o fragLighting.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSAMPLED_INPUTS shaderFX.frag -o fragFXSampled.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSAMPLED_INPUTS shaderDecal.frag -o fragDecalSampled.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSAMPLED_INPUTS shaderDecalTiles.frag -o fragDecalTilesSampled.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSAMPLED_INPUTS shaderScreen.frag -o fragScreenSampled.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DOIT_OUTPUT shaderFX.frag -o fragFXOit.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DGBUFFER_OUTPUT shader0.frag -o frag0Gbuffer.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DCLUSTERED_LIGHTS shader0.frag -o frag0Clustered.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DDEPTH_ONLY shader0.vert -o vert0Depth.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSHADOW_CASTER shader0.vert -o vert0Shadow.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSHADOWS shader0.frag -o frag0Shadows.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSHADOWS -DCLUSTERED_LIGHTS shader0.frag -o frag0ClusteredShadows.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DMULTIVIEW shader0.vert -o vert0Multiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DDEPTH_ONLY -DMULTIVIEW shader0.vert -o vert0DepthMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DMULTIVIEW shader0.frag -o frag0Multiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSHADOWS -DMULTIVIEW shader0.frag -o frag0ShadowsMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DMULTIVIEW shaderFX.vert -o vertFXMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DMULTIVIEW shaderFX.frag -o fragFXMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DOIT_OUTPUT -DMULTIVIEW shaderFX.frag -o fragFXOitMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DMULTIVIEW shaderDecal.vert -o vertDecalMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DMULTIVIEW shaderDecal.frag -o fragDecalMultiview.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe shaderAutoExposure.comp -o compAutoExposure.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DBRIGHT_PASS shaderBloom.comp -o compBloomBright.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DDOWNSAMPLE shaderBloom.comp -o compBloomDown.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DUPSAMPLE shaderBloom.comp -o compBloomUp.spv
+C:\VulkanSDK\1.2.176.1\Bin32\glslc.exe -DSAMPLED_INPUTS -DBLOOM shaderScreen.frag -o fragScreenSampledBloom.spv
 pause
\ No newline at end of file
@@ -0,0 +1,31 @@
+// per-frame global uniforms (set 0), shared by all pipelines and bound once per command buffer.
+// must match VulkanApp::UniformBufferObjectFrame
+struct Frame {
+	mat4 view;
+	mat4 proj;
+	mat4 viewProj;
+	mat4 invViewProj; // inverse(proj * view), precomputed on the CPU
+	mat4 invProj;     // inverse(proj)
+	vec4 camPos;      // camera world-space position (xyz)
+	vec4 camDir;      // camera world-space forward direction (xyz)
+	vec4 projParams;  // (proj[2][2], proj[3][2]): view depth = projParams.y / (depth + projParams.x)
+	vec2 res;
+	float time;
+	float exposure;
+};
+
+#ifdef MULTIVIEW
+// multiview stereo (--stereo, compiled with -DMULTIVIEW): the frame block is followed by one copy per view (the eye cameras),
+// each shader invocation of the render pass reads the one of its view. shaders without MULTIVIEW read the first:
+// the culling camera, whose frustum contains both eyes'. (gl_ViewIndex: the including shader enables GL_EXT_multiview
+// right after #version, extension directives have to come before any declaration)
+layout(set = 0, binding = 0) uniform uboFrame{
+	Frame views[3];
+} frameViews;
+#define frame frameViews.views[1 + gl_ViewIndex]
+#else
+layout(set = 0, binding = 0) uniform uboFrame{
+	Frame views[1];
+} frameViews;
+#define frame frameViews.views[0]
+#endif
@@ -0,0 +1,19 @@
+// force field instance (std430), shared by shaderFX.vert and the sort compute shader. must match VulkanApp::FxInstanceData
+struct FxInstance {
+	vec4 positionScale; // xyz: world position, w: base scale
+	vec4 color;         // rgb: glow color, a: intensity
+	vec4 animation;     // x: pulse amplitude (scale), y: pulse speed, z: phase, w: bob amplitude (along z)
+};
+
+// animation: pulsing scale and bobbing along z
+float fxInstanceWave(FxInstance instance, float time) {
+	return sin(instance.animation.y * time + instance.animation.z);
+}
+
+vec3 fxInstanceCenter(FxInstance instance, float time) {
+	return instance.positionScale.xyz + vec3(0.0, 0.0, instance.animation.w * fxInstanceWave(instance, time));
+}
+
+float fxInstanceScale(FxInstance instance, float time) {
+	return instance.positionScale.w + instance.animation.x * fxInstanceWave(instance, time);
+}
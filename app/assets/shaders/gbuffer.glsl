@@ -0,0 +1,20 @@
+// deferred shading G-buffer encoding, shared by the scene's G-buffer output and the lighting subpass.
+// normals are stored octahedral in two 16-bit floats (gNormal, RG16F)
+
+vec2 octWrap(vec2 v) {
+	return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// unit vector -> [-1, 1]^2: project onto the octahedron |x| + |y| + |z| = 1, fold the lower half over the upper one
+vec2 octEncode(vec3 n) {
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	return n.z >= 0.0 ? n.xy : octWrap(n.xy);
+}
+
+vec3 octDecode(vec2 e) {
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0) {
+		n.xy = octWrap(n.xy);
+	}
+	return normalize(n);
+}
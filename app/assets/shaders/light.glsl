@@ -0,0 +1,38 @@
+// light (std430), shared by the deferred lighting shaders and the clustered scene shader. must match VulkanApp::LightGpuData
+struct Light {
+	vec4 positionRadius; // xyz: world position, w: radius (0: global light, unattenuated, adds ambient)
+	vec4 color;          // rgb: color, a: intensity
+	vec4 screenRect;     // deferred: projected bounds in pixels (x0, y0, x1, y1)
+};
+
+// global light: the forward path's shading (shader0.frag), ambient included. shadow: fraction of the diffuse term that reaches the point
+vec3 shadeGlobalLight(Light light, vec3 worldPos, vec3 normal, vec3 albedo, float shadow) {
+	vec3 lightCol = light.color.rgb * light.color.a;
+	float diffuse = max(dot(normal, normalize(light.positionRadius.xyz - worldPos)), 0.0);
+	return (0.1 + diffuse * shadow) * lightCol * albedo;
+}
+
+// contribution of one light to a surface point.
+// global light: shadeGlobalLight(), unshadowed.
+// point light: smooth falloff to 0 at the radius, diffuse + Blinn-Phong specular (scaled by the material)
+vec3 shadeLight(Light light, vec3 worldPos, vec3 normal, vec3 albedo, float specularMaterial, vec3 camPos) {
+	float radius = light.positionRadius.w;
+	if (radius <= 0.0) {
+		return shadeGlobalLight(light, worldPos, normal, albedo, 1.0);
+	}
+
+	vec3 lightCol = light.color.rgb * light.color.a;
+	vec3 toLight = light.positionRadius.xyz - worldPos;
+	vec3 lightDir = normalize(toLight);
+	float diffuse = max(dot(normal, lightDir), 0.0);
+
+	float dist = length(toLight);
+	if (dist >= radius) {
+		return vec3(0.0);
+	}
+	float falloff = 1.0 - (dist * dist) / (radius * radius);
+	float attenuation = falloff * falloff;
+	vec3 halfDir = normalize(lightDir + normalize(camPos - worldPos));
+	float specular = pow(max(dot(normal, halfDir), 0.0), 32.0) * specularMaterial * step(0.0, dot(normal, lightDir));
+	return (diffuse * albedo + specular) * lightCol * attenuation;
+}
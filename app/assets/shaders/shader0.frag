@@ -1,24 +1,82 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
 
 layout(location = 0) in vec3 v2fCol;
 layout(location = 1) in vec2 v2fUV;
 layout(location = 2) in vec3 v2fWorldPos;
 layout(location = 3) in vec3 v2fWorldNormal;
 
+#ifdef GBUFFER_OUTPUT
+#include "gbuffer.glsl"
+// deferred shading (--deferred): surface attributes only, lit by the lighting subpass (shaderLighting.frag)
+layout(location = 0) out vec4 outAlbedo; // rgb: albedo, a: specular material
+layout(location = 1) out vec2 outNormal; // octahedral world normal
+#else
 layout(location = 0) out vec4 outColor;
+#endif
+
+#ifdef CLUSTERED_LIGHTS
+#include "frame.glsl"
+#include "light.glsl"
+#include "cluster.glsl"
+// clustered forward shading (--clustered): light 0 (global) shades every fragment, point lights only through the cluster's list
+layout(std430, set = 2, binding = 0) readonly buffer lightData{
+	Light lights[];
+};
+layout(std430, set = 2, binding = 1) readonly buffer clusterRanges{
+	uvec2 ranges[];   // (first entry in lightIndices, light count)
+} clusters;
+layout(std430, set = 2, binding = 2) readonly buffer clusterLightIndices{
+	uint lightIndices[];
+};
+#endif
+
+#ifdef SHADOWS
+// shadow map of the forward light / light 0 (--shadows): attenuates its diffuse term, ambient and point lights stay unshadowed
+#include "shadow.glsl"
+#endif
 
 void main() {
 	vec3 albedo = vec3(0.5, 0.5, 0.5);
+	vec3 wNormal = normalize(v2fWorldNormal);
+#ifdef GBUFFER_OUTPUT
+	float specular = 0.5;
+	outAlbedo = vec4(albedo, specular);
+	outNormal = octEncode(wNormal);
+#elif defined(CLUSTERED_LIGHTS)
+	float specular = 0.5;
+#ifdef SHADOWS
+	vec3 shaded = shadeGlobalLight(lights[0], v2fWorldPos, wNormal, albedo, shadowFactor(v2fWorldPos));
+#else
+	vec3 shaded = shadeLight(lights[0], v2fWorldPos, wNormal, albedo, specular, frame.camPos.xyz);
+#endif
+	float viewDepth = dot(v2fWorldPos - frame.camPos.xyz, frame.camDir.xyz);
+	uvec2 range = clusters.ranges[clusterIndex(gl_FragCoord.xy, frame.res, viewDepth)];
+	for (uint i = 0; i < range.y; i++) {
+		shaded += shadeLight(lights[lightIndices[range.x + i]], v2fWorldPos, wNormal, albedo, specular, frame.camPos.xyz);
+	}
+	outColor = vec4(shaded, 1.0);
+#else
+#ifdef SHADOWS
+	vec3 lightPos = shadowLight.position.xyz;
+#else
 	vec3 lightPos = vec3(1.0, 1.0, -1.0);
+#endif
 	vec3 lightCol = vec3(1.0, 1.0, 1.0);
-	vec3 wNormal = normalize(v2fWorldNormal);
 	vec3 lightDir = normalize(lightPos - v2fWorldPos);
 	
 	vec3 ambient = 0.1 * lightCol;
 	
 	float diffuse = max(dot(wNormal, lightDir), 0.0);
+#ifdef SHADOWS
+	diffuse *= shadowFactor(v2fWorldPos);
+#endif
 	vec3 diffuseCol = diffuse * lightCol;
 	
 	vec3 shaded = (ambient + diffuse) * albedo; 
     outColor = vec4(shaded, 1.0);
+#endif
 }
\ No newline at end of file
@@ -1,27 +1,50 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
+#include "frame.glsl"
+
+// shadow map pass (-DSHADOW_CASTER): position-only stream like the depth pre-pass, projected with the light's view-projection
+#ifdef SHADOW_CASTER
+#define DEPTH_ONLY
+#include "shadow.glsl"
+#endif
 
 layout(location = 0) in vec3 inPosition;
+#ifndef DEPTH_ONLY
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inUV;
 layout(location = 3) in vec3 inNormal;
+#endif
 
-layout(set = 0, binding = 0) uniform uboScene{
+// per-object uniforms (set 1)
+layout(set = 1, binding = 0) uniform uboScene{
 	mat4 model;
-	mat4 view;
-	mat4 proj;
+	mat4 normalMatrix; // transpose(inverse(model)), precomputed on the CPU
 } ubo;
 
+// depth pre-pass (-DDEPTH_ONLY, position-only vertex stream): the scene subpass tests its depth EQUAL against the pre-pass depth,
+// so both variants have to compute bit-identical positions
+invariant gl_Position;
 
+#ifndef DEPTH_ONLY
 layout(location = 0) out vec3 v2fCol;
 layout(location = 1) out vec2 v2fUV;
 layout(location = 2) out vec3 v2fWorldPos;
 layout(location = 3) out vec3 v2fWorldNormal;
+#endif
 
 void main() {
-	gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+#ifdef SHADOW_CASTER
+	gl_Position = shadowLight.viewProj * ubo.model * vec4(inPosition, 1.0);
+#else
+	gl_Position = frame.viewProj * ubo.model * vec4(inPosition, 1.0);
+#endif
+#ifndef DEPTH_ONLY
 	v2fWorldPos = vec3(ubo.model * vec4(inPosition, 1.0));
-	v2fWorldNormal = vec3(transpose(inverse(ubo.model)) * vec4(inNormal, 1.0));
+	v2fWorldNormal = vec3(ubo.normalMatrix * vec4(inNormal, 1.0));
 	v2fCol = inColor;
 	v2fUV = inUV;
-	
+#endif
 }
\ No newline at end of file
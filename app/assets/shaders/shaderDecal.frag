@@ -1,59 +1,86 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
+#include "frame.glsl"
+
+// depth, depth-bounds and stencil tests run before the shader: fragments outside the stencil-marked volume are never shaded,
+// and the stencil reset of the decal draw doesn't depend on the discard below
+layout(early_fragment_tests) in;
 
 layout(location = 0) in vec3 v2fCol;
 layout(location = 1) in vec2 v2fUV;
 layout(location = 2) in vec2 v2fScreenUV;
 layout(location = 3) in vec3 v2fWorldPos;
 layout(location = 4) in vec3 v2fWorldNormal;
-layout(location = 5) in vec3 v2fViewPos;
+layout(location = 5) noperspective in vec3 v2fViewRay;
 
-layout(set = 0, binding = 0) uniform uboFX{
+// per-object uniforms (set 1)
+layout(set = 1, binding = 0) uniform uboFX{
 	mat4 model;
-	mat4 view;
-	mat4 proj;
-	vec2 res;
+	mat4 invModel;    // inverse(model)
 } ubo;
 
 //layout(set = 0, binding = 1) uniform sampler2D textureSampler;
 
-layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
-layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputDepthAttachment;
+#ifdef SAMPLED_INPUTS
+// separate render passes (--multipass): col0/depth0 are sampled textures, fetched at the fragment's own pixel
+layout(set = 2, binding = 0) uniform sampler2D inputColorTexture;
+layout(set = 2, binding = 1) uniform sampler2D inputDepthTexture;
+#define LOAD_INPUT_COLOR() texelFetch(inputColorTexture, ivec2(gl_FragCoord.xy), 0)
+#define LOAD_INPUT_DEPTH() texelFetch(inputDepthTexture, ivec2(gl_FragCoord.xy), 0)
+#else
+layout(input_attachment_index = 0, set = 2, binding = 0) uniform subpassInput inputColorAttachment;
+layout(input_attachment_index = 1, set = 2, binding = 1) uniform subpassInput inputDepthAttachment;
+#define LOAD_INPUT_COLOR() subpassLoad(inputColorAttachment)
+#define LOAD_INPUT_DEPTH() subpassLoad(inputDepthAttachment)
+#endif
 
 layout(location = 0) out vec4 outColor;
 
+// true: reconstruct the scene position from the linearized depth and the interpolated view ray (a few ALU ops).
+// false: reference path, unproject with the inverse projection and rebuild the camera ray per fragment
+layout(constant_id = 0) const bool ANALYTIC_DEPTH = true;
+
 
 void main() {
 
-	float inDepth = subpassLoad(inputDepthAttachment).x; // depth is [-1, 1]
-	vec3 inCol = subpassLoad(inputColorAttachment).xyz; 
+	float inDepth = LOAD_INPUT_DEPTH().x; // depth is [-1, 1]
+	vec3 inCol = LOAD_INPUT_COLOR().xyz; 
 	
-	// calculate scene view-space position:
+	vec3 sceneWorldPos;
+	if (ANALYTIC_DEPTH) {
+		float sceneViewDepth = frame.projParams.y / (inDepth + frame.projParams.x);
+		sceneWorldPos = frame.camPos.xyz + v2fViewRay * sceneViewDepth;
+	}
+	else {
+		// calculate scene view-space position:
 	
-	// get ndc position from screen XY positions, and depth buffer Z position.  (post perspective divide)
-	vec2 ndc_xy = v2fScreenUV * 2.0 - 1.0; // remap to [-1,1]  (Vulkan coordinate system is [-1, 1])
-	vec4 sceneNDC = vec4(ndc_xy, inDepth, 1.0); 
+		// get ndc position from screen XY positions, and depth buffer Z position.  (post perspective divide)
+		vec2 ndc_xy = v2fScreenUV * 2.0 - 1.0; // remap to [-1,1]  (Vulkan coordinate system is [-1, 1])
+		vec4 sceneNDC = vec4(ndc_xy, inDepth, 1.0); 
 	
 
-	// transform NDC to viewspace position
-	mat4 invProj = inverse(ubo.proj);
-	vec4 sceneViewPos_w = invProj * sceneNDC;
-	vec3 sceneViewPos  = sceneViewPos_w.xyz / sceneViewPos_w.w;
+		// transform NDC to viewspace position
+		vec4 sceneViewPos_w = frame.invProj * sceneNDC;
+		vec3 sceneViewPos  = sceneViewPos_w.xyz / sceneViewPos_w.w;
 
-	vec3 camWorldPos =  vec3(0.0f, 1.0f, -4.0f);
-	vec3 viewCenter = vec3(0.0f, 0.0f, 1.0f);
-	vec3 camWorldDir = normalize(viewCenter - camWorldPos);
+		vec3 camWorldPos = frame.camPos.xyz;
+		vec3 camWorldDir = frame.camDir.xyz;
 	
-	// get scene's worldspace position
-	vec3 fragWorldDir = normalize(  v2fWorldPos - camWorldPos );
+		// get scene's worldspace position
+		vec3 fragWorldDir = normalize(  v2fWorldPos - camWorldPos );
 	
-	float dot = dot(fragWorldDir, camWorldDir);
-	vec3 a = fragWorldDir / dot;
-	vec3 b = -sceneViewPos.z * a;
+		float dot = dot(fragWorldDir, camWorldDir);
+		vec3 a = fragWorldDir / dot;
+		vec3 b = -sceneViewPos.z * a;
 	
-	vec3 sceneWorldPos = camWorldPos + b;
+		sceneWorldPos = camWorldPos + b;
+	}
 		 
 	// transform scene's worldspace to decal's object space
-	vec3 sceneModelPos = vec3(inverse(ubo.model) * vec4(sceneWorldPos, 1.0));
+	vec3 sceneModelPos = vec3(ubo.invModel * vec4(sceneWorldPos, 1.0));
 
 
 	// bound-box clipping in decal object space
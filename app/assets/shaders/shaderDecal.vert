@@ -1,15 +1,19 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
+#include "frame.glsl"
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inUV;
 layout(location = 3) in vec3 inNormal;
 
-layout(set = 0, binding = 0) uniform uboFX{
+// per-object uniforms (set 1)
+layout(set = 1, binding = 0) uniform uboFX{
 	mat4 model;
-	mat4 view;
-	mat4 proj;
-	vec2 res;
+	mat4 invModel;    // inverse(model)
 } ubo;
 
 layout(location = 0) out vec3 v2fCol;
@@ -17,9 +21,12 @@ layout(location = 1) out vec2 v2fUV;
 layout(location = 2) out vec2 v2fScreenUV;
 layout(location = 3) out vec3 v2fWorldPos;
 layout(location = 4) out vec3 v2fWorldNormal;
+// world-space camera-to-vertex vector, scaled to a view depth of 1: scene world position = camPos + v2fViewRay * sceneViewDepth.
+// linear in screen space, so it is interpolated without perspective correction
+layout(location = 5) noperspective out vec3 v2fViewRay;
 
 void main() {
-	vec4 clipPos = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0); // store clip-space position (before perspective divide)
+	vec4 clipPos = frame.viewProj * ubo.model * vec4(inPosition, 1.0); // store clip-space position (before perspective divide)
 	gl_Position = clipPos;
 	v2fCol = inColor;
 	v2fUV = inUV;
@@ -31,6 +38,7 @@ void main() {
 	v2fScreenUV = ndc.xy * 0.5 + vec2(0.5);
 	
 	v2fWorldPos = vec3(ubo.model * vec4(inPosition, 1.0));
+	v2fViewRay = (v2fWorldPos - frame.camPos.xyz) / clipPos.w; // clip w = view depth
 	v2fWorldNormal =  vec3( ubo.model * vec4(inNormal, 1.0));
 
 	
@@ -0,0 +1,96 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "frame.glsl"
+
+layout(location = 0) flat in uint v2fTile;
+layout(location = 1) noperspective in vec3 v2fViewRay;
+
+// decal storage buffers (set 1), written per frame from DecalBins
+struct Decal {
+	mat4 invModel;    // world -> decal box space
+	vec4 color;       // rgb tint, a: opacity
+};
+layout(std430, set = 1, binding = 0) readonly buffer decalData{
+	Decal decals[];
+};
+layout(std430, set = 1, binding = 1) readonly buffer tileRanges{
+	uvec2 ranges[];   // (first entry in decalIndices, decal count)
+} tiles;
+layout(std430, set = 1, binding = 2) readonly buffer tileDecalIndices{
+	uint decalIndices[];
+};
+
+#ifdef SAMPLED_INPUTS
+// separate render passes (--multipass): depth0 is a sampled texture, fetched at the fragment's own pixel
+layout(set = 2, binding = 1) uniform sampler2D inputDepthTexture;
+#define LOAD_INPUT_DEPTH() texelFetch(inputDepthTexture, ivec2(gl_FragCoord.xy), 0)
+#else
+layout(input_attachment_index = 1, set = 2, binding = 1) uniform subpassInput inputDepthAttachment;
+#define LOAD_INPUT_DEPTH() subpassLoad(inputDepthAttachment)
+#endif
+
+layout(location = 0) out vec4 outColor;
+
+// true: reconstruct the scene position from the linearized depth and the interpolated view ray.
+// false: reference path, unproject with the inverse view-projection matrix
+layout(constant_id = 0) const bool ANALYTIC_DEPTH = true;
+
+
+// decal pattern of one decal at a position in its box space (shaderDecal.frag); alpha 0 outside the box
+vec4 shadeDecal(vec3 decalPos, vec4 tint) {
+	float cubeEdgeLength = 4.0;
+	vec3 bounds = vec3(cubeEdgeLength / 2.0);
+	vec3 testBounds = abs(decalPos) - bounds;
+	if (testBounds.x >= 0.0 || testBounds.y >= 0.0 || testBounds.z >= 0.0) {
+		return vec4(0.0);
+	}
+
+	float y = length(decalPos) / bounds.x;
+
+	float range = 0.74;
+	float blurOuter = 0.25;
+	float blurInner = 0.025;
+	float outer = smoothstep(range, range + blurOuter, y) * step(range, y);
+	float outer1 = smoothstep(range, range + 0.0125, y) * step(range, y);
+	float inner = (1.0-smoothstep(range - blurInner, range, y)) * (1.0-step(range, y));
+
+	float mask0 =  (1.0-smoothstep(range, range + blurOuter, y)) * step(range, y);
+	float mask1 =  (smoothstep(range - blurInner, range, y)) * (1.0-step(range, y));
+	float mask3 =  (1.0-smoothstep(range, range + 0.0125, y)) * step(range, y);
+	float mask = mask0*0.125 + mask1*0.75 + mask3*0.75 + (1.0-step(range,y))*.125;
+
+	vec3 col = mix(vec3(1.0), tint.rgb, outer+outer1+inner);
+	col = mix(tint.rgb*0.5*.75, col, step(range-0.125, y));
+	return vec4(col, mask * tint.a);
+}
+
+void main() {
+	float inDepth = LOAD_INPUT_DEPTH().x;
+
+	vec3 sceneWorldPos;
+	if (ANALYTIC_DEPTH) {
+		float sceneViewDepth = frame.projParams.y / (inDepth + frame.projParams.x);
+		sceneWorldPos = frame.camPos.xyz + v2fViewRay * sceneViewDepth;
+	}
+	else {
+		vec2 ndc_xy = gl_FragCoord.xy / frame.res * 2.0 - 1.0;
+		vec4 sceneWorldPos_w = frame.invViewProj * vec4(ndc_xy, inDepth, 1.0);
+		sceneWorldPos = sceneWorldPos_w.xyz / sceneWorldPos_w.w;
+	}
+
+	// all decals of this tile, composited in decal order (premultiplied alpha, "over")
+	uvec2 range = tiles.ranges[v2fTile];
+	vec3 color = vec3(0.0);
+	float alpha = 0.0;
+	for (uint i = 0; i < range.y; i++) {
+		Decal decal = decals[decalIndices[range.x + i]];
+		vec3 decalPos = vec3(decal.invModel * vec4(sceneWorldPos, 1.0));
+		vec4 decalColor = shadeDecal(decalPos, decal.color);
+		color = decalColor.rgb * decalColor.a + color * (1.0 - decalColor.a);
+		alpha = decalColor.a + alpha * (1.0 - decalColor.a);
+	}
+	if (alpha <= 0.0) {
+		discard;
+	}
+	outColor = vec4(color, alpha); // blended with ONE, ONE_MINUS_SRC_ALPHA
+}
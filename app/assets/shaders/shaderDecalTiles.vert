@@ -0,0 +1,34 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "frame.glsl"
+
+// tiled decals: one instance per screen tile with decals (DecalBins::activeTiles), 6 vertices (two triangles) each,
+// no vertex buffer. must match DecalManager::TILE_SIZE
+const uint TILE_SIZE = 32;
+
+layout(std430, set = 1, binding = 3) readonly buffer activeTiles{
+	uint indices[];
+} active;
+
+layout(location = 0) flat out uint v2fTile;
+// world-space camera-to-pixel vector, scaled to a view depth of 1 (see shaderDecal.vert)
+layout(location = 1) noperspective out vec3 v2fViewRay;
+
+void main() {
+	const vec2 corners[6] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+
+	uint tile = active.indices[gl_InstanceIndex];
+	uint tilesX = (uint(frame.res.x) + TILE_SIZE - 1) / TILE_SIZE;
+	vec2 tileOrigin = vec2(tile % tilesX, tile / tilesX) * float(TILE_SIZE);
+	// (the last row/column is clipped by the viewport)
+	vec2 pixel = tileOrigin + corners[gl_VertexIndex] * float(TILE_SIZE);
+	vec2 ndc = pixel / frame.res * 2.0 - 1.0;
+	gl_Position = vec4(ndc, 0.0, 1.0);
+	v2fTile = tile;
+
+	// view ray through this corner: any point on the ray, divided by its view depth (clip w)
+	vec4 world = frame.invViewProj * vec4(ndc, 0.5, 1.0);
+	world /= world.w;
+	vec4 clipPos = frame.viewProj * world;
+	v2fViewRay = (world.xyz - frame.camPos.xyz) / clipPos.w;
+}
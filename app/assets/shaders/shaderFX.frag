@@ -1,24 +1,52 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
+#include "frame.glsl"
 
 layout(location = 0) in vec3 v2fCol;
 layout(location = 1) in vec2 v2fUV;
 layout(location = 2) in vec2 v2fScreenUV;
 layout(location = 3) in vec3 v2fWorldPos;
 layout(location = 4) in vec3 v2fWorldNormal;
+layout(location = 5) noperspective in vec3 v2fViewRay;
+layout(location = 6) flat in vec4 v2fGlow; // instance glow color (rgb) and intensity (a)
+layout(location = 7) flat in float v2fFieldScale; // instance base scale / original field's
 
-layout(set = 0, binding = 0) uniform uboFX{
+// per-object uniforms (set 1)
+layout(set = 1, binding = 0) uniform uboFX{
 	mat4 model;
-	mat4 view;
-	mat4 proj;
-	vec2 res;
+	mat4 invModel;    // inverse(model)
 } ubo;
 
 //layout(set = 0, binding = 1) uniform sampler2D textureSampler;
 
-layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
-layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputDepthAttachment;
+#ifdef SAMPLED_INPUTS
+// separate render passes (--multipass): col0/depth0 are sampled textures, fetched at the fragment's own pixel
+layout(set = 2, binding = 0) uniform sampler2D inputColorTexture;
+layout(set = 2, binding = 1) uniform sampler2D inputDepthTexture;
+#define LOAD_INPUT_COLOR() texelFetch(inputColorTexture, ivec2(gl_FragCoord.xy), 0)
+#define LOAD_INPUT_DEPTH() texelFetch(inputDepthTexture, ivec2(gl_FragCoord.xy), 0)
+#else
+layout(input_attachment_index = 0, set = 2, binding = 0) uniform subpassInput inputColorAttachment;
+layout(input_attachment_index = 1, set = 2, binding = 1) uniform subpassInput inputDepthAttachment;
+#define LOAD_INPUT_COLOR() subpassLoad(inputColorAttachment)
+#define LOAD_INPUT_DEPTH() subpassLoad(inputDepthAttachment)
+#endif
 
+#ifdef OIT_OUTPUT
+// weighted blended OIT (--oit): additive accumulation of (premultiplied color, alpha) * weight, and the product of (1 - alpha),
+// averaged and composited by shaderOitResolve.frag
+layout(location = 0) out vec4 outAccum;
+layout(location = 1) out float outReveal;
+#else
 layout(location = 0) out vec4 outColor;
+#endif
+
+// true: reconstruct the scene position from the linearized depth and the interpolated view ray (a few ALU ops).
+// false: reference path, unproject with the inverse view-projection matrix
+layout(constant_id = 0) const bool ANALYTIC_DEPTH = true;
 
 
 void main() {
@@ -29,44 +57,53 @@ void main() {
 
 	float outline = smoothstep(3.14*0.25, 3.14*0.5, angle);	
 	
-	vec3 viewOriginWorldPos = vec3(0.0f, 1.0f, -4.0f);
-	vec3 viewDir = normalize(v2fWorldPos - viewOriginWorldPos);
-	vec4 inCol = subpassLoad(inputColorAttachment);
-	float inDepth = subpassLoad(inputDepthAttachment).x; // depth is [-1, 1]
+	vec3 viewDir = normalize(v2fWorldPos - frame.camPos.xyz);
+	vec4 inCol = LOAD_INPUT_COLOR();
+	float inDepth = LOAD_INPUT_DEPTH().x; // depth is [-1, 1]
 	 
 	// calculate attachment's world-space position
 		// Vulkan coordinate system is [-1, 1]
 	vec2 ndc_xy = v2fScreenUV * 2.0 - 1.0; // remap to [-1,1]
 	vec4 inAttachment_ndc = vec4(ndc_xy, inDepth, 1.0); 
 	
-	mat4 inv_viewProj = inverse(ubo.proj * ubo.view);
-	vec4 inWorld_w = inv_viewProj * inAttachment_ndc;
-	vec3 inWorld   = inWorld_w.xyz / inWorld_w.w;
-	
-	/*
-	float T1 = ubo.proj[2][2];
-	float T2 = ubo.proj[3][2];
-	float viewSpaceZ = -T2 / (inAttachment_ndc.z + T1);
-	float clispaceW = -viewSpaceZ;
-	vec4 sceneClipSpace = vec4(inAttachment_ndc.xyz * clipSpaceW, clipSpaceW);
-	vec4 sceneViewSpace = inverse(ubo.proj) * sceneClipSpace;
-	*/
+	vec3 inWorld;
+	if (ANALYTIC_DEPTH) {
+		float sceneViewDepth = frame.projParams.y / (inDepth + frame.projParams.x);
+		inWorld = frame.camPos.xyz + v2fViewRay * sceneViewDepth;
+	}
+	else {
+		vec4 inWorld_w = frame.invViewProj * inAttachment_ndc;
+		inWorld = inWorld_w.xyz / inWorld_w.w;
+	}
 	
-	// compare attachment's and fragment's worldspace positions
-	float glow =  smoothstep(0.0,1.5,1.0-(inWorld.z-(v2fWorldPos.z-0.65)));
-	float highlight = smoothstep(0.0,1.5,1.0-(inWorld.z-(v2fWorldPos.z-0.75)));
-	float intersect = smoothstep(0.0,1.0,1.0-(inWorld.z-(v2fWorldPos.z-0.8)));
+	// compare attachment's and fragment's worldspace positions.
+	// the offsets are tuned for the original field: z distance in units of the instance's size, so small fields don't saturate
+	float dz = (inWorld.z - v2fWorldPos.z) / v2fFieldScale;
+	float glow =  smoothstep(0.0,1.5,1.0-(dz+0.65));
+	float highlight = smoothstep(0.0,1.5,1.0-(dz+0.75));
+	float intersect = smoothstep(0.0,1.0,1.0-(dz+0.8));
 	
 	//float nDepth = inDepth * 0.5 + 0.5; // [0, 1]
 	//float a = smoothstep(0.99965, 1.000, nDepth);
 	
-	vec3 col = mix(vec3(0.0),vec3(1.0,1.0,10.0), outline+glow);
+	vec3 glowCol = v2fGlow.rgb * v2fGlow.a; // (1, 1, 10) for the original field
+	vec3 col = mix(vec3(0.0),glowCol, outline+glow);
 	
 	//float pattern = texture(textureSampler, v2fScreenUV .xy);
 	
 	//float mask = (raymarch * raymarch);
-	col += mix(vec3(0.0),vec3(1.0,1.0,10.0), highlight + highlight);
-	col += mix(vec3(0.0),vec3(1.0,1.0,10.0), intersect * 4.0 );
-    outColor = vec4(col, 0.75);
+	col += mix(vec3(0.0),glowCol, highlight + highlight);
+	col += mix(vec3(0.0),glowCol, intersect * 4.0 );
+	float alpha = 0.75;
+#ifdef OIT_OUTPUT
+	// depth weight (McGuire and Bavoil 2013, eq. 9): nearer fragments dominate the average.
+	// upper clamp lowered from 3e3: glow colors reach ~70, and the RGBA16F accumulation tops out at 65504
+	float viewDepth = dot(v2fWorldPos - frame.camPos.xyz, frame.camDir.xyz);
+	float weight = clamp(10.0 / (1e-5 + pow(viewDepth / 5.0, 2.0) + pow(viewDepth / 200.0, 6.0)), 1e-2, 3e2);
+	outAccum = vec4(col * alpha, alpha) * weight;
+	outReveal = alpha;
+#else
+    outColor = vec4(col, alpha);
+#endif
 	
 }
\ No newline at end of file
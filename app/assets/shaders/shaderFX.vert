@@ -1,25 +1,55 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
+#include "frame.glsl"
+#include "fxInstance.glsl"
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inUV;
 layout(location = 3) in vec3 inNormal;
 
-layout(set = 0, binding = 0) uniform uboFX{
+// per-object uniforms (set 1)
+layout(set = 1, binding = 0) uniform uboFX{
 	mat4 model;
-	mat4 view;
-	mat4 proj;
-	vec2 res;
+	mat4 invModel;    // inverse(model)
 } ubo;
 
+// force field instances (set 1)
+layout(std430, set = 1, binding = 1) readonly buffer fxInstances{
+	FxInstance instances[];
+};
+// draw order (set 1): instance index of each draw instance, sorted back to front every frame
+layout(std430, set = 1, binding = 2) readonly buffer fxOrder{
+	uint order[];
+};
+
 layout(location = 0) out vec3 v2fCol;
 layout(location = 1) out vec2 v2fUV;
 layout(location = 2) out vec2 v2fScreenUV;
 layout(location = 3) out vec3 v2fWorldPos;
 layout(location = 4) out vec3 v2fWorldNormal;
+// world-space camera-to-vertex vector, scaled to a view depth of 1: scene world position = camPos + v2fViewRay * sceneViewDepth.
+// linear in screen space, so it is interpolated without perspective correction
+layout(location = 5) noperspective out vec3 v2fViewRay;
+layout(location = 6) flat out vec4 v2fGlow; // instance glow color (rgb) and intensity (a)
+// instance base scale relative to the original field's (1.125), whose world-space glow offsets shaderFX.frag keeps
+layout(location = 7) flat out float v2fFieldScale;
 
 void main() {
-	vec4 clipPos = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0); // store clip-space position (before perspective divide)
+	// instance animation, evaluated here so the CPU never touches the instances per frame
+	FxInstance instance = instances[order[gl_InstanceIndex]];
+	float scale = fxInstanceScale(instance, frame.time);
+	vec3 position = fxInstanceCenter(instance, frame.time);
+	mat4 model = mat4(
+		vec4(scale, 0.0, 0.0, 0.0),
+		vec4(0.0, scale, 0.0, 0.0),
+		vec4(0.0, 0.0, scale, 0.0),
+		vec4(position, 1.0));
+
+	vec4 clipPos = frame.viewProj * model * vec4(inPosition, 1.0); // store clip-space position (before perspective divide)
 	gl_Position = clipPos;
 	v2fCol = inColor;
 	v2fUV = inUV;
@@ -30,8 +60,11 @@ void main() {
 	// For screenspace UV, remap to [0,1]
 	v2fScreenUV = ndc.xy * 0.5 + vec2(0.5);
 	
-	v2fWorldPos = vec3(ubo.model * vec4(inPosition, 1.0));
-	v2fWorldNormal =  vec3( ubo.model * vec4(inNormal, 1.0));
+	v2fWorldPos = vec3(model * vec4(inPosition, 1.0));
+	v2fViewRay = (v2fWorldPos - frame.camPos.xyz) / clipPos.w; // clip w = view depth
+	v2fWorldNormal =  vec3( model * vec4(inNormal, 0.0));
+	v2fGlow = instance.color;
+	v2fFieldScale = instance.positionScale.w / 1.125;
 
 	
 }
\ No newline at end of file
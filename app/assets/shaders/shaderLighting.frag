@@ -0,0 +1,49 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "frame.glsl"
+#include "gbuffer.glsl"
+#include "light.glsl"
+
+layout(location = 0) flat in uint v2fLight;
+layout(location = 1) noperspective in vec3 v2fViewRay;
+
+// G-buffer of the scene subpass and depth0, read at the fragment's own pixel
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputAlbedoAttachment;
+layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputNormalAttachment;
+layout(input_attachment_index = 2, set = 1, binding = 2) uniform subpassInput inputDepthAttachment;
+// the frame's visible lights (VulkanApp::cullLights)
+layout(std430, set = 1, binding = 3) readonly buffer lightData{
+	Light lights[];
+};
+
+layout(location = 0) out vec4 outColor; // added to col0 (ONE, ONE)
+
+// true: reconstruct the scene position from the linearized depth and the interpolated view ray.
+// false: reference path, unproject with the inverse view-projection matrix
+layout(constant_id = 0) const bool ANALYTIC_DEPTH = true;
+
+void main() {
+	float inDepth = subpassLoad(inputDepthAttachment).x;
+	if (inDepth >= 1.0) {
+		discard; // background: nothing to light
+	}
+	Light light = lights[v2fLight];
+	vec4 albedo = subpassLoad(inputAlbedoAttachment);
+	vec3 wNormal = octDecode(subpassLoad(inputNormalAttachment).xy);
+
+	vec3 sceneWorldPos;
+	if (ANALYTIC_DEPTH) {
+		float sceneViewDepth = frame.projParams.y / (inDepth + frame.projParams.x);
+		sceneWorldPos = frame.camPos.xyz + v2fViewRay * sceneViewDepth;
+	}
+	else {
+		vec2 ndc_xy = gl_FragCoord.xy / frame.res * 2.0 - 1.0;
+		vec4 sceneWorldPos_w = frame.invViewProj * vec4(ndc_xy, inDepth, 1.0);
+		sceneWorldPos = sceneWorldPos_w.xyz / sceneWorldPos_w.w;
+	}
+
+	if (light.positionRadius.w > 0.0 && distance(light.positionRadius.xyz, sceneWorldPos) >= light.positionRadius.w) {
+		discard; // outside the point light's radius
+	}
+	outColor = vec4(shadeLight(light, sceneWorldPos, wNormal, albedo.rgb, albedo.a, frame.camPos.xyz), 0.0);
+}
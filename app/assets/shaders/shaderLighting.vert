@@ -0,0 +1,32 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "frame.glsl"
+#include "light.glsl"
+
+// deferred lighting (--deferred): one instance per visible light, 6 vertices (two triangles) over its screen rectangle,
+// no vertex buffer. only the pixels a light can reach run its fragment shader
+
+// the frame's visible lights (VulkanApp::cullLights), one instance each
+layout(std430, set = 1, binding = 3) readonly buffer lightData{
+	Light lights[];
+};
+
+layout(location = 0) flat out uint v2fLight;
+// world-space camera-to-pixel vector, scaled to a view depth of 1 (see shaderDecal.vert)
+layout(location = 1) noperspective out vec3 v2fViewRay;
+
+void main() {
+	const vec2 corners[6] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+
+	vec4 rect = lights[gl_InstanceIndex].screenRect;
+	vec2 pixel = mix(rect.xy, rect.zw, corners[gl_VertexIndex]);
+	vec2 ndc = pixel / frame.res * 2.0 - 1.0;
+	gl_Position = vec4(ndc, 0.0, 1.0);
+	v2fLight = gl_InstanceIndex;
+
+	// view ray through this corner: any point on the ray, divided by its view depth (clip w)
+	vec4 world = frame.invViewProj * vec4(ndc, 0.5, 1.0);
+	world /= world.w;
+	vec4 clipPos = frame.viewProj * world;
+	v2fViewRay = (world.xyz - frame.camPos.xyz) / clipPos.w;
+}
@@ -0,0 +1,47 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "frame.glsl"
+
+// occlusion query proxy (--occlusion-queries): the bounding box of a volume, expanded from gl_VertexIndex (36 vertices, no vertex buffer)
+// and depth-tested against the scene without a fragment shader or any writes, so the query only counts the samples in front of it.
+// instance 0: world-space bounds of all fx instances, instance 1: the volume decal's box, placed with uboFX.model
+
+// bounds fixed at pipeline creation: fx instances (world space), decal box (object space)
+layout(constant_id = 0) const float FX_MIN_X = 0.0;
+layout(constant_id = 1) const float FX_MIN_Y = 0.0;
+layout(constant_id = 2) const float FX_MIN_Z = 0.0;
+layout(constant_id = 3) const float FX_MAX_X = 0.0;
+layout(constant_id = 4) const float FX_MAX_Y = 0.0;
+layout(constant_id = 5) const float FX_MAX_Z = 0.0;
+layout(constant_id = 6) const float DECAL_MIN_X = 0.0;
+layout(constant_id = 7) const float DECAL_MIN_Y = 0.0;
+layout(constant_id = 8) const float DECAL_MIN_Z = 0.0;
+layout(constant_id = 9) const float DECAL_MAX_X = 0.0;
+layout(constant_id = 10) const float DECAL_MAX_Y = 0.0;
+layout(constant_id = 11) const float DECAL_MAX_Z = 0.0;
+
+// per-object uniforms (set 1, the fx set)
+layout(set = 1, binding = 0) uniform uboFX{
+	mat4 model;
+	mat4 invModel;
+} ubo;
+
+// box corners (bit 0: x, bit 1: y, bit 2: z set to max) of the 12 triangles, two per face (no culling: winding does not matter)
+const uint CORNERS[36] = uint[](
+	0, 2, 6, 0, 6, 4,  // -x
+	1, 5, 7, 1, 7, 3,  // +x
+	0, 4, 5, 0, 5, 1,  // -y
+	2, 3, 7, 2, 7, 6,  // +y
+	0, 1, 3, 0, 3, 2,  // -z
+	4, 6, 7, 4, 7, 5   // +z
+);
+
+void main() {
+	uint corner = CORNERS[gl_VertexIndex];
+	vec3 atMax = vec3(corner & 1u, (corner >> 1) & 1u, (corner >> 2) & 1u);
+	bool decal = gl_InstanceIndex != 0;
+	vec3 boxMin = decal ? vec3(DECAL_MIN_X, DECAL_MIN_Y, DECAL_MIN_Z) : vec3(FX_MIN_X, FX_MIN_Y, FX_MIN_Z);
+	vec3 boxMax = decal ? vec3(DECAL_MAX_X, DECAL_MAX_Y, DECAL_MAX_Z) : vec3(FX_MAX_X, FX_MAX_Y, FX_MAX_Z);
+	mat4 model = decal ? ubo.model : mat4(1.0);
+	gl_Position = frame.viewProj * model * vec4(mix(boxMin, boxMax, atMax), 1.0);
+}
@@ -0,0 +1,20 @@
+#version 450
+
+layout(location = 0) out vec4 outColor;
+
+// weighted blended OIT (--oit): accumulation and revealage of the fx subpass, read at the fragment's own pixel
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputAccumAttachment;
+layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputRevealAttachment;
+
+void main() {
+
+	float reveal = subpassLoad(inputRevealAttachment).r;
+	if (reveal >= 1.0) {
+		discard; // no fx fragment at this pixel
+	}
+	vec4 accum = subpassLoad(inputAccumAttachment);
+
+	// weighted average color, blended over col1 with the total coverage (SRC_ALPHA, ONE_MINUS_SRC_ALPHA)
+	vec3 averageColor = accum.rgb / max(accum.a, 1e-5);
+	outColor = vec4(averageColor, 1.0 - reveal);
+}
@@ -1,21 +1,38 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#include "frame.glsl"
 
 layout(location = 0) out vec4 outColor;
 
 layout(location = 0) in vec3 v2fCol;
 layout(location = 1) in vec2 v2fUV;
 
-layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput inputColorAttachment;
-//layout(input_attachment_index = 1, set = 0, binding = 1) uniform subpassInput inputBloomAttachment;
+#ifdef SAMPLED_INPUTS
+// separate render passes (--multipass): col0 is a sampled texture, fetched at the fragment's own pixel
+layout(set = 1, binding = 0) uniform sampler2D inputColorTexture;
+#define LOAD_INPUT_COLOR() texelFetch(inputColorTexture, ivec2(gl_FragCoord.xy), 0)
+#else
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
+#define LOAD_INPUT_COLOR() subpassLoad(inputColorAttachment)
+#endif
+#ifdef BLOOM
+// bloom (--bloom, with SAMPLED_INPUTS only): level 0 of the bloom pyramid, upscaled by the linear sampler (computed between the
+// scene and the composition pass)
+layout(set = 1, binding = 1) uniform sampler2D inputBloomTexture;
+const float BLOOM_STRENGTH = 0.1;
+#endif
 
 void main() {
 
 	outColor = vec4(0.0, 0.0, 0.0, 0.0);
 	
 	// accumulate color and bloom attachments
-	vec4 inCol = subpassLoad(inputColorAttachment);
+	vec4 inCol = LOAD_INPUT_COLOR();
+#ifdef BLOOM
+	inCol.rgb += texture(inputBloomTexture, gl_FragCoord.xy / frame.res).rgb * BLOOM_STRENGTH;
+#endif
 
-	float exposure = 1.0;
+	float exposure = frame.exposure;
 	// apply tonemapping
 	vec4 remapped = vec4(1.0) - exp(-inCol * exposure);
 	// output to swapchain image
@@ -0,0 +1,32 @@
+// shadow map of the forward path's light (set 3 of the scene pipeline layout). must match VulkanApp::UniformBufferObjectShadow
+layout(set = 3, binding = 0) uniform uboShadow{
+	mat4 viewProj;  // light view-projection the shadow map was rendered with
+	vec4 position;  // light world-space position (xyz)
+} shadowLight;
+
+#ifndef SHADOW_CASTER
+// depth comparison sampler (LESS_OR_EQUAL): 1 where the reference depth is not behind the stored one
+layout(set = 3, binding = 1) uniform sampler2DShadow shadowMap;
+
+// fraction of a 3x3 texel neighbourhood that sees the light (percentage-closer filtering).
+// outside the light's frustum: lit (the frustum is fitted around the scene, so only non-casters end up there)
+float shadowFactor(vec3 worldPos) {
+	vec4 lightClip = shadowLight.viewProj * vec4(worldPos, 1.0);
+	if (lightClip.w <= 0.0) {
+		return 1.0;
+	}
+	vec3 ndc = lightClip.xyz / lightClip.w;
+	if (ndc.z >= 1.0 || any(greaterThan(abs(ndc.xy), vec2(1.0)))) {
+		return 1.0;
+	}
+	vec2 uv = ndc.xy * 0.5 + 0.5;
+	vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+	float lit = 0.0;
+	for (int y = -1; y <= 1; y++) {
+		for (int x = -1; x <= 1; x++) {
+			lit += texture(shadowMap, vec3(uv + vec2(x, y) * texel, ndc.z));
+		}
+	}
+	return lit / 9.0;
+}
+#endif
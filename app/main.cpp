@@ -1,9 +1,146 @@
 #include "VulkanExample.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
 
-int main()
+static void printUsage()
 {
-	VulkanApp vulkanApp;
+	std::cout << "usage: VulkanExampleApp [options]" << '\n';
+	std::cout << "  --pipelined          run update and render-submission stages on separate threads" << '\n';
+	std::cout << "  --benchmark <frames> render <frames> frames, then print frame timings and exit" << '\n';
+	std::cout << "  --serial-startup     run the startup tasks one after another, instead of on the job system" << '\n';
+	std::cout << "  --multipass          render scene and composition as separate render passes instead of subpasses" << '\n';
+	std::cout << "  --no-dynamic-rendering  use the render pass backend even if dynamic rendering with local read is supported" << '\n';
+	std::cout << "  --matrix-depth       reconstruct positions from depth with inverse matrices instead of the analytic linearization" << '\n';
+	std::cout << "  --no-volume-bounds   draw the fx/decal volumes without screen-space scissor and depth-bounds test" << '\n';
+	std::cout << "  --no-decal-stencil   shade the decal box without the stencil mask of its intersection with the scene (--volume-decals)" << '\n';
+	std::cout << "  --decals <n>         number of decals applied by the tiled decal pass (default 256)" << '\n';
+	std::cout << "  --volume-decals      draw a single decal box per frame instead of the tiled decal pass" << '\n';
+	std::cout << "  --fx <n>             number of force fields, drawn by one instanced draw (default 64)" << '\n';
+	std::cout << "  --gpu-sort           sort the force fields back to front in a compute dispatch instead of on the CPU" << '\n';
+	std::cout << "  --gpu-culling        frustum-cull the force fields in a compute dispatch that writes their indirect draw" << '\n';
+	std::cout << "  --oit                blend the force fields with weighted blended order-independent transparency (no sort)" << '\n';
+	std::cout << "  --deferred           shade the scene in a deferred lighting subpass (G-buffer on tile) instead of forward" << '\n';
+	std::cout << "  --clustered          shade the scene forward with per-cluster light lists (view-space froxels)" << '\n';
+	std::cout << "  --lights <n>         number of lights of the deferred/clustered paths (default 64)" << '\n';
+	std::cout << "  --msaa <2|4|8>       multisample the scene subpass, resolved inside the render pass (default 1: off)" << '\n';
+	std::cout << "  --depth-prepass      draw scene depth in a depth-only subpass first, then shade with an EQUAL depth test" << '\n';
+	std::cout << "  --hiz                skip force fields and decals hidden behind the previous frame's depth (Hi-Z pyramid)" << '\n';
+	std::cout << "  --occlusion-queries  skip the fx/decal draws whose proxy box was hidden the frame before (occlusion queries)" << '\n';
+	std::cout << "  --shadows            shadow the scene's light with a shadow map (re-rendered only when the light or the scene moves)" << '\n';
+	std::cout << "  --no-shadow-cache    re-render the shadow map every frame" << '\n';
+	std::cout << "  --stereo             render both eyes in one pass with multiview, shown side by side" << '\n';
+	std::cout << "  --auto-exposure      adapt the exposure to the scene's luminance (histogram dispatch on the async compute queue)" << '\n';
+	std::cout << "  --no-async-compute   dispatch the auto exposure histogram in the graphics command buffer instead" << '\n';
+	std::cout << "  --bloom              add bloom from a bright pass and dual filter mip chain in compute dispatches (turns on --multipass)" << '\n';
+	std::cout << "  --fast-bloom         performance preset of --bloom: quarter-resolution first level, 4 levels" << '\n';
+}
+
+static bool parseSettings(int argc, char* argv[], VulkanApp::Settings& settings)
+{
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--pipelined") {
+			settings.pipelinedFrames = true;
+		}
+		else if (arg == "--serial-startup") {
+			settings.serialStartup = true;
+		}
+		else if (arg == "--multipass") {
+			settings.multiPass = true;
+		}
+		else if (arg == "--no-dynamic-rendering") {
+			settings.disableDynamicRendering = true;
+		}
+		else if (arg == "--matrix-depth") {
+			settings.matrixDepthReconstruction = true;
+		}
+		else if (arg == "--no-volume-bounds") {
+			settings.disableVolumeBounds = true;
+		}
+		else if (arg == "--no-decal-stencil") {
+			settings.disableDecalStencil = true;
+		}
+		else if (arg == "--volume-decals") {
+			settings.volumeDecals = true;
+		}
+		else if (arg == "--decals" && i + 1 < argc) {
+			settings.decalCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--gpu-sort") {
+			settings.gpuSort = true;
+		}
+		else if (arg == "--gpu-culling") {
+			settings.gpuCulling = true;
+		}
+		else if (arg == "--hiz") {
+			settings.hiZ = true;
+		}
+		else if (arg == "--occlusion-queries") {
+			settings.occlusionQueries = true;
+		}
+		else if (arg == "--shadows") {
+			settings.shadows = true;
+		}
+		else if (arg == "--no-shadow-cache") {
+			settings.disableShadowCache = true;
+		}
+		else if (arg == "--stereo") {
+			settings.stereo = true;
+		}
+		else if (arg == "--auto-exposure") {
+			settings.autoExposure = true;
+		}
+		else if (arg == "--no-async-compute") {
+			settings.disableAsyncCompute = true;
+		}
+		else if (arg == "--bloom") {
+			settings.bloom = true;
+		}
+		else if (arg == "--fast-bloom") {
+			settings.fastBloom = true;
+		}
+		else if (arg == "--oit") {
+			settings.oit = true;
+		}
+		else if (arg == "--deferred") {
+			settings.deferred = true;
+		}
+		else if (arg == "--clustered") {
+			settings.clustered = true;
+		}
+		else if (arg == "--lights" && i + 1 < argc) {
+			settings.lightCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--depth-prepass") {
+			settings.depthPrepass = true;
+		}
+		else if (arg == "--msaa" && i + 1 < argc) {
+			settings.msaaSamples = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--fx" && i + 1 < argc) {
+			settings.fxCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--benchmark" && i + 1 < argc) {
+			settings.benchmarkFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else {
+			std::cerr << "unknown option: " << arg << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	VulkanApp::Settings settings;
+	if (!parseSettings(argc, argv, settings)) {
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	VulkanApp vulkanApp(settings);
 	std::cout << "Launching Vulkan app" << std::endl;
 	try {
         	vulkanApp.run();
@@ -12,8 +149,8 @@ int main()
         	std::cerr << e.what() << std::endl;
         	return EXIT_FAILURE;
     	}
-	
+
 	return EXIT_SUCCESS;
 
  }
-	
+
@@ -0,0 +1,64 @@
+#ifndef DECALMANAGER_H
+#define DECALMANAGER_H
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+// Tiled decals:
+// decals are boxes projected onto the scene. Instead of one draw per decal box, every frame the decals are binned into
+// screen tiles (by their projected screen-space rectangles), and one instanced draw covers only the tiles with decals:
+// -> each tile's fragments loop over the tile's decal list, and blend all decals covering the pixel in one shader invocation
+// -> cost scales with the covered tiles and the decals per tile, not with the total decal count
+
+struct DecalInfo {
+    glm::mat4 model = glm::mat4(1.0f); // decal box (the decal mesh's local bounds) to world space
+    glm::vec4 color = glm::vec4(1.0f); // rgb tint, a: opacity
+};
+
+// one decal as the tiled decal shader reads it (std430: struct Decal in shaderDecalTiles.frag)
+struct DecalGpuData {
+    glm::mat4 invModel;
+    glm::vec4 color;
+};
+
+// per-frame binning result, laid out as the shader's storage buffers
+struct DecalBins {
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+    std::vector<DecalGpuData> decals;      // all decals, indexed by decalIndices
+    std::vector<glm::uvec2> tileRanges;    // per tile (row-major): first entry in decalIndices, decal count
+    std::vector<uint32_t> decalIndices;    // decal lists of all tiles, tile after tile
+    std::vector<uint32_t> activeTiles;     // tiles with at least one decal: one draw instance each
+    // binning scratch (CPU only, not uploaded)
+    std::vector<glm::uvec4> decalTiles;    // per decal: tile range x0, y0, x1, y1 (exclusive)
+    std::vector<uint32_t> tileCounts;      // per tile: decal count
+};
+
+class DecalManager {
+
+public:
+    static const uint32_t TILE_SIZE = 32; // pixels
+
+    uint32_t addDecal(const DecalInfo& decal);
+
+    void setModel(uint32_t decal, const glm::mat4& model);
+
+    uint32_t getDecalCount() const;
+
+    static uint32_t getTileCount(VkExtent2D extent);
+
+    // bin the decals into the tiles overlapped by their screen-space rectangles (one rectangle per decal, empty if not visible).
+    // tile ranges of all rectangles first, then two passes over them (count, then fill), so tile lists are contiguous without
+    // per-tile allocations
+    void binDecals(const std::vector<VkRect2D>& screenRects, VkExtent2D extent, DecalBins& bins) const;
+
+    const DecalInfo& getDecal(uint32_t decal) const;
+
+private:
+    std::vector<DecalInfo> decals;
+};
+
+#endif
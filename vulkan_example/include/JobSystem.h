@@ -0,0 +1,116 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <ostream>
+#include <cstdint>
+
+// Small work-stealing job system:
+// every worker owns a job queue. A worker pops its own newest job first (LIFO, cache-warm),
+// and when its queue runs dry, steals the oldest job from another worker's queue (FIFO).
+
+class JobSystem {
+
+public:
+    explicit JobSystem(uint32_t workerCount);
+    ~JobSystem();
+
+    // queue a job. Jobs queued from a worker go to that worker's queue, other threads spread jobs round-robin.
+    void submit(std::function<void()> job);
+
+    // run one queued job on the calling thread (so a waiting thread can help). returns false if no job was found.
+    bool tryRunOne();
+
+    uint32_t getWorkerCount() const;
+
+private:
+    struct WorkerQueue {
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<bool> stopping;
+    std::atomic<uint32_t> queuedJobs;
+    std::atomic<uint32_t> nextQueue;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+    bool popOwn(uint32_t queueIndex, std::function<void()>& job);
+
+    bool steal(uint32_t thiefIndex, std::function<void()>& job);
+
+    void workerMain(uint32_t workerIndex);
+};
+
+
+// Task graph with explicit dependencies, executed on a JobSystem.
+// Dependencies must be added before the tasks depending on them, which keeps the graph acyclic
+// and makes insertion order a valid serial execution order.
+
+class TaskGraph {
+
+public:
+    typedef uint32_t TaskID;
+
+    // task that may run on any thread
+    TaskID addTask(const std::string& name, std::function<void()> work, const std::vector<TaskID>& dependencies = {});
+
+    // task that must run on the thread calling run() (e.g. window-system calls)
+    TaskID addMainThreadTask(const std::string& name, std::function<void()> work, const std::vector<TaskID>& dependencies = {});
+
+    // execute all tasks as soon as their dependencies finished. The calling thread runs main-thread tasks, and helps with other jobs.
+    // rethrows the first exception thrown by a task (tasks depending on a failed task are skipped).
+    void run(JobSystem& jobSystem);
+
+    // execute all tasks one after another on the calling thread, in insertion order
+    void runSerial();
+
+    // per-task timings, total wall time, summed task time and the critical path
+    void printReport(std::ostream& out) const;
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> work;
+        std::vector<TaskID> dependencies;
+        std::vector<TaskID> dependents;
+        bool mainThread = false;
+        std::atomic<uint32_t> remainingDependencies{ 0 };
+        bool failed = false;
+        double startSeconds = 0.0;
+        double endSeconds = 0.0;
+    };
+
+    std::vector<std::unique_ptr<Task>> tasks;
+    double runStartSeconds = 0.0;
+    double runEndSeconds = 0.0;
+    bool ranSerial = false;
+
+    std::mutex mainThreadMutex;
+    std::vector<TaskID> mainThreadReady;
+    std::atomic<uint32_t> unfinishedTasks{ 0 };
+    std::mutex exceptionMutex;
+    std::exception_ptr firstException;
+
+    TaskID addTaskInternal(const std::string& name, std::function<void()> work, const std::vector<TaskID>& dependencies, bool mainThread);
+
+    void schedule(JobSystem& jobSystem, TaskID id);
+
+    void execute(JobSystem& jobSystem, TaskID id);
+
+    static double nowSeconds();
+};
+
+#endif
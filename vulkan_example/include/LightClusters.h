@@ -0,0 +1,49 @@
+#ifndef LIGHTCLUSTERS_H
+#define LIGHTCLUSTERS_H
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+// Clustered forward lighting:
+// the view frustum is split into froxel clusters (a CLUSTERS_X x CLUSTERS_Y screen grid, CLUSTERS_Z exponential view-depth slices).
+// Every frame each light is assigned to the clusters overlapped by its screen-space rectangle and view-depth range, and the scene's
+// fragment shader only walks the light list of its own cluster:
+// -> per-fragment cost scales with the lights near the fragment, not with the total light count
+
+// conservative bounds of one light for the assignment (an empty rectangle: not visible, not assigned)
+struct LightClusterBounds {
+    VkRect2D screenRect{};  // pixels
+    float minDepth = 0.0f;  // view depth range (distance along the camera's forward direction)
+    float maxDepth = 0.0f;
+};
+
+// per-frame assignment result, laid out as the shader's storage buffers
+struct LightClusterGrid {
+    std::vector<glm::uvec2> clusterRanges; // per cluster (x fastest, then y, then slice): first entry in lightIndices, light count
+    std::vector<uint32_t> lightIndices;    // light lists of all clusters, cluster after cluster
+};
+
+class LightClusters {
+
+public:
+    // must match cluster.glsl
+    static const uint32_t CLUSTERS_X = 16;
+    static const uint32_t CLUSTERS_Y = 9;
+    static const uint32_t CLUSTERS_Z = 16;
+    static constexpr float DEPTH_NEAR = 0.1f; // slice 0 also holds everything closer
+    static constexpr float DEPTH_FAR = 10.0f; // the last slice also holds everything further
+
+    static uint32_t getClusterCount();
+
+    // exponential slicing: slices have the same depth ratio, so they stay roughly cube-shaped in view space
+    static uint32_t getSlice(float viewDepth);
+
+    // assign every light to the clusters overlapped by its bounds (one bounds entry per light, indices refer to that order).
+    // two passes over the lights (count, then fill), so cluster lists are contiguous without per-cluster allocations
+    static void assignLights(const std::vector<LightClusterBounds>& bounds, VkExtent2D extent, LightClusterGrid& grid);
+};
+
+#endif
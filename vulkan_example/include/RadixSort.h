@@ -0,0 +1,26 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <vector>
+#include <cstdint>
+
+// LSD radix sort of 32-bit keys with a 32-bit payload each (e.g. instance indices):
+// 4 counting-sort passes over 8-bit digits (histogram, exclusive prefix sum, stable scatter), no comparisons, O(n).
+// passes whose digit is the same for every key are skipped (common for the high byte of nearby depths)
+
+class RadixSort {
+
+public:
+    // order-preserving float -> uint mapping: a < b <=> floatKey(a) < floatKey(b) (negative values included)
+    static uint32_t floatKey(float value);
+
+    // sort keys ascending, and reorder values alongside (stable). keys and values must have the same size.
+    // the scratch arrays are kept between calls, so sorting the same count again does not allocate
+    void sort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values);
+
+private:
+    std::vector<uint32_t> scratchKeys;
+    std::vector<uint32_t> scratchValues;
+};
+
+#endif
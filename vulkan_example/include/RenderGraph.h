@@ -0,0 +1,167 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+#include <string>
+#include <map>
+#include <ostream>
+#include <cstdint>
+
+// Declarative render graph:
+// passes declare which attachments they write and read, and the graph derives one VkRenderPass from it:
+// -> one subpass per pass (in declaration order)
+// -> load/store ops: attachments are only loaded if read before written, only stored if used after the render pass
+// -> transient attachments (only used inside the render pass) get TRANSIENT usage, so they can live in lazily allocated (tile) memory
+// -> layouts: each attachment stays in the layout of its last use, instead of transitioning at the end of the render pass
+// -> multisample resolves at the end of a subpass (pResolveAttachments, depth/stencil resolve), so the samples can stay transient
+// -> multiview: every subpass renders all views of the view mask (one layer per view), with view-local subpass dependencies
+// -> subpass dependencies only for real hazards (read-after-write, write-after-read, write-after-write, layout change),
+//    with only the stages/accesses of the involved uses, and BY_REGION (all reads are framebuffer-local)
+
+struct RenderGraphAttachmentInfo {
+    std::string name;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkClearValue clearValue{};
+    // false: the first write covers every pixel, so the previous contents are DONT_CARE instead of cleared
+    bool clearOnFirstWrite = true;
+
+    // persistent attachments are used outside of the render pass (presented, sampled later):
+    // they are stored, never transient, and end in finalLayout
+    bool persistent = false;
+    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // first stage/access using a persistent attachment after the render pass
+    VkPipelineStageFlags externalDstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    VkAccessFlags externalDstAccessMask = 0;
+    // stages/accesses using the attachment outside of the render pass, which the next frame's first use has to wait for
+    // (e.g. sampled by a later render pass)
+    VkPipelineStageFlags externalSrcStageMask = 0;
+    VkAccessFlags externalSrcAccessMask = 0;
+    // persistent attachments the graph only reads (loaded, bound read-only) keep their contents, so they are never stored:
+    // true: read after the render pass (STORE_OP_NONE if enabled, STORE otherwise), false: DONT_CARE
+    bool readAfterPass = true;
+};
+
+struct RenderGraphPassInfo {
+    std::string name;
+    std::vector<std::string> colorOutputs;      // color attachments (written)
+    std::string depthOutput;                    // depth/stencil attachment (written)
+    std::string depthInput;                     // depth/stencil attachment bound read-only (depth test without writes)
+    std::vector<std::string> inputAttachments;  // read with subpassLoad(), in input_attachment_index order
+    // multisampled outputs resolved at the end of the pass: one single-sample target per color output (same order),
+    // and the depth output's target (depth: sample 0, stencil is not resolved)
+    std::vector<std::string> resolveOutputs;
+    std::string depthResolveOutput;
+    // the pass writes the stencil aspect of its depth/stencil attachment; with a depthInput the depth aspect stays read-only
+    // (DEPTH_READ_ONLY_STENCIL_ATTACHMENT_OPTIMAL), so it can still be read as an input attachment
+    bool stencilWrite = false;
+};
+
+class RenderGraph {
+
+public:
+    void addAttachment(const RenderGraphAttachmentInfo& info);
+
+    void addPass(const RenderGraphPassInfo& info);
+
+    // views rendered by every subpass (bit i: layer i of each attachment, gl_ViewIndex i). 0: no multiview, single-layer attachments
+    void setViewMask(uint32_t mask);
+
+    uint32_t getViewCount() const;
+
+    // VK_ATTACHMENT_STORE_OP_NONE (Vulkan 1.3): read-only attachments read after the render pass are kept without a store
+    void setStoreOpNone(bool supported);
+
+    // image usage an attachment's image must be created with (includes TRANSIENT for transient attachments)
+    VkImageUsageFlags getImageUsage(const std::string& attachment) const;
+
+    // attachment is only used inside the render pass: its contents never leave tile memory
+    bool isTransient(const std::string& attachment) const;
+
+    uint32_t getSubpassIndex(const std::string& pass) const;
+
+    // clear values, in attachment order (for VkRenderPassBeginInfo)
+    std::vector<VkClearValue> getClearValues() const;
+
+    // derived ops and clear value of one attachment (for VkRenderingAttachmentInfo, without a render pass)
+    VkAttachmentLoadOp getLoadOp(const std::string& attachment) const;
+
+    VkAttachmentStoreOp getStoreOp(const std::string& attachment) const;
+
+    VkAttachmentLoadOp getStencilLoadOp(const std::string& attachment) const;
+
+    VkAttachmentStoreOp getStencilStoreOp(const std::string& attachment) const;
+
+    VkClearValue getClearValue(const std::string& attachment) const;
+
+    // derive subpasses, dependencies and attachment descriptions, then create the render pass
+    VkRenderPass createRenderPass(VkDevice device);
+
+    // views for an attachment: one view shared by all framebuffers, or one view per framebuffer (swapchain)
+    void bindImageViews(const std::string& attachment, const std::vector<VkImageView>& views);
+
+    void createFramebuffers(VkDevice device, VkRenderPass renderPass, VkExtent2D extent, uint32_t framebufferCount, std::vector<VkFramebuffer>& framebuffers) const;
+
+    // attachment load/store traffic per frame in bytes (clears and DONT_CARE are free on tile-based GPUs).
+    // derived from the declaration only, so graphs can be compared without creating them
+    VkDeviceSize estimateBandwidth(VkExtent2D extent) const;
+
+    // same, if every attachment were loaded and stored (hand-written render pass without the graph's derivation)
+    VkDeviceSize estimateWorstCaseBandwidth(VkExtent2D extent) const;
+
+    void printSummary(std::ostream& out, VkExtent2D extent) const;
+
+private:
+    enum UseType {
+        USE_COLOR_OUTPUT,
+        USE_DEPTH_OUTPUT,
+        USE_DEPTH_INPUT,
+        USE_INPUT_ATTACHMENT,
+        USE_RESOLVE_OUTPUT
+    };
+
+    // all uses of one attachment inside one pass, merged
+    struct AttachmentUse {
+        uint32_t pass;
+        bool write = false;
+        bool stencilWrite = false; // only the stencil aspect is written (depth may be read-only)
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stageMask = 0;
+        VkAccessFlags accessMask = 0;
+        VkAccessFlags writeAccessMask = 0;
+    };
+
+    struct Attachment {
+        RenderGraphAttachmentInfo info;
+        std::vector<AttachmentUse> uses; // in pass order
+        std::vector<VkImageView> views;
+    };
+
+    std::vector<Attachment> attachments;
+    std::vector<RenderGraphPassInfo> passes;
+    std::map<std::pair<uint32_t, uint32_t>, VkSubpassDependency2> dependencies; // (src, dst) -> merged dependency
+    uint32_t viewMask = 0;
+    bool storeOpNone = false;
+
+    uint32_t getAttachmentIndex(const std::string& attachment) const;
+
+    void addUse(const std::string& attachment, uint32_t pass, UseType type);
+
+    VkAttachmentLoadOp deriveLoadOp(const Attachment& attachment) const;
+
+    VkAttachmentStoreOp deriveStoreOp(const Attachment& attachment) const;
+
+    VkAttachmentLoadOp deriveStencilLoadOp(const Attachment& attachment) const;
+
+    void deriveDependencies();
+
+    void addDependency(uint32_t srcSubpass, uint32_t dstSubpass, VkPipelineStageFlags srcStageMask, VkAccessFlags srcAccessMask, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask);
+
+    static bool isDepthFormat(VkFormat format);
+
+    static uint32_t formatBytesPerPixel(VkFormat format);
+};
+
+#endif
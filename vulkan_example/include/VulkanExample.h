@@ -26,15 +26,101 @@
 #include <fstream>
 #include <array>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <limits>
+#include <exception>
 #include <math.h> 
 
+#include "JobSystem.h"
+#include "RenderGraph.h"
+#include "DecalManager.h"
+#include "RadixSort.h"
+#include "LightClusters.h"
+
 
 
 // Vulkan subpasses example
 
 class VulkanApp {
 
+public:
+    // runtime options (parsed from command line arguments in main.cpp)
+    struct Settings {
+        // run the simulation/update stage and the render-submission stage on separate threads,
+        // handing off frame-state snapshots, so updating frame N+1 overlaps submitting frame N
+        bool pipelinedFrames = false;
+        // if non-zero: exit after rendering this many frames, and print CPU frame timings
+        uint32_t benchmarkFrames = 0;
+        // run the initVulkan() startup tasks one after another, instead of on the job system (for comparison)
+        bool serialStartup = false;
+        // render scene and composition as two render passes (sampled textures, explicit barriers, stored attachments)
+        // instead of two subpasses of one render pass, to measure what the subpasses save
+        bool multiPass = false;
+        // use the render pass backend even if the device supports dynamic rendering with local read
+        bool disableDynamicRendering = false;
+        // fx/decal shaders reconstruct scene positions with the inverse matrices, instead of the analytic depth linearization
+        bool matrixDepthReconstruction = false;
+        // rasterize the fx/decal volumes with a full-screen scissor and no depth-bounds test (for comparison)
+        bool disableVolumeBounds = false;
+        // shade the decal box without the stencil mask of the volume/scene intersection (for comparison)
+        bool disableDecalStencil = false;
+        // number of projected decals (DecalManager), applied by one tiled draw
+        uint32_t decalCount = 256;
+        // draw the decal as its own box (the first decal only, with volume bounds and stencil mask) instead of the tiled draw
+        bool volumeDecals = false;
+        // number of force fields, drawn by one instanced draw (instance 0 is the original field at the origin)
+        uint32_t fxCount = 64;
+        // sort the force fields back to front in a compute dispatch, instead of on the CPU in the update stage
+        bool gpuSort = false;
+        // GPU-driven fx draw: a compute dispatch frustum-culls the force fields and writes the indirect draw command and count
+        // the fx draw consumes, instead of the CPU-supplied instance count of a direct draw
+        bool gpuCulling = false;
+        // Hi-Z occlusion culling: a depth pyramid reduced from the previous frame's depth by compute, the force fields are tested
+        // against it in the cull dispatch (implies gpuCulling), the decals on the CPU against a read-back coarse level
+        bool hiZ = false;
+        // weighted blended order-independent transparency for the force fields: no draw order, no sort
+        // (render pass backend with subpasses only: ignored with multiPass)
+        bool oit = false;
+        // deferred shading: the scene subpass writes a G-buffer, a lighting subpass accumulates lightCount point lights into col0
+        // (render pass backend with subpasses only: ignored with multiPass)
+        bool deferred = false;
+        // clustered forward shading: the scene fragment shader walks the lights of its view-space cluster (ignored with deferred)
+        bool clustered = false;
+        // number of lights of the deferred/clustered paths (light 0 is the forward path's light, with ambient, over the whole screen)
+        uint32_t lightCount = 64;
+        // samples per pixel of the scene subpass (1: no multisampling; 2, 4 or 8, clamped to what the device supports),
+        // resolved into col0/depth0 at the end of the subpass (render pass backend with subpasses only: ignored with multiPass, deferred)
+        uint32_t msaaSamples = 1;
+        // depth-only pre-pass subpass before the scene subpass (position-only vertex stream, no fragment shader),
+        // the scene subpass then shades only the visible fragments (depth test EQUAL, no depth writes)
+        bool depthPrepass = false;
+        // occlusion queries around cheap proxy boxes of the fx instances and the volume decal: the next frame skips the draw of a
+        // volume whose proxy passed no depth test (VK_EXT_conditional_rendering if supported, otherwise CPU readback)
+        bool occlusionQueries = false;
+        // shadow map of the forward path's light, rendered before the render pass from the position-only stream and sampled
+        // by the scene subpass (forward and clustered shading: ignored with deferred). only re-rendered when the light or the scene moved
+        bool shadows = false;
+        // re-render the shadow map every frame, instead of reusing it while the light and the shadow casters stay put (for comparison)
+        bool disableShadowCache = false;
+        // multiview stereo: both eyes rendered by one pass over the render pass (view mask on every subpass, 2-layer attachments),
+        // shown side by side (render pass backend with subpasses only: ignored with multiPass, deferred)
+        bool stereo = false;
+        // auto exposure: histogram of a quarter-resolution copy of col0 after the render pass, adapted exposure read back for the
+        // tonemapping of the following frames. dispatched on the compute queue, overlapping the next frames' graphics work
+        bool autoExposure = false;
+        // record the auto exposure dispatch into the graphics command buffer instead of the compute queue (for comparison)
+        bool disableAsyncCompute = false;
+        // bloom: bright pass and dual filter down/upsampling over a mip pyramid in compute dispatches, added by the composition
+        // (enables multiPass: the chain runs between the render passes; not with stereo: the composition would need one pyramid per view)
+        bool bloom = false;
+        // performance preset of the bloom pyramid (quarter-resolution first level, fewer levels), implies bloom
+        bool fastBloom = false;
+    };
+
 private:
+    Settings settings;
     bool blocked;
    
 	GLFWwindow* window;
@@ -69,8 +155,10 @@ private:
 
     VkQueue graphicsQueue;
     VkQueue presentQueue;
-    VkQueue computeQueue;
+    VkQueue computeQueue; // compute family queue 0; async auto exposure: a queue of a compute-only family if there is one (computeQueueFamily/Index)
     VkQueue transferQueue;
+    uint32_t computeQueueFamily = 0;
+    uint32_t computeQueueIndex = 0;
 
     VkSwapchainKHR swapChain;
 
@@ -81,7 +169,8 @@ private:
 
     VkImage depthImage;
     VkDeviceMemory depthImageMemory;
-    VkImageView depthImageView;
+    VkImageView depthImageView; // depth aspect only: read by the fx/decal shaders
+    VkImageView depthStencilImageView; // depth and stencil aspects: bound as depth/stencil attachment
 
     VkImage offscreenImage;
     VkDeviceMemory offscreenImageMemory;
@@ -93,6 +182,7 @@ private:
     int textureWidth = 1024;
     int textureHeight = 1024;
     int textureChannels = 4;
+    unsigned char* texturePixels = nullptr; // decoded by decodeTexture(), freed after upload
 
     VkImage textureImage;
     VkDeviceMemory textureImageMemory;
@@ -101,48 +191,526 @@ private:
     VkImageView textureImageView;
     VkSampler textureSampler;
 
-    struct UniformBufferObjectScene {
-        glm::mat4 model;
+    // per-frame camera/global uniforms (set 0 of every pipeline layout, bound once per command buffer), see shaders/frame.glsl.
+    // derived matrices are computed once per frame on the CPU, instead of per vertex/fragment in the shaders
+    struct UniformBufferObjectFrame {
         glm::mat4 view;
         glm::mat4 proj;
+        glm::mat4 viewProj;
+        glm::mat4 invViewProj; // inverse(proj * view)
+        glm::mat4 invProj;
+        glm::vec4 camPos; // camera world-space position (xyz)
+        glm::vec4 camDir; // camera world-space forward direction (xyz)
+        glm::vec4 projParams; // (proj[2][2], proj[3][2], 0, 0): analytic depth linearization
+        glm::vec2 res;
+        float time;
+        float exposure;
+    };
+    std::vector<VkBuffer> uniformBuffersFrame;
+    std::vector<VkDeviceMemory> uniformBuffersFrameMemory;
+
+    // free-fly camera, moved with WASD/QE by updateCamera() on the main thread
+    struct {
+        glm::vec3 position = glm::vec3(0.0f, 1.0f, -4.0f);
+        glm::vec3 forward = glm::vec3(0.0f, -1.0f, 5.0f); // initial view center (0, 0, 1)
+        glm::vec3 up = glm::vec3(0.0f, 0.0f, 1.0f);
+        float speed = 1.0f; // world units per second
+        float fovY = 45.0f; // degrees
+        float nearPlane = 0.001f;
+        float farPlane = 10.0f;
+        std::chrono::high_resolution_clock::time_point lastUpdateTime = std::chrono::high_resolution_clock::now();
+    } camera;
+    float exposure = 1.0f;
+
+    // per-object uniforms (set 1)
+    struct UniformBufferObjectScene {
+        glm::mat4 model;
+        glm::mat4 normalMatrix; // transpose(inverse(model))
     };
     std::vector<VkBuffer> uniformBuffersScene;
     std::vector<VkDeviceMemory> uniformBuffersSceneMemory;
 
     struct UniformBufferObjectFX {
         glm::mat4 model;
-        glm::mat4 view;
-        glm::mat4 proj;
-        glm::vec2 res;
+        glm::mat4 invModel;
     };
     std::vector<VkBuffer> uniformBuffersFX;
     std::vector<VkDeviceMemory> uniformBuffersFXMemory;
 
-    std::vector<VkBuffer> uniformBuffersDecal;
-    std::vector<VkDeviceMemory> uniformBuffersDecalMemory;
+    // one force field instance (std430: struct FxInstance in shaderFX.vert)
+    struct FxInstanceData {
+        glm::vec4 positionScale; // xyz: world position, w: base scale
+        glm::vec4 color;         // rgb: glow color, a: intensity
+        glm::vec4 animation;     // x: pulse amplitude (scale), y: pulse speed (rad/s), z: phase, w: bob amplitude (along z)
+    };
+
+    // instanced force fields: all fields are one instanced draw, animated in the vertex shader from frame.time.
+    // the instance buffer is persistently mapped and written when the instances change (not per frame),
+    // so the per-frame CPU cost does not grow with the instance count
+    struct {
+        std::vector<FxInstanceData> instances;
+        glm::vec3 worldMin, worldMax; // bounds of all instances over their whole animation (fx scissor)
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+    } fxInstances;
+
+    // back-to-front draw order of the fx instances (fx set 1, binding 2), sorted every frame by view depth:
+    // on the CPU in the update stage (radix sort, uploaded to a host-visible buffer per swapchain image),
+    // or (settings.gpuSort) by a compute dispatch before the render pass, into a device-local buffer per swapchain image
+    struct {
+        RadixSort sorter; // update stage only
+        std::vector<uint32_t> keys;
+        std::vector<VkBuffer> buffers; // CPU: draw order. GPU: keys range, then values range (first half: draw order)
+        std::vector<VkDeviceMemory> memory;
+        VkDeviceSize keysSize = 0;
+        VkDeviceSize valuesOffset = 0;
+        VkDeviceSize valuesSize = 0;
+        double cpuSeconds = 0.0; // accumulated for the benchmark report
+        uint64_t cpuFrames = 0;
+    } fxSort;
+
+    // GPU-driven fx draw (settings.gpuCulling): a compute dispatch before the render pass tests the fx instances of the draw order
+    // against the camera frustum, compacts the visible ones (in draw order) into the order the fx vertex shader reads (fx set 1, binding 2)
+    // and writes the fx draw's VkDrawIndexedIndirectCommand and draw count: the recorded draw does not depend on the instance count
+    struct {
+        std::vector<VkBuffer> buffers; // per swapchain image: draw command, draw count, then (at orderOffset) the visible order
+        std::vector<VkDeviceMemory> memory;
+        VkDeviceSize countOffset = sizeof(VkDrawIndexedIndirectCommand);
+        VkDeviceSize orderOffset = 0;
+        bool drawIndirectCount = false; // device feature drawIndirectCount (else vkCmdDrawIndexedIndirect: an empty draw if nothing is visible)
+    } fxCull;
+
+    // one light as the lighting shaders read it (std430: struct Light in light.glsl)
+    struct LightGpuData {
+        glm::vec4 positionRadius; // world position, w: radius (0: global light, unattenuated, whole screen, adds ambient)
+        glm::vec4 color;          // rgb color, a: intensity
+        glm::vec4 screenRect;     // deferred: projected bounds in pixels (x0, y0, x1, y1), the light's quad
+    };
+
+    // lights of the deferred and clustered paths (screenRect unset), created by createLights()
+    std::vector<LightGpuData> lights;
+
+    // deferred shading (settings.deferred): the scene subpass writes albedo/material and an octahedral normal into two transient
+    // attachments (gAlbedo, gNormal), the lighting subpass reads them and depth0 with subpassLoad and draws one additive quad per
+    // visible light over its projected bounds into col0. the G-buffer never leaves tile memory, lighting cost follows the lit pixels
+    struct {
+        bool enabled = false; // settings.deferred, and not settings.multiPass
+        VkImage albedoImage = VK_NULL_HANDLE; // gAlbedo: RGBA8, albedo (rgb), specular material (a)
+        VkDeviceMemory albedoMemory = VK_NULL_HANDLE;
+        VkImageView albedoView = VK_NULL_HANDLE;
+        VkImage normalImage = VK_NULL_HANDLE; // gNormal: RG16F, octahedral world normal
+        VkDeviceMemory normalMemory = VK_NULL_HANDLE;
+        VkImageView normalView = VK_NULL_HANDLE;
+        std::vector<VkBuffer> lightBuffers; // visible lights of the frame, per swapchain image (host-visible)
+        std::vector<VkDeviceMemory> lightMemory;
+        uint64_t visibleLights = 0; // accumulated for the benchmark report
+        uint64_t frames = 0;
+    } deferred;
+
+    // clustered forward shading (settings.clustered): every frame the lights are assigned to view-space froxel clusters on the CPU
+    // (update stage), the scene fragment shader walks only its cluster's light list. all lights live in one storage buffer written at
+    // startup, the cluster ranges and light lists in one host-visible buffer per swapchain image (scene set 2)
+    struct {
+        bool enabled = false; // settings.clustered, and not settings.deferred
+        std::vector<LightClusterBounds> bounds; // update stage only
+        VkBuffer lightBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory lightMemory = VK_NULL_HANDLE;
+        std::vector<VkBuffer> buffers; // cluster ranges, then light indices
+        std::vector<VkDeviceMemory> memory;
+        VkDeviceSize indicesOffset = 0;
+        VkDeviceSize indicesSize = 0; // worst case: every light in every cluster
+        double cpuSeconds = 0.0; // accumulated for the benchmark report
+        uint64_t lightEntries = 0;
+        uint64_t frames = 0;
+    } clustered;
+
+    // weighted blended OIT (settings.oit): the fx subpass accumulates premultiplied color * weight and the product of (1 - alpha)
+    // into two transient attachments, the resolve subpass reads them as input attachments and blends the average color over col1.
+    // both attachments only live inside the render pass (lazily allocated: on tile, if supported)
+    struct {
+        bool enabled = false; // settings.oit, and not settings.multiPass
+        VkImage accumImage = VK_NULL_HANDLE; // oitAccum: RGBA16F, sum of (color * alpha, alpha) * weight
+        VkDeviceMemory accumMemory = VK_NULL_HANDLE;
+        VkImageView accumView = VK_NULL_HANDLE;
+        VkImage revealImage = VK_NULL_HANDLE; // oitReveal: R8, product of (1 - alpha)
+        VkDeviceMemory revealMemory = VK_NULL_HANDLE;
+        VkImageView revealView = VK_NULL_HANDLE;
+    } oit;
+
+    // multisampled scene subpass (settings.msaaSamples): the scene draws into multisampled color/depth attachments (col0MS, depth0MS),
+    // which the scene subpass resolves into col0/depth0 (pResolveAttachments, depth: sample 0). the samples are transient
+    // (lazily allocated: on tile, if supported), composition and fx keep reading single-sample col0/depth0
+    struct {
+        bool enabled = false; // settings.msaaSamples > 1 and supported by the device, not settings.multiPass, not deferred
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT; // scene pipeline rasterization samples
+        VkImage colorImage = VK_NULL_HANDLE; // col0MS: RGBA32F
+        VkDeviceMemory colorMemory = VK_NULL_HANDLE;
+        VkImageView colorView = VK_NULL_HANDLE;
+        VkImage depthImage = VK_NULL_HANDLE; // depth0MS
+        VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+        VkImageView depthView = VK_NULL_HANDLE;
+    } msaa;
+
+    // multiview stereo (settings.stereo, VK_KHR_multiview: core since Vulkan 1.1): every subpass of the render pass has view mask 0b11,
+    // so each draw is recorded once and rasterized for both eyes, into one layer per eye of col0/depth0/col1 (and the msaa/OIT
+    // attachments). the -DMULTIVIEW shaders read their eye's camera from the frame block (frame.glsl, gl_ViewIndex). col1 is an
+    // offscreen 2-layer image here, its layers are blitted side by side into the swapchain image after the render pass
+    struct {
+        bool enabled = false; // settings.stereo and the device's multiview feature, not settings.multiPass, not deferred
+        const uint32_t viewMask = 0b11; // view i renders layer i: 0 left eye, 1 right eye
+        const uint32_t viewCount = 2;
+        float eyeSeparation = 0.064f; // distance between the eye cameras, along the camera's right direction
+        VkImage outputImage = VK_NULL_HANDLE; // col1: swapchain format, one layer per eye
+        VkDeviceMemory outputMemory = VK_NULL_HANDLE;
+        VkImageView outputView = VK_NULL_HANDLE;
+    } multiview;
+
+    // depth pre-pass (settings.depthPrepass): the "depthPrepass" subpass draws the scene into depth0 (depth0MS) from a separate,
+    // tightly packed position stream without a fragment shader, so the scene subpass's EQUAL test leaves one shaded fragment per pixel
+    struct {
+        VkBuffer positionBuffer = VK_NULL_HANDLE; // scene vertex positions (vec3), indexed by indicesBuffer0
+        VkDeviceMemory positionMemory = VK_NULL_HANDLE;
+    } depthPrepass;
+
+    // light of the shadow map (set 3 of the scene pipeline layout, see shaders/shadow.glsl)
+    struct UniformBufferObjectShadow {
+        glm::mat4 viewProj; // light view-projection the shadow map was rendered with
+        glm::vec4 position; // light world-space position (xyz)
+    };
+
+    // shadow map (settings.shadows): a depth-only render pass of its own (shadow.graph) draws the scene from the forward path's light
+    // into a D32 image before the main render pass, from the depthPrepass position stream, and the scene subpass samples it with a
+    // comparison sampler (3x3 PCF). The map is cached: it is only re-rendered when the light's view-projection or the scene's model
+    // matrix differ from the ones it was last rendered with, so a static scene renders it once
+    struct {
+        bool enabled = false; // settings.shadows, and not deferred.enabled
+        VkExtent2D extent = { 2048, 2048 };
+        glm::vec3 lightPosition = glm::vec3(1.0f, 1.0f, -1.0f); // the forward path's light (shader0.frag, light 0 of the other paths)
+        glm::vec3 sceneLocalMin, sceneLocalMax; // object-space bounds of the scene mesh (the light frustum is fitted around them)
+        RenderGraph graph; // one "shadow" pass writing "shadowMap"
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkSampler sampler = VK_NULL_HANDLE; // depth comparison (LESS_OR_EQUAL), white border: outside the map is lit
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        std::vector<VkBuffer> uniformBuffers; // UniformBufferObjectShadow, per swapchain image
+        std::vector<VkDeviceMemory> uniformMemory;
+        // render stage: what the shadow map currently holds
+        bool cached = false;
+        glm::mat4 cachedViewProj = glm::mat4(1.0f);
+        glm::mat4 cachedSceneModel = glm::mat4(1.0f);
+        uint64_t renders = 0; // accumulated for the benchmark report
+        uint64_t frames = 0;
+    } shadow;
+
+    // ANALYTIC_DEPTH specialization constant of the fx/decal fragment shaders (set by selectDepthReconstruction())
+    VkBool32 analyticDepthReconstruction = VK_TRUE;
+
+    // tiled decals: decal data and the frame's tile bins, in one host-visible storage buffer per swapchain image
+    // (4 ranges, bound at set 1 bindings 0-3 of the tiled decal pipeline)
+    struct {
+        DecalManager manager;
+        std::vector<VkBuffer> buffers;
+        std::vector<VkDeviceMemory> memory;
+        std::array<VkDeviceSize, 4> offsets{}; // decals, tileRanges, decalIndices, activeTiles
+        std::array<VkDeviceSize, 4> sizes{};
+        uint64_t activeTiles = 0; // accumulated for the benchmark report
+        uint64_t tileEntries = 0;
+        uint64_t frames = 0;
+    } tiledDecals;
+
+    // projected screen-space rectangle and depth range of a volume draw (dynamic scissor and depth bounds)
+    struct VolumeBounds {
+        VkRect2D scissor;
+        float minDepth;
+        float maxDepth;
+    };
+
+    // fx sphere/decal box: only the pixels inside their projected bounds are rasterized, and the decal only shades
+    // pixels whose scene depth lies in its depth range, so fragments that can't contribute are never shaded
+    struct {
+        glm::vec3 fxLocalMin, fxLocalMax; // object-space bounding boxes of the meshes
+        glm::vec3 decalLocalMin, decalLocalMax;
+        bool depthBoundsTest = false; // device feature depthBounds (and not settings.disableVolumeBounds)
+        bool statisticsQueries = false; // device feature pipelineStatisticsQuery
+        bool decalStencil = false; // depth format has stencil (and not settings.disableDecalStencil)
+        VkQueryPool statisticsPool = VK_NULL_HANDLE; // fragment shader invocations of the fx, decal and scene draws, 3 per swapchain image
+        uint64_t fxInvocations = 0;
+        uint64_t decalInvocations = 0;
+        uint64_t sceneInvocations = 0; // (compare with and without settings.depthPrepass)
+        uint64_t frames = 0;
+    } volumeDraws;
+
+    // Hi-Z occlusion culling (settings.hiZ): after the render pass a compute pass reduces the stored depth0 into a depth pyramid
+    // (R32F, level 0 at half resolution, every texel the farthest depth below it), which the next frame tests bounds against:
+    // the fx cull dispatch per instance (occluded instances leave the indirect draw), the update stage per decal, against a
+    // coarse level read back to the host (occluded decals are not binned). The tests project the bounds with the camera the
+    // pyramid's depth was rendered with, so static occluders stay exact whatever the camera did since
+    struct {
+        bool enabled = false; // settings.hiZ
+        std::vector<VkExtent2D> extents; // per level
+        VkImage image = VK_NULL_HANDLE; // (always in GENERAL layout after the first frame)
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE; // all levels (sampled by the fx cull dispatch)
+        std::vector<VkImageView> levelViews; // one level each (written, then sampled by the next level's reduction)
+        VkSampler sampler = VK_NULL_HANDLE; // nearest (texelFetch only), also used for depth0
+        // render stage: camera of the pyramid the next recorded command buffer reads (the last recorded frame's)
+        glm::mat4 viewProj = glm::mat4(1.0f);
+        bool built = false;
+        // per swapchain image, host-visible: the read-back level, then (at statisticsOffset) the fx cull dispatch's counts
+        uint32_t readbackLevel = 0;
+        VkDeviceSize statisticsOffset = 0;
+        std::vector<VkBuffer> readbackBuffers;
+        std::vector<VkDeviceMemory> readbackMemory;
+        std::vector<void*> readbackMapped;
+        std::vector<glm::mat4> readbackViewProj; // camera of the depth each image's command buffer reduced
+        std::vector<bool> readbackPending;
+        // latest read-back level, handed from the render stage (readHiZResults) to the update stage (decal tests)
+        std::mutex snapshotMutex;
+        bool snapshotValid = false;
+        glm::mat4 snapshotViewProj = glm::mat4(1.0f);
+        std::vector<float> snapshotDepths;
+        uint64_t fxFrustumCulled = 0; // accumulated for the benchmark report
+        uint64_t fxOccluded = 0;
+        uint64_t fxFrames = 0;
+        uint64_t decalsOccluded = 0;
+        uint64_t decalFrames = 0;
+    } hiZ;
+
+    // occlusion queries (settings.occlusionQueries): in the composition subpass the bounding box of all fx instances (proxy 0) and of the
+    // volume decal (proxy 1) is depth-tested against depth0 without any writes, inside an occlusion query. A volume whose proxy passed no
+    // sample is not drawn by the next recorded frame: with VK_EXT_conditional_rendering the results are copied into a predicate buffer at
+    // the end of the command buffer and the GPU skips the draws, otherwise the CPU leaves them out from the results it read back
+    struct {
+        bool enabled = false; // settings.occlusionQueries
+        bool conditionalRendering = false; // VK_EXT_conditional_rendering supported (and enabled)
+        PFN_vkCmdBeginConditionalRenderingEXT cmdBeginConditionalRendering = nullptr;
+        PFN_vkCmdEndConditionalRenderingEXT cmdEndConditionalRendering = nullptr;
+        VkQueryPool queryPool = VK_NULL_HANDLE; // 2 queries (fx proxy, decal proxy) per swapchain image
+        // conditional rendering: one uint32 per proxy (sample count of the last recorded frame, non-zero: draw), initialized to 1
+        VkBuffer predicateBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory predicateMemory = VK_NULL_HANDLE;
+        std::vector<std::array<bool, 2>> tested; // per swapchain image: proxies its last recorded command buffer queried
+        std::array<bool, 2> hidden = { false, false }; // CPU readback: the latest read-back result of each proxy
+        std::array<uint64_t, 2> testedFrames = { 0, 0 }; // accumulated for the benchmark report
+        std::array<uint64_t, 2> hiddenFrames = { 0, 0 };
+        std::array<uint64_t, 2> skippedDraws = { 0, 0 }; // (CPU readback only: conditional rendering skips on the GPU)
+    } occlusion;
+
+    // auto exposure (settings.autoExposure): after the render pass the graphics command buffer blits col0 (layer 0) into a quarter-resolution
+    // RGBA16F copy per swapchain image. The histogram dispatch (shaderAutoExposure.comp) is submitted to computeQueue, waiting for the copy
+    // on the graphics timeline semaphore and signalling the compute timeline semaphore, both valued with the frame's submission count.
+    // Nothing on the graphics queue waits for it: it runs while the next frames render, and the host reads its exposure back when the
+    // swapchain image comes round again (waiting for the compute timeline, which has long passed by then), for the following frames' tonemapping
+    struct {
+        bool enabled = false; // settings.autoExposure, not with the dynamic rendering backend
+        bool async = false; // on computeQueue (not settings.disableAsyncCompute)
+        VkExtent2D extent{}; // of the luminance copies
+        std::vector<VkImage> images; // per swapchain image (concurrent sharing between the graphics and the compute family)
+        std::vector<VkDeviceMemory> imageMemory;
+        std::vector<VkImageView> views;
+        VkSampler sampler = VK_NULL_HANDLE; // nearest (texelFetch only)
+        VkBuffer stateBuffer = VK_NULL_HANDLE; // current exposure, carried from dispatch to dispatch
+        VkDeviceMemory stateMemory = VK_NULL_HANDLE;
+        std::vector<VkBuffer> resultBuffers; // per swapchain image, host-visible: mean log2 luminance, exposure
+        std::vector<VkDeviceMemory> resultMemory;
+        std::vector<void*> resultMapped;
+        VkCommandPool commandPool = VK_NULL_HANDLE; // computeQueueFamily (async only)
+        std::vector<VkCommandBuffer> commandBuffers; // per swapchain image, re-recorded every frame (async only)
+        VkSemaphore graphicsTimeline = VK_NULL_HANDLE; // value n: frame n's copy is written (async only)
+        VkSemaphore computeTimeline = VK_NULL_HANDLE; // value n: frame n's dispatch finished (async only)
+        uint64_t submittedFrames = 0;
+        std::vector<uint64_t> pendingFrames; // per swapchain image: frame value of its unread result (0: none)
+        VkQueryPool queryPool = VK_NULL_HANDLE; // 2 timestamps (dispatch start, end) per swapchain image
+        float timestampPeriod = 0.0f; // (nanoseconds per tick)
+        bool dispatched = false; // stateBuffer holds an exposure
+        std::chrono::high_resolution_clock::time_point lastDispatchTime;
+        float speed = 1.5f; // adaptation rate, 1 / seconds
+        // render stage: latest read-back result, used by uploadFrameState()
+        float exposure = 1.0f;
+        float meanLogLuminance = 0.0f;
+        double dispatchSeconds = 0.0; // accumulated for the benchmark report
+        uint64_t timedDispatches = 0;
+        uint64_t readbacks = 0;
+    } autoExposure;
+
+    // bloom (settings.bloom): a mip pyramid (RGBA16F, level 0 at half resolution, --fast-bloom: quarter resolution and fewer levels)
+    // built by compute dispatches from col0: a thresholded bright pass into level 0, dual filter downsamples level by level, then
+    // dual filter upsamples back up, each added to the level below, so level 0 holds the whole blur. The composition samples level 0.
+    // Separate render passes only (bloom turns on settings.multiPass): the chain runs between the scene and the composition pass, so
+    // it is added in the same frame (in the subpass path compute could only run after the render pass, and the bloom would lag a frame)
+    struct {
+        bool enabled = false; // settings.bloom, not with multiview
+        uint32_t downscale = 2; // col0 texels per level 0 texel (per axis)
+        std::vector<VkExtent2D> extents; // per level
+        VkImage image = VK_NULL_HANDLE; // (always in GENERAL layout after the first frame)
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        std::vector<VkImageView> levelViews; // one level each (written, then sampled by the next dispatch; level 0 by the composition)
+        VkSampler sampler = VK_NULL_HANDLE; // linear, clamped (col0: texelFetch only)
+        float threshold = 1.0f; // brightness where bloom starts (the fx fields go up to 10)
+        float knee = 0.5f; // soft transition below the threshold
+        bool initialized = false; // cleared and in GENERAL layout (by the first recorded command buffer)
+        VkQueryPool queryPool = VK_NULL_HANDLE; // 2 timestamps (chain start, end) per swapchain image
+        double gpuSeconds = 0.0; // accumulated for the benchmark report
+        uint64_t gpuFrames = 0;
+    } bloom;
+
+    // push constants of the bloom bright pass (must match shaderBloom.comp)
+    struct BloomPushConstants {
+        float threshold;
+        float knee;
+    };
+
+    // push constants of the auto exposure dispatch (must match shaderAutoExposure.comp)
+    struct AutoExposurePushConstants {
+        float rate; // fraction of the way from the previous exposure to the target
+        uint32_t reset; // 1: no previous exposure
+    };
+
+    // push constants of the fx cull dispatch with Hi-Z (must match shaderFxCull.comp): camera of the pyramid, 0 before the first pyramid
+    struct HiZCullPushConstants {
+        glm::mat4 viewProj;
+        uint32_t valid;
+    };
+
+    // snapshot of per-frame simulation results, produced by the update stage and consumed by the render-submission stage
+    struct FrameState {
+        uint64_t frameIndex;
+        float time;
+        UniformBufferObjectFrame uboFrame;
+        UniformBufferObjectScene uboScene;
+        UniformBufferObjectFX uboFX;
+        UniformBufferObjectShadow uboShadow; // (shadow.enabled only)
+        std::array<UniformBufferObjectFrame, 2> uboViews; // eye cameras, after uboFrame in the frame buffer (multiview.enabled only)
+        VolumeBounds fxBounds;
+        VolumeBounds decalBounds;
+        std::vector<uint32_t> fxOrder; // back-to-front fx instance order (CPU sort)
+        std::vector<VkRect2D> decalRects; // projected screen-space rectangle of every decal
+        uint32_t occludedDecals; // decals (or the volume decal) skipped by the Hi-Z test
+        std::array<bool, 2> occlusionTestable; // fx/decal proxy box in front of the near plane and on screen (occlusion.enabled)
+        std::vector<LightGpuData> visibleLights; // deferred lights with a non-empty screen rectangle
+        DecalBins decalBins;
+        LightClusterGrid lightClusters; // clustered forward shading: light lists per cluster
+    };
+
+    // triple-buffered frame-state handoff between the update stage (main thread) and the render-submission stage (render thread):
+    // the update stage writes slots[writeSlot], the render stage reads slots[readSlot], slots[readySlot] holds the latest complete snapshot.
+    struct {
+        std::array<FrameState, 3> slots;
+        int writeSlot = 0;
+        int readySlot = 1;
+        int readSlot = 2;
+        bool stateReady = false; // slots[readySlot] holds a snapshot not yet taken by the render stage
+        bool stop = false;
+        std::mutex mutex;
+        std::condition_variable stateReadyCondition;
+        std::condition_variable stateConsumedCondition;
+    } frameStates;
+
+    std::thread renderThread;
+    std::exception_ptr renderThreadException;
+
+    // CPU frame timings, accumulated for the benchmark report
+    struct {
+        double updateSeconds = 0.0; // update stage: event polling + frame-state simulation
+        double renderSeconds = 0.0; // render stage: total time in drawFrame()
+        double renderBlockedSeconds = 0.0; // render stage: time blocked on fences and swapchain image acquisition
+        double firstFrameTime = 0.0;
+        double lastFrameTime = 0.0;
+        uint64_t updatedFrames = 0;
+    } frameTimings;
+    std::atomic<uint64_t> renderedFrames;
+
+    // GPU frame timings: timestamps at the start/end of each swapchain image's command buffer, after the fx sort/cull dispatches
+    // and after the render pass (before the Hi-Z pyramid build)
+    struct {
+        VkQueryPool queryPool = VK_NULL_HANDLE; // 4 queries per swapchain image (start, sorted, rendered, end)
+        float timestampPeriod = 0.0f; // nanoseconds per timestamp tick
+        double gpuSeconds = 0.0;
+        double sortSeconds = 0.0;
+        double hiZSeconds = 0.0;
+        uint64_t gpuFrames = 0;
+    } gpuTimings;
 
     std::vector<VkFramebuffer> swapChainFramebuffers;
 
-    VkRenderPass renderPass;
+    VkRenderPass renderPass = VK_NULL_HANDLE; // (not created by the dynamic rendering backend)
+    RenderGraph renderGraph; // declares attachments/passes, derives renderPass and swapChainFramebuffers
+
+    // settings.multiPass: renderPass/swapChainFramebuffers only hold the scene pass, composition is a second render pass
+    struct {
+        RenderGraph compositionGraph;
+        VkRenderPass compositionRenderPass = VK_NULL_HANDLE;
+        std::vector<VkFramebuffer> compositionFramebuffers;
+        VkSampler inputSampler = VK_NULL_HANDLE; // col0/depth0 are sampled with texelFetch
+    } separatePasses;
+
+    // VK_KHR_dynamic_rendering + VK_KHR_dynamic_rendering_local_read: scene and composition are recorded in one
+    // vkCmdBeginRendering instance, reading col0/depth0 on tile with local-read barriers. No renderPass, no framebuffers.
+    // selected when the device supports it (and settings.multiPass is off), otherwise the render pass backend is used
+    struct {
+        bool enabled = false;
+        PFN_vkCmdBeginRenderingKHR cmdBeginRendering = nullptr;
+        PFN_vkCmdEndRenderingKHR cmdEndRendering = nullptr;
+        PFN_vkCmdSetRenderingAttachmentLocationsKHR cmdSetRenderingAttachmentLocations = nullptr;
+        PFN_vkCmdSetRenderingInputAttachmentIndicesKHR cmdSetRenderingInputAttachmentIndices = nullptr;
+    } dynamicRendering;
+
+    // pipeline state depending on the backend (render pass/subpass, or the dynamic rendering pNext chain).
+    // referenced by the pipeline create info, so it has to outlive vkCreateGraphicsPipelines
+    struct PipelineRenderTarget {
+        VkPipelineRenderingCreateInfoKHR rendering{};
+        std::array<VkFormat, 2> colorFormats{}; // col0, col1
+        VkRenderingAttachmentLocationInfoKHR locations{};
+        std::array<uint32_t, 2> colorLocations{};
+        VkRenderingInputAttachmentIndexInfoKHR inputIndices{};
+        std::array<uint32_t, 2> colorInputIndices{};
+        uint32_t depthInputIndex = 0;
+        std::array<VkPipelineColorBlendAttachmentState, 2> colorBlendAttachments{};
+        VkPipelineColorBlendStateCreateInfo colorBlend{};
+    };
 
     VkDescriptorPool descriptorPool;
 
     struct {
-        //std::vector<VkDescriptorSet> shadows;
+        std::vector<VkDescriptorSet> frame;
         std::vector<VkDescriptorSet> scene;
         std::vector<VkDescriptorSet> composition;
         std::vector<VkDescriptorSet> fx0;
         std::vector<VkDescriptorSet> fx1;
         std::vector<VkDescriptorSet> decal;
+        std::vector<VkDescriptorSet> fxSort; // (settings.gpuSort only)
+        std::vector<VkDescriptorSet> fxCull; // (settings.gpuCulling only)
+        std::vector<VkDescriptorSet> hiZBuild; // per pyramid level, not per swapchain image (hiZ.enabled only)
+        std::vector<VkDescriptorSet> hiZCull; // (hiZ.enabled only)
+        std::vector<VkDescriptorSet> oitResolve; // (oit.enabled only)
+        std::vector<VkDescriptorSet> lighting; // (deferred.enabled only)
+        std::vector<VkDescriptorSet> clusters; // (clustered.enabled only)
+        std::vector<VkDescriptorSet> shadows; // (shadow.enabled only)
+        std::vector<VkDescriptorSet> autoExposure; // (autoExposure.enabled only)
+        std::vector<VkDescriptorSet> bloom; // per dispatch: bright pass, downsamples, upsamples (bloom.enabled only)
     } descriptorSets;
 
     struct {
-        //VkDescriptorSetLayout shadows;
+        VkDescriptorSetLayout frame;
         VkDescriptorSetLayout scene;
         VkDescriptorSetLayout composition;
         VkDescriptorSetLayout fx0;
         VkDescriptorSetLayout fx1;
         VkDescriptorSetLayout decal;
+        VkDescriptorSetLayout fxSort;
+        VkDescriptorSetLayout fxCull;
+        VkDescriptorSetLayout hiZBuild;
+        VkDescriptorSetLayout hiZCull;
+        VkDescriptorSetLayout oitResolve;
+        VkDescriptorSetLayout lighting;
+        VkDescriptorSetLayout clusters;
+        VkDescriptorSetLayout shadows;
+        VkDescriptorSetLayout autoExposure;
+        VkDescriptorSetLayout bloom;
     } descriptorSetLayouts;
 
     struct {
@@ -150,13 +718,36 @@ private:
         VkPipelineLayout composition;
         VkPipelineLayout fx;
         VkPipelineLayout decal;
+        VkPipelineLayout decalTiles = VK_NULL_HANDLE; // (tiled decals only, no --volume-decals)
+        VkPipelineLayout fxSort = VK_NULL_HANDLE; // (settings.gpuSort only)
+        VkPipelineLayout fxCull = VK_NULL_HANDLE; // (settings.gpuCulling only)
+        VkPipelineLayout hiZBuild = VK_NULL_HANDLE; // (hiZ.enabled only)
+        VkPipelineLayout occlusionProxy = VK_NULL_HANDLE; // (occlusion.enabled only)
+        VkPipelineLayout oitResolve = VK_NULL_HANDLE; // (oit.enabled only)
+        VkPipelineLayout lighting = VK_NULL_HANDLE; // (deferred.enabled only)
+        VkPipelineLayout autoExposure = VK_NULL_HANDLE; // (autoExposure.enabled only)
+        VkPipelineLayout bloom = VK_NULL_HANDLE; // shared by the bloom dispatches (bloom.enabled only)
     } pipelineLayouts;
 
     struct {
         VkPipeline scene;
+        VkPipeline depthPrepass = VK_NULL_HANDLE; // (settings.depthPrepass only)
+        VkPipeline shadow = VK_NULL_HANDLE; // shadow map pass, vertex stage only (shadow.enabled only)
         VkPipeline composition;
         VkPipeline fx;
         VkPipeline decal;
+        VkPipeline decalStencil = VK_NULL_HANDLE; // marks the decal box/scene intersection in stencil, before pipelines.decal shades it
+        VkPipeline decalTiles = VK_NULL_HANDLE; // (tiled decals only, no --volume-decals)
+        VkPipeline fxSort = VK_NULL_HANDLE; // compute (settings.gpuSort only)
+        VkPipeline fxCull = VK_NULL_HANDLE; // compute (settings.gpuCulling only)
+        VkPipeline hiZBuild = VK_NULL_HANDLE; // compute (hiZ.enabled only)
+        VkPipeline occlusionProxy = VK_NULL_HANDLE; // vertex stage only, no writes (occlusion.enabled only)
+        VkPipeline oitResolve = VK_NULL_HANDLE; // (oit.enabled only)
+        VkPipeline lighting = VK_NULL_HANDLE; // (deferred.enabled only)
+        VkPipeline autoExposure = VK_NULL_HANDLE; // compute (autoExposure.enabled only)
+        VkPipeline bloomBright = VK_NULL_HANDLE; // compute (bloom.enabled only)
+        VkPipeline bloomDown = VK_NULL_HANDLE;
+        VkPipeline bloomUp = VK_NULL_HANDLE;
     } pipelines;
 
     const std::string SHADER_VERT_PATH_0 = "./assets/shaders/vert0.spv";
@@ -167,6 +758,53 @@ private:
     const std::string SHADER_FRAG_PATH_2 = "./assets/shaders/fragDecal.spv";
     const std::string SHADER_VERT_PATH_3 = "./assets/shaders/vertScreen.spv";
     const std::string SHADER_FRAG_PATH_3 = "./assets/shaders/fragScreen.spv";
+    const std::string SHADER_VERT_PATH_4 = "./assets/shaders/vertDecalTiles.spv";
+    const std::string SHADER_FRAG_PATH_4 = "./assets/shaders/fragDecalTiles.spv";
+    const std::string SHADER_COMP_PATH_FX_SORT = "./assets/shaders/compFxSort.spv";
+    const std::string SHADER_COMP_PATH_FX_CULL = "./assets/shaders/compFxCull.spv";
+    // Hi-Z occlusion culling (hiZ.enabled): pyramid reduction, and the -DHI_Z variant of the fx cull shader
+    const std::string SHADER_COMP_PATH_HI_Z = "./assets/shaders/compHiZ.spv";
+    const std::string SHADER_COMP_PATH_FX_CULL_HI_Z = "./assets/shaders/compFxCullHiZ.spv";
+    // auto exposure (autoExposure.enabled): luminance histogram and exposure adaptation
+    const std::string SHADER_COMP_PATH_AUTO_EXPOSURE = "./assets/shaders/compAutoExposure.spv";
+    // bloom (bloom.enabled): -DBRIGHT_PASS, -DDOWNSAMPLE, -DUPSAMPLE variants of the bloom shader, -DBLOOM variant of the sampled composition
+    const std::string SHADER_COMP_PATH_BLOOM_BRIGHT = "./assets/shaders/compBloomBright.spv";
+    const std::string SHADER_COMP_PATH_BLOOM_DOWN = "./assets/shaders/compBloomDown.spv";
+    const std::string SHADER_COMP_PATH_BLOOM_UP = "./assets/shaders/compBloomUp.spv";
+    const std::string SHADER_FRAG_PATH_3_SAMPLED_BLOOM = "./assets/shaders/fragScreenSampledBloom.spv";
+    // occlusion queries (occlusion.enabled): proxy boxes expanded from gl_VertexIndex
+    const std::string SHADER_VERT_PATH_OCCLUSION_PROXY = "./assets/shaders/vertOcclusionProxy.spv";
+    // weighted blended OIT (oit.enabled): -DOIT_OUTPUT variant of the fx fragment shader, and the resolve
+    const std::string SHADER_FRAG_PATH_1_OIT = "./assets/shaders/fragFXOit.spv";
+    const std::string SHADER_FRAG_PATH_OIT_RESOLVE = "./assets/shaders/fragOitResolve.spv";
+    // deferred shading (deferred.enabled): -DGBUFFER_OUTPUT variant of the scene fragment shader, and the lighting subpass
+    const std::string SHADER_FRAG_PATH_0_GBUFFER = "./assets/shaders/frag0Gbuffer.spv";
+    const std::string SHADER_VERT_PATH_LIGHTING = "./assets/shaders/vertLighting.spv";
+    const std::string SHADER_FRAG_PATH_LIGHTING = "./assets/shaders/fragLighting.spv";
+    // clustered forward shading (clustered.enabled): -DCLUSTERED_LIGHTS variant of the scene fragment shader
+    const std::string SHADER_FRAG_PATH_0_CLUSTERED = "./assets/shaders/frag0Clustered.spv";
+    // depth pre-pass (settings.depthPrepass): -DDEPTH_ONLY variant of the scene vertex shader
+    const std::string SHADER_VERT_PATH_0_DEPTH = "./assets/shaders/vert0Depth.spv";
+    // shadow map (shadow.enabled): -DSHADOW_CASTER variant of the scene vertex shader (light view-projection, positions only),
+    // -DSHADOWS variants of the forward and clustered scene fragment shaders
+    const std::string SHADER_VERT_PATH_0_SHADOW = "./assets/shaders/vert0Shadow.spv";
+    const std::string SHADER_FRAG_PATH_0_SHADOWS = "./assets/shaders/frag0Shadows.spv";
+    const std::string SHADER_FRAG_PATH_0_CLUSTERED_SHADOWS = "./assets/shaders/frag0ClusteredShadows.spv";
+    // multiview stereo (multiview.enabled): -DMULTIVIEW variants of the shaders that use the camera inside the render pass
+    const std::string SHADER_VERT_PATH_0_MULTIVIEW = "./assets/shaders/vert0Multiview.spv";
+    const std::string SHADER_FRAG_PATH_0_MULTIVIEW = "./assets/shaders/frag0Multiview.spv";
+    const std::string SHADER_FRAG_PATH_0_SHADOWS_MULTIVIEW = "./assets/shaders/frag0ShadowsMultiview.spv";
+    const std::string SHADER_VERT_PATH_0_DEPTH_MULTIVIEW = "./assets/shaders/vert0DepthMultiview.spv";
+    const std::string SHADER_VERT_PATH_1_MULTIVIEW = "./assets/shaders/vertFXMultiview.spv";
+    const std::string SHADER_FRAG_PATH_1_MULTIVIEW = "./assets/shaders/fragFXMultiview.spv";
+    const std::string SHADER_FRAG_PATH_1_OIT_MULTIVIEW = "./assets/shaders/fragFXOitMultiview.spv";
+    const std::string SHADER_VERT_PATH_2_MULTIVIEW = "./assets/shaders/vertDecalMultiview.spv";
+    const std::string SHADER_FRAG_PATH_2_MULTIVIEW = "./assets/shaders/fragDecalMultiview.spv";
+    // -DSAMPLED_INPUTS variants (settings.multiPass)
+    const std::string SHADER_FRAG_PATH_1_SAMPLED = "./assets/shaders/fragFXSampled.spv";
+    const std::string SHADER_FRAG_PATH_2_SAMPLED = "./assets/shaders/fragDecalSampled.spv";
+    const std::string SHADER_FRAG_PATH_3_SAMPLED = "./assets/shaders/fragScreenSampled.spv";
+    const std::string SHADER_FRAG_PATH_4_SAMPLED = "./assets/shaders/fragDecalTilesSampled.spv";
     const std::string MODEL_PATH_0 = "./assets/models/scene.obj";
     const std::string MODEL_PATH_1 = "./assets/models/sphere_smooth.obj";
     const std::string MODEL_PATH_2 = "./assets/models/cube.obj";
@@ -188,8 +826,16 @@ private:
         "VK_KHR_swapchain"
     };
 
+    // optional: enabled if supported (dynamicRendering.enabled)
+    const std::vector<const char*> dynamicRenderingExtensions = {
+        VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+        VK_KHR_DYNAMIC_RENDERING_LOCAL_READ_EXTENSION_NAME
+    };
+
     static std::vector<char> readFile(const std::string& filename);
 
+    std::map<std::string, std::vector<char>> shaderCode; // SPIR-V code per shader path, loaded once at startup
+
     struct Vertex {
         glm::vec3 pos;
         glm::vec3 color;
@@ -293,12 +939,16 @@ private:
 
     void createSwapChain();
 
-    void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags memProperties, VkImage& image, VkDeviceMemory& imageMemory, bool generalLayout);
+    // layers > 1: 2D array image (multiview attachments, one layer per view)
+    void createImage(uint32_t width, uint32_t height, VkSampleCountFlagBits samples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags memProperties, VkImage& image, VkDeviceMemory& imageMemory, bool generalLayout, uint32_t layers = 1);
        
-    void createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView& imageView);
+    // layers > 1: 2D array view of all of them
+    void createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView& imageView, uint32_t layers = 1);
 
     void createImageResources();
 
+    void decodeTexture();
+
     void createTextureImageResources();
 	
     VkFormat findSupportedImageFormat(const std::vector<VkFormat> candidateFormats, VkImageTiling requiredTiling, VkFormatFeatureFlags requiredFeaturesBitflags);
@@ -319,24 +969,149 @@ private:
 	
     void createDescriptorSets();
 
+    bool tryFindMemoryTypeIndex(uint32_t bufferSupportedMemTypes_Bitflags, VkMemoryPropertyFlags requiredMemProperties, uint32_t& memTypeIndex);
+
     uint32_t findMemoryTypeIndex(uint32_t bufferSupportedMemTypes_Bitflags, VkMemoryPropertyFlags requiredMemProperties);
 
     void createGraphicsBuffer(VkDeviceSize bufferSize, VkBufferUsageFlags bufferUsage_Bitflags, VkMemoryPropertyFlags memProperties_Bitflags, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 
+    // size of the frame uniform buffer (multiview stereo: culling camera + one camera per eye)
+    VkDeviceSize frameUniformSize() const;
     void createUniformBuffers();
 
+    // decal placement: the first decal follows the fx volume (as the decal box did), the others are scattered around the scene
+    void createDecals();
+
+    void createFxInstances();
+
+    void createFxInstanceBuffer();
+
+    void createFxSortBuffers();
+    void createFxCullBuffers();
+    uint32_t getHiZLevelCount() const;
+    void createHiZResources();
+
+    // auto exposure: luminance copies, result/state buffers, timestamp queries; async: command pool/buffers on computeQueueFamily, timelines
+    void createAutoExposureResources();
+
+    // bloom: pyramid image, level views, sampler, timestamp queries
+    uint32_t getBloomLevelCount() const;
+    void createBloomResources();
+
+    void sortFxInstances(FrameState& state);
+
+    void createDecalBuffers();
+
+    // project every decal's box to the screen and bin the decals into screen tiles (update stage)
+    void binDecals(const glm::mat4& viewProj, FrameState& state);
+
+    // deferred light placement: light 0 is the forward path's light, the others are point lights scattered around the scene
+    void createLights();
+
+    void createLightBuffers();
+
+    // project every point light's bounding cube to the screen and keep the lights with a non-empty rectangle (update stage)
+    void cullLights(const glm::mat4& viewProj, FrameState& state);
+
+    // screen-space rectangle of a point light's bounding cube (empty if not visible)
+    VkRect2D projectLightBounds(const glm::mat4& viewProj, const LightGpuData& light) const;
+
+    void createClusterBuffers();
+
+    // shadow map image, comparison sampler, its render pass/framebuffer (shadow.graph) and the light uniform buffers
+    void createShadowResources();
+
+    // light view-projection around the scene's bounding sphere (update stage)
+    glm::mat4 fitShadowFrustum(const glm::mat4& sceneModel) const;
+
+    // assign the point lights to the view-space clusters overlapped by their bounds (update stage)
+    void clusterLights(const glm::mat4& viewProj, const glm::vec3& camPos, const glm::vec3& camDir, FrameState& state);
+
     void createTextureSampler();
 
+    void createTimestampQueryPool();
+
+    // ANALYTIC_DEPTH: compare the float precision of the analytic linearization with the inverse-matrix formula on the CPU,
+    // on a grid of pixels and depths, and fall back to the matrix path if it is out of tolerance (--matrix-depth: always)
+    void selectDepthReconstruction();
+
+    void readGpuTimestamps(uint32_t swapImageID);
+
+    void createStatisticsQueryPool();
+
+    void readVolumeStatistics(uint32_t swapImageID);
+    void readHiZResults(uint32_t swapImageID);
+
+    void createOcclusionQueries();
+
+    void readOcclusionResults(uint32_t swapImageID);
+    // auto exposure result (and dispatch timestamps) of the image's previous frame (async: waits for the compute timeline)
+    void readAutoExposure(uint32_t swapImageID);
+
+    static void computeLocalBounds(const std::vector<Vertex>& vertices, glm::vec3& localMin, glm::vec3& localMax);
+
+    VolumeBounds projectVolumeBounds(const glm::mat4& modelViewProj, const glm::vec3& localMin, const glm::vec3& localMax) const;
+    bool isOccludedHiZ(const VolumeBounds& bounds) const; // (bounds projected with hiZ.snapshotViewProj, caller holds hiZ.snapshotMutex)
+
+    VolumeBounds fullScreenBounds() const;
+
+    // fragment shader of the scene subpass (G-buffer, clustered, forward, with or without shadows)
+    const std::string& getSceneFragShaderPath() const;
+    // fragment shader of the composition (input attachment or sampled col0, with or without bloom)
+    const std::string& getCompositionFragShaderPath() const;
+
     void createGraphicsPipelineScene();
   
     void createGraphicsPipelineFX();
 
     void createGraphicsPipelineDecal();
 
+    void createGraphicsPipelineDecalTiles();
+
+    void createComputePipelineFxSort();
+    void createComputePipelineFxCull();
+    void createComputePipelineHiZ();
+
+    void createComputePipelineAutoExposure();
+    void createComputePipelinesBloom();
+
+    void createGraphicsPipelineOcclusionProxy();
+
+    void createGraphicsPipelineOitResolve();
+
+    void createGraphicsPipelineLighting();
+
     void createGraphicsPipelineComposition();
 
     VkShaderModule createShaderModule(const std::vector<char>& code);
 
+    // separateRenderPasses: scene pass in sceneGraph, composition pass in compositionGraph. otherwise both passes in sceneGraph
+    void declareRenderGraph(bool separateRenderPasses, RenderGraph& sceneGraph, RenderGraph& compositionGraph);
+
+    // render pass and subpass index for pipelines drawing in a pass ("scene", "composition")
+    VkRenderPass getPassRenderPass(const std::string& pass);
+
+    uint32_t getPassSubpassIndex(const std::string& pass);
+
+    // set render pass/subpass of a pipeline drawing in a pass, or chain the dynamic rendering attachment info
+    // (also widens pColorBlendState to one blend state per color attachment of the rendering)
+    void setPipelineRenderTarget(const std::string& pass, VkGraphicsPipelineCreateInfo& pipelineCreateInfo, PipelineRenderTarget& target);
+
+    bool checkDynamicRenderingSupport(VkPhysicalDevice device);
+
+    void loadDynamicRenderingFunctions();
+
+    bool checkConditionalRenderingSupport(VkPhysicalDevice device);
+
+    void loadConditionalRenderingFunctions();
+
+    // dynamic rendering backend: layout transitions + vkCmdBeginRendering, local-read barrier between scene and composition, end + present transition
+    void beginDynamicRendering(VkCommandBuffer commandBuffer, uint32_t swapImageID);
+
+    void nextDynamicRenderingPass(VkCommandBuffer commandBuffer);
+
+    void endDynamicRendering(VkCommandBuffer commandBuffer, uint32_t swapImageID);
+
     void createRenderPass();
     
     void createFramebuffers();
@@ -345,7 +1120,38 @@ private:
         
     void createTransferCommandPool();
 
-    void recordCommandBuffers();
+    void createGraphicsCommandBuffers();
+
+    void recordCommandBuffer(uint32_t i, const FrameState& state);
+
+    // instanced fx draw (composition subpass, or the fx subpass with oit.enabled)
+    void recordFxDraw(uint32_t i, const FrameState& state);
+    void recordHiZBuild(uint32_t i, const FrameState& state);
+
+    // auto exposure: the copy of col0 (graphics command buffer, after the render pass), and the histogram dispatch
+    // (into the compute command buffer, or the graphics one with settings.disableAsyncCompute)
+    void recordLuminanceCopy(uint32_t i);
+    void recordAutoExposure(VkCommandBuffer commandBuffer, uint32_t i);
+    // async: records and submits image i's compute command buffer, after the graphics submission of frame value frameValue
+    void submitAutoExposure(uint32_t i, uint64_t frameValue);
+
+    // bloom chain from col0 (sampled layout), between the scene and the composition pass
+    void recordBloom(uint32_t i);
+
+    // shadow map pass before the render pass, skipped while the cached map is still valid for the frame's light and scene
+    void recordShadowPass(uint32_t i, const FrameState& state);
+
+    // multiview stereo: both layers of col1 side by side into the swapchain image, after the render pass
+    void recordStereoBlit(uint32_t i);
+
+    // occlusion queries: proxy draws (composition subpass), and the copy of their results into the predicate buffer (after the render pass)
+    void recordOcclusionProxies(uint32_t i, const FrameState& state);
+    void recordOcclusionPredicates(uint32_t i);
+
+    // predicate the following draws of a volume on its proxy's last result: begins conditional rendering and returns true,
+    // or (CPU readback) returns false if the latest read-back result hid the proxy. endOcclusionCondition() after the draws
+    bool beginOcclusionCondition(uint32_t i, uint32_t proxy);
+    void endOcclusionCondition(uint32_t i);
        
     void createSyncObjects();      
 
@@ -365,24 +1171,47 @@ private:
 
     void createIndexBuffers();
 
-    void loadObjs();
+    void loadShaderCode();
+
+    void loadObj(const std::string& path, glm::vec3 color, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
         
     void initVulkan();
 
-    void updateUniformBuffers(uint32_t currentImage);
+    void simulateFrameState(FrameState& state);
+
+    // multiview stereo: eye cameras either side of the frame's camera, and uboFrame moved back so its frustum contains both
+    // (culling camera of the CPU and compute passes)
+    void simulateEyeCameras(FrameState& state) const;
+
+    void updateCamera();
+
+    void uploadFrameState(const FrameState& state, uint32_t currentImage);
 
     void checkFenceStatus();
 
-    void drawFrame();
+    void drawFrame(const FrameState& state);
+
+    bool benchmarkFinished();
+
+    void publishFrameState();
+
+    void renderLoop();
+
+    void mainLoopSerial();
+
+    void mainLoopPipelined();
 
     void mainLoop();
 
+    void printFrameTimings();
+
     void cleanup();
 
 
 public:
 	void run();
     VulkanApp();
+    VulkanApp(const Settings& settings);
 
 };
 #endif	
@@ -0,0 +1,98 @@
+#include "DecalManager.h"
+
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+uint32_t DecalManager::addDecal(const DecalInfo& decal) {
+    decals.push_back(decal);
+    return static_cast<uint32_t>(decals.size() - 1);
+}
+
+void DecalManager::setModel(uint32_t decal, const glm::mat4& model) {
+    if (decal >= decals.size()) {
+        throw std::runtime_error("decal manager: unknown decal " + std::to_string(decal));
+    }
+    decals[decal].model = model;
+}
+
+uint32_t DecalManager::getDecalCount() const {
+    return static_cast<uint32_t>(decals.size());
+}
+
+const DecalInfo& DecalManager::getDecal(uint32_t decal) const {
+    return decals.at(decal);
+}
+
+uint32_t DecalManager::getTileCount(VkExtent2D extent) {
+    uint32_t tilesX = (extent.width + TILE_SIZE - 1) / TILE_SIZE;
+    uint32_t tilesY = (extent.height + TILE_SIZE - 1) / TILE_SIZE;
+    return tilesX * tilesY;
+}
+
+void DecalManager::binDecals(const std::vector<VkRect2D>& screenRects, VkExtent2D extent, DecalBins& bins) const {
+    if (screenRects.size() != decals.size()) {
+        throw std::runtime_error("decal manager: one screen rectangle per decal expected");
+    }
+    bins.tilesX = (extent.width + TILE_SIZE - 1) / TILE_SIZE;
+    bins.tilesY = (extent.height + TILE_SIZE - 1) / TILE_SIZE;
+    uint32_t tileCount = bins.tilesX * bins.tilesY;
+
+    // (vectors keep their capacity between frames: no allocations once the frame-state slots are warm)
+    bins.decals.resize(decals.size());
+    for (size_t d = 0; d < decals.size(); d++) {
+        bins.decals[d].invModel = glm::inverse(decals[d].model);
+        bins.decals[d].color = decals[d].color;
+    }
+
+    //1. tile range of each rectangle (x0, y0, x1, y1 exclusive, empty rectangles get an empty range), computed once for both
+    // passes below. branchless over the whole array, so the compiler vectorizes it (several rectangles per instruction)
+    bins.decalTiles.resize(screenRects.size());
+    for (size_t d = 0; d < screenRects.size(); d++) {
+        const VkRect2D& rect = screenRects[d];
+        uint32_t left = static_cast<uint32_t>(std::max(rect.offset.x, 0));
+        uint32_t top = static_cast<uint32_t>(std::max(rect.offset.y, 0));
+        uint32_t x0 = left / TILE_SIZE;
+        uint32_t y0 = top / TILE_SIZE;
+        uint32_t x1 = std::min((left + rect.extent.width + TILE_SIZE - 1) / TILE_SIZE, bins.tilesX);
+        uint32_t y1 = std::min((top + rect.extent.height + TILE_SIZE - 1) / TILE_SIZE, bins.tilesY);
+        bool empty = rect.extent.width == 0 || rect.extent.height == 0;
+        bins.decalTiles[d] = glm::uvec4(x0, y0, empty ? x0 : x1, y1);
+    }
+
+    //2. count decals per tile: contiguous counters, so each row span is a vectorizable run of increments
+    bins.tileCounts.assign(tileCount, 0);
+    for (glm::uvec4 tiles : bins.decalTiles) { // (copy: the bounds cannot alias the counters)
+        for (uint32_t y = tiles.y; y < tiles.w; y++) {
+            uint32_t* row = bins.tileCounts.data() + y * bins.tilesX;
+            for (uint32_t x = tiles.x; x < tiles.z; x++) {
+                row[x]++;
+            }
+        }
+    }
+
+    //3. prefix sum: first entry of each tile, and the active tile list
+    uint32_t entries = 0;
+    bins.tileRanges.resize(tileCount);
+    bins.activeTiles.clear();
+    for (uint32_t tile = 0; tile < tileCount; tile++) {
+        bins.tileRanges[tile] = glm::uvec2(entries, 0); // count refilled below
+        entries += bins.tileCounts[tile];
+        if (bins.tileCounts[tile] > 0) {
+            bins.activeTiles.push_back(tile);
+        }
+    }
+
+    //4. fill the tile lists (in decal order, so blending order is the same in every tile)
+    bins.decalIndices.resize(entries);
+    for (uint32_t d = 0; d < bins.decalTiles.size(); d++) {
+        const glm::uvec4& tiles = bins.decalTiles[d];
+        for (uint32_t y = tiles.y; y < tiles.w; y++) {
+            for (uint32_t x = tiles.x; x < tiles.z; x++) {
+                glm::uvec2& range = bins.tileRanges[y * bins.tilesX + x];
+                bins.decalIndices[range.x + range.y] = d;
+                range.y++;
+            }
+        }
+    }
+}
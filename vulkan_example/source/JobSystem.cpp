@@ -0,0 +1,297 @@
+#include "JobSystem.h"
+
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+
+// index of the worker owning the current thread (-1 for non-worker threads)
+static thread_local int currentWorkerIndex = -1;
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    stopping = false;
+    queuedJobs = 0;
+    nextQueue = 0;
+
+    if (workerCount == 0) {
+        workerCount = 1;
+    }
+    for (uint32_t i = 0; i < workerCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (uint32_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&JobSystem::workerMain, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::getWorkerCount() const {
+    return static_cast<uint32_t>(workers.size());
+}
+
+void JobSystem::submit(std::function<void()> job) {
+    uint32_t queueIndex;
+    if (currentWorkerIndex >= 0) {
+        queueIndex = static_cast<uint32_t>(currentWorkerIndex);
+    }
+    else {
+        queueIndex = nextQueue++ % static_cast<uint32_t>(queues.size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->jobs.push_back(std::move(job));
+    }
+    {
+        // increment under the wake mutex, so a worker can't miss the wake-up between its check and its wait
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queuedJobs++;
+    }
+    wakeCondition.notify_one();
+}
+
+bool JobSystem::popOwn(uint32_t queueIndex, std::function<void()>& job) {
+    WorkerQueue& queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    // newest job first
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    queuedJobs--;
+    return true;
+}
+
+bool JobSystem::steal(uint32_t thiefIndex, std::function<void()>& job) {
+    uint32_t queueCount = static_cast<uint32_t>(queues.size());
+    for (uint32_t i = 1; i <= queueCount; i++) {
+        WorkerQueue& victim = *queues[(thiefIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            // oldest job of the victim
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedJobs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::tryRunOne() {
+    std::function<void()> job;
+    bool found;
+    if (currentWorkerIndex >= 0) {
+        found = popOwn(static_cast<uint32_t>(currentWorkerIndex), job) || steal(static_cast<uint32_t>(currentWorkerIndex), job);
+    }
+    else {
+        found = steal(0, job);
+    }
+    if (found) {
+        job();
+    }
+    return found;
+}
+
+void JobSystem::workerMain(uint32_t workerIndex) {
+    currentWorkerIndex = static_cast<int>(workerIndex);
+    while (true) {
+        std::function<void()> job;
+        if (popOwn(workerIndex, job) || steal(workerIndex, job)) {
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait(lock, [this] { return stopping || queuedJobs > 0; });
+        if (stopping && queuedJobs == 0) {
+            return;
+        }
+    }
+}
+
+
+double TaskGraph::nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+TaskGraph::TaskID TaskGraph::addTaskInternal(const std::string& name, std::function<void()> work, const std::vector<TaskID>& dependencies, bool mainThread) {
+    TaskID id = static_cast<TaskID>(tasks.size());
+    auto task = std::make_unique<Task>();
+    task->name = name;
+    task->work = std::move(work);
+    task->dependencies = dependencies;
+    task->mainThread = mainThread;
+    for (TaskID dependency : dependencies) {
+        if (dependency >= id) {
+            throw std::invalid_argument("task graph: dependency of task '" + name + "' must be added before the task");
+        }
+        tasks[dependency]->dependents.push_back(id);
+    }
+    tasks.push_back(std::move(task));
+    return id;
+}
+
+TaskGraph::TaskID TaskGraph::addTask(const std::string& name, std::function<void()> work, const std::vector<TaskID>& dependencies) {
+    return addTaskInternal(name, std::move(work), dependencies, false);
+}
+
+TaskGraph::TaskID TaskGraph::addMainThreadTask(const std::string& name, std::function<void()> work, const std::vector<TaskID>& dependencies) {
+    return addTaskInternal(name, std::move(work), dependencies, true);
+}
+
+void TaskGraph::schedule(JobSystem& jobSystem, TaskID id) {
+    if (tasks[id]->mainThread) {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        mainThreadReady.push_back(id);
+    }
+    else {
+        jobSystem.submit([this, &jobSystem, id] { execute(jobSystem, id); });
+    }
+}
+
+void TaskGraph::execute(JobSystem& jobSystem, TaskID id) {
+    Task& task = *tasks[id];
+
+    // skip the work if a dependency failed, but keep propagating so the graph drains
+    for (TaskID dependency : task.dependencies) {
+        if (tasks[dependency]->failed) {
+            task.failed = true;
+        }
+    }
+
+    task.startSeconds = nowSeconds();
+    if (!task.failed) {
+        try {
+            task.work();
+        }
+        catch (...) {
+            task.failed = true;
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!firstException) {
+                firstException = std::current_exception();
+            }
+        }
+    }
+    task.endSeconds = nowSeconds();
+
+    for (TaskID dependent : task.dependents) {
+        if (--tasks[dependent]->remainingDependencies == 0) {
+            schedule(jobSystem, dependent);
+        }
+    }
+    unfinishedTasks--;
+}
+
+void TaskGraph::run(JobSystem& jobSystem) {
+    ranSerial = false;
+    firstException = nullptr;
+    unfinishedTasks = static_cast<uint32_t>(tasks.size());
+    for (auto& task : tasks) {
+        task->remainingDependencies = static_cast<uint32_t>(task->dependencies.size());
+        task->failed = false;
+    }
+
+    runStartSeconds = nowSeconds();
+    for (TaskID id = 0; id < tasks.size(); id++) {
+        if (tasks[id]->dependencies.empty()) {
+            schedule(jobSystem, id);
+        }
+    }
+
+    // the calling thread runs main-thread tasks, and otherwise helps the workers
+    while (unfinishedTasks > 0) {
+        TaskID mainThreadTask = 0;
+        bool haveMainThreadTask = false;
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            if (!mainThreadReady.empty()) {
+                mainThreadTask = mainThreadReady.front();
+                mainThreadReady.erase(mainThreadReady.begin());
+                haveMainThreadTask = true;
+            }
+        }
+        if (haveMainThreadTask) {
+            execute(jobSystem, mainThreadTask);
+        }
+        else if (!jobSystem.tryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+    runEndSeconds = nowSeconds();
+
+    if (firstException) {
+        std::rethrow_exception(firstException);
+    }
+}
+
+void TaskGraph::runSerial() {
+    ranSerial = true;
+    runStartSeconds = nowSeconds();
+    for (auto& task : tasks) {
+        task->startSeconds = nowSeconds();
+        task->work();
+        task->endSeconds = nowSeconds();
+    }
+    runEndSeconds = nowSeconds();
+}
+
+void TaskGraph::printReport(std::ostream& out) const {
+    double toMs = 1000.0;
+    double summedSeconds = 0.0;
+
+    // critical path: longest chain of task durations through the dependencies (insertion order is topological)
+    std::vector<double> pathSeconds(tasks.size(), 0.0);
+    std::vector<int> pathPredecessor(tasks.size(), -1);
+    for (TaskID id = 0; id < tasks.size(); id++) {
+        const Task& task = *tasks[id];
+        double duration = task.endSeconds - task.startSeconds;
+        summedSeconds += duration;
+        double longestDependency = 0.0;
+        for (TaskID dependency : task.dependencies) {
+            if (pathSeconds[dependency] > longestDependency) {
+                longestDependency = pathSeconds[dependency];
+                pathPredecessor[id] = static_cast<int>(dependency);
+            }
+        }
+        pathSeconds[id] = longestDependency + duration;
+    }
+
+    int pathEnd = -1;
+    double criticalPathSeconds = 0.0;
+    for (TaskID id = 0; id < tasks.size(); id++) {
+        if (pathSeconds[id] >= criticalPathSeconds) {
+            criticalPathSeconds = pathSeconds[id];
+            pathEnd = static_cast<int>(id);
+        }
+    }
+    std::vector<int> criticalPath;
+    for (int id = pathEnd; id >= 0; id = pathPredecessor[id]) {
+        criticalPath.push_back(id);
+    }
+    std::reverse(criticalPath.begin(), criticalPath.end());
+
+    out << std::fixed << std::setprecision(2);
+    out << '\n' << "task graph (" << (ranSerial ? "serial" : "parallel") << "):" << '\n';
+    for (const auto& task : tasks) {
+        out << "  " << std::setw(10) << (task->startSeconds - runStartSeconds) * toMs << " ms  +" << std::setw(9) << (task->endSeconds - task->startSeconds) * toMs << " ms  " << task->name << '\n';
+    }
+    out << "  critical path: " << criticalPathSeconds * toMs << " ms" << '\n';
+    for (int id : criticalPath) {
+        out << "    -> " << tasks[id]->name << '\n';
+    }
+    out << "  summed task time (serial cost): " << summedSeconds * toMs << " ms" << '\n';
+    out << "  total startup time:             " << (runEndSeconds - runStartSeconds) * toMs << " ms" << '\n';
+    out << std::defaultfloat;
+}
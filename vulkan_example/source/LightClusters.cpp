@@ -0,0 +1,84 @@
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+
+uint32_t LightClusters::getClusterCount() {
+    return CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+}
+
+uint32_t LightClusters::getSlice(float viewDepth) {
+    if (viewDepth <= DEPTH_NEAR) {
+        return 0;
+    }
+    float slice = std::log(viewDepth / DEPTH_NEAR) / std::log(DEPTH_FAR / DEPTH_NEAR) * static_cast<float>(CLUSTERS_Z);
+    return std::min(static_cast<uint32_t>(slice), CLUSTERS_Z - 1);
+}
+
+void LightClusters::assignLights(const std::vector<LightClusterBounds>& bounds, VkExtent2D extent, LightClusterGrid& grid) {
+    // cluster size in pixels (the last row/column may be partially off screen, as in the shader)
+    uint32_t tileWidth = (extent.width + CLUSTERS_X - 1) / CLUSTERS_X;
+    uint32_t tileHeight = (extent.height + CLUSTERS_Y - 1) / CLUSTERS_Y;
+
+    // cluster range of each light (x0, y0, z0, x1, y1, z1 exclusive), false if the light is not visible
+    auto clusterRange = [&](const LightClusterBounds& light, uint32_t range[6]) {
+        const VkRect2D& rect = light.screenRect;
+        if (rect.extent.width == 0 || rect.extent.height == 0) {
+            return false;
+        }
+        uint32_t x = static_cast<uint32_t>(std::max(rect.offset.x, 0));
+        uint32_t y = static_cast<uint32_t>(std::max(rect.offset.y, 0));
+        range[0] = std::min(x / tileWidth, CLUSTERS_X);
+        range[1] = std::min(y / tileHeight, CLUSTERS_Y);
+        range[2] = getSlice(light.minDepth);
+        range[3] = std::min((x + rect.extent.width + tileWidth - 1) / tileWidth, CLUSTERS_X);
+        range[4] = std::min((y + rect.extent.height + tileHeight - 1) / tileHeight, CLUSTERS_Y);
+        range[5] = getSlice(light.maxDepth) + 1;
+        return true;
+    };
+    auto clusterIndex = [](uint32_t x, uint32_t y, uint32_t z) {
+        return (z * CLUSTERS_Y + y) * CLUSTERS_X + x;
+    };
+
+    //1. count lights per cluster
+    // (vectors keep their capacity between frames: no allocations once the frame-state slots are warm)
+    grid.clusterRanges.assign(getClusterCount(), glm::uvec2(0));
+    uint32_t range[6];
+    for (const LightClusterBounds& light : bounds) {
+        if (!clusterRange(light, range)) {
+            continue;
+        }
+        for (uint32_t z = range[2]; z < range[5]; z++) {
+            for (uint32_t y = range[1]; y < range[4]; y++) {
+                for (uint32_t x = range[0]; x < range[3]; x++) {
+                    grid.clusterRanges[clusterIndex(x, y, z)].y++;
+                }
+            }
+        }
+    }
+
+    //2. prefix sum: first entry of each cluster
+    uint32_t entries = 0;
+    for (glm::uvec2& cluster : grid.clusterRanges) {
+        cluster.x = entries;
+        entries += cluster.y;
+        cluster.y = 0; // refilled below
+    }
+
+    //3. fill the cluster lists (in light order)
+    grid.lightIndices.resize(entries);
+    for (uint32_t l = 0; l < bounds.size(); l++) {
+        if (!clusterRange(bounds[l], range)) {
+            continue;
+        }
+        for (uint32_t z = range[2]; z < range[5]; z++) {
+            for (uint32_t y = range[1]; y < range[4]; y++) {
+                for (uint32_t x = range[0]; x < range[3]; x++) {
+                    glm::uvec2& cluster = grid.clusterRanges[clusterIndex(x, y, z)];
+                    grid.lightIndices[cluster.x + cluster.y] = l;
+                    cluster.y++;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include "RadixSort.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <array>
+#include <utility>
+
+uint32_t RadixSort::floatKey(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // negative: flip all bits (larger magnitude sorts first), positive: flip the sign bit (sorts after all negatives)
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+void RadixSort::sort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values) {
+    if (keys.size() != values.size()) {
+        throw std::runtime_error("radix sort: one value per key expected");
+    }
+    const size_t count = keys.size();
+    scratchKeys.resize(count);
+    scratchValues.resize(count);
+
+    uint32_t* srcKeys = keys.data();
+    uint32_t* srcValues = values.data();
+    uint32_t* dstKeys = scratchKeys.data();
+    uint32_t* dstValues = scratchValues.data();
+
+    for (uint32_t shift = 0; shift < 32; shift += 8) {
+        //1. histogram of the pass's digit
+        std::array<uint32_t, 256> offsets{};
+        for (size_t i = 0; i < count; i++) {
+            offsets[(srcKeys[i] >> shift) & 0xff]++;
+        }
+        if (count == 0 || offsets[(srcKeys[0] >> shift) & 0xff] == count) {
+            continue; // all keys share this digit: the pass would not change the order
+        }
+
+        //2. exclusive prefix sum: first output slot of each digit
+        uint32_t sum = 0;
+        for (uint32_t& offset : offsets) {
+            uint32_t digitCount = offset;
+            offset = sum;
+            sum += digitCount;
+        }
+
+        //3. stable scatter, in input order
+        for (size_t i = 0; i < count; i++) {
+            uint32_t slot = offsets[(srcKeys[i] >> shift) & 0xff]++;
+            dstKeys[slot] = srcKeys[i];
+            dstValues[slot] = srcValues[i];
+        }
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    // odd number of executed passes: the result is in the scratch arrays
+    if (srcKeys != keys.data()) {
+        std::memcpy(keys.data(), srcKeys, count * sizeof(uint32_t));
+        std::memcpy(values.data(), srcValues, count * sizeof(uint32_t));
+    }
+}
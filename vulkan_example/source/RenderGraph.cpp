@@ -0,0 +1,588 @@
+#include "RenderGraph.h"
+
+#include <stdexcept>
+#include <iomanip>
+
+void RenderGraph::addAttachment(const RenderGraphAttachmentInfo& info) {
+    for (const Attachment& attachment : attachments) {
+        if (attachment.info.name == info.name) {
+            throw std::runtime_error("render graph: attachment declared twice: " + info.name);
+        }
+    }
+    Attachment attachment{};
+    attachment.info = info;
+    attachments.push_back(attachment);
+}
+
+void RenderGraph::setViewMask(uint32_t mask) {
+    viewMask = mask;
+}
+
+void RenderGraph::setStoreOpNone(bool supported) {
+    storeOpNone = supported;
+}
+
+uint32_t RenderGraph::getViewCount() const {
+    uint32_t count = 0;
+    for (uint32_t mask = viewMask; mask != 0; mask &= mask - 1) {
+        count++;
+    }
+    return count > 0 ? count : 1;
+}
+
+uint32_t RenderGraph::getAttachmentIndex(const std::string& attachment) const {
+    for (uint32_t i = 0; i < attachments.size(); i++) {
+        if (attachments[i].info.name == attachment) {
+            return i;
+        }
+    }
+    throw std::runtime_error("render graph: unknown attachment: " + attachment);
+}
+
+uint32_t RenderGraph::getSubpassIndex(const std::string& pass) const {
+    for (uint32_t i = 0; i < passes.size(); i++) {
+        if (passes[i].name == pass) {
+            return i;
+        }
+    }
+    throw std::runtime_error("render graph: unknown pass: " + pass);
+}
+
+bool RenderGraph::isDepthFormat(VkFormat format) {
+    return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D32_SFLOAT || format == VK_FORMAT_D16_UNORM_S8_UINT
+        || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_X8_D24_UNORM_PACK32;
+}
+
+uint32_t RenderGraph::formatBytesPerPixel(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_R8_UNORM:
+        return 1;
+    case VK_FORMAT_R16_SFLOAT:
+    case VK_FORMAT_D16_UNORM:
+        return 2;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+        return 3;
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return 5;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+    case VK_FORMAT_R32G32_SFLOAT:
+        return 8;
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+        return 16;
+    default:
+        return 4; // 8-bit RGBA/BGRA, packed 32-bit formats, R32, D32, D24S8
+    }
+}
+
+void RenderGraph::addUse(const std::string& name, uint32_t pass, UseType type) {
+    Attachment& attachment = attachments[getAttachmentIndex(name)];
+    bool depthFormat = isDepthFormat(attachment.info.format);
+
+    AttachmentUse use{};
+    use.pass = pass;
+    switch (type) {
+    case USE_COLOR_OUTPUT:
+        use.write = true;
+        use.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        use.stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        use.accessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; // read for blending
+        use.writeAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        break;
+    case USE_DEPTH_OUTPUT:
+        use.write = true;
+        use.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        use.stageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        use.accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        use.writeAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        break;
+    case USE_DEPTH_INPUT:
+        use.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        use.stageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        use.accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        break;
+    case USE_INPUT_ATTACHMENT:
+        use.layout = depthFormat ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        use.stageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        use.accessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+        break;
+    case USE_RESOLVE_OUTPUT:
+        // resolves (color and depth/stencil) run in the color attachment output stage, as color attachment writes
+        use.write = true;
+        use.layout = depthFormat ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        use.stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        use.accessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        use.writeAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        break;
+    }
+
+    if (passes[pass].stencilWrite && depthFormat && type != USE_COLOR_OUTPUT && type != USE_RESOLVE_OUTPUT) {
+        // read-only depth, written stencil: one layout for the depth test, the stencil writes and the input attachment read
+        if (type != USE_DEPTH_OUTPUT) {
+            use.layout = VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_STENCIL_ATTACHMENT_OPTIMAL;
+        }
+        if (type != USE_INPUT_ATTACHMENT) {
+            use.stencilWrite = true;
+            use.accessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            use.writeAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        }
+    }
+
+    bool depthUse = (type == USE_DEPTH_OUTPUT || type == USE_DEPTH_INPUT);
+    if ((type == USE_COLOR_OUTPUT && depthFormat) || (depthUse && !depthFormat)) {
+        throw std::runtime_error("render graph: attachment " + name + " used as " + (depthFormat ? "color" : "depth") + " attachment");
+    }
+
+    // merge with an earlier use in the same pass (e.g. depth test + input attachment read)
+    if (!attachment.uses.empty() && attachment.uses.back().pass == pass) {
+        AttachmentUse& merged = attachment.uses.back();
+        if (merged.layout != use.layout) {
+            throw std::runtime_error("render graph: attachment " + name + " used with two different layouts in pass " + passes[pass].name);
+        }
+        merged.write = merged.write || use.write;
+        merged.stencilWrite = merged.stencilWrite || use.stencilWrite;
+        merged.stageMask |= use.stageMask;
+        merged.accessMask |= use.accessMask;
+        merged.writeAccessMask |= use.writeAccessMask;
+        return;
+    }
+    attachment.uses.push_back(use);
+}
+
+void RenderGraph::addPass(const RenderGraphPassInfo& info) {
+    if (!info.depthOutput.empty() && !info.depthInput.empty()) {
+        throw std::runtime_error("render graph: pass " + info.name + " declares a depth output and a depth input");
+    }
+    if (!info.resolveOutputs.empty() && info.resolveOutputs.size() != info.colorOutputs.size()) {
+        throw std::runtime_error("render graph: pass " + info.name + " needs one resolve target per color output");
+    }
+    if (!info.depthResolveOutput.empty() && info.depthOutput.empty()) {
+        throw std::runtime_error("render graph: pass " + info.name + " resolves depth without a depth output");
+    }
+    auto checkResolve = [&](const std::string& source, const std::string& target) {
+        const RenderGraphAttachmentInfo& sourceInfo = attachments[getAttachmentIndex(source)].info;
+        const RenderGraphAttachmentInfo& targetInfo = attachments[getAttachmentIndex(target)].info;
+        if (sourceInfo.samples == VK_SAMPLE_COUNT_1_BIT || targetInfo.samples != VK_SAMPLE_COUNT_1_BIT || sourceInfo.format != targetInfo.format) {
+            throw std::runtime_error("render graph: pass " + info.name + " cannot resolve " + source + " into " + target);
+        }
+    };
+    for (size_t i = 0; i < info.resolveOutputs.size(); i++) {
+        checkResolve(info.colorOutputs[i], info.resolveOutputs[i]);
+    }
+    if (!info.depthResolveOutput.empty()) {
+        checkResolve(info.depthOutput, info.depthResolveOutput);
+    }
+
+    uint32_t pass = static_cast<uint32_t>(passes.size());
+    passes.push_back(info);
+
+    // reads first: an input read and an output write of the same attachment (feedback loop) hits the layout check in addUse
+    for (const std::string& input : info.inputAttachments) {
+        addUse(input, pass, USE_INPUT_ATTACHMENT);
+    }
+    if (!info.depthInput.empty()) {
+        addUse(info.depthInput, pass, USE_DEPTH_INPUT);
+    }
+    for (const std::string& output : info.colorOutputs) {
+        addUse(output, pass, USE_COLOR_OUTPUT);
+    }
+    if (!info.depthOutput.empty()) {
+        addUse(info.depthOutput, pass, USE_DEPTH_OUTPUT);
+    }
+    for (const std::string& resolve : info.resolveOutputs) {
+        addUse(resolve, pass, USE_RESOLVE_OUTPUT);
+    }
+    if (!info.depthResolveOutput.empty()) {
+        addUse(info.depthResolveOutput, pass, USE_RESOLVE_OUTPUT);
+    }
+}
+
+VkImageUsageFlags RenderGraph::getImageUsage(const std::string& name) const {
+    const Attachment& attachment = attachments[getAttachmentIndex(name)];
+    VkImageUsageFlags usage = 0;
+    for (const RenderGraphPassInfo& pass : passes) {
+        for (const std::string& output : pass.colorOutputs) {
+            if (output == name) {
+                usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            }
+        }
+        for (const std::string& input : pass.inputAttachments) {
+            if (input == name) {
+                usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+            }
+        }
+        for (const std::string& resolve : pass.resolveOutputs) {
+            if (resolve == name) {
+                usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            }
+        }
+        if (pass.depthOutput == name || pass.depthInput == name || pass.depthResolveOutput == name) {
+            usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        }
+    }
+    if (!attachment.info.persistent) {
+        // contents never leave the render pass: may be backed by lazily allocated memory
+        usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+    return usage;
+}
+
+bool RenderGraph::isTransient(const std::string& name) const {
+    return !attachments[getAttachmentIndex(name)].info.persistent;
+}
+
+std::vector<VkClearValue> RenderGraph::getClearValues() const {
+    std::vector<VkClearValue> clearValues;
+    for (const Attachment& attachment : attachments) {
+        clearValues.push_back(attachment.info.clearValue);
+    }
+    return clearValues;
+}
+
+VkAttachmentLoadOp RenderGraph::getLoadOp(const std::string& attachment) const {
+    return deriveLoadOp(attachments[getAttachmentIndex(attachment)]);
+}
+
+VkAttachmentStoreOp RenderGraph::getStoreOp(const std::string& attachment) const {
+    return deriveStoreOp(attachments[getAttachmentIndex(attachment)]);
+}
+
+VkAttachmentLoadOp RenderGraph::getStencilLoadOp(const std::string& attachment) const {
+    return deriveStencilLoadOp(attachments[getAttachmentIndex(attachment)]);
+}
+
+VkAttachmentStoreOp RenderGraph::getStencilStoreOp(const std::string& attachment) const {
+    getAttachmentIndex(attachment); // throws for unknown attachments
+    // stencil is only used inside one render pass (masks), it is never stored
+    return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+}
+
+VkClearValue RenderGraph::getClearValue(const std::string& attachment) const {
+    return attachments[getAttachmentIndex(attachment)].info.clearValue;
+}
+
+VkAttachmentLoadOp RenderGraph::deriveLoadOp(const Attachment& attachment) const {
+    if (attachment.uses.empty()) {
+        throw std::runtime_error("render graph: attachment " + attachment.info.name + " is never used");
+    }
+
+    if (attachment.uses.front().write) {
+        // first use writes: previous contents are not needed
+        return attachment.info.clearOnFirstWrite ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    }
+    // first use reads: contents must come from outside the render pass
+    if (!attachment.info.persistent) {
+        throw std::runtime_error("render graph: attachment " + attachment.info.name + " is read before it is written, but is not persistent");
+    }
+    return VK_ATTACHMENT_LOAD_OP_LOAD;
+}
+
+VkAttachmentStoreOp RenderGraph::deriveStoreOp(const Attachment& attachment) const {
+    // only persistent attachments are used after the render pass
+    if (!attachment.info.persistent) {
+        return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+    for (const AttachmentUse& use : attachment.uses) {
+        if (use.write) {
+            return VK_ATTACHMENT_STORE_OP_STORE;
+        }
+    }
+    // only read by the graph: the contents in memory are still valid, there is nothing to write back
+    if (!attachment.info.readAfterPass) {
+        return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+    return storeOpNone ? VK_ATTACHMENT_STORE_OP_NONE : VK_ATTACHMENT_STORE_OP_STORE;
+}
+
+VkAttachmentLoadOp RenderGraph::deriveStencilLoadOp(const Attachment& attachment) const {
+    // stencil masks start from the clear value; nothing reads stencil before a pass writes it
+    for (const AttachmentUse& use : attachment.uses) {
+        if (use.stencilWrite) {
+            return VK_ATTACHMENT_LOAD_OP_CLEAR;
+        }
+    }
+    return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+}
+
+void RenderGraph::addDependency(uint32_t srcSubpass, uint32_t dstSubpass, VkPipelineStageFlags srcStageMask, VkAccessFlags srcAccessMask, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask) {
+    std::pair<uint32_t, uint32_t> key(srcSubpass, dstSubpass);
+    if (dependencies.find(key) == dependencies.end()) {
+        VkSubpassDependency2 dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_SUBPASS_DEPENDENCY_2;
+        dependency.srcSubpass = srcSubpass;
+        dependency.dstSubpass = dstSubpass;
+        // subpass -> subpass: every read is framebuffer-local (input attachments, depth test), so only the same pixel has to be waited for
+        // (multiview: and only in the same view, each view reads its own layer)
+        if (srcSubpass != VK_SUBPASS_EXTERNAL && dstSubpass != VK_SUBPASS_EXTERNAL) {
+            dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+            if (viewMask != 0) {
+                dependency.dependencyFlags |= VK_DEPENDENCY_VIEW_LOCAL_BIT;
+            }
+        }
+        dependencies[key] = dependency;
+    }
+    VkSubpassDependency2& dependency = dependencies[key];
+    dependency.srcStageMask |= srcStageMask;
+    dependency.srcAccessMask |= srcAccessMask;
+    dependency.dstStageMask |= dstStageMask;
+    dependency.dstAccessMask |= dstAccessMask;
+}
+
+void RenderGraph::deriveDependencies() {
+    dependencies.clear();
+
+    for (const Attachment& attachment : attachments) {
+        const std::vector<AttachmentUse>& uses = attachment.uses;
+
+        // within the render pass: one dependency per hazard
+        int lastWrite = -1;
+        std::vector<uint32_t> readsSinceWrite;
+        for (uint32_t k = 0; k < uses.size(); k++) {
+            const AttachmentUse& use = uses[k];
+            // a stencil write is a write hazard, even if the depth aspect is only read
+            if (use.write || use.stencilWrite) {
+                if (!readsSinceWrite.empty()) {
+                    // write-after-read: execution dependency on every reader (which already waited for the last write)
+                    for (uint32_t read : readsSinceWrite) {
+                        addDependency(uses[read].pass, use.pass, uses[read].stageMask, 0, use.stageMask, use.accessMask);
+                    }
+                }
+                else if (lastWrite >= 0) {
+                    // write-after-write
+                    addDependency(uses[lastWrite].pass, use.pass, uses[lastWrite].stageMask, uses[lastWrite].writeAccessMask, use.stageMask, use.accessMask);
+                }
+                lastWrite = static_cast<int>(k);
+                readsSinceWrite.clear();
+            }
+            else {
+                if (lastWrite >= 0) {
+                    // read-after-write
+                    addDependency(uses[lastWrite].pass, use.pass, uses[lastWrite].stageMask, uses[lastWrite].writeAccessMask, use.stageMask, use.accessMask);
+                }
+                if (k > 0 && static_cast<int>(k - 1) != lastWrite && uses[k - 1].layout != use.layout) {
+                    // read-after-read with a layout transition in between (the transition is a write)
+                    addDependency(uses[k - 1].pass, use.pass, uses[k - 1].stageMask, 0, use.stageMask, use.accessMask);
+                }
+                readsSinceWrite.push_back(k);
+            }
+        }
+
+        // previous frame -> first use: the same image is reused every frame, so wait for its last use in the previous render pass,
+        // and its uses outside of it (for the swapchain this is the color output stage, where the image-available semaphore wait happens)
+        const AttachmentUse& firstUse = uses.front();
+        const AttachmentUse& lastUse = uses.back();
+        addDependency(VK_SUBPASS_EXTERNAL, firstUse.pass, lastUse.stageMask | attachment.info.externalSrcStageMask, lastUse.writeAccessMask | attachment.info.externalSrcAccessMask, firstUse.stageMask, firstUse.accessMask);
+
+        // last use -> after the render pass (persistent attachments only)
+        if (attachment.info.persistent) {
+            addDependency(lastUse.pass, VK_SUBPASS_EXTERNAL, lastUse.stageMask, lastUse.writeAccessMask, attachment.info.externalDstStageMask, attachment.info.externalDstAccessMask);
+        }
+    }
+}
+
+VkRenderPass RenderGraph::createRenderPass(VkDevice device) {
+    deriveDependencies();
+
+    //1. Attachments
+    // ------------------------
+    std::vector<VkAttachmentDescription2> attachmentDescriptions;
+    for (const Attachment& attachment : attachments) {
+        VkAttachmentDescription2 description{};
+        description.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2;
+        description.format = attachment.info.format;
+        description.samples = attachment.info.samples;
+        description.loadOp = deriveLoadOp(attachment);
+        description.storeOp = deriveStoreOp(attachment);
+        description.stencilLoadOp = deriveStencilLoadOp(attachment);
+        description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        // loaded attachments come in the layout they were left in, otherwise the previous contents (and layout) are discarded
+        description.initialLayout = (description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) ? attachment.info.finalLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+        // transient attachments stay in the layout of their last use: no transition at the end of the render pass
+        description.finalLayout = attachment.info.persistent ? attachment.info.finalLayout : attachment.uses.back().layout;
+        attachmentDescriptions.push_back(description);
+    }
+
+    //2. Subpasses
+    // ------------
+    // references are sized up front, so pointers into them stay valid
+    std::vector<std::vector<VkAttachmentReference2>> colorReferences(passes.size());
+    std::vector<std::vector<VkAttachmentReference2>> inputReferences(passes.size());
+    std::vector<std::vector<VkAttachmentReference2>> resolveReferences(passes.size());
+    std::vector<VkAttachmentReference2> depthReferences(passes.size());
+    std::vector<VkAttachmentReference2> depthResolveReferences(passes.size());
+    std::vector<VkSubpassDescriptionDepthStencilResolve> depthResolves(passes.size());
+    std::vector<VkSubpassDescription2> subpasses(passes.size());
+
+    auto makeReference = [this](const std::string& name, uint32_t pass) {
+        uint32_t index = getAttachmentIndex(name);
+        VkAttachmentReference2 reference{};
+        reference.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2;
+        reference.attachment = index;
+        for (const AttachmentUse& use : attachments[index].uses) {
+            if (use.pass == pass) {
+                reference.layout = use.layout;
+            }
+        }
+        reference.aspectMask = isDepthFormat(attachments[index].info.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        return reference;
+    };
+
+    for (uint32_t p = 0; p < passes.size(); p++) {
+        const RenderGraphPassInfo& pass = passes[p];
+        for (const std::string& output : pass.colorOutputs) {
+            colorReferences[p].push_back(makeReference(output, p));
+        }
+        for (const std::string& input : pass.inputAttachments) {
+            inputReferences[p].push_back(makeReference(input, p));
+        }
+        for (const std::string& resolve : pass.resolveOutputs) {
+            resolveReferences[p].push_back(makeReference(resolve, p));
+        }
+
+        VkSubpassDescription2& subpass = subpasses[p];
+        subpass.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2;
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.viewMask = viewMask;
+        subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences[p].size());
+        subpass.pColorAttachments = colorReferences[p].data();
+        subpass.inputAttachmentCount = static_cast<uint32_t>(inputReferences[p].size());
+        subpass.pInputAttachments = inputReferences[p].data();
+        subpass.pResolveAttachments = resolveReferences[p].empty() ? nullptr : resolveReferences[p].data();
+
+        std::string depthAttachment = pass.depthOutput.empty() ? pass.depthInput : pass.depthOutput;
+        if (!depthAttachment.empty()) {
+            depthReferences[p] = makeReference(depthAttachment, p);
+            subpass.pDepthStencilAttachment = &depthReferences[p];
+        }
+        if (!pass.depthResolveOutput.empty()) {
+            // sample 0: the only depth resolve mode every device supports (stencil is never read after the pass that writes it)
+            depthResolveReferences[p] = makeReference(pass.depthResolveOutput, p);
+            VkSubpassDescriptionDepthStencilResolve& depthResolve = depthResolves[p];
+            depthResolve.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_DEPTH_STENCIL_RESOLVE;
+            depthResolve.depthResolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+            depthResolve.stencilResolveMode = VK_RESOLVE_MODE_NONE;
+            depthResolve.pDepthStencilResolveAttachment = &depthResolveReferences[p];
+            subpass.pNext = &depthResolve;
+        }
+    }
+
+    //3. Dependencies
+    // --------------
+    std::vector<VkSubpassDependency2> subpassDependencies;
+    for (const auto& dependency : dependencies) {
+        subpassDependencies.push_back(dependency.second);
+    }
+
+    //4. Render Pass
+    // -------------
+    VkRenderPassCreateInfo2 renderPassCreateInfo{};
+    renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2;
+    renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachmentDescriptions.size());
+    renderPassCreateInfo.pAttachments = attachmentDescriptions.data();
+    renderPassCreateInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+    renderPassCreateInfo.pSubpasses = subpasses.data();
+    renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(subpassDependencies.size());
+    renderPassCreateInfo.pDependencies = subpassDependencies.data();
+    // the views see (nearly) the same geometry: a hint that the implementation may render them concurrently
+    renderPassCreateInfo.correlatedViewMaskCount = viewMask != 0 ? 1 : 0;
+    renderPassCreateInfo.pCorrelatedViewMasks = viewMask != 0 ? &viewMask : nullptr;
+
+    VkRenderPass renderPass;
+    VkResult renderPassCreated = vkCreateRenderPass2(device, &renderPassCreateInfo, nullptr, &renderPass);
+    if (renderPassCreated != VK_SUCCESS) {
+        throw std::runtime_error("failed to create render pass from render graph");
+    }
+    return renderPass;
+}
+
+void RenderGraph::bindImageViews(const std::string& name, const std::vector<VkImageView>& views) {
+    attachments[getAttachmentIndex(name)].views = views;
+}
+
+void RenderGraph::createFramebuffers(VkDevice device, VkRenderPass renderPass, VkExtent2D extent, uint32_t framebufferCount, std::vector<VkFramebuffer>& framebuffers) const {
+    framebuffers.resize(framebufferCount);
+
+    for (uint32_t i = 0; i < framebufferCount; i++) {
+        std::vector<VkImageView> views;
+        for (const Attachment& attachment : attachments) {
+            if (attachment.views.size() == 1) {
+                views.push_back(attachment.views[0]);
+            }
+            else if (i < attachment.views.size()) {
+                views.push_back(attachment.views[i]);
+            }
+            else {
+                throw std::runtime_error("render graph: no image view bound for attachment " + attachment.info.name);
+            }
+        }
+
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = renderPass;
+        framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+        framebufferInfo.pAttachments = views.data();
+        framebufferInfo.width = extent.width;
+        framebufferInfo.height = extent.height;
+        framebufferInfo.layers = 1; // (multiview: the views select the layers of the attachments, layers must stay 1)
+
+        VkResult framebufferCreated = vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffers[i]);
+        if (framebufferCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create framebuffer");
+        }
+    }
+}
+
+VkDeviceSize RenderGraph::estimateBandwidth(VkExtent2D extent) const {
+    VkDeviceSize bytes = 0;
+    for (const Attachment& attachment : attachments) {
+        VkDeviceSize attachmentBytes = VkDeviceSize(extent.width) * extent.height * formatBytesPerPixel(attachment.info.format) * attachment.info.samples * getViewCount();
+        if (deriveLoadOp(attachment) == VK_ATTACHMENT_LOAD_OP_LOAD) {
+            bytes += attachmentBytes;
+        }
+        if (deriveStoreOp(attachment) == VK_ATTACHMENT_STORE_OP_STORE) {
+            bytes += attachmentBytes;
+        }
+    }
+    return bytes;
+}
+
+VkDeviceSize RenderGraph::estimateWorstCaseBandwidth(VkExtent2D extent) const {
+    VkDeviceSize bytes = 0;
+    for (const Attachment& attachment : attachments) {
+        bytes += 2 * VkDeviceSize(extent.width) * extent.height * formatBytesPerPixel(attachment.info.format) * attachment.info.samples * getViewCount();
+    }
+    return bytes;
+}
+
+void RenderGraph::printSummary(std::ostream& out, VkExtent2D extent) const {
+    auto loadOpName = [](VkAttachmentLoadOp op) {
+        return op == VK_ATTACHMENT_LOAD_OP_LOAD ? "LOAD" : (op == VK_ATTACHMENT_LOAD_OP_CLEAR ? "CLEAR" : "DONT_CARE");
+    };
+    auto storeOpName = [](VkAttachmentStoreOp op) {
+        return op == VK_ATTACHMENT_STORE_OP_STORE ? "STORE" : (op == VK_ATTACHMENT_STORE_OP_NONE ? "NONE" : "DONT_CARE");
+    };
+    auto stageName = [](uint32_t subpass) {
+        return subpass == VK_SUBPASS_EXTERNAL ? std::string("EXTERNAL") : std::to_string(subpass);
+    };
+
+    out << "render graph: " << attachments.size() << " attachments, " << passes.size() << " subpasses, " << dependencies.size() << " dependencies"
+        << (viewMask != 0 ? ", " + std::to_string(getViewCount()) + " views" : "") << '\n';
+    for (const Attachment& attachment : attachments) {
+        out << "  attachment " << attachment.info.name << ": load " << loadOpName(deriveLoadOp(attachment))
+            << ", store " << storeOpName(deriveStoreOp(attachment))
+            << (deriveStencilLoadOp(attachment) == VK_ATTACHMENT_LOAD_OP_CLEAR ? ", stencil CLEAR" : "")
+            << (attachment.info.persistent ? "" : ", transient")
+            << (attachment.info.samples != VK_SAMPLE_COUNT_1_BIT ? ", " + std::to_string(attachment.info.samples) + " samples" : "") << '\n';
+    }
+    for (uint32_t p = 0; p < passes.size(); p++) {
+        out << "  subpass " << p << ": " << passes[p].name << '\n';
+    }
+    for (const auto& dependency : dependencies) {
+        out << "  dependency " << stageName(dependency.first.first) << " -> " << stageName(dependency.first.second)
+            << ((dependency.second.dependencyFlags & VK_DEPENDENCY_BY_REGION_BIT) ? " (by region)" : "") << '\n';
+    }
+    double toMB = 1.0 / (1024.0 * 1024.0);
+    out << std::fixed << std::setprecision(1);
+    out << "  attachment load/store traffic per frame: " << estimateBandwidth(extent) * toMB << " MB"
+        << " (every attachment loaded and stored: " << estimateWorstCaseBandwidth(extent) * toMB << " MB)" << '\n';
+    out << std::defaultfloat;
+}
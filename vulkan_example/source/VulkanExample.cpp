@@ -6,6 +6,7 @@
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
+// (no effect: VulkanExample.h includes glm first, so glm::perspective keeps its -1..1 depth range, see shaderFxCull.comp)
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
@@ -39,14 +40,108 @@
 #define VK_API_VERSION_MAJOR(version) (((uint32_t)(version) >> 22) & 0x7FU)
 #define VK_API_VERSION_MINOR(version) (((uint32_t)(version) >> 12) & 0x3FFU)
 
-VulkanApp::VulkanApp(){
+VulkanApp::VulkanApp() : VulkanApp(Settings{}) {
+}
+
+VulkanApp::VulkanApp(const Settings& settings){
 	
+	this->settings = settings;
 	glfwExtensionCount = 0;
 	deviceCount = 0;
 	physicalDevice = VK_NULL_HANDLE;
 	frameID = 0;	
 	blocked = false;
-	
+	renderedFrames = 0;
+
+	// bloom: compute chain from col0 between the scene and the composition render pass, so the composition adds the bloom of
+	// the frame it shows (compute cannot run inside the subpass path's single render pass). --fast-bloom: performance preset
+	if (this->settings.fastBloom) {
+		this->settings.bloom = true;
+	}
+	bool stereoRequested = this->settings.stereo && !this->settings.multiPass && !this->settings.deferred;
+	bloom.enabled = this->settings.bloom && !stereoRequested;
+	if (this->settings.bloom && !bloom.enabled) {
+		std::cout << "warning: --bloom ignored: the composition writes both eyes' layers, the bloom pyramid has one (--stereo)" << '\n';
+	}
+	if (bloom.enabled && !this->settings.multiPass) {
+		std::cout << "--bloom enables --multipass: the chain runs between the scene and the composition render pass"
+			<< " (the subpass-only options --oit, --deferred and --msaa are ignored)" << '\n';
+		this->settings.multiPass = true;
+	}
+	bloom.downscale = this->settings.fastBloom ? 4 : 2;
+
+	// weighted blended OIT: extra subpasses of the render pass, so not with separate render passes
+	oit.enabled = this->settings.oit && !this->settings.multiPass;
+	if (this->settings.oit && !oit.enabled) {
+		std::cout << "--oit ignored: order-independent transparency needs the subpass render path (no --multipass)" << '\n';
+	}
+	if (oit.enabled && this->settings.gpuSort) {
+		std::cout << "--gpu-sort ignored: order-independent transparency draws the force fields unsorted" << '\n';
+		this->settings.gpuSort = false;
+	}
+
+	// deferred shading: the lighting subpass reads the G-buffer as input attachments, so not with separate render passes either
+	deferred.enabled = this->settings.deferred && !this->settings.multiPass;
+	if (this->settings.deferred && !deferred.enabled) {
+		std::cout << "--deferred ignored: deferred shading needs the subpass render path (no --multipass)" << '\n';
+	}
+	// multiview stereo: view masks on the subpasses of the single render pass. the CPU/compute work that depends on one camera's
+	// screen space (decal tiles, cluster light lists, volume scissors/depth bounds, the Hi-Z pyramid) is left out or switched
+	// to its camera-independent variant, with a warning for every option this overrides (a stereo benchmark measures less work)
+	multiview.enabled = this->settings.stereo && !this->settings.multiPass && !deferred.enabled;
+	if (this->settings.stereo && !multiview.enabled) {
+		std::cout << "--stereo ignored: multiview needs the forward subpass render path (no --multipass, no --deferred)" << '\n';
+	}
+	if (multiview.enabled && !this->settings.volumeDecals) {
+		std::cout << "warning: --stereo replaces the tiled decal pass with --volume-decals: the decal tiles are binned in one camera's screen space" << '\n';
+		if (this->settings.decalCount != Settings{}.decalCount) {
+			std::cout << "warning: --decals ignored: the volume decal path draws a single decal box (--stereo)" << '\n';
+		}
+		this->settings.volumeDecals = true;
+	}
+	if (multiview.enabled && !this->settings.disableVolumeBounds) {
+		std::cout << "warning: --stereo turns off the fx/decal scissors and depth bounds (--no-volume-bounds): they are one camera's,"
+			<< " and the volume draws' fragment statistics (a query in a multiview render pass takes one result per view)" << '\n';
+		this->settings.disableVolumeBounds = true;
+	}
+	if (multiview.enabled) {
+		std::cout << "warning: --stereo shows both eyes side by side in the window (blit into the swapchain image), there is no headless offscreen output" << '\n';
+	}
+	// clustered forward shading: only changes the scene fragment shader, which the deferred path replaces
+	clustered.enabled = this->settings.clustered && !deferred.enabled && !multiview.enabled;
+	if (this->settings.clustered && deferred.enabled) {
+		std::cout << "--clustered ignored: the lights are shaded by the deferred lighting subpass (--deferred)" << '\n';
+	}
+	else if (this->settings.clustered && multiview.enabled) {
+		std::cout << "warning: --clustered ignored: the cluster light lists are assigned in one camera's screen space (--stereo)" << '\n';
+	}
+	// multisampled scene: resolved inside the scene subpass, so not with separate render passes; the G-buffer is not multisampled
+	msaa.enabled = this->settings.msaaSamples > 1 && !this->settings.multiPass && !deferred.enabled;
+	if (this->settings.msaaSamples > 1 && !msaa.enabled) {
+		std::cout << "--msaa ignored: the scene subpass resolve needs the forward subpass render path (no --multipass, no --deferred)" << '\n';
+	}
+	// Hi-Z occlusion culling: the force fields are tested against the pyramid by the GPU-driven fx draw's cull dispatch
+	hiZ.enabled = this->settings.hiZ && !multiview.enabled;
+	if (this->settings.hiZ && !hiZ.enabled) {
+		std::cout << "warning: --hiz ignored: the depth pyramid would be reduced from one eye's depth (--stereo)" << '\n';
+	}
+	if (hiZ.enabled && !this->settings.gpuCulling) {
+		std::cout << "--hiz enables --gpu-culling: the force fields are tested against the depth pyramid by the cull dispatch" << '\n';
+		this->settings.gpuCulling = true;
+	}
+	// occlusion queries: proxies in the composition subpass of every render path (conditional rendering or CPU readback: see the device)
+	occlusion.enabled = this->settings.occlusionQueries && !multiview.enabled;
+	if (this->settings.occlusionQueries && !occlusion.enabled) {
+		std::cout << "warning: --occlusion-queries ignored: a query in a multiview render pass takes one result per view (--stereo)" << '\n';
+	}
+	// shadow map: sampled by the forward/clustered scene fragment shader, the G-buffer path shades its lights in the lighting subpass
+	shadow.enabled = this->settings.shadows && !deferred.enabled;
+	if (this->settings.shadows && !shadow.enabled) {
+		std::cout << "--shadows ignored: the shadow map is sampled by the forward/clustered scene subpass (no --deferred)" << '\n';
+	}
+	// auto exposure: copy of col0 after the render pass in every render path, dispatched on the compute queue unless disabled
+	autoExposure.enabled = this->settings.autoExposure;
+	autoExposure.async = autoExposure.enabled && !this->settings.disableAsyncCompute;
 }
 
 VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pDebugMessenger) {
@@ -285,6 +380,26 @@ void VulkanApp::loadExtensionFunctions() {
     *(void**)&_vkCmdPipelineBarrier2KHR = (void*)vkGetInstanceProcAddr(instance, "vkCmdPipelineBarrier2KHR");
 }
 
+void VulkanApp::loadDynamicRenderingFunctions() {
+    // device-level entry points of the enabled extensions
+    *(void**)&dynamicRendering.cmdBeginRendering = (void*)vkGetDeviceProcAddr(device, "vkCmdBeginRenderingKHR");
+    *(void**)&dynamicRendering.cmdEndRendering = (void*)vkGetDeviceProcAddr(device, "vkCmdEndRenderingKHR");
+    *(void**)&dynamicRendering.cmdSetRenderingAttachmentLocations = (void*)vkGetDeviceProcAddr(device, "vkCmdSetRenderingAttachmentLocationsKHR");
+    *(void**)&dynamicRendering.cmdSetRenderingInputAttachmentIndices = (void*)vkGetDeviceProcAddr(device, "vkCmdSetRenderingInputAttachmentIndicesKHR");
+    if (!dynamicRendering.cmdBeginRendering || !dynamicRendering.cmdEndRendering ||
+        !dynamicRendering.cmdSetRenderingAttachmentLocations || !dynamicRendering.cmdSetRenderingInputAttachmentIndices) {
+        throw std::runtime_error("failed to load dynamic rendering functions");
+    }
+}
+
+void VulkanApp::loadConditionalRenderingFunctions() {
+    *(void**)&occlusion.cmdBeginConditionalRendering = (void*)vkGetDeviceProcAddr(device, "vkCmdBeginConditionalRenderingEXT");
+    *(void**)&occlusion.cmdEndConditionalRendering = (void*)vkGetDeviceProcAddr(device, "vkCmdEndConditionalRenderingEXT");
+    if (!occlusion.cmdBeginConditionalRendering || !occlusion.cmdEndConditionalRendering) {
+        throw std::runtime_error("failed to load conditional rendering functions");
+    }
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanApp::debugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -400,6 +515,70 @@ bool VulkanApp::checkDeviceExtensionSupport(VkPhysicalDevice device) {
 
 }
 
+bool VulkanApp::checkDynamicRenderingSupport(VkPhysicalDevice device) {
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> supportedExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, supportedExtensions.data());
+
+        for (const char* extension : dynamicRenderingExtensions) {
+            bool extensionFound = false;
+            for (const VkExtensionProperties& supportedExtension : supportedExtensions) {
+                if (strcmp(extension, supportedExtension.extensionName) == 0) {
+                    extensionFound = true;
+                    break;
+                }
+            }
+            if (!extensionFound) {
+                std::cout << "optional device extension is not supported: " << extension << '\n';
+                return false;
+            }
+        }
+
+        // extensions can be exposed without the features
+        VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR localReadFeatures{};
+        localReadFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR;
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+        dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+        dynamicRenderingFeatures.pNext = &localReadFeatures;
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &dynamicRenderingFeatures;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        return dynamicRenderingFeatures.dynamicRendering == VK_TRUE && localReadFeatures.dynamicRenderingLocalRead == VK_TRUE;
+}
+
+bool VulkanApp::checkConditionalRenderingSupport(VkPhysicalDevice device) {
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> supportedExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, supportedExtensions.data());
+
+        bool extensionFound = false;
+        for (const VkExtensionProperties& supportedExtension : supportedExtensions) {
+            if (strcmp(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME, supportedExtension.extensionName) == 0) {
+                extensionFound = true;
+                break;
+            }
+        }
+        if (!extensionFound) {
+            std::cout << "optional device extension is not supported: " << VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME << '\n';
+            return false;
+        }
+
+        VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures{};
+        conditionalRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &conditionalRenderingFeatures;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        return conditionalRenderingFeatures.conditionalRendering == VK_TRUE;
+}
+
 VulkanApp::SwapChainSupportDetails VulkanApp::querySwapChainSupport(VkPhysicalDevice device) {
         SwapChainSupportDetails details;
         // get device surface capabilities (amount of images, width/height)
@@ -540,28 +719,172 @@ void VulkanApp::createLogicalDeviceAndQueues() {
             queueFamilyIndices.transferFamilyIndex.value()
         };
 
+        // compute queue: the first queue of the compute family, unless auto exposure runs async (--auto-exposure without
+        // --no-async-compute): then the first compute family without graphics (dedicated async compute hardware queue), else a
+        // second queue of the compute family if it has one, else its first queue (submissions then only interleave on the one queue)
+        computeQueueFamily = queueFamilyIndices.computeFamilyIndex.value();
+        computeQueueIndex = 0;
+        if (autoExposure.async) {
+            uint32_t queueFamilyCount = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+            std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+            computeQueueIndex = (queueFamilyProperties[computeQueueFamily].queueCount > 1) ? 1 : 0;
+            for (uint32_t family = 0; family < queueFamilyCount; family++) {
+                if ((queueFamilyProperties[family].queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamilyProperties[family].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                    computeQueueFamily = family;
+                    computeQueueIndex = 0;
+                    break;
+                }
+            }
+            uniqueQueueFamilies.insert(computeQueueFamily);
+        }
+
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 
-        float queuePriority = 1.0f;
+        float queuePriorities[] = { 1.0f, 1.0f };
         for (uint32_t queueFamilyIndex : uniqueQueueFamilies) {
             VkDeviceQueueCreateInfo queueCreateInfo{};
             queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = queueFamilyIndex;
-            queueCreateInfo.queueCount = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfo.queueCount = (queueFamilyIndex == computeQueueFamily) ? computeQueueIndex + 1 : 1;
+            queueCreateInfo.pQueuePriorities = queuePriorities;
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
         VkPhysicalDeviceFeatures deviceFeatures{};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+        // fx/decal volume draws (optional): depth-bounds test of the decal, fragment shader invocation statistics
+        VkPhysicalDeviceFeatures supportedFeatures{};
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+        volumeDraws.depthBoundsTest = !settings.disableVolumeBounds && supportedFeatures.depthBounds == VK_TRUE;
+        // (not in a multiview render pass: a query there takes one result per view, the pool has one per draw)
+        volumeDraws.statisticsQueries = supportedFeatures.pipelineStatisticsQuery == VK_TRUE && !multiview.enabled;
+        deviceFeatures.depthBounds = volumeDraws.depthBoundsTest ? VK_TRUE : VK_FALSE;
+        deviceFeatures.pipelineStatisticsQuery = volumeDraws.statisticsQueries ? VK_TRUE : VK_FALSE;
+        // decal stencil mask (volume decal path only): needs a depth format with a stencil aspect
+        volumeDraws.decalStencil = settings.volumeDecals && !settings.disableDecalStencil && formatSupportsStencil(findSupportedDepthFormat());
+
+        // scene sample count (optional): the largest count up to settings.msaaSamples that color and depth attachments support
+        // (for float color formats the image format limits include framebufferColorSampleCounts). depth is resolved with
+        // SAMPLE_ZERO, which every device supporting depth/stencil resolve (core in Vulkan 1.2) has to support; the stencil aspect is
+        // not resolved (depth0's stencil is the composition pass's decal mask), which needs independentResolveNone for stencil formats
+        if (msaa.enabled) {
+            VkPhysicalDeviceDepthStencilResolveProperties depthResolveProperties{};
+            depthResolveProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEPTH_STENCIL_RESOLVE_PROPERTIES;
+            VkPhysicalDeviceProperties2 deviceProperties2{};
+            deviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            deviceProperties2.pNext = &depthResolveProperties;
+            vkGetPhysicalDeviceProperties2(physicalDevice, &deviceProperties2);
+            VkSampleCountFlags supportedCounts = deviceProperties2.properties.limits.framebufferColorSampleCounts & deviceProperties2.properties.limits.framebufferDepthSampleCounts;
+            for (VkSampleCountFlagBits count : { VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT }) {
+                if (count <= settings.msaaSamples && (supportedCounts & count)) {
+                    msaa.samples = count;
+                    break;
+                }
+            }
+            bool depthResolveSupported = (depthResolveProperties.supportedDepthResolveModes & VK_RESOLVE_MODE_SAMPLE_ZERO_BIT)
+                && (!formatSupportsStencil(findSupportedDepthFormat()) || depthResolveProperties.independentResolveNone == VK_TRUE);
+            if (msaa.samples == VK_SAMPLE_COUNT_1_BIT || !depthResolveSupported) {
+                std::cout << "--msaa ignored: no supported sample count up to " << settings.msaaSamples << " with depth resolve" << '\n';
+                msaa.enabled = false;
+                msaa.samples = VK_SAMPLE_COUNT_1_BIT;
+            }
+            else {
+                std::cout << "scene multisampling: " << msaa.samples << " samples, resolved in the scene subpass" << '\n';
+            }
+        }
+
+        // dynamic rendering backend (optional): separate render passes (settings.multiPass), the OIT and the deferred lighting subpasses,
+        // the multisample resolves of the scene subpass, the multiview render pass, the auto exposure copy and the bloom chain (col0 left
+        // in TRANSFER_SRC_OPTIMAL/SHADER_READ_ONLY_OPTIMAL by the final layout) are only implemented with VkRenderPass
+        std::vector<const char*> enabledExtensions = deviceExtensions;
+        dynamicRendering.enabled = !settings.multiPass && !oit.enabled && !deferred.enabled && !msaa.enabled && !multiview.enabled && !autoExposure.enabled && !bloom.enabled && !settings.disableDynamicRendering && checkDynamicRenderingSupport(physicalDevice);
+
+        VkPhysicalDeviceDynamicRenderingLocalReadFeaturesKHR localReadFeatures{};
+        localReadFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_LOCAL_READ_FEATURES_KHR;
+        localReadFeatures.dynamicRenderingLocalRead = VK_TRUE;
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+        dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+        dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+        dynamicRenderingFeatures.pNext = &localReadFeatures;
+
         VkDeviceCreateInfo deviceCreateInfo{};
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
         deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-        deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-        deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        if (dynamicRendering.enabled) {
+            enabledExtensions.insert(enabledExtensions.end(), dynamicRenderingExtensions.begin(), dynamicRenderingExtensions.end());
+            deviceCreateInfo.pNext = &dynamicRenderingFeatures;
+        }
+
+        // GPU-driven fx draw (optional): the draw count read from the cull buffer needs drawIndirectCount (Vulkan 1.2),
+        // without it the fx draw is one indirect draw whose instance count is the visible count.
+        // async auto exposure: the graphics and compute submissions are ordered by timeline semaphores (Vulkan 1.2)
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+        supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        if (settings.gpuCulling || autoExposure.async) {
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+            if (deviceProperties.apiVersion >= VK_MAKE_VERSION(1, 2, 0)) {
+                VkPhysicalDeviceFeatures2 features{};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features.pNext = &supportedVulkan12Features;
+                vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+            }
+        }
+        if (settings.gpuCulling) {
+            fxCull.drawIndirectCount = supportedVulkan12Features.drawIndirectCount == VK_TRUE;
+            vulkan12Features.drawIndirectCount = fxCull.drawIndirectCount ? VK_TRUE : VK_FALSE;
+            std::cout << "fx draw: gpu-driven (" << (fxCull.drawIndirectCount ? "indirect draw count" : "indirect draw, drawIndirectCount not supported") << ")" << '\n';
+        }
+        if (autoExposure.async) {
+            if (supportedVulkan12Features.timelineSemaphore != VK_TRUE) {
+                throw std::runtime_error("failed to enable timeline semaphores for --auto-exposure: not supported by the device (use --no-async-compute)");
+            }
+            vulkan12Features.timelineSemaphore = VK_TRUE;
+        }
+        if (vulkan12Features.drawIndirectCount || vulkan12Features.timelineSemaphore) {
+            vulkan12Features.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+            deviceCreateInfo.pNext = &vulkan12Features;
+        }
+
+        // multiview stereo: VK_KHR_multiview is core in Vulkan 1.1 (and its multiview feature mandatory there), only the feature is enabled
+        VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+        multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+        if (multiview.enabled) {
+            VkPhysicalDeviceMultiviewFeatures supportedMultiviewFeatures{};
+            supportedMultiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = &supportedMultiviewFeatures;
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+            if (supportedMultiviewFeatures.multiview != VK_TRUE) {
+                throw std::runtime_error("failed to enable multiview for --stereo: not supported by the device");
+            }
+            multiviewFeatures.multiview = VK_TRUE;
+            multiviewFeatures.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+            deviceCreateInfo.pNext = &multiviewFeatures;
+            std::cout << "multiview stereo: " << multiview.viewCount << " views per draw, shown side by side" << '\n';
+        }
+
+        // occlusion queries (optional): the GPU skips the draws of hidden volumes with VK_EXT_conditional_rendering,
+        // without it the CPU reads the query results back and leaves those draws out of the command buffer
+        VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalRenderingFeatures{};
+        conditionalRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT;
+        if (occlusion.enabled && checkConditionalRenderingSupport(physicalDevice)) {
+            occlusion.conditionalRendering = true;
+            enabledExtensions.push_back(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME);
+            conditionalRenderingFeatures.conditionalRendering = VK_TRUE;
+            conditionalRenderingFeatures.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+            deviceCreateInfo.pNext = &conditionalRenderingFeatures;
+        }
+        deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         if (enableExtensionLayers) {
             deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(layers.size());
@@ -581,11 +904,22 @@ void VulkanApp::createLogicalDeviceAndQueues() {
         // retrieve handle to newly created device queues
         vkGetDeviceQueue(device, queueFamilyIndices.graphicsFamilyIndex.value(), 0, &graphicsQueue);
         vkGetDeviceQueue(device, queueFamilyIndices.presentFamilyIndex.value(), 0, &presentQueue);
-        vkGetDeviceQueue(device, queueFamilyIndices.computeFamilyIndex.value(), 0, &computeQueue);
+        vkGetDeviceQueue(device, computeQueueFamily, computeQueueIndex, &computeQueue);
         vkGetDeviceQueue(device, queueFamilyIndices.transferFamilyIndex.value(), 0, &transferQueue);
 
         std::cout << "graphics, present and compute queues created" << '\n';
 
+        if (dynamicRendering.enabled) {
+            loadDynamicRenderingFunctions();
+        }
+        std::cout << "render backend: " << (dynamicRendering.enabled ? "dynamic rendering (local read)" : "render pass (subpasses)") << '\n';
+        if (occlusion.conditionalRendering) {
+            loadConditionalRenderingFunctions();
+        }
+        if (occlusion.enabled) {
+            std::cout << "occlusion queries: " << (occlusion.conditionalRendering ? "conditional rendering" : "cpu readback") << '\n';
+        }
+
 }
 
 void VulkanApp::createSurface() {
@@ -668,9 +1002,12 @@ void VulkanApp::createSwapChain() {
         swapchainCreateInfo.imageFormat = surfaceFormat.format;
         swapchainCreateInfo.imageColorSpace = surfaceFormat.colorSpace;
         swapchainCreateInfo.imageExtent = extent;
-        swapchainCreateInfo.imageArrayLayers = 1; // layers per image. set 2 for stereoscopic
+        swapchainCreateInfo.imageArrayLayers = 1; // layers per image. (multiview stereo: the eyes are shown side by side in one layer)
         swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; // render directly to swapchain image's color attachment
-        // can also set to VK_IMAGE_USAGE_TRANSFER_DST_BIT, for tranferring offscreen buffer data to swapchain images
+        // multiview stereo: the 2-layer offscreen output is blitted into the swapchain image instead
+        if (multiview.enabled) {
+            swapchainCreateInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
 
         /*
         VK_SHARING_MODE_EXCLUSIVE: An image is owned by one queue family at a time and ownership must be explicitly transferred before using it in another queue family. This option offers the best performance.
@@ -726,7 +1063,7 @@ void VulkanApp::createSwapChain() {
 
 }
 
-void VulkanApp::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags memProperties, VkImage& image, VkDeviceMemory& imageMemory, bool generalLayout) {
+void VulkanApp::createImage(uint32_t width, uint32_t height, VkSampleCountFlagBits samples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags memProperties, VkImage& image, VkDeviceMemory& imageMemory, bool generalLayout, uint32_t layers) {
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -734,7 +1071,7 @@ void VulkanApp::createImage(uint32_t width, uint32_t height, VkFormat format, Vk
         imageInfo.extent.height = height;
         imageInfo.extent.depth = 1;
         imageInfo.mipLevels = 1;
-        imageInfo.arrayLayers = 1;
+        imageInfo.arrayLayers = layers;
         imageInfo.format = format;
         imageInfo.tiling = tiling;
         if (generalLayout) {
@@ -744,7 +1081,7 @@ void VulkanApp::createImage(uint32_t width, uint32_t height, VkFormat format, Vk
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         }
         imageInfo.usage = usage;
-        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.samples = samples;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // share resource across queues
         /*
         QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice);
@@ -764,6 +1101,11 @@ void VulkanApp::createImage(uint32_t width, uint32_t height, VkFormat format, Vk
         allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         allocInfo.allocationSize = imageMemRequirements.size;
         VkMemoryPropertyFlags requiredMemProperties = memProperties;
+        if ((requiredMemProperties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) && !tryFindMemoryTypeIndex(imageSupportedMemTypes_Bitflags, requiredMemProperties, allocInfo.memoryTypeIndex)) {
+            // no lazily allocated memory (desktop GPUs): fall back to regular device-local memory
+            requiredMemProperties &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            std::cout << "lazily allocated memory not supported, using device-local memory for transient attachment" << '\n';
+        }
         allocInfo.memoryTypeIndex = findMemoryTypeIndex(imageSupportedMemTypes_Bitflags, requiredMemProperties);
 
         if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
@@ -774,13 +1116,13 @@ void VulkanApp::createImage(uint32_t width, uint32_t height, VkFormat format, Vk
 
 }
 
-void VulkanApp::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView& imageView) {
+void VulkanApp::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkImageView& imageView, uint32_t layers) {
 
         // create view for offscreen image
         VkImageViewCreateInfo viewCreateInfo{};
         viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewCreateInfo.image = image;
-        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.viewType = (layers > 1) ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
         viewCreateInfo.format = format;
         // can swizle view channels, or harcode a value (0/1)
         viewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -788,12 +1130,12 @@ void VulkanApp::createImageView(VkImage image, VkFormat format, VkImageAspectFla
         viewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
         viewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
         // view properties :
-        // in stereroscopic rendering, can set an image view per swapchain-image layer 
+        // multiview attachments: one view of all layers, the render pass's view mask selects the layer each view renders
         viewCreateInfo.subresourceRange.aspectMask = aspectFlags;
         viewCreateInfo.subresourceRange.baseMipLevel = 0;
         viewCreateInfo.subresourceRange.levelCount = 1;
         viewCreateInfo.subresourceRange.baseArrayLayer = 0;
-        viewCreateInfo.subresourceRange.layerCount = 1;
+        viewCreateInfo.subresourceRange.layerCount = layers;
 
         // create view from swapchain image
         VkResult viewCreated = vkCreateImageView(device, &viewCreateInfo, nullptr, &imageView);
@@ -811,19 +1153,80 @@ void VulkanApp::createImageResources() {
         }
    
         // create image+view for offscreen image attachment
-        VkImageUsageFlags usage0 = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
-        createImage(WIDTH, HEIGHT, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_TILING_OPTIMAL, usage0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, offscreenImage, offscreenImageMemory, false);
-        createImageView(offscreenImage, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, offscreenImageView);
-        
+        // usage derived by the render graph: transient attachments live in lazily allocated memory (on tile, if supported)
+        VkImageUsageFlags usage0 = renderGraph.getImageUsage("col0");
+        if (settings.multiPass) {
+            usage0 |= VK_IMAGE_USAGE_SAMPLED_BIT; // sampled by the composition render pass
+        }
+        if (autoExposure.enabled) {
+            usage0 |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT; // blitted into the luminance copy
+        }
+        if (bloom.enabled) {
+            usage0 |= VK_IMAGE_USAGE_SAMPLED_BIT; // read by the bloom bright pass
+        }
+        VkMemoryPropertyFlags memoryProperties0 = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        if (renderGraph.isTransient("col0")) {
+            memoryProperties0 |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        }
+        // (multiview stereo: the render pass's attachments have one layer per view)
+        uint32_t layers = renderGraph.getViewCount();
+        createImage(WIDTH, HEIGHT, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_TILING_OPTIMAL, usage0, memoryProperties0, offscreenImage, offscreenImageMemory, false, layers);
+        createImageView(offscreenImage, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, offscreenImageView, layers);
+
+        // multiview stereo: col1 is offscreen (one layer per eye, blitted side by side into the swapchain image after the render pass)
+        if (multiview.enabled) {
+            createImage(swapChainExtent.width, swapChainExtent.height, VK_SAMPLE_COUNT_1_BIT, swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("col1") | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, multiview.outputImage, multiview.outputMemory, false, layers);
+            createImageView(multiview.outputImage, swapChainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT, multiview.outputView, layers);
+        }
+
+        // multisampled scene color (transient: only resolved into col0)
+        if (msaa.enabled) {
+            VkMemoryPropertyFlags msaaMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            if (renderGraph.isTransient("col0MS")) {
+                msaaMemoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            }
+            createImage(WIDTH, HEIGHT, msaa.samples, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("col0MS"), msaaMemoryProperties, msaa.colorImage, msaa.colorMemory, false, layers);
+            createImageView(msaa.colorImage, VK_FORMAT_R32G32B32A32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, msaa.colorView, layers);
+        }
+
+        // OIT accumulation/revealage attachments (transient: only read by the resolve subpass)
+        if (oit.enabled) {
+            VkMemoryPropertyFlags oitMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            if (renderGraph.isTransient("oitAccum") && renderGraph.isTransient("oitReveal")) {
+                oitMemoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            }
+            createImage(WIDTH, HEIGHT, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("oitAccum"), oitMemoryProperties, oit.accumImage, oit.accumMemory, false, layers);
+            createImageView(oit.accumImage, VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, oit.accumView, layers);
+            createImage(WIDTH, HEIGHT, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8_UNORM, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("oitReveal"), oitMemoryProperties, oit.revealImage, oit.revealMemory, false, layers);
+            createImageView(oit.revealImage, VK_FORMAT_R8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, oit.revealView, layers);
+        }
+
+        // deferred G-buffer attachments (transient: only read by the lighting subpass)
+        if (deferred.enabled) {
+            VkMemoryPropertyFlags gbufferMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            if (renderGraph.isTransient("gAlbedo") && renderGraph.isTransient("gNormal")) {
+                gbufferMemoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            }
+            createImage(WIDTH, HEIGHT, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("gAlbedo"), gbufferMemoryProperties, deferred.albedoImage, deferred.albedoMemory, false);
+            createImageView(deferred.albedoImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, deferred.albedoView);
+            createImage(WIDTH, HEIGHT, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R16G16_SFLOAT, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("gNormal"), gbufferMemoryProperties, deferred.normalImage, deferred.normalMemory, false);
+            createImageView(deferred.normalImage, VK_FORMAT_R16G16_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, deferred.normalView);
+        }
 }
 
 
+void VulkanApp::decodeTexture() {
+    // decode texture file to texturePixels (CPU only, runs in parallel with device setup)
+    texturePixels = stbi_load(TEXTURE_PATH_0, &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
+    if (!texturePixels) { throw std::runtime_error("failed to load texture data from image file " + std::string(TEXTURE_PATH_0)); }
+    std::cout << "texture decoded" << '\n';
+}
+
 void VulkanApp::createTextureImageResources() {
     // create image+view for texture
      // ------------------------------------
-     // load texture to textureData
-    stbi_uc* textureData = stbi_load(TEXTURE_PATH_0, &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
-    if (!textureData) { throw std::runtime_error("failed to load texture data from image file " + std::string(TEXTURE_PATH_0)); }
+     // upload texturePixels (see decodeTexture())
     VkDeviceSize textureSize = textureWidth * textureHeight * 4;
 
     // copy image data to staging buffer, then copy to device-local image
@@ -834,14 +1237,15 @@ void VulkanApp::createTextureImageResources() {
     createGraphicsBuffer(textureSize, stagingBufferUsageBitflags, stagingBufferMemPropertiesBitflags, stagingBuffer0, stagingBufferMemory0);
     void* data0;
     vkMapMemory(device, stagingBufferMemory0, 0, textureSize, 0, &data0); // (access region of specified GPU memory, at given offset, and size, 0, output pointer to memory)
-    memcpy(data0, textureData, (size_t)textureSize); // copy data to GPU memory (happens in the background, before next vkSubmitQueue
+    memcpy(data0, texturePixels, (size_t)textureSize); // copy data to GPU memory (happens in the background, before next vkSubmitQueue
     vkUnmapMemory(device, stagingBufferMemory0);
 
-    stbi_image_free(textureData);
+    stbi_image_free(texturePixels);
+    texturePixels = nullptr;
 
     // create image in device-local memory
     VkImageUsageFlags usage1 = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT; // will be used as destination for stagingbuffer copy, and for shader sampling
-    createImage(textureWidth, textureHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, usage1, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, false);
+    createImage(textureWidth, textureHeight, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, usage1, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, false);
     createImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, textureImageView);
 
     // transition image layout to transfer layout
@@ -893,6 +1297,7 @@ bool VulkanApp::formatSupportsStencil(VkFormat format) {
         if (format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT) {
             return true;
         }
+        return false;
 }
 
 /*
@@ -1071,10 +1476,32 @@ void VulkanApp::transitionImageLayoutSync2(VkImage image, VkFormat format, VkIma
 
 void VulkanApp::createDepthResources() {
     VkFormat depthSupportedFormat = findSupportedDepthFormat();
-    VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    VkImageUsageFlags usage = renderGraph.getImageUsage("depth0");
+    if (settings.multiPass || hiZ.enabled) {
+        usage |= VK_IMAGE_USAGE_SAMPLED_BIT; // (Hi-Z: level 0 of the pyramid is reduced from depth0)
+    }
     VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT; // allocate using device-local memory
-    createImage(swapChainExtent.width, swapChainExtent.height, depthSupportedFormat, VK_IMAGE_TILING_OPTIMAL, usage, memoryProperties, depthImage, depthImageMemory, false);
-    createImageView(depthImage, depthSupportedFormat, VK_IMAGE_ASPECT_DEPTH_BIT, depthImageView);
+    if (renderGraph.isTransient("depth0")) {
+        memoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    }
+    uint32_t layers = renderGraph.getViewCount(); // (multiview stereo: one layer per view)
+    createImage(swapChainExtent.width, swapChainExtent.height, VK_SAMPLE_COUNT_1_BIT, depthSupportedFormat, VK_IMAGE_TILING_OPTIMAL, usage, memoryProperties, depthImage, depthImageMemory, false, layers);
+    createImageView(depthImage, depthSupportedFormat, VK_IMAGE_ASPECT_DEPTH_BIT, depthImageView, layers);
+    // the attachment view covers both aspects (decal stencil mask), descriptors of a depth/stencil image have to select one
+    VkImageAspectFlags attachmentAspects = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (formatSupportsStencil(depthSupportedFormat)) {
+        attachmentAspects |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    createImageView(depthImage, depthSupportedFormat, attachmentAspects, depthStencilImageView, layers);
+    // multisampled scene depth (transient: only resolved into depth0)
+    if (msaa.enabled) {
+        VkMemoryPropertyFlags msaaMemoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        if (renderGraph.isTransient("depth0MS")) {
+            msaaMemoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        }
+        createImage(swapChainExtent.width, swapChainExtent.height, msaa.samples, depthSupportedFormat, VK_IMAGE_TILING_OPTIMAL, renderGraph.getImageUsage("depth0MS"), msaaMemoryProperties, msaa.depthImage, msaa.depthMemory, false, layers);
+        createImageView(msaa.depthImage, depthSupportedFormat, attachmentAspects, msaa.depthView, layers);
+    }
     // on first subpass where depth0 is used, transition image layout to "VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL".
         // block following depth-read/write operations (in early fragment-test stage of pipeline), until layout transition is finished.
     //transitionImageLayout(depthImage, depthSupportedFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
@@ -1083,6 +1510,30 @@ void VulkanApp::createDepthResources() {
 
 void VulkanApp::createDescriptorSetLayouts() {
 
+        // col0/depth0 are read with subpassLoad (input attachments), or with texelFetch in separate render passes
+        VkDescriptorType inputDescriptorType = settings.multiPass ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+
+        // -------------------
+        // Layout for DescriptorSets.frame (set 0 of every pipeline layout): per-frame camera/global uniforms
+        VkDescriptorSetLayoutBinding frameDescriptorSetLayoutBinding0{};
+        frameDescriptorSetLayoutBinding0.binding = 0;
+        frameDescriptorSetLayoutBinding0.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        frameDescriptorSetLayoutBinding0.descriptorCount = 1;
+        frameDescriptorSetLayoutBinding0.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT; // (compute: fx sort)
+        frameDescriptorSetLayoutBinding0.pImmutableSamplers = nullptr;
+
+        std::array<VkDescriptorSetLayoutBinding, 1> frameSetBindings = { frameDescriptorSetLayoutBinding0 };
+
+        VkDescriptorSetLayoutCreateInfo frameSetLayout{};
+        frameSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        frameSetLayout.bindingCount = static_cast<uint32_t>(frameSetBindings.size());
+        frameSetLayout.pBindings = frameSetBindings.data();
+
+        VkResult frameDescriptorSetLayoutCreated = vkCreateDescriptorSetLayout(device, &frameSetLayout, nullptr, &descriptorSetLayouts.frame);
+        if (frameDescriptorSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
         // -------------------
         // Layout for DescriptorSets.scene
         VkDescriptorSetLayoutBinding sceneDescriptorSetLayoutBinding0{}; // sceneTransform
@@ -1108,12 +1559,23 @@ void VulkanApp::createDescriptorSetLayouts() {
         // Layout for DescriptorSets.composition
         VkDescriptorSetLayoutBinding compositionDescriptorSetLayoutBinding0{};
         compositionDescriptorSetLayoutBinding0.binding = 0;
-        compositionDescriptorSetLayoutBinding0.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        compositionDescriptorSetLayoutBinding0.descriptorType = inputDescriptorType;
         compositionDescriptorSetLayoutBinding0.descriptorCount = 1;
         compositionDescriptorSetLayoutBinding0.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         compositionDescriptorSetLayoutBinding0.pImmutableSamplers = nullptr;
 
-        std::array<VkDescriptorSetLayoutBinding, 1> compositionSetBindings = { compositionDescriptorSetLayoutBinding0 };
+        std::vector<VkDescriptorSetLayoutBinding> compositionSetBindings = { compositionDescriptorSetLayoutBinding0 };
+
+        // layout(set = 1, binding = 1) uniform sampler2D inputBloomTexture (bloom.enabled only)
+        if (bloom.enabled) {
+            VkDescriptorSetLayoutBinding compositionDescriptorSetLayoutBinding1{};
+            compositionDescriptorSetLayoutBinding1.binding = 1;
+            compositionDescriptorSetLayoutBinding1.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            compositionDescriptorSetLayoutBinding1.descriptorCount = 1;
+            compositionDescriptorSetLayoutBinding1.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            compositionDescriptorSetLayoutBinding1.pImmutableSamplers = nullptr;
+            compositionSetBindings.push_back(compositionDescriptorSetLayoutBinding1);
+        }
 
         VkDescriptorSetLayoutCreateInfo compositionSetLayout{};
         compositionSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -1126,10 +1588,10 @@ void VulkanApp::createDescriptorSetLayouts() {
         }
 
         // --------------
-        // Create 2 Descriptor Set Layouts for DescriptorSets.fx
+        // Create 2 Descriptor Set Layouts for DescriptorSets.fx (bound at set 1 and 2, after DescriptorSets.frame)
 
-        // Set 0 Layout 
-        // (set = 0, binding 0)
+        // Set 1 Layout 
+        // (set = 1, binding 0)
         VkDescriptorSetLayoutBinding fxDescriptorSet0LayoutBinding0{};
         fxDescriptorSet0LayoutBinding0.binding = 0;
         fxDescriptorSet0LayoutBinding0.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -1137,10 +1599,22 @@ void VulkanApp::createDescriptorSetLayouts() {
         fxDescriptorSet0LayoutBinding0.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
         fxDescriptorSet0LayoutBinding0.pImmutableSamplers = nullptr;
 
-        VkDescriptorSetLayoutBinding fxSet0LayoutBindings[] = { fxDescriptorSet0LayoutBinding0};
+        // (set = 1, binding 1): fx instances
+        VkDescriptorSetLayoutBinding fxDescriptorSet0LayoutBinding1{};
+        fxDescriptorSet0LayoutBinding1.binding = 1;
+        fxDescriptorSet0LayoutBinding1.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        fxDescriptorSet0LayoutBinding1.descriptorCount = 1;
+        fxDescriptorSet0LayoutBinding1.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        fxDescriptorSet0LayoutBinding1.pImmutableSamplers = nullptr;
+
+        // (set = 1, binding 2): fx draw order
+        VkDescriptorSetLayoutBinding fxDescriptorSet0LayoutBinding2 = fxDescriptorSet0LayoutBinding1;
+        fxDescriptorSet0LayoutBinding2.binding = 2;
+
+        VkDescriptorSetLayoutBinding fxSet0LayoutBindings[] = { fxDescriptorSet0LayoutBinding0, fxDescriptorSet0LayoutBinding1, fxDescriptorSet0LayoutBinding2 };
         VkDescriptorSetLayoutCreateInfo fxSet0Layout{};
         fxSet0Layout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        fxSet0Layout.bindingCount = 1;
+        fxSet0Layout.bindingCount = 3;
         fxSet0Layout.pBindings = fxSet0LayoutBindings;
 
         VkResult fxDescriptorSet0LayoutCreated = vkCreateDescriptorSetLayout(device, &fxSet0Layout, nullptr, &descriptorSetLayouts.fx0);
@@ -1148,18 +1622,18 @@ void VulkanApp::createDescriptorSetLayouts() {
             throw std::runtime_error("failed to created descriptor set layout");
         }
 
-        // Set 1 Layout 
-        // (set = 1, binding 0)
+        // Set 2 Layout 
+        // (set = 2, binding 0)
         VkDescriptorSetLayoutBinding fxDescriptorSet1LayoutBinding0{};
         fxDescriptorSet1LayoutBinding0.binding = 0;
-        fxDescriptorSet1LayoutBinding0.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        fxDescriptorSet1LayoutBinding0.descriptorType = inputDescriptorType;
         fxDescriptorSet1LayoutBinding0.descriptorCount = 1;
         fxDescriptorSet1LayoutBinding0.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         fxDescriptorSet1LayoutBinding0.pImmutableSamplers = nullptr;
-        // (set = 1, binding 1)
+        // (set = 2, binding 1)
         VkDescriptorSetLayoutBinding fxDescriptorSet1LayoutBinding1{};
         fxDescriptorSet1LayoutBinding1.binding = 1;
-        fxDescriptorSet1LayoutBinding1.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        fxDescriptorSet1LayoutBinding1.descriptorType = inputDescriptorType;
         fxDescriptorSet1LayoutBinding1.descriptorCount = 1;
         fxDescriptorSet1LayoutBinding1.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         fxDescriptorSet1LayoutBinding1.pImmutableSamplers = nullptr;
@@ -1174,11 +1648,272 @@ void VulkanApp::createDescriptorSetLayouts() {
         if (fxDescriptorSet1LayoutCreated != VK_SUCCESS) {
             throw std::runtime_error("failed to created descriptor set layout");
         }
+
+        // --------------
+        // Layout for DescriptorSets.decal (set 1 of the tiled decal pipeline): decals, tileRanges, decalIndices, activeTiles
+        std::array<VkDescriptorSetLayoutBinding, 4> decalSetBindings{};
+        for (uint32_t binding = 0; binding < decalSetBindings.size(); binding++) {
+            decalSetBindings[binding].binding = binding;
+            decalSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            decalSetBindings[binding].descriptorCount = 1;
+            decalSetBindings[binding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            decalSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+        decalSetBindings[3].stageFlags = VK_SHADER_STAGE_VERTEX_BIT; // activeTiles: tile of each instance
+
+        VkDescriptorSetLayoutCreateInfo decalSetLayout{};
+        decalSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        decalSetLayout.bindingCount = static_cast<uint32_t>(decalSetBindings.size());
+        decalSetLayout.pBindings = decalSetBindings.data();
+
+        VkResult decalSetLayoutCreated = vkCreateDescriptorSetLayout(device, &decalSetLayout, nullptr, &descriptorSetLayouts.decal);
+        if (decalSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Create Descriptor Set Layout for DescriptorSets.fxSort (compute, bound at set 1 after DescriptorSets.frame)
+        // (set = 1, binding 0..2): fx instances, sort keys, sort values
+        std::array<VkDescriptorSetLayoutBinding, 3> fxSortSetBindings{};
+        for (uint32_t binding = 0; binding < fxSortSetBindings.size(); binding++) {
+            fxSortSetBindings[binding].binding = binding;
+            fxSortSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            fxSortSetBindings[binding].descriptorCount = 1;
+            fxSortSetBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            fxSortSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo fxSortSetLayout{};
+        fxSortSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        fxSortSetLayout.bindingCount = static_cast<uint32_t>(fxSortSetBindings.size());
+        fxSortSetLayout.pBindings = fxSortSetBindings.data();
+
+        VkResult fxSortSetLayoutCreated = vkCreateDescriptorSetLayout(device, &fxSortSetLayout, nullptr, &descriptorSetLayouts.fxSort);
+        if (fxSortSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Create Descriptor Set Layout for DescriptorSets.fxCull (compute, bound at set 1 after DescriptorSets.frame)
+        // (set = 1, binding 0..3): fx instances, draw order, draw command and count, visible order
+        std::array<VkDescriptorSetLayoutBinding, 4> fxCullSetBindings{};
+        for (uint32_t binding = 0; binding < fxCullSetBindings.size(); binding++) {
+            fxCullSetBindings[binding].binding = binding;
+            fxCullSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            fxCullSetBindings[binding].descriptorCount = 1;
+            fxCullSetBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            fxCullSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo fxCullSetLayout{};
+        fxCullSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        fxCullSetLayout.bindingCount = static_cast<uint32_t>(fxCullSetBindings.size());
+        fxCullSetLayout.pBindings = fxCullSetBindings.data();
+
+        VkResult fxCullSetLayoutCreated = vkCreateDescriptorSetLayout(device, &fxCullSetLayout, nullptr, &descriptorSetLayouts.fxCull);
+        if (fxCullSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Create Descriptor Set Layout for DescriptorSets.hiZBuild (compute, the only set of the pyramid reduction)
+        // (set = 0, binding 0): source level (depth0 for level 0), (binding 1): destination level
+        std::array<VkDescriptorSetLayoutBinding, 2> hiZBuildSetBindings{};
+        for (uint32_t binding = 0; binding < hiZBuildSetBindings.size(); binding++) {
+            hiZBuildSetBindings[binding].binding = binding;
+            hiZBuildSetBindings[binding].descriptorCount = 1;
+            hiZBuildSetBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            hiZBuildSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+        hiZBuildSetBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        hiZBuildSetBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+        VkDescriptorSetLayoutCreateInfo hiZBuildSetLayout{};
+        hiZBuildSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        hiZBuildSetLayout.bindingCount = static_cast<uint32_t>(hiZBuildSetBindings.size());
+        hiZBuildSetLayout.pBindings = hiZBuildSetBindings.data();
+
+        VkResult hiZBuildSetLayoutCreated = vkCreateDescriptorSetLayout(device, &hiZBuildSetLayout, nullptr, &descriptorSetLayouts.hiZBuild);
+        if (hiZBuildSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Create Descriptor Set Layout for DescriptorSets.hiZCull (compute, bound at set 2 of the fx cull dispatch)
+        // (set = 2, binding 0): depth pyramid, (binding 1): cull statistics
+        std::array<VkDescriptorSetLayoutBinding, 2> hiZCullSetBindings{};
+        for (uint32_t binding = 0; binding < hiZCullSetBindings.size(); binding++) {
+            hiZCullSetBindings[binding].binding = binding;
+            hiZCullSetBindings[binding].descriptorCount = 1;
+            hiZCullSetBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            hiZCullSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+        hiZCullSetBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        hiZCullSetBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+        VkDescriptorSetLayoutCreateInfo hiZCullSetLayout{};
+        hiZCullSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        hiZCullSetLayout.bindingCount = static_cast<uint32_t>(hiZCullSetBindings.size());
+        hiZCullSetLayout.pBindings = hiZCullSetBindings.data();
+
+        VkResult hiZCullSetLayoutCreated = vkCreateDescriptorSetLayout(device, &hiZCullSetLayout, nullptr, &descriptorSetLayouts.hiZCull);
+        if (hiZCullSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Layout for DescriptorSets.oitResolve (set 1 of the OIT resolve pipeline)
+        // (set = 1, binding 0..1): oitAccum, oitReveal input attachments
+        std::array<VkDescriptorSetLayoutBinding, 2> oitResolveSetBindings{};
+        for (uint32_t binding = 0; binding < oitResolveSetBindings.size(); binding++) {
+            oitResolveSetBindings[binding].binding = binding;
+            oitResolveSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            oitResolveSetBindings[binding].descriptorCount = 1;
+            oitResolveSetBindings[binding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            oitResolveSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo oitResolveSetLayout{};
+        oitResolveSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        oitResolveSetLayout.bindingCount = static_cast<uint32_t>(oitResolveSetBindings.size());
+        oitResolveSetLayout.pBindings = oitResolveSetBindings.data();
+
+        VkResult oitResolveSetLayoutCreated = vkCreateDescriptorSetLayout(device, &oitResolveSetLayout, nullptr, &descriptorSetLayouts.oitResolve);
+        if (oitResolveSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Layout for DescriptorSets.lighting (set 1 of the deferred lighting pipeline)
+        // (set = 1, binding 0..2): gAlbedo, gNormal, depth0 input attachments, (binding 3): visible lights
+        std::array<VkDescriptorSetLayoutBinding, 4> lightingSetBindings{};
+        for (uint32_t binding = 0; binding < lightingSetBindings.size(); binding++) {
+            lightingSetBindings[binding].binding = binding;
+            lightingSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            lightingSetBindings[binding].descriptorCount = 1;
+            lightingSetBindings[binding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            lightingSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+        lightingSetBindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        lightingSetBindings[3].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT; // screen rectangle, light parameters
+
+        VkDescriptorSetLayoutCreateInfo lightingSetLayout{};
+        lightingSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        lightingSetLayout.bindingCount = static_cast<uint32_t>(lightingSetBindings.size());
+        lightingSetLayout.pBindings = lightingSetBindings.data();
+
+        VkResult lightingSetLayoutCreated = vkCreateDescriptorSetLayout(device, &lightingSetLayout, nullptr, &descriptorSetLayouts.lighting);
+        if (lightingSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Layout for DescriptorSets.clusters (set 2 of the scene pipeline, clustered forward shading)
+        // (set = 2, binding 0..2): lights, cluster ranges, cluster light indices
+        std::array<VkDescriptorSetLayoutBinding, 3> clusterSetBindings{};
+        for (uint32_t binding = 0; binding < clusterSetBindings.size(); binding++) {
+            clusterSetBindings[binding].binding = binding;
+            clusterSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            clusterSetBindings[binding].descriptorCount = 1;
+            clusterSetBindings[binding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            clusterSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo clusterSetLayout{};
+        clusterSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        clusterSetLayout.bindingCount = static_cast<uint32_t>(clusterSetBindings.size());
+        clusterSetLayout.pBindings = clusterSetBindings.data();
+
+        VkResult clusterSetLayoutCreated = vkCreateDescriptorSetLayout(device, &clusterSetLayout, nullptr, &descriptorSetLayouts.clusters);
+        if (clusterSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Layout for DescriptorSets.shadows (set 3 of the scene pipeline, shadow map)
+        // (set = 3, binding 0): light uniforms (also read by the shadow map pass), (binding 1): shadow map, comparison sampler
+        std::array<VkDescriptorSetLayoutBinding, 2> shadowSetBindings{};
+        shadowSetBindings[0].binding = 0;
+        shadowSetBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        shadowSetBindings[0].descriptorCount = 1;
+        shadowSetBindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        shadowSetBindings[0].pImmutableSamplers = nullptr;
+        shadowSetBindings[1].binding = 1;
+        shadowSetBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        shadowSetBindings[1].descriptorCount = 1;
+        shadowSetBindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        shadowSetBindings[1].pImmutableSamplers = nullptr;
+
+        VkDescriptorSetLayoutCreateInfo shadowSetLayout{};
+        shadowSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        shadowSetLayout.bindingCount = static_cast<uint32_t>(shadowSetBindings.size());
+        shadowSetLayout.pBindings = shadowSetBindings.data();
+
+        VkResult shadowSetLayoutCreated = vkCreateDescriptorSetLayout(device, &shadowSetLayout, nullptr, &descriptorSetLayouts.shadows);
+        if (shadowSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Layout for DescriptorSets.autoExposure (auto exposure dispatch)
+        // (set = 0, binding 0): luminance copy, (binding 1): result (read back), (binding 2): exposure state
+        std::array<VkDescriptorSetLayoutBinding, 3> autoExposureSetBindings{};
+        autoExposureSetBindings[0].binding = 0;
+        autoExposureSetBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        autoExposureSetBindings[0].descriptorCount = 1;
+        autoExposureSetBindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        autoExposureSetBindings[0].pImmutableSamplers = nullptr;
+        for (uint32_t binding = 1; binding < 3; binding++) {
+            autoExposureSetBindings[binding].binding = binding;
+            autoExposureSetBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            autoExposureSetBindings[binding].descriptorCount = 1;
+            autoExposureSetBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            autoExposureSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo autoExposureSetLayout{};
+        autoExposureSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        autoExposureSetLayout.bindingCount = static_cast<uint32_t>(autoExposureSetBindings.size());
+        autoExposureSetLayout.pBindings = autoExposureSetBindings.data();
+
+        VkResult autoExposureSetLayoutCreated = vkCreateDescriptorSetLayout(device, &autoExposureSetLayout, nullptr, &descriptorSetLayouts.autoExposure);
+        if (autoExposureSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
+
+        // --------------
+        // Layout for DescriptorSets.bloom (bloom dispatches)
+        // (set = 0, binding 0): col0 or the source level, (binding 1): destination level
+        std::array<VkDescriptorSetLayoutBinding, 2> bloomSetBindings{};
+        for (uint32_t binding = 0; binding < bloomSetBindings.size(); binding++) {
+            bloomSetBindings[binding].binding = binding;
+            bloomSetBindings[binding].descriptorCount = 1;
+            bloomSetBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            bloomSetBindings[binding].pImmutableSamplers = nullptr;
+        }
+        bloomSetBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bloomSetBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+        VkDescriptorSetLayoutCreateInfo bloomSetLayout{};
+        bloomSetLayout.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        bloomSetLayout.bindingCount = static_cast<uint32_t>(bloomSetBindings.size());
+        bloomSetLayout.pBindings = bloomSetBindings.data();
+
+        VkResult bloomSetLayoutCreated = vkCreateDescriptorSetLayout(device, &bloomSetLayout, nullptr, &descriptorSetLayouts.bloom);
+        if (bloomSetLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to created descriptor set layout");
+        }
 }
 
 void VulkanApp::createDescriptorPool() {
         std::vector<VkDescriptorPoolSize> poolSizes{};
 
+        // uboFrame
+        VkDescriptorPoolSize poolsizeFrame;
+        poolsizeFrame.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
+        poolsizeFrame.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        poolSizes.push_back(poolsizeFrame);
+
         // uboScene 
         VkDescriptorPoolSize poolsize0;
         poolsize0.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
@@ -1191,18 +1926,118 @@ void VulkanApp::createDescriptorPool() {
         poolsize1.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         poolSizes.push_back(poolsize1);
 
-        // inputCol
+        VkDescriptorType inputDescriptorType = settings.multiPass ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+
+        // inputCol (composition set, fx1 set)
         VkDescriptorPoolSize poolsize2;
-        poolsize2.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
-        poolsize2.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        poolsize2.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 2;
+        poolsize2.type = inputDescriptorType;
         poolSizes.push_back(poolsize2);
 
-        // inputDepth
+        // inputDepth (fx1 set)
         VkDescriptorPoolSize poolsize3;
         poolsize3.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
-        poolsize3.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        poolsize3.type = inputDescriptorType;
         poolSizes.push_back(poolsize3);
 
+        // fx instances, fx draw order (fx0 set), fx instances, sort keys, sort values (fxSort set)
+        VkDescriptorPoolSize poolsizeFxInstances;
+        poolsizeFxInstances.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 5;
+        poolsizeFxInstances.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeFxInstances);
+
+        // fx instances, draw order, draw command and count, visible order (fxCull set)
+        VkDescriptorPoolSize poolsizeFxCull;
+        poolsizeFxCull.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 4;
+        poolsizeFxCull.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeFxCull);
+
+        // source levels (hiZBuild sets, per pyramid level), pyramid (hiZCull set)
+        uint32_t hiZLevels = hiZ.enabled ? getHiZLevelCount() : 0;
+        VkDescriptorPoolSize poolsizeHiZSamplers;
+        poolsizeHiZSamplers.descriptorCount = hiZLevels + static_cast<uint32_t>(swapChainImages.size());
+        poolsizeHiZSamplers.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes.push_back(poolsizeHiZSamplers);
+
+        // destination levels (hiZBuild sets)
+        if (hiZ.enabled) {
+            VkDescriptorPoolSize poolsizeHiZLevels;
+            poolsizeHiZLevels.descriptorCount = hiZLevels;
+            poolsizeHiZLevels.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            poolSizes.push_back(poolsizeHiZLevels);
+        }
+
+        // cull statistics (hiZCull set)
+        VkDescriptorPoolSize poolsizeHiZStatistics;
+        poolsizeHiZStatistics.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
+        poolsizeHiZStatistics.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeHiZStatistics);
+
+        // tiled decal storage buffers (decal set)
+        VkDescriptorPoolSize poolsizeDecal;
+        poolsizeDecal.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 4;
+        poolsizeDecal.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeDecal);
+
+        // oitAccum, oitReveal (oitResolve set)
+        VkDescriptorPoolSize poolsizeOit;
+        poolsizeOit.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 2;
+        poolsizeOit.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        poolSizes.push_back(poolsizeOit);
+
+        // gAlbedo, gNormal, depth0, visible lights (lighting set)
+        VkDescriptorPoolSize poolsizeLightingInputs;
+        poolsizeLightingInputs.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 3;
+        poolsizeLightingInputs.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        poolSizes.push_back(poolsizeLightingInputs);
+
+        VkDescriptorPoolSize poolsizeLights;
+        poolsizeLights.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
+        poolsizeLights.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeLights);
+
+        // lights, cluster ranges, cluster light indices (clusters set)
+        VkDescriptorPoolSize poolsizeClusters;
+        poolsizeClusters.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 3;
+        poolsizeClusters.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeClusters);
+
+        // light uniforms, shadow map (shadows set)
+        VkDescriptorPoolSize poolsizeShadowLight;
+        poolsizeShadowLight.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
+        poolsizeShadowLight.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        poolSizes.push_back(poolsizeShadowLight);
+
+        VkDescriptorPoolSize poolsizeShadowMap;
+        poolsizeShadowMap.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
+        poolsizeShadowMap.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes.push_back(poolsizeShadowMap);
+
+        // luminance copy, result and state buffers (autoExposure set)
+        VkDescriptorPoolSize poolsizeLuminance;
+        poolsizeLuminance.descriptorCount = static_cast<uint32_t>(swapChainImages.size());
+        poolsizeLuminance.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes.push_back(poolsizeLuminance);
+
+        VkDescriptorPoolSize poolsizeExposure;
+        poolsizeExposure.descriptorCount = static_cast<uint32_t>(swapChainImages.size()) * 2;
+        poolsizeExposure.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes.push_back(poolsizeExposure);
+
+        // source and destination levels (bloom sets, per dispatch), bloom level 0 (composition set)
+        uint32_t bloomSets = bloom.enabled ? getBloomLevelCount() * 2 - 1 : 0;
+        if (bloom.enabled) {
+            VkDescriptorPoolSize poolsizeBloomSamplers;
+            poolsizeBloomSamplers.descriptorCount = bloomSets + static_cast<uint32_t>(swapChainImages.size());
+            poolsizeBloomSamplers.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            poolSizes.push_back(poolsizeBloomSamplers);
+
+            VkDescriptorPoolSize poolsizeBloomLevels;
+            poolsizeBloomLevels.descriptorCount = bloomSets;
+            poolsizeBloomLevels.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            poolSizes.push_back(poolsizeBloomLevels);
+        }
+
         /*
         // textureImage
         VkDescriptorPoolSize poolsize4;
@@ -1216,8 +2051,9 @@ void VulkanApp::createDescriptorPool() {
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
         poolInfo.pPoolSizes = poolSizes.data();
-        // createDescriptorSets() is creating 5 descriptor-sets (scene, comp, fx0, fx1), per swapchain image 
-        poolInfo.maxSets = swapChainImages.size() * 4;
+        // createDescriptorSets() is creating up to 14 descriptor-sets (frame, scene, comp, fx0, fx1, decal, fxSort, fxCull, hiZCull, oitResolve, lighting, clusters, shadows,
+        // autoExposure), per swapchain image, one hiZBuild set per pyramid level and one bloom set per bloom dispatch
+        poolInfo.maxSets = swapChainImages.size() * 14 + hiZLevels + bloomSets;
         poolInfo.flags = 0;
 
         VkResult descriptorPoolCreated = vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool);
@@ -1228,12 +2064,27 @@ void VulkanApp::createDescriptorPool() {
 
 void VulkanApp::createDescriptorSets() {
 
+        std::vector<VkDescriptorSetLayout> frameDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.frame);
         std::vector<VkDescriptorSetLayout> sceneDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.scene);
         std::vector<VkDescriptorSetLayout> compositionDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.composition);
         std::vector<VkDescriptorSetLayout> fxDescriptorSet0Layout(swapChainImages.size(), descriptorSetLayouts.fx0);
         std::vector<VkDescriptorSetLayout> fxDescriptorSet1Layout(swapChainImages.size(), descriptorSetLayouts.fx1);
+        std::vector<VkDescriptorSetLayout> decalDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.decal);
         
 
+        // allocate frame descriptor sets from descriptor-pool
+        VkDescriptorSetAllocateInfo frameDescriptorSetInfo{};
+        frameDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        frameDescriptorSetInfo.descriptorPool = descriptorPool;
+        frameDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+        frameDescriptorSetInfo.pSetLayouts = frameDescriptorSetLayout.data();
+
+        descriptorSets.frame.resize(swapChainImages.size());
+        VkResult frameDescriptorSetAllocated = vkAllocateDescriptorSets(device, &frameDescriptorSetInfo, descriptorSets.frame.data());
+        if (frameDescriptorSetAllocated != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate descriptor sets");
+        }
+
         // allocate scene descriptor sets from descriptor-pool
         VkDescriptorSetAllocateInfo sceneDescriptorSetInfo{};
         sceneDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -1287,10 +2138,189 @@ void VulkanApp::createDescriptorSets() {
             throw std::runtime_error("failed to allocate descriptor sets");
         }
 
+        // allocate decal descriptor sets from descriptor-pool
+        VkDescriptorSetAllocateInfo decalDescriptorSetInfo{};
+        decalDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        decalDescriptorSetInfo.descriptorPool = descriptorPool;
+        decalDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+        decalDescriptorSetInfo.pSetLayouts = decalDescriptorSetLayout.data();
+
+        descriptorSets.decal.resize(swapChainImages.size());
+        VkResult decalDescriptorSetAllocated = vkAllocateDescriptorSets(device, &decalDescriptorSetInfo, descriptorSets.decal.data());
+        if (decalDescriptorSetAllocated != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate descriptor sets");
+        }
+
+        // allocate fx sort descriptor sets from descriptor-pool (compute sort only)
+        if (settings.gpuSort) {
+            std::vector<VkDescriptorSetLayout> fxSortDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.fxSort);
+            VkDescriptorSetAllocateInfo fxSortDescriptorSetInfo{};
+            fxSortDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            fxSortDescriptorSetInfo.descriptorPool = descriptorPool;
+            fxSortDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            fxSortDescriptorSetInfo.pSetLayouts = fxSortDescriptorSetLayout.data();
+
+            descriptorSets.fxSort.resize(swapChainImages.size());
+            VkResult fxSortDescriptorSetAllocated = vkAllocateDescriptorSets(device, &fxSortDescriptorSetInfo, descriptorSets.fxSort.data());
+            if (fxSortDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate fx cull descriptor sets from descriptor-pool (GPU-driven fx draw only)
+        if (settings.gpuCulling) {
+            std::vector<VkDescriptorSetLayout> fxCullDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.fxCull);
+            VkDescriptorSetAllocateInfo fxCullDescriptorSetInfo{};
+            fxCullDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            fxCullDescriptorSetInfo.descriptorPool = descriptorPool;
+            fxCullDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            fxCullDescriptorSetInfo.pSetLayouts = fxCullDescriptorSetLayout.data();
+
+            descriptorSets.fxCull.resize(swapChainImages.size());
+            VkResult fxCullDescriptorSetAllocated = vkAllocateDescriptorSets(device, &fxCullDescriptorSetInfo, descriptorSets.fxCull.data());
+            if (fxCullDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate Hi-Z descriptor sets from descriptor-pool (hiZ.enabled only): one build set per pyramid level, one cull set per image
+        if (hiZ.enabled) {
+            std::vector<VkDescriptorSetLayout> hiZBuildDescriptorSetLayout(hiZ.levelViews.size(), descriptorSetLayouts.hiZBuild);
+            VkDescriptorSetAllocateInfo hiZBuildDescriptorSetInfo{};
+            hiZBuildDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            hiZBuildDescriptorSetInfo.descriptorPool = descriptorPool;
+            hiZBuildDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(hiZ.levelViews.size());
+            hiZBuildDescriptorSetInfo.pSetLayouts = hiZBuildDescriptorSetLayout.data();
+
+            descriptorSets.hiZBuild.resize(hiZ.levelViews.size());
+            VkResult hiZBuildDescriptorSetAllocated = vkAllocateDescriptorSets(device, &hiZBuildDescriptorSetInfo, descriptorSets.hiZBuild.data());
+            if (hiZBuildDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+
+            std::vector<VkDescriptorSetLayout> hiZCullDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.hiZCull);
+            VkDescriptorSetAllocateInfo hiZCullDescriptorSetInfo{};
+            hiZCullDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            hiZCullDescriptorSetInfo.descriptorPool = descriptorPool;
+            hiZCullDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            hiZCullDescriptorSetInfo.pSetLayouts = hiZCullDescriptorSetLayout.data();
+
+            descriptorSets.hiZCull.resize(swapChainImages.size());
+            VkResult hiZCullDescriptorSetAllocated = vkAllocateDescriptorSets(device, &hiZCullDescriptorSetInfo, descriptorSets.hiZCull.data());
+            if (hiZCullDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate OIT resolve descriptor sets from descriptor-pool (oit.enabled only)
+        if (oit.enabled) {
+            std::vector<VkDescriptorSetLayout> oitResolveDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.oitResolve);
+            VkDescriptorSetAllocateInfo oitResolveDescriptorSetInfo{};
+            oitResolveDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            oitResolveDescriptorSetInfo.descriptorPool = descriptorPool;
+            oitResolveDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            oitResolveDescriptorSetInfo.pSetLayouts = oitResolveDescriptorSetLayout.data();
+
+            descriptorSets.oitResolve.resize(swapChainImages.size());
+            VkResult oitResolveDescriptorSetAllocated = vkAllocateDescriptorSets(device, &oitResolveDescriptorSetInfo, descriptorSets.oitResolve.data());
+            if (oitResolveDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate deferred lighting descriptor sets from descriptor-pool (deferred.enabled only)
+        if (deferred.enabled) {
+            std::vector<VkDescriptorSetLayout> lightingDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.lighting);
+            VkDescriptorSetAllocateInfo lightingDescriptorSetInfo{};
+            lightingDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            lightingDescriptorSetInfo.descriptorPool = descriptorPool;
+            lightingDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            lightingDescriptorSetInfo.pSetLayouts = lightingDescriptorSetLayout.data();
+
+            descriptorSets.lighting.resize(swapChainImages.size());
+            VkResult lightingDescriptorSetAllocated = vkAllocateDescriptorSets(device, &lightingDescriptorSetInfo, descriptorSets.lighting.data());
+            if (lightingDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate clustered lighting descriptor sets from descriptor-pool (clustered.enabled only)
+        if (clustered.enabled) {
+            std::vector<VkDescriptorSetLayout> clusterDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.clusters);
+            VkDescriptorSetAllocateInfo clusterDescriptorSetInfo{};
+            clusterDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            clusterDescriptorSetInfo.descriptorPool = descriptorPool;
+            clusterDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            clusterDescriptorSetInfo.pSetLayouts = clusterDescriptorSetLayout.data();
+
+            descriptorSets.clusters.resize(swapChainImages.size());
+            VkResult clusterDescriptorSetAllocated = vkAllocateDescriptorSets(device, &clusterDescriptorSetInfo, descriptorSets.clusters.data());
+            if (clusterDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate shadow map descriptor sets from descriptor-pool (shadow.enabled only)
+        if (shadow.enabled) {
+            std::vector<VkDescriptorSetLayout> shadowDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.shadows);
+            VkDescriptorSetAllocateInfo shadowDescriptorSetInfo{};
+            shadowDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            shadowDescriptorSetInfo.descriptorPool = descriptorPool;
+            shadowDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            shadowDescriptorSetInfo.pSetLayouts = shadowDescriptorSetLayout.data();
+
+            descriptorSets.shadows.resize(swapChainImages.size());
+            VkResult shadowDescriptorSetAllocated = vkAllocateDescriptorSets(device, &shadowDescriptorSetInfo, descriptorSets.shadows.data());
+            if (shadowDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate auto exposure descriptor sets from descriptor-pool (autoExposure.enabled only)
+        if (autoExposure.enabled) {
+            std::vector<VkDescriptorSetLayout> autoExposureDescriptorSetLayout(swapChainImages.size(), descriptorSetLayouts.autoExposure);
+            VkDescriptorSetAllocateInfo autoExposureDescriptorSetInfo{};
+            autoExposureDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            autoExposureDescriptorSetInfo.descriptorPool = descriptorPool;
+            autoExposureDescriptorSetInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size());
+            autoExposureDescriptorSetInfo.pSetLayouts = autoExposureDescriptorSetLayout.data();
+
+            descriptorSets.autoExposure.resize(swapChainImages.size());
+            VkResult autoExposureDescriptorSetAllocated = vkAllocateDescriptorSets(device, &autoExposureDescriptorSetInfo, descriptorSets.autoExposure.data());
+            if (autoExposureDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        // allocate bloom descriptor sets from descriptor-pool (bloom.enabled only): bright pass, downsamples, upsamples
+        if (bloom.enabled) {
+            uint32_t bloomSetCount = static_cast<uint32_t>(bloom.levelViews.size()) * 2 - 1;
+            std::vector<VkDescriptorSetLayout> bloomDescriptorSetLayout(bloomSetCount, descriptorSetLayouts.bloom);
+            VkDescriptorSetAllocateInfo bloomDescriptorSetInfo{};
+            bloomDescriptorSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            bloomDescriptorSetInfo.descriptorPool = descriptorPool;
+            bloomDescriptorSetInfo.descriptorSetCount = bloomSetCount;
+            bloomDescriptorSetInfo.pSetLayouts = bloomDescriptorSetLayout.data();
+
+            descriptorSets.bloom.resize(bloomSetCount);
+            VkResult bloomDescriptorSetAllocated = vkAllocateDescriptorSets(device, &bloomDescriptorSetInfo, descriptorSets.bloom.data());
+            if (bloomDescriptorSetAllocated != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor sets");
+            }
+        }
+
+        VkDescriptorType inputDescriptorType = settings.multiPass ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        VkSampler inputSampler = settings.multiPass ? separatePasses.inputSampler : VK_NULL_HANDLE;
+
         // write to descriptor sets (per swapchain image):
         for (size_t i = 0; i < swapChainImages.size(); i++) {
 
             // Descriptors:
+            VkDescriptorBufferInfo frameDescriptor{};
+            frameDescriptor.buffer = uniformBuffersFrame[i];
+            frameDescriptor.offset = 0;
+            frameDescriptor.range = frameUniformSize();
+
             VkDescriptorBufferInfo sceneDescriptor{};
             sceneDescriptor.buffer = uniformBuffersScene[i]; // buffer with UBO content
             sceneDescriptor.offset = 0; // offset within buffer, where UBO content exists
@@ -1301,16 +2331,24 @@ void VulkanApp::createDescriptorSets() {
             fxDescriptor.offset = 0;
             fxDescriptor.range = sizeof(UniformBufferObjectFX); // data size of UBO content
 
+            // dynamic rendering: col0/depth0 are read on tile in the local-read layout
             VkDescriptorImageInfo imageDescriptor{};
             imageDescriptor.imageView = offscreenImageView;
-            imageDescriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageDescriptor.sampler = VK_NULL_HANDLE;
+            imageDescriptor.imageLayout = dynamicRendering.enabled ? VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            imageDescriptor.sampler = inputSampler;
 
 
+            // (the composition pass writes the decal stencil mask while depth0 is read: depth read-only, stencil attachment layout)
             VkDescriptorImageInfo depthDescriptor{};
             depthDescriptor.imageView = depthImageView;
             depthDescriptor.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-            depthDescriptor.sampler = VK_NULL_HANDLE;
+            if (dynamicRendering.enabled) {
+                depthDescriptor.imageLayout = VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+            }
+            else if (volumeDraws.decalStencil) {
+                depthDescriptor.imageLayout = VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_STENCIL_ATTACHMENT_OPTIMAL;
+            }
+            depthDescriptor.sampler = inputSampler;
 
             /*
             VkDescriptorImageInfo textureDescriptor{};
@@ -1319,9 +2357,23 @@ void VulkanApp::createDescriptorSets() {
             textureDescriptor.sampler = textureSampler;
             */
 
+            // ----------------
+            // Frame Descriptor Set
+            // layout(set = 0, binding = 0) uniform uboFrame (frame.glsl)
+            std::array<VkWriteDescriptorSet, 1> frameDescriptorSetWrite{};
+            frameDescriptorSetWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            frameDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            frameDescriptorSetWrite[0].dstSet = descriptorSets.frame[i];
+            frameDescriptorSetWrite[0].dstBinding = 0;
+            frameDescriptorSetWrite[0].descriptorCount = 1;
+            frameDescriptorSetWrite[0].dstArrayElement = 0;
+            frameDescriptorSetWrite[0].pBufferInfo = &frameDescriptor;
+
+            vkUpdateDescriptorSets(device, static_cast<uint32_t>(frameDescriptorSetWrite.size()), frameDescriptorSetWrite.data(), 0, nullptr);
+
             // ----------------
             // Scene Descriptor Set
-            // layout(set = 0, binding = 0) uniform uboScene
+            // layout(set = 1, binding = 0) uniform uboScene
             std::array<VkWriteDescriptorSet, 1> sceneDescriptorSetWrite{};
             sceneDescriptorSetWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
             sceneDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -1336,23 +2388,55 @@ void VulkanApp::createDescriptorSets() {
 
             // ---------------
             // Composition Descriptor Set
-            // layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput inputColorAttachment;
-            std::array<VkWriteDescriptorSet, 1> compositionDescriptorSetWrite{};
+            // layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
+            // layout(set = 1, binding = 1) uniform sampler2D inputBloomTexture (bloom.enabled only)
+            VkDescriptorImageInfo bloomDescriptor{};
+            bloomDescriptor.imageView = bloom.enabled ? bloom.levelViews[0] : VK_NULL_HANDLE;
+            bloomDescriptor.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            bloomDescriptor.sampler = bloom.sampler;
+
+            std::vector<VkWriteDescriptorSet> compositionDescriptorSetWrite(bloom.enabled ? 2 : 1);
             compositionDescriptorSetWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            compositionDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            compositionDescriptorSetWrite[0].descriptorType = inputDescriptorType;
             compositionDescriptorSetWrite[0].dstSet = descriptorSets.composition[i];
             compositionDescriptorSetWrite[0].dstBinding = 0;
             compositionDescriptorSetWrite[0].descriptorCount = 1;
             compositionDescriptorSetWrite[0].dstArrayElement = 0;
             compositionDescriptorSetWrite[0].pImageInfo = &imageDescriptor;
+            if (bloom.enabled) {
+                compositionDescriptorSetWrite[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                compositionDescriptorSetWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                compositionDescriptorSetWrite[1].dstSet = descriptorSets.composition[i];
+                compositionDescriptorSetWrite[1].dstBinding = 1;
+                compositionDescriptorSetWrite[1].descriptorCount = 1;
+                compositionDescriptorSetWrite[1].dstArrayElement = 0;
+                compositionDescriptorSetWrite[1].pImageInfo = &bloomDescriptor;
+            }
 
             vkUpdateDescriptorSets(device, static_cast<uint32_t>(compositionDescriptorSetWrite.size()), compositionDescriptorSetWrite.data(), 0, nullptr);
 
 
             // ---------------
             // FX Descriptor Set 0
-            // layout(set = 0, binding = 0) uniform uboFX
-            std::array<VkWriteDescriptorSet, 1> fxDescriptorSet0Write{};
+            // layout(set = 1, binding = 0) uniform uboFX
+            // layout(std430, set = 1, binding = 1) readonly buffer fxInstances (shared by all swapchain images)
+            VkDescriptorBufferInfo fxInstancesDescriptor{};
+            fxInstancesDescriptor.buffer = fxInstances.buffer;
+            fxInstancesDescriptor.offset = 0;
+            fxInstancesDescriptor.range = VK_WHOLE_SIZE;
+            // layout(std430, set = 1, binding = 2) readonly buffer fxOrder (CPU: uploaded order, GPU: first half of the sorted values,
+            // GPU-driven draw: the visible instances of that order, compacted by the cull dispatch)
+            VkDescriptorBufferInfo sortedOrderDescriptor{};
+            sortedOrderDescriptor.buffer = fxSort.buffers[i];
+            sortedOrderDescriptor.offset = settings.gpuSort ? fxSort.valuesOffset : 0;
+            sortedOrderDescriptor.range = fxInstances.instances.size() * sizeof(uint32_t);
+            VkDescriptorBufferInfo fxOrderDescriptor = sortedOrderDescriptor;
+            if (settings.gpuCulling) {
+                fxOrderDescriptor.buffer = fxCull.buffers[i];
+                fxOrderDescriptor.offset = fxCull.orderOffset;
+            }
+
+            std::array<VkWriteDescriptorSet, 3> fxDescriptorSet0Write{};
             fxDescriptorSet0Write[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
             fxDescriptorSet0Write[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
             fxDescriptorSet0Write[0].dstSet = descriptorSets.fx0[i];
@@ -1360,32 +2444,35 @@ void VulkanApp::createDescriptorSets() {
             fxDescriptorSet0Write[0].descriptorCount = 1;
             fxDescriptorSet0Write[0].dstArrayElement = 0;
             fxDescriptorSet0Write[0].pBufferInfo = &fxDescriptor;
-            
-            /*
+
             fxDescriptorSet0Write[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            fxDescriptorSet0Write[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            fxDescriptorSet0Write[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
             fxDescriptorSet0Write[1].dstSet = descriptorSets.fx0[i];
             fxDescriptorSet0Write[1].dstBinding = 1;
             fxDescriptorSet0Write[1].descriptorCount = 1;
             fxDescriptorSet0Write[1].dstArrayElement = 0;
-            fxDescriptorSet0Write[1].pImageInfo = &textureDescriptor;
-            */
+            fxDescriptorSet0Write[1].pBufferInfo = &fxInstancesDescriptor;
+
+            fxDescriptorSet0Write[2] = fxDescriptorSet0Write[1];
+            fxDescriptorSet0Write[2].dstBinding = 2;
+            fxDescriptorSet0Write[2].pBufferInfo = &fxOrderDescriptor;
+
             vkUpdateDescriptorSets(device, static_cast<uint32_t>(fxDescriptorSet0Write.size()), fxDescriptorSet0Write.data(), 0, nullptr);
 
 
             std::array<VkWriteDescriptorSet, 2> fxDescriptorSet1Write{};
             // FX Descriptor Set 1
-            // layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
+            // layout(input_attachment_index = 0, set = 2, binding = 0) uniform subpassInput inputColorAttachment;
             fxDescriptorSet1Write[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            fxDescriptorSet1Write[0].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            fxDescriptorSet1Write[0].descriptorType = inputDescriptorType;
             fxDescriptorSet1Write[0].dstSet = descriptorSets.fx1[i];
             fxDescriptorSet1Write[0].dstBinding = 0;
             fxDescriptorSet1Write[0].descriptorCount = 1;
             fxDescriptorSet1Write[0].dstArrayElement = 0;
             fxDescriptorSet1Write[0].pImageInfo = &imageDescriptor;
-            // layout(input_attachment_index = 1, set = 1 binding = 1) uniform subpassInput inputDepthAttachment;
+            // layout(input_attachment_index = 1, set = 2 binding = 1) uniform subpassInput inputDepthAttachment;
             fxDescriptorSet1Write[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            fxDescriptorSet1Write[1].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            fxDescriptorSet1Write[1].descriptorType = inputDescriptorType;
             fxDescriptorSet1Write[1].dstSet = descriptorSets.fx1[i];
             fxDescriptorSet1Write[1].dstBinding = 1;
             fxDescriptorSet1Write[1].descriptorCount = 1;
@@ -1394,15 +2481,353 @@ void VulkanApp::createDescriptorSets() {
 
             vkUpdateDescriptorSets(device, static_cast<uint32_t>(fxDescriptorSet1Write.size()), fxDescriptorSet1Write.data(), 0, nullptr);
 
-        }
+            // ---------------
+            // Decal Descriptor Set
+            // layout(std430, set = 1, binding = 0..3) readonly buffer decalData, tileRanges, tileDecalIndices, activeTiles
+            std::array<VkDescriptorBufferInfo, 4> decalDescriptors{};
+            std::array<VkWriteDescriptorSet, 4> decalDescriptorSetWrite{};
+            for (uint32_t binding = 0; binding < decalDescriptorSetWrite.size(); binding++) {
+                decalDescriptors[binding].buffer = tiledDecals.buffers[i];
+                decalDescriptors[binding].offset = tiledDecals.offsets[binding];
+                decalDescriptors[binding].range = tiledDecals.sizes[binding];
+
+                decalDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                decalDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                decalDescriptorSetWrite[binding].dstSet = descriptorSets.decal[i];
+                decalDescriptorSetWrite[binding].dstBinding = binding;
+                decalDescriptorSetWrite[binding].descriptorCount = 1;
+                decalDescriptorSetWrite[binding].dstArrayElement = 0;
+                decalDescriptorSetWrite[binding].pBufferInfo = &decalDescriptors[binding];
+            }
 
-}
+            vkUpdateDescriptorSets(device, static_cast<uint32_t>(decalDescriptorSetWrite.size()), decalDescriptorSetWrite.data(), 0, nullptr);
 
-uint32_t VulkanApp::findMemoryTypeIndex(uint32_t bufferSupportedMemTypes_Bitflags, VkMemoryPropertyFlags requiredMemProperties) {
-        VkPhysicalDeviceMemoryProperties deviceSupportedMemProperties; // get device supported memory properties:
-            // memoryTypeCount: amount of memory types supported
-            // memoryTypes[]: array of supported VkMemoryType's that can be allocated from heaps
-            // memoryHeapCount: amount of available memory heaps
+            // ---------------
+            // FX Sort Descriptor Set (compute sort only)
+            // layout(std430, set = 1, binding = 0..2) buffers fxInstances, sortKeys, sortValues
+            if (settings.gpuSort) {
+                std::array<VkDescriptorBufferInfo, 3> fxSortDescriptors{};
+                fxSortDescriptors[0] = fxInstancesDescriptor;
+                fxSortDescriptors[1].buffer = fxSort.buffers[i];
+                fxSortDescriptors[1].offset = 0;
+                fxSortDescriptors[1].range = fxSort.keysSize;
+                fxSortDescriptors[2].buffer = fxSort.buffers[i];
+                fxSortDescriptors[2].offset = fxSort.valuesOffset;
+                fxSortDescriptors[2].range = fxSort.valuesSize;
+
+                std::array<VkWriteDescriptorSet, 3> fxSortDescriptorSetWrite{};
+                for (uint32_t binding = 0; binding < fxSortDescriptorSetWrite.size(); binding++) {
+                    fxSortDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    fxSortDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    fxSortDescriptorSetWrite[binding].dstSet = descriptorSets.fxSort[i];
+                    fxSortDescriptorSetWrite[binding].dstBinding = binding;
+                    fxSortDescriptorSetWrite[binding].descriptorCount = 1;
+                    fxSortDescriptorSetWrite[binding].dstArrayElement = 0;
+                    fxSortDescriptorSetWrite[binding].pBufferInfo = &fxSortDescriptors[binding];
+                }
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(fxSortDescriptorSetWrite.size()), fxSortDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // FX Cull Descriptor Set (GPU-driven fx draw only)
+            // layout(std430, set = 1, binding = 0..3) buffers fxInstances, fxOrder, fxDraw, fxVisibleOrder
+            if (settings.gpuCulling) {
+                std::array<VkDescriptorBufferInfo, 4> fxCullDescriptors{};
+                fxCullDescriptors[0] = fxInstancesDescriptor;
+                fxCullDescriptors[1] = sortedOrderDescriptor;
+                fxCullDescriptors[2].buffer = fxCull.buffers[i];
+                fxCullDescriptors[2].offset = 0;
+                fxCullDescriptors[2].range = fxCull.countOffset + sizeof(uint32_t);
+                fxCullDescriptors[3] = fxOrderDescriptor;
+
+                std::array<VkWriteDescriptorSet, 4> fxCullDescriptorSetWrite{};
+                for (uint32_t binding = 0; binding < fxCullDescriptorSetWrite.size(); binding++) {
+                    fxCullDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    fxCullDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    fxCullDescriptorSetWrite[binding].dstSet = descriptorSets.fxCull[i];
+                    fxCullDescriptorSetWrite[binding].dstBinding = binding;
+                    fxCullDescriptorSetWrite[binding].descriptorCount = 1;
+                    fxCullDescriptorSetWrite[binding].dstArrayElement = 0;
+                    fxCullDescriptorSetWrite[binding].pBufferInfo = &fxCullDescriptors[binding];
+                }
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(fxCullDescriptorSetWrite.size()), fxCullDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // Hi-Z Cull Descriptor Set
+            // layout(set = 2, binding = 0) uniform sampler2D hiZPyramid, layout(std430, set = 2, binding = 1) buffer cullStatistics
+            if (hiZ.enabled) {
+                VkDescriptorImageInfo pyramidDescriptor{};
+                pyramidDescriptor.imageView = hiZ.view;
+                pyramidDescriptor.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+                pyramidDescriptor.sampler = hiZ.sampler;
+
+                VkDescriptorBufferInfo statisticsDescriptor{};
+                statisticsDescriptor.buffer = hiZ.readbackBuffers[i];
+                statisticsDescriptor.offset = hiZ.statisticsOffset;
+                statisticsDescriptor.range = 2 * sizeof(uint32_t);
+
+                std::array<VkWriteDescriptorSet, 2> hiZCullDescriptorSetWrite{};
+                for (uint32_t binding = 0; binding < hiZCullDescriptorSetWrite.size(); binding++) {
+                    hiZCullDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    hiZCullDescriptorSetWrite[binding].dstSet = descriptorSets.hiZCull[i];
+                    hiZCullDescriptorSetWrite[binding].dstBinding = binding;
+                    hiZCullDescriptorSetWrite[binding].descriptorCount = 1;
+                    hiZCullDescriptorSetWrite[binding].dstArrayElement = 0;
+                }
+                hiZCullDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                hiZCullDescriptorSetWrite[0].pImageInfo = &pyramidDescriptor;
+                hiZCullDescriptorSetWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                hiZCullDescriptorSetWrite[1].pBufferInfo = &statisticsDescriptor;
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(hiZCullDescriptorSetWrite.size()), hiZCullDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // OIT Resolve Descriptor Set
+            // layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputAccumAttachment;
+            // layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputRevealAttachment;
+            if (oit.enabled) {
+                std::array<VkDescriptorImageInfo, 2> oitDescriptors{};
+                oitDescriptors[0].imageView = oit.accumView;
+                oitDescriptors[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                oitDescriptors[0].sampler = VK_NULL_HANDLE;
+                oitDescriptors[1].imageView = oit.revealView;
+                oitDescriptors[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                oitDescriptors[1].sampler = VK_NULL_HANDLE;
+
+                std::array<VkWriteDescriptorSet, 2> oitResolveDescriptorSetWrite{};
+                for (uint32_t binding = 0; binding < oitResolveDescriptorSetWrite.size(); binding++) {
+                    oitResolveDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    oitResolveDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    oitResolveDescriptorSetWrite[binding].dstSet = descriptorSets.oitResolve[i];
+                    oitResolveDescriptorSetWrite[binding].dstBinding = binding;
+                    oitResolveDescriptorSetWrite[binding].descriptorCount = 1;
+                    oitResolveDescriptorSetWrite[binding].dstArrayElement = 0;
+                    oitResolveDescriptorSetWrite[binding].pImageInfo = &oitDescriptors[binding];
+                }
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(oitResolveDescriptorSetWrite.size()), oitResolveDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // Deferred Lighting Descriptor Set
+            // layout(input_attachment_index = 0..2, set = 1, binding = 0..2) uniform subpassInput inputAlbedo/Normal/DepthAttachment;
+            // layout(std430, set = 1, binding = 3) readonly buffer lightData
+            if (deferred.enabled) {
+                std::array<VkDescriptorImageInfo, 3> gbufferDescriptors{};
+                gbufferDescriptors[0].imageView = deferred.albedoView;
+                gbufferDescriptors[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                gbufferDescriptors[0].sampler = VK_NULL_HANDLE;
+                gbufferDescriptors[1].imageView = deferred.normalView;
+                gbufferDescriptors[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                gbufferDescriptors[1].sampler = VK_NULL_HANDLE;
+                gbufferDescriptors[2].imageView = depthImageView;
+                gbufferDescriptors[2].imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL; // depth0 layout of the lighting subpass
+                gbufferDescriptors[2].sampler = VK_NULL_HANDLE;
+
+                VkDescriptorBufferInfo lightsDescriptor{};
+                lightsDescriptor.buffer = deferred.lightBuffers[i];
+                lightsDescriptor.offset = 0;
+                lightsDescriptor.range = sizeof(LightGpuData) * lights.size();
+
+                std::array<VkWriteDescriptorSet, 4> lightingDescriptorSetWrite{};
+                for (uint32_t binding = 0; binding < lightingDescriptorSetWrite.size(); binding++) {
+                    lightingDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    lightingDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    lightingDescriptorSetWrite[binding].dstSet = descriptorSets.lighting[i];
+                    lightingDescriptorSetWrite[binding].dstBinding = binding;
+                    lightingDescriptorSetWrite[binding].descriptorCount = 1;
+                    lightingDescriptorSetWrite[binding].dstArrayElement = 0;
+                    if (binding < gbufferDescriptors.size()) {
+                        lightingDescriptorSetWrite[binding].pImageInfo = &gbufferDescriptors[binding];
+                    }
+                }
+                lightingDescriptorSetWrite[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                lightingDescriptorSetWrite[3].pBufferInfo = &lightsDescriptor;
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(lightingDescriptorSetWrite.size()), lightingDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // Clustered Lighting Descriptor Set
+            // layout(std430, set = 2, binding = 0..2) readonly buffer lightData, clusterRanges, clusterLightIndices
+            if (clustered.enabled) {
+                std::array<VkDescriptorBufferInfo, 3> clusterDescriptors{};
+                clusterDescriptors[0].buffer = clustered.lightBuffer;
+                clusterDescriptors[0].offset = 0;
+                clusterDescriptors[0].range = lights.size() * sizeof(LightGpuData);
+                clusterDescriptors[1].buffer = clustered.buffers[i];
+                clusterDescriptors[1].offset = 0;
+                clusterDescriptors[1].range = LightClusters::getClusterCount() * sizeof(glm::uvec2);
+                clusterDescriptors[2].buffer = clustered.buffers[i];
+                clusterDescriptors[2].offset = clustered.indicesOffset;
+                clusterDescriptors[2].range = clustered.indicesSize;
+
+                std::array<VkWriteDescriptorSet, 3> clusterDescriptorSetWrite{};
+                for (uint32_t binding = 0; binding < clusterDescriptorSetWrite.size(); binding++) {
+                    clusterDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    clusterDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    clusterDescriptorSetWrite[binding].dstSet = descriptorSets.clusters[i];
+                    clusterDescriptorSetWrite[binding].dstBinding = binding;
+                    clusterDescriptorSetWrite[binding].descriptorCount = 1;
+                    clusterDescriptorSetWrite[binding].dstArrayElement = 0;
+                    clusterDescriptorSetWrite[binding].pBufferInfo = &clusterDescriptors[binding];
+                }
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(clusterDescriptorSetWrite.size()), clusterDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // Shadow Map Descriptor Set
+            // layout(set = 3, binding = 0) uniform uboShadow, layout(set = 3, binding = 1) uniform sampler2DShadow shadowMap
+            if (shadow.enabled) {
+                VkDescriptorBufferInfo shadowLightDescriptor{};
+                shadowLightDescriptor.buffer = shadow.uniformBuffers[i];
+                shadowLightDescriptor.offset = 0;
+                shadowLightDescriptor.range = sizeof(UniformBufferObjectShadow);
+
+                VkDescriptorImageInfo shadowMapDescriptor{};
+                shadowMapDescriptor.imageView = shadow.view;
+                shadowMapDescriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; // (final layout of the shadow render pass)
+                shadowMapDescriptor.sampler = shadow.sampler;
+
+                std::array<VkWriteDescriptorSet, 2> shadowDescriptorSetWrite{};
+                shadowDescriptorSetWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                shadowDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                shadowDescriptorSetWrite[0].dstSet = descriptorSets.shadows[i];
+                shadowDescriptorSetWrite[0].dstBinding = 0;
+                shadowDescriptorSetWrite[0].descriptorCount = 1;
+                shadowDescriptorSetWrite[0].dstArrayElement = 0;
+                shadowDescriptorSetWrite[0].pBufferInfo = &shadowLightDescriptor;
+                shadowDescriptorSetWrite[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                shadowDescriptorSetWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                shadowDescriptorSetWrite[1].dstSet = descriptorSets.shadows[i];
+                shadowDescriptorSetWrite[1].dstBinding = 1;
+                shadowDescriptorSetWrite[1].descriptorCount = 1;
+                shadowDescriptorSetWrite[1].dstArrayElement = 0;
+                shadowDescriptorSetWrite[1].pImageInfo = &shadowMapDescriptor;
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(shadowDescriptorSetWrite.size()), shadowDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+            // ---------------
+            // Auto Exposure Descriptor Set
+            // layout(set = 0, binding = 0) uniform sampler2D luminanceSource, layout(set = 0, binding = 1) buffer exposureResult,
+            // layout(set = 0, binding = 2) buffer exposureState
+            if (autoExposure.enabled) {
+                VkDescriptorImageInfo luminanceDescriptor{};
+                luminanceDescriptor.imageView = autoExposure.views[i];
+                luminanceDescriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; // (after recordLuminanceCopy)
+                luminanceDescriptor.sampler = autoExposure.sampler;
+
+                std::array<VkDescriptorBufferInfo, 2> exposureDescriptors{};
+                exposureDescriptors[0].buffer = autoExposure.resultBuffers[i];
+                exposureDescriptors[0].offset = 0;
+                exposureDescriptors[0].range = VK_WHOLE_SIZE;
+                exposureDescriptors[1].buffer = autoExposure.stateBuffer;
+                exposureDescriptors[1].offset = 0;
+                exposureDescriptors[1].range = VK_WHOLE_SIZE;
+
+                std::array<VkWriteDescriptorSet, 3> autoExposureDescriptorSetWrite{};
+                autoExposureDescriptorSetWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                autoExposureDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                autoExposureDescriptorSetWrite[0].dstSet = descriptorSets.autoExposure[i];
+                autoExposureDescriptorSetWrite[0].dstBinding = 0;
+                autoExposureDescriptorSetWrite[0].descriptorCount = 1;
+                autoExposureDescriptorSetWrite[0].dstArrayElement = 0;
+                autoExposureDescriptorSetWrite[0].pImageInfo = &luminanceDescriptor;
+                for (uint32_t binding = 1; binding < 3; binding++) {
+                    autoExposureDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    autoExposureDescriptorSetWrite[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    autoExposureDescriptorSetWrite[binding].dstSet = descriptorSets.autoExposure[i];
+                    autoExposureDescriptorSetWrite[binding].dstBinding = binding;
+                    autoExposureDescriptorSetWrite[binding].descriptorCount = 1;
+                    autoExposureDescriptorSetWrite[binding].dstArrayElement = 0;
+                    autoExposureDescriptorSetWrite[binding].pBufferInfo = &exposureDescriptors[binding - 1];
+                }
+
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(autoExposureDescriptorSetWrite.size()), autoExposureDescriptorSetWrite.data(), 0, nullptr);
+            }
+
+        }
+
+        // ---------------
+        // Hi-Z Build Descriptor Sets (per pyramid level)
+        // layout(set = 0, binding = 0) uniform sampler2D source: depth0 (read-only layout) for level 0, the previous level otherwise
+        // layout(set = 0, binding = 1, r32f) uniform writeonly image2D destination
+        for (size_t level = 0; level < descriptorSets.hiZBuild.size(); level++) {
+            VkDescriptorImageInfo sourceDescriptor{};
+            sourceDescriptor.imageView = (level == 0) ? depthImageView : hiZ.levelViews[level - 1];
+            sourceDescriptor.imageLayout = (level == 0) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+            sourceDescriptor.sampler = hiZ.sampler;
+
+            VkDescriptorImageInfo destinationDescriptor{};
+            destinationDescriptor.imageView = hiZ.levelViews[level];
+            destinationDescriptor.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            destinationDescriptor.sampler = VK_NULL_HANDLE;
+
+            std::array<VkWriteDescriptorSet, 2> hiZBuildDescriptorSetWrite{};
+            for (uint32_t binding = 0; binding < hiZBuildDescriptorSetWrite.size(); binding++) {
+                hiZBuildDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                hiZBuildDescriptorSetWrite[binding].dstSet = descriptorSets.hiZBuild[level];
+                hiZBuildDescriptorSetWrite[binding].dstBinding = binding;
+                hiZBuildDescriptorSetWrite[binding].descriptorCount = 1;
+                hiZBuildDescriptorSetWrite[binding].dstArrayElement = 0;
+            }
+            hiZBuildDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            hiZBuildDescriptorSetWrite[0].pImageInfo = &sourceDescriptor;
+            hiZBuildDescriptorSetWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            hiZBuildDescriptorSetWrite[1].pImageInfo = &destinationDescriptor;
+
+            vkUpdateDescriptorSets(device, static_cast<uint32_t>(hiZBuildDescriptorSetWrite.size()), hiZBuildDescriptorSetWrite.data(), 0, nullptr);
+        }
+
+        // ---------------
+        // Bloom Descriptor Sets (per dispatch: bright pass, downsample to level 1..n-1, upsample to level n-2..0)
+        // layout(set = 0, binding = 0) uniform sampler2D source: col0 (sampled layout) for the bright pass, the neighbouring level otherwise
+        // layout(set = 0, binding = 1, rgba16f) uniform image2D destination
+        uint32_t bloomLevels = static_cast<uint32_t>(bloom.levelViews.size());
+        for (uint32_t set = 0; set < descriptorSets.bloom.size(); set++) {
+            // downsamples: set n writes level n from level n - 1, upsamples: set 2 * levels - 2 - n writes level n from level n + 1
+            uint32_t destination = (set < bloomLevels) ? set : bloomLevels * 2 - 2 - set;
+            uint32_t source = (set < bloomLevels) ? destination - 1 : destination + 1;
+
+            VkDescriptorImageInfo sourceDescriptor{};
+            sourceDescriptor.imageView = (set == 0) ? offscreenImageView : bloom.levelViews[source];
+            sourceDescriptor.imageLayout = (set == 0) ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+            sourceDescriptor.sampler = bloom.sampler;
+
+            VkDescriptorImageInfo destinationDescriptor{};
+            destinationDescriptor.imageView = bloom.levelViews[destination];
+            destinationDescriptor.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            destinationDescriptor.sampler = VK_NULL_HANDLE;
+
+            std::array<VkWriteDescriptorSet, 2> bloomDescriptorSetWrite{};
+            for (uint32_t binding = 0; binding < bloomDescriptorSetWrite.size(); binding++) {
+                bloomDescriptorSetWrite[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                bloomDescriptorSetWrite[binding].dstSet = descriptorSets.bloom[set];
+                bloomDescriptorSetWrite[binding].dstBinding = binding;
+                bloomDescriptorSetWrite[binding].descriptorCount = 1;
+                bloomDescriptorSetWrite[binding].dstArrayElement = 0;
+            }
+            bloomDescriptorSetWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            bloomDescriptorSetWrite[0].pImageInfo = &sourceDescriptor;
+            bloomDescriptorSetWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            bloomDescriptorSetWrite[1].pImageInfo = &destinationDescriptor;
+
+            vkUpdateDescriptorSets(device, static_cast<uint32_t>(bloomDescriptorSetWrite.size()), bloomDescriptorSetWrite.data(), 0, nullptr);
+        }
+
+}
+
+bool VulkanApp::tryFindMemoryTypeIndex(uint32_t bufferSupportedMemTypes_Bitflags, VkMemoryPropertyFlags requiredMemProperties, uint32_t& memTypeIndex) {
+        VkPhysicalDeviceMemoryProperties deviceSupportedMemProperties; // get device supported memory properties:
+            // memoryTypeCount: amount of memory types supported
+            // memoryTypes[]: array of supported VkMemoryType's that can be allocated from heaps
+            // memoryHeapCount: amount of available memory heaps
             // memoryHeaps[]: array of available memory heaps
         vkGetPhysicalDeviceMemoryProperties(physicalDevice, &deviceSupportedMemProperties);
 
@@ -1412,14 +2837,24 @@ uint32_t VulkanApp::findMemoryTypeIndex(uint32_t bufferSupportedMemTypes_Bitflag
             uint32_t bitflag = (1 << i);
             // find the first device-supported mem type, which matches one of the buffer-supported mem types
             bool memTypeFound = (bitflag & bufferSupportedMemTypes_Bitflags);
-            // check if the mem type supports the required mem properties
+            // check if the mem type supports all of the required mem properties
             uint32_t memTypeSupportedProperties = deviceSupportedMemProperties.memoryTypes[i].propertyFlags;
-            bool requiredMemPropertiesSupported = (memTypeSupportedProperties & requiredMemProperties);
+            bool requiredMemPropertiesSupported = (memTypeSupportedProperties & requiredMemProperties) == requiredMemProperties;
             if ((memTypeFound) && (requiredMemPropertiesSupported)) {
                 // if so, return index of the memory type
-                return i;
+                memTypeIndex = i;
+                return true;
             }
         }
+        return false;
+}
+
+uint32_t VulkanApp::findMemoryTypeIndex(uint32_t bufferSupportedMemTypes_Bitflags, VkMemoryPropertyFlags requiredMemProperties) {
+        uint32_t memTypeIndex;
+        if (!tryFindMemoryTypeIndex(bufferSupportedMemTypes_Bitflags, requiredMemProperties, memTypeIndex)) {
+            throw std::runtime_error("failed to find a memory type supporting the required memory properties");
+        }
+        return memTypeIndex;
 }
 
 void VulkanApp::createGraphicsBuffer(VkDeviceSize bufferSize, VkBufferUsageFlags bufferUsage_Bitflags, VkMemoryPropertyFlags memProperties_Bitflags, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
@@ -1467,7 +2902,17 @@ void VulkanApp::createGraphicsBuffer(VkDeviceSize bufferSize, VkBufferUsageFlags
         vkBindBufferMemory(device, buffer, bufferMemory, 0);
 }
 
+VkDeviceSize VulkanApp::frameUniformSize() const {
+        // multiview stereo: the culling camera, then one camera per eye (frame.glsl)
+        return sizeof(UniformBufferObjectFrame) * (multiview.enabled ? 1 + multiview.viewCount : 1);
+}
+
 void VulkanApp::createUniformBuffers() {
+        uniformBuffersFrame.resize(swapChainImages.size());
+        uniformBuffersFrameMemory.resize(swapChainImages.size());
+
+        VkDeviceSize bufferSizeFrame = frameUniformSize();
+
         uniformBuffersScene.resize(swapChainImages.size());
         uniformBuffersSceneMemory.resize(swapChainImages.size());
 
@@ -1476,13 +2921,14 @@ void VulkanApp::createUniformBuffers() {
         uniformBuffersFX.resize(swapChainImages.size());
         uniformBuffersFXMemory.resize(swapChainImages.size());
 
-        uniformBuffersDecal.resize(swapChainImages.size());
-        uniformBuffersDecalMemory.resize(swapChainImages.size());
-
         VkDeviceSize bufferSize1 = sizeof(UniformBufferObjectFX);
-        VkDeviceSize bufferSize2 = sizeof(UniformBufferObjectFX);
 
         for (size_t i = 0; i < swapChainImages.size(); i++) {
+            VkBufferUsageFlags bufferUsageBitflagsFrame = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+            VkMemoryPropertyFlags memPropertiesBitflagsFrame = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+            createGraphicsBuffer(bufferSizeFrame, bufferUsageBitflagsFrame, memPropertiesBitflagsFrame, uniformBuffersFrame[i], uniformBuffersFrameMemory[i]);
+
             VkBufferUsageFlags bufferUsageBitflags0 = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
             VkMemoryPropertyFlags memPropertiesBitflags0 = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
             //mem properties bitflag : 
@@ -1496,164 +2942,2490 @@ void VulkanApp::createUniformBuffers() {
 
             createGraphicsBuffer(bufferSize1, bufferUsageBitflags1, memPropertiesBitflags1, uniformBuffersFX[i], uniformBuffersFXMemory[i]);
 
-            VkBufferUsageFlags bufferUsageBitflags2 = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-            VkMemoryPropertyFlags memPropertiesBitflags2 = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        }
+}
+
+void VulkanApp::createDecals() {
+        // decal 0: placed with uboFX.model every frame (simulateFrameState)
+        DecalInfo decal{};
+        decal.color = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        tiledDecals.manager.addDecal(decal);
+
+        // the others: small boxes scattered around the origin, deterministic (same placement every run)
+        uint32_t seed = 1;
+        auto random01 = [&seed]() {
+            seed = seed * 1664525u + 1013904223u; // LCG
+            return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+        };
+        for (uint32_t d = 1; d < settings.decalCount; d++) {
+            glm::vec3 position = glm::vec3(random01(), random01(), random01()) * 3.0f - 1.5f;
+            float angle = random01() * glm::radians(360.0f);
+            float scale = 0.08f + 0.12f * random01();
+            decal.model = glm::translate(glm::mat4(1.0f), position);
+            decal.model = glm::rotate(decal.model, angle, glm::vec3(0.0f, 0.0f, 1.0f)); // around camera.up
+            decal.model = glm::scale(decal.model, glm::vec3(scale));
+            decal.color = glm::vec4(random01(), random01(), random01(), 0.5f + 0.5f * random01());
+            tiledDecals.manager.addDecal(decal);
+        }
+        std::cout << "decals created: " << tiledDecals.manager.getDecalCount() << '\n';
+}
 
-            createGraphicsBuffer(bufferSize2, bufferUsageBitflags2, memPropertiesBitflags2, uniformBuffersDecal[i], uniformBuffersDecalMemory[i]);
+void VulkanApp::createDecalBuffers() {
+        // worst case: every decal in every tile. ranges are aligned for the storage buffer descriptors' offsets
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        VkDeviceSize alignment = std::max<VkDeviceSize>(deviceProperties.limits.minStorageBufferOffsetAlignment, 16);
+
+        VkDeviceSize decalCount = std::max(tiledDecals.manager.getDecalCount(), 1u);
+        VkDeviceSize tileCount = DecalManager::getTileCount(swapChainExtent);
+        tiledDecals.sizes = {
+            decalCount * sizeof(DecalGpuData),
+            tileCount * sizeof(glm::uvec2),
+            decalCount * tileCount * sizeof(uint32_t),
+            tileCount * sizeof(uint32_t)
+        };
+        VkDeviceSize bufferSize = 0;
+        for (size_t range = 0; range < tiledDecals.sizes.size(); range++) {
+            tiledDecals.offsets[range] = bufferSize;
+            bufferSize += (tiledDecals.sizes[range] + alignment - 1) / alignment * alignment;
+        }
 
+        tiledDecals.buffers.resize(swapChainImages.size());
+        tiledDecals.memory.resize(swapChainImages.size());
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            // written by the CPU every frame (uploadFrameState), read by the tiled decal draw
+            createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, tiledDecals.buffers[i], tiledDecals.memory[i]);
         }
 }
 
-void VulkanApp::createTextureSampler() {
+void VulkanApp::createLights() {
+        if (!deferred.enabled && !clustered.enabled) {
+            return;
+        }
+        // light 0: the forward path's light (shader0.frag), with its ambient term, applied to every pixel
+        LightGpuData light{};
+        light.positionRadius = glm::vec4(1.0f, 1.0f, -1.0f, 0.0f);
+        light.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+        lights.push_back(light);
+
+        // the others: point lights scattered around the origin, deterministic (same placement every run)
+        uint32_t seed = 3;
+        auto random01 = [&seed]() {
+            seed = seed * 1664525u + 1013904223u; // LCG
+            return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+        };
+        for (uint32_t l = 1; l < settings.lightCount; l++) {
+            glm::vec3 position = glm::vec3(random01(), random01(), random01()) * 3.0f - 1.5f;
+            float radius = 0.3f + 0.5f * random01();
+            light.positionRadius = glm::vec4(position, radius);
+            light.color = glm::vec4(random01(), random01(), random01(), 1.0f + 2.0f * random01());
+            lights.push_back(light);
+        }
+        std::cout << "lights created: " << lights.size() << '\n';
+}
+
+void VulkanApp::createLightBuffers() {
+        if (!deferred.enabled) {
+            return;
+        }
+        // worst case: every light visible
+        VkDeviceSize bufferSize = lights.size() * sizeof(LightGpuData);
+        deferred.lightBuffers.resize(swapChainImages.size());
+        deferred.lightMemory.resize(swapChainImages.size());
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            // written by the CPU every frame (uploadFrameState), read by the lighting draw
+            createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, deferred.lightBuffers[i], deferred.lightMemory[i]);
+        }
+}
+
+void VulkanApp::createClusterBuffers() {
+        if (!clustered.enabled) {
+            return;
+        }
+        // all lights: written once, the lights do not move
+        VkDeviceSize lightsSize = lights.size() * sizeof(LightGpuData);
+        createGraphicsBuffer(lightsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, clustered.lightBuffer, clustered.lightMemory);
+        void* dataLights;
+        vkMapMemory(device, clustered.lightMemory, 0, lightsSize, 0, &dataLights);
+        memcpy(dataLights, lights.data(), static_cast<size_t>(lightsSize));
+        vkUnmapMemory(device, clustered.lightMemory);
+
+        // worst case: every light in every cluster. ranges are aligned for the storage buffer descriptors' offsets
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        VkDeviceSize alignment = std::max<VkDeviceSize>(deviceProperties.limits.minStorageBufferOffsetAlignment, 16);
+        VkDeviceSize clusterCount = LightClusters::getClusterCount();
+        VkDeviceSize rangesSize = clusterCount * sizeof(glm::uvec2);
+        clustered.indicesOffset = (rangesSize + alignment - 1) / alignment * alignment;
+        clustered.indicesSize = clusterCount * lights.size() * sizeof(uint32_t);
+
+        clustered.buffers.resize(swapChainImages.size());
+        clustered.memory.resize(swapChainImages.size());
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            // written by the CPU every frame (uploadFrameState), read by the scene fragment shader
+            createGraphicsBuffer(clustered.indicesOffset + clustered.indicesSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, clustered.buffers[i], clustered.memory[i]);
+        }
+}
+
+void VulkanApp::createShadowResources() {
+        if (!shadow.enabled) {
+            return;
+        }
+        //1. Render pass: a graph of its own with one depth-only pass (a VkRenderPass with either backend: it is recorded outside of the
+        // main rendering). the map is persistent, ends in the sampled layout, and a re-render waits for earlier frames' fragment reads
+        shadow.format = findSupportedImageFormat({ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM }, VK_IMAGE_TILING_OPTIMAL,
+            VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+
+        RenderGraphAttachmentInfo shadowMap{};
+        shadowMap.name = "shadowMap";
+        shadowMap.format = shadow.format;
+        shadowMap.clearValue.depthStencil = { 1.0f, 0 };
+        shadowMap.persistent = true;
+        shadowMap.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        shadowMap.externalDstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        shadowMap.externalDstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        shadowMap.externalSrcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        shadowMap.externalSrcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        shadow.graph.addAttachment(shadowMap);
+
+        RenderGraphPassInfo shadowPass{};
+        shadowPass.name = "shadow";
+        shadowPass.depthOutput = "shadowMap";
+        shadow.graph.addPass(shadowPass);
+
+        shadow.renderPass = shadow.graph.createRenderPass(device);
+        shadow.graph.printSummary(std::cout, shadow.extent);
+
+        //2. Image (depth attachment, then sampled by the scene subpass), view and framebuffer
+        createImage(shadow.extent.width, shadow.extent.height, VK_SAMPLE_COUNT_1_BIT, shadow.format, VK_IMAGE_TILING_OPTIMAL,
+            shadow.graph.getImageUsage("shadowMap") | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, shadow.image, shadow.memory, false);
+        createImageView(shadow.image, shadow.format, VK_IMAGE_ASPECT_DEPTH_BIT, shadow.view);
+        shadow.graph.bindImageViews("shadowMap", { shadow.view });
+        std::vector<VkFramebuffer> framebuffers;
+        shadow.graph.createFramebuffers(device, shadow.renderPass, shadow.extent, 1, framebuffers);
+        shadow.framebuffer = framebuffers[0];
+
+        //3. Sampler: depth comparison, so every tap of the PCF kernel is a lit/shadowed test (bilinear-filtered where the format allows).
+        // clamped to a white border: depth 1.0, nothing outside the map casts a shadow
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, shadow.format, &formatProperties);
+        VkFilter filter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
         VkSamplerCreateInfo samplerInfo{};
         samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-        // over/undersample filtering
-        samplerInfo.magFilter = VK_FILTER_LINEAR; //oversample filtering
-        samplerInfo.minFilter = VK_FILTER_LINEAR; //undersample filtering
-        // addressing mode
-        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        // anisotropic filtering
-        samplerInfo.anisotropyEnable = VK_TRUE;
-        VkPhysicalDeviceProperties deviceProperties{};
-        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
-        samplerInfo.maxAnisotropy = deviceProperties.limits.maxSamplerAnisotropy;
-        // border color (if clamp)
-        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-        // coordinate space
+        samplerInfo.magFilter = filter;
+        samplerInfo.minFilter = filter;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
         samplerInfo.unnormalizedCoordinates = VK_FALSE;
-        // comparison value for precentange-close filtering
-        samplerInfo.compareEnable = VK_FALSE;
-        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-        // mipmapping
-        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.compareEnable = VK_TRUE;
+        samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
         samplerInfo.maxLod = 0.0f;
+        if (vkCreateSampler(device, &samplerInfo, nullptr, &shadow.sampler) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create shadow sampler");
+        }
 
-        VkResult samplerCreated = vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler);
-        if (samplerCreated != VK_SUCCESS) {
-            throw std::runtime_error("failed to create texture sampler");
+        //4. Light uniforms, per swapchain image: written by the CPU every frame (uploadFrameState)
+        shadow.uniformBuffers.resize(swapChainImages.size());
+        shadow.uniformMemory.resize(swapChainImages.size());
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            createGraphicsBuffer(sizeof(UniformBufferObjectShadow), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, shadow.uniformBuffers[i], shadow.uniformMemory[i]);
         }
-        std::cout << "texture sampler created" << '\n';
 
-    }
+        std::cout << "shadow map created: " << shadow.extent.width << "x" << shadow.extent.height
+            << (shadow.format == VK_FORMAT_D32_SFLOAT ? " D32" : " D16") << (filter == VK_FILTER_LINEAR ? ", bilinear" : ", nearest") << " comparison sampler"
+            << (settings.disableShadowCache ? ", re-rendered every frame" : ", cached") << '\n';
+}
 
-void VulkanApp::createGraphicsPipelineScene() {
+void VulkanApp::createFxInstances() {
+        // instance 0: the original field at the origin, scale 1 + 0.25 * (0.5 * sin(time) + 0.5)
+        FxInstanceData field{};
+        field.positionScale = glm::vec4(0.0f, 0.0f, 0.0f, 1.125f);
+        field.color = glm::vec4(0.1f, 0.1f, 1.0f, 10.0f);
+        field.animation = glm::vec4(0.125f, 1.0f, 0.0f, 0.0f);
+        fxInstances.instances.push_back(field);
+
+        // the others: small fields scattered around the origin, deterministic (same placement every run)
+        uint32_t seed = 7;
+        auto random01 = [&seed]() {
+            seed = seed * 1664525u + 1013904223u; // LCG
+            return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+        };
+        for (uint32_t f = 1; f < settings.fxCount; f++) {
+            glm::vec3 position = glm::vec3(random01(), random01(), random01()) * 3.0f - 1.5f;
+            float scale = 0.04f + 0.08f * random01();
+            field.positionScale = glm::vec4(position, scale);
+            field.color = glm::vec4(random01(), random01(), random01(), 2.0f + 8.0f * random01());
+            field.animation = glm::vec4(scale * 0.25f * random01(), 0.5f + 2.5f * random01(), random01() * glm::radians(360.0f), 0.1f * random01());
+            fxInstances.instances.push_back(field);
+        }
 
-        /*Summary:
-        -> programmable shader stages
-        -> fixed function stages
-            - vertex input
-            - input assembler
-            - input assembler
-            - rasterizer
-            - viewport
-            - color blending
-        -> pipeline layout (uniform layout)
-        -> render pass (attachments and subpasses)
+        // bounds over the whole animation: largest pulse scale, bob range (see shaderFX.vert)
+        fxInstances.worldMin = glm::vec3(std::numeric_limits<float>::max());
+        fxInstances.worldMax = glm::vec3(-std::numeric_limits<float>::max());
+        for (const FxInstanceData& instance : fxInstances.instances) {
+            float maxScale = instance.positionScale.w + std::abs(instance.animation.x);
+            glm::vec3 bob = glm::vec3(0.0f, 0.0f, std::abs(instance.animation.w));
+            glm::vec3 position = glm::vec3(instance.positionScale);
+            glm::vec3 localMin = glm::min(volumeDraws.fxLocalMin * maxScale, volumeDraws.fxLocalMax * maxScale);
+            glm::vec3 localMax = glm::max(volumeDraws.fxLocalMin * maxScale, volumeDraws.fxLocalMax * maxScale);
+            fxInstances.worldMin = glm::min(fxInstances.worldMin, position + localMin - bob);
+            fxInstances.worldMax = glm::max(fxInstances.worldMax, position + localMax + bob);
+        }
+        std::cout << "fx instances created: " << fxInstances.instances.size() << '\n';
+}
 
-        */
-        //1. Shader Loading 
-        static std::vector<char> vertShaderCode = readFile(SHADER_VERT_PATH_0);
-        static std::vector<char> fragShaderCode = readFile(SHADER_FRAG_PATH_0);
+void VulkanApp::createFxInstanceBuffer() {
+        // host-visible storage buffer, mapped once for the app's lifetime: instance changes are written straight into it
+        // (parameters only, the animation itself runs on the GPU)
+        VkDeviceSize bufferSize = std::max<size_t>(fxInstances.instances.size(), 1) * sizeof(FxInstanceData);
+        createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, fxInstances.buffer, fxInstances.memory);
+        VkResult memoryMapped = vkMapMemory(device, fxInstances.memory, 0, VK_WHOLE_SIZE, 0, &fxInstances.mapped);
+        if (memoryMapped != VK_SUCCESS) {
+            throw std::runtime_error("failed to map fx instance buffer");
+        }
+        memcpy(fxInstances.mapped, fxInstances.instances.data(), fxInstances.instances.size() * sizeof(FxInstanceData));
+}
 
-        // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
-        // Thus, shader modules can be deleted when leaving pipeline-creation scope.
+void VulkanApp::createFxSortBuffers() {
+        VkDeviceSize orderSize = fxInstances.instances.size() * sizeof(uint32_t);
+        VkDeviceSize bufferSize = orderSize;
+        VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        if (settings.gpuSort) {
+            // compute sort: keys and values, each two ping-pong halves, only touched by the GPU
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+            VkDeviceSize alignment = std::max<VkDeviceSize>(deviceProperties.limits.minStorageBufferOffsetAlignment, 16);
+            fxSort.keysSize = orderSize * 2;
+            fxSort.valuesSize = orderSize * 2;
+            fxSort.valuesOffset = (fxSort.keysSize + alignment - 1) / alignment * alignment;
+            bufferSize = fxSort.valuesOffset + fxSort.valuesSize;
+            memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        }
 
-        //2. Shader Modules setup
-        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+        fxSort.buffers.resize(swapChainImages.size());
+        fxSort.memory.resize(swapChainImages.size());
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            // CPU sort: written every frame (uploadFrameState). GPU sort: written by the sort dispatch of the image's command buffer
+            createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, memoryProperties, fxSort.buffers[i], fxSort.memory[i]);
+        }
+        if (!settings.gpuSort) {
+            fxSort.keys.reserve(fxInstances.instances.size());
+        }
+}
 
-        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        vertShaderStageInfo.module = vertShaderModule;
-        // shader function to call (entry point)
-        vertShaderStageInfo.pName = "main";
-        vertShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+void VulkanApp::createFxCullBuffers() {
+        if (!settings.gpuCulling) {
+            return; // direct fx draw of all instances
+        }
+        // draw command and count first (indirect buffer), the visible order behind them (storage buffer offset alignment)
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        VkDeviceSize alignment = std::max<VkDeviceSize>(deviceProperties.limits.minStorageBufferOffsetAlignment, 16);
+        VkDeviceSize drawSize = fxCull.countOffset + sizeof(uint32_t);
+        fxCull.orderOffset = (drawSize + alignment - 1) / alignment * alignment;
+        VkDeviceSize bufferSize = fxCull.orderOffset + fxInstances.instances.size() * sizeof(uint32_t);
 
-        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragShaderStageInfo.module = fragShaderModule;
-        // shader function to call (entry point)
-        fragShaderStageInfo.pName = "main";
-        fragShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+        fxCull.buffers.resize(swapChainImages.size());
+        fxCull.memory.resize(swapChainImages.size());
+        for (size_t i = 0; i < swapChainImages.size(); i++) {
+            // written by the cull dispatch of the image's command buffer, read by its fx draw
+            createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, fxCull.buffers[i], fxCull.memory[i]);
+        }
+}
 
-        //3. Shader Stages 
-        VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
+uint32_t VulkanApp::getHiZLevelCount() const {
+        // level 0 at half resolution, halved down to 1x1
+        uint32_t size = std::max(std::max(swapChainExtent.width / 2, swapChainExtent.height / 2), 1u);
+        uint32_t levels = 1;
+        while (size > 1) {
+            size /= 2;
+            levels++;
+        }
+        return levels;
+}
 
-        //4. Vertex Input
-        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-        auto bindingDescription = Vertex::getBindingDescription();
-        auto attributeDescriptions = Vertex::getAttributeDescriptions();
+void VulkanApp::createHiZResources() {
+        if (!hiZ.enabled) {
+            return;
+        }
+        //1. Depth pyramid: R32F, every texel the farthest depth0 value below it (odd sizes round down, the last row/column
+        // of a level also covers the leftover texel of its source)
+        uint32_t levels = getHiZLevelCount();
+        hiZ.extents.resize(levels);
+        VkExtent2D extent = { std::max(swapChainExtent.width / 2, 1u), std::max(swapChainExtent.height / 2, 1u) };
+        for (uint32_t level = 0; level < levels; level++) {
+            hiZ.extents[level] = extent;
+            extent = { std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u) };
+        }
 
-        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription; // describing vertex data bindings
-        vertexInputInfo.vertexAttributeDescriptionCount = 4;
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data(); // describing vertex data attributes
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = hiZ.extents[0].width;
+        imageInfo.extent.height = hiZ.extents[0].height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = levels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = VK_FORMAT_R32_SFLOAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        // written by the reduction, sampled by the next level and the fx cull dispatch, one level copied for the decal tests
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateImage(device, &imageInfo, nullptr, &hiZ.image) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create image!");
+        }
 
-        //5. Input AssembLer
-            // Topology:
-            /*
-            VK_PRIMITIVE_TOPOLOGY_POINT_LIST: points from vertices
-            VK_PRIMITIVE_TOPOLOGY_LINE_LIST : line from every 2 vertices without reuse
-            VK_PRIMITIVE_TOPOLOGY_LINE_STRIP : the end vertex of every line is used as start vertex for the next line
-            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : triangle from every 3 vertices without reuse
-            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : the second and third vertex of every triangle are used as first two vertices of the next triangle
-            */
+        VkMemoryRequirements imageMemRequirements;
+        vkGetImageMemoryRequirements(device, hiZ.image, &imageMemRequirements);
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = imageMemRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryTypeIndex(imageMemRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &hiZ.memory) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate image memory!");
+        }
+        vkBindImageMemory(device, hiZ.image, hiZ.memory, 0);
 
-            // PrimitiveRestartEnable:
-            //VK_TRUE: Can break up lines and triangles in the _STRIP topology method, using 0xFFFF
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssembly.primitiveRestartEnable = VK_FALSE;
+        //2. Views: all levels (fx cull dispatch), one per level (reduction source/destination)
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = hiZ.image;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = VK_FORMAT_R32_SFLOAT;
+        viewCreateInfo.components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY };
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.levelCount = levels;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(device, &viewCreateInfo, nullptr, &hiZ.view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create image view");
+        }
+        hiZ.levelViews.resize(levels);
+        for (uint32_t level = 0; level < levels; level++) {
+            viewCreateInfo.subresourceRange.baseMipLevel = level;
+            viewCreateInfo.subresourceRange.levelCount = 1;
+            if (vkCreateImageView(device, &viewCreateInfo, nullptr, &hiZ.levelViews[level]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create image view");
+            }
+        }
 
-        //6. Viewport
-            // Transform
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = (float)swapChainExtent.width;
-        viewport.height = (float)swapChainExtent.height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
+        //3. Sampler: texelFetch only (explicit texels and levels), no filtering
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_NEAREST;
+        samplerInfo.minFilter = VK_FILTER_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.mipLodBias = 0.0f;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = static_cast<float>(levels);
+        if (vkCreateSampler(device, &samplerInfo, nullptr, &hiZ.sampler) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create hi-z sampler");
+        }
 
-        // Scissor (Clipping)
-        VkRect2D scissor{};
-        scissor.offset = { 0, 0 };
-        scissor.extent = swapChainExtent;
+        //4. Read-back buffers (host-visible, persistently mapped): the first level of at most 128x128 texels for the
+        // decal tests on the CPU, then the fx cull dispatch's counts (storage buffer offset alignment)
+        hiZ.readbackLevel = 0;
+        while (hiZ.readbackLevel + 1 < levels && (hiZ.extents[hiZ.readbackLevel].width > 128 || hiZ.extents[hiZ.readbackLevel].height > 128)) {
+            hiZ.readbackLevel++;
+        }
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        VkDeviceSize alignment = std::max<VkDeviceSize>(deviceProperties.limits.minStorageBufferOffsetAlignment, 16);
+        const VkExtent2D& readbackExtent = hiZ.extents[hiZ.readbackLevel];
+        VkDeviceSize levelSize = static_cast<VkDeviceSize>(readbackExtent.width) * readbackExtent.height * sizeof(float);
+        hiZ.statisticsOffset = (levelSize + alignment - 1) / alignment * alignment;
+        VkDeviceSize bufferSize = hiZ.statisticsOffset + 2 * sizeof(uint32_t);
+
+        size_t imageCount = swapChainImages.size();
+        hiZ.readbackBuffers.resize(imageCount);
+        hiZ.readbackMemory.resize(imageCount);
+        hiZ.readbackMapped.resize(imageCount);
+        hiZ.readbackViewProj.resize(imageCount);
+        hiZ.readbackPending.assign(imageCount, false);
+        for (size_t i = 0; i < imageCount; i++) {
+            createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, hiZ.readbackBuffers[i], hiZ.readbackMemory[i]);
+            vkMapMemory(device, hiZ.readbackMemory[i], 0, VK_WHOLE_SIZE, 0, &hiZ.readbackMapped[i]);
+        }
+        hiZ.snapshotDepths.reserve(static_cast<size_t>(readbackExtent.width) * readbackExtent.height);
 
-        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+        std::cout << "hi-z pyramid created: " << levels << " levels from " << hiZ.extents[0].width << "x" << hiZ.extents[0].height
+            << ", level " << hiZ.readbackLevel << " (" << readbackExtent.width << "x" << readbackExtent.height << ") read back for the decal tests" << '\n';
+}
+
+void VulkanApp::createAutoExposureResources() {
+        if (!autoExposure.enabled) {
+            return;
+        }
+        size_t imageCount = swapChainImages.size();
+        autoExposure.extent = { std::max(swapChainExtent.width / 4, 1u), std::max(swapChainExtent.height / 4, 1u) };
+
+        //1. Luminance copies: blit destination on the graphics queue, sampled by the dispatch on the compute queue
+        // (concurrent sharing if those are different families: no queue family ownership transfers)
+        QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice);
+        uint32_t sharingFamilies[] = { queueFamilyIndices.graphicsFamilyIndex.value(), computeQueueFamily };
+        bool concurrent = autoExposure.async && sharingFamilies[0] != sharingFamilies[1];
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = autoExposure.extent.width;
+        imageInfo.extent.height = autoExposure.extent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.queueFamilyIndexCount = concurrent ? 2 : 0;
+        imageInfo.pQueueFamilyIndices = concurrent ? sharingFamilies : nullptr;
+
+        autoExposure.images.resize(imageCount);
+        autoExposure.imageMemory.resize(imageCount);
+        autoExposure.views.resize(imageCount);
+        for (size_t i = 0; i < imageCount; i++) {
+            if (vkCreateImage(device, &imageInfo, nullptr, &autoExposure.images[i]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create image!");
+            }
+            VkMemoryRequirements imageMemRequirements;
+            vkGetImageMemoryRequirements(device, autoExposure.images[i], &imageMemRequirements);
+            VkMemoryAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = imageMemRequirements.size;
+            allocInfo.memoryTypeIndex = findMemoryTypeIndex(imageMemRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            if (vkAllocateMemory(device, &allocInfo, nullptr, &autoExposure.imageMemory[i]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate image memory!");
+            }
+            vkBindImageMemory(device, autoExposure.images[i], autoExposure.imageMemory[i], 0);
+            createImageView(autoExposure.images[i], VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, autoExposure.views[i]);
+        }
+
+        //2. Sampler: texelFetch only, no filtering
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_NEAREST;
+        samplerInfo.minFilter = VK_FILTER_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.mipLodBias = 0.0f;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = 0.0f;
+        if (vkCreateSampler(device, &samplerInfo, nullptr, &autoExposure.sampler) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create auto exposure sampler");
+        }
+
+        //3. Buffers: the exposure carried from dispatch to dispatch (device-local), the results read back per swapchain image
+        // (host-visible, persistently mapped)
+        createGraphicsBuffer(sizeof(float), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, autoExposure.stateBuffer, autoExposure.stateMemory);
+        autoExposure.resultBuffers.resize(imageCount);
+        autoExposure.resultMemory.resize(imageCount);
+        autoExposure.resultMapped.resize(imageCount);
+        autoExposure.pendingFrames.assign(imageCount, 0);
+        for (size_t i = 0; i < imageCount; i++) {
+            createGraphicsBuffer(2 * sizeof(float), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, autoExposure.resultBuffers[i], autoExposure.resultMemory[i]);
+            vkMapMemory(device, autoExposure.resultMemory[i], 0, VK_WHOLE_SIZE, 0, &autoExposure.resultMapped[i]);
+        }
+
+        //4. Timestamps of the dispatch, if the family it is submitted to writes them
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+        uint32_t dispatchFamily = autoExposure.async ? computeQueueFamily : queueFamilyIndices.graphicsFamilyIndex.value();
+        if (queueFamilyProperties[dispatchFamily].timestampValidBits > 0) {
+            VkPhysicalDeviceProperties deviceProperties{};
+            vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+            autoExposure.timestampPeriod = deviceProperties.limits.timestampPeriod;
+
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = static_cast<uint32_t>(imageCount) * 2;
+            if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &autoExposure.queryPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create auto exposure query pool");
+            }
+        }
+
+        //5. Async: command buffers on the compute family (re-recorded every frame), the timeline semaphores between the queues
+        if (autoExposure.async) {
+            VkCommandPoolCreateInfo computePoolCreateInfo{};
+            computePoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            computePoolCreateInfo.queueFamilyIndex = computeQueueFamily;
+            computePoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            if (vkCreateCommandPool(device, &computePoolCreateInfo, nullptr, &autoExposure.commandPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create compute command pool");
+            }
+
+            autoExposure.commandBuffers.resize(imageCount);
+            VkCommandBufferAllocateInfo commandBuffersAllocateInfo{};
+            commandBuffersAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            commandBuffersAllocateInfo.commandPool = autoExposure.commandPool;
+            commandBuffersAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            commandBuffersAllocateInfo.commandBufferCount = static_cast<uint32_t>(imageCount);
+            if (vkAllocateCommandBuffers(device, &commandBuffersAllocateInfo, autoExposure.commandBuffers.data()) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate compute command buffers");
+            }
+
+            VkSemaphoreTypeCreateInfo timelineCreateInfo{};
+            timelineCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            timelineCreateInfo.initialValue = 0;
+            VkSemaphoreCreateInfo semaphoreCreateInfo{};
+            semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            semaphoreCreateInfo.pNext = &timelineCreateInfo;
+            if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &autoExposure.graphicsTimeline) != VK_SUCCESS ||
+                vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &autoExposure.computeTimeline) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create timeline semaphores");
+            }
+        }
+
+        std::cout << "auto exposure resources created: " << autoExposure.extent.width << "x" << autoExposure.extent.height << " luminance copies, dispatch "
+            << (autoExposure.async ? "on the compute queue (family " + std::to_string(computeQueueFamily) + ", queue " + std::to_string(computeQueueIndex) + ")" : "in the graphics command buffer")
+            << '\n';
+}
+
+uint32_t VulkanApp::getBloomLevelCount() const {
+        // level 0 at 1/downscale resolution, halved until the next level's smaller side would drop below 2 texels
+        // (quality preset: at most 6 levels, --fast-bloom: 4)
+        uint32_t maxLevels = settings.fastBloom ? 4 : 6;
+        uint32_t size = std::max(std::min(swapChainExtent.width, swapChainExtent.height) / bloom.downscale, 1u);
+        uint32_t levels = 1;
+        while (levels < maxLevels && size >= 4) {
+            size /= 2;
+            levels++;
+        }
+        return levels;
+}
+
+void VulkanApp::createBloomResources() {
+        if (!bloom.enabled) {
+            return;
+        }
+        //1. Pyramid image (written and sampled level by level, level 0 also sampled by the composition, cleared once)
+        uint32_t levels = getBloomLevelCount();
+        bloom.extents.resize(levels);
+        VkExtent2D extent = { std::max(swapChainExtent.width / bloom.downscale, 1u), std::max(swapChainExtent.height / bloom.downscale, 1u) };
+        for (uint32_t level = 0; level < levels; level++) {
+            bloom.extents[level] = extent;
+            extent = { std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u) };
+        }
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = bloom.extents[0].width;
+        imageInfo.extent.height = bloom.extents[0].height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = levels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateImage(device, &imageInfo, nullptr, &bloom.image) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create image!");
+        }
+
+        VkMemoryRequirements imageMemRequirements;
+        vkGetImageMemoryRequirements(device, bloom.image, &imageMemRequirements);
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = imageMemRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryTypeIndex(imageMemRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &bloom.memory) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate image memory!");
+        }
+        vkBindImageMemory(device, bloom.image, bloom.memory, 0);
+
+        //2. Views: one per level
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = bloom.image;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+        viewCreateInfo.components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY };
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewCreateInfo.subresourceRange.levelCount = 1;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+        bloom.levelViews.resize(levels);
+        for (uint32_t level = 0; level < levels; level++) {
+            viewCreateInfo.subresourceRange.baseMipLevel = level;
+            if (vkCreateImageView(device, &viewCreateInfo, nullptr, &bloom.levelViews[level]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create image view");
+            }
+        }
+
+        //3. Sampler: bilinear taps of the dual filter, level 0 upscaled by the composition (col0 is only fetched)
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.mipLodBias = 0.0f;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = 0.0f; // (single-level views)
+        if (vkCreateSampler(device, &samplerInfo, nullptr, &bloom.sampler) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create bloom sampler");
+        }
+
+        //4. Timestamps of the chain (graphics queue, as the frame timings)
+        VkPhysicalDeviceProperties deviceProperties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        if (deviceProperties.limits.timestampComputeAndGraphics) {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = static_cast<uint32_t>(swapChainImages.size()) * 2;
+            if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &bloom.queryPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create bloom query pool");
+            }
+        }
+
+        std::cout << "bloom pyramid created: " << levels << " levels from " << bloom.extents[0].width << "x" << bloom.extents[0].height
+            << " (" << (settings.fastBloom ? "performance" : "quality") << " preset)" << '\n';
+}
+
+void VulkanApp::createTextureSampler() {
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        // over/undersample filtering
+        samplerInfo.magFilter = VK_FILTER_LINEAR; //oversample filtering
+        samplerInfo.minFilter = VK_FILTER_LINEAR; //undersample filtering
+        // addressing mode
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        // anisotropic filtering
+        samplerInfo.anisotropyEnable = VK_TRUE;
+        VkPhysicalDeviceProperties deviceProperties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        samplerInfo.maxAnisotropy = deviceProperties.limits.maxSamplerAnisotropy;
+        // border color (if clamp)
+        samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        // coordinate space
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        // comparison value for precentange-close filtering
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+        // mipmapping
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.mipLodBias = 0.0f;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = 0.0f;
+
+        VkResult samplerCreated = vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler);
+        if (samplerCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create texture sampler");
+        }
+        std::cout << "texture sampler created" << '\n';
+
+        if (settings.multiPass) {
+            // col0/depth0 are read with texelFetch at the fragment's own pixel: no filtering, no mips, no anisotropy
+            VkSamplerCreateInfo inputSamplerInfo{};
+            inputSamplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            inputSamplerInfo.magFilter = VK_FILTER_NEAREST;
+            inputSamplerInfo.minFilter = VK_FILTER_NEAREST;
+            inputSamplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            inputSamplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            inputSamplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            inputSamplerInfo.anisotropyEnable = VK_FALSE;
+            inputSamplerInfo.maxAnisotropy = 1.0f;
+            inputSamplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+            inputSamplerInfo.unnormalizedCoordinates = VK_FALSE;
+            inputSamplerInfo.compareEnable = VK_FALSE;
+            inputSamplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+            inputSamplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            inputSamplerInfo.mipLodBias = 0.0f;
+            inputSamplerInfo.minLod = 0.0f;
+            inputSamplerInfo.maxLod = 0.0f;
+
+            VkResult inputSamplerCreated = vkCreateSampler(device, &inputSamplerInfo, nullptr, &separatePasses.inputSampler);
+            if (inputSamplerCreated != VK_SUCCESS) {
+                throw std::runtime_error("failed to create input sampler");
+            }
+            std::cout << "input sampler created" << '\n';
+        }
+
+    }
+
+void VulkanApp::createTimestampQueryPool() {
+        VkPhysicalDeviceProperties deviceProperties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        if (!deviceProperties.limits.timestampComputeAndGraphics) {
+            std::cout << "timestamps not supported on graphics queue: no GPU frame timings" << '\n';
+            return;
+        }
+        gpuTimings.timestampPeriod = deviceProperties.limits.timestampPeriod;
+
+        // 4 timestamps (start, fx instances sorted/culled, render pass ended, end) per swapchain image's command buffer
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = static_cast<uint32_t>(swapChainImages.size()) * 4;
+
+        VkResult queryPoolCreated = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &gpuTimings.queryPool);
+        if (queryPoolCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create timestamp query pool");
+        }
+        std::cout << "timestamp query pool created" << '\n';
+}
+
+void VulkanApp::createStatisticsQueryPool() {
+        if (!volumeDraws.statisticsQueries) {
+            std::cout << "pipeline statistics queries not supported: no fx/decal/scene fragment shader invocation counts" << '\n';
+            return;
+        }
+
+        // 3 queries (fx draw, decal draw, scene draw) per swapchain image's command buffer
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        queryPoolInfo.queryCount = static_cast<uint32_t>(swapChainImages.size()) * 3;
+        queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+        VkResult queryPoolCreated = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &volumeDraws.statisticsPool);
+        if (queryPoolCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline statistics query pool");
+        }
+        std::cout << "pipeline statistics query pool created" << '\n';
+}
+
+void VulkanApp::createOcclusionQueries() {
+        if (!occlusion.enabled) {
+            return;
+        }
+        // 2 occlusion queries (fx proxy, decal proxy) per swapchain image's command buffer
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+        queryPoolInfo.queryCount = static_cast<uint32_t>(swapChainImages.size()) * 2;
+
+        VkResult queryPoolCreated = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &occlusion.queryPool);
+        if (queryPoolCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create occlusion query pool");
+        }
+        occlusion.tested.assign(swapChainImages.size(), { false, false });
+        std::cout << "occlusion query pool created" << '\n';
+
+        // conditional rendering: one predicate buffer, written at the end of each command buffer and read by the next one
+        // (submitted in order on the graphics queue). 1 before the first results: the first frame draws everything
+        if (occlusion.conditionalRendering) {
+            VkDeviceSize bufferSize = 2 * sizeof(uint32_t);
+            createGraphicsBuffer(bufferSize, VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, occlusion.predicateBuffer, occlusion.predicateMemory);
+            uint32_t* predicates;
+            vkMapMemory(device, occlusion.predicateMemory, 0, bufferSize, 0, reinterpret_cast<void**>(&predicates));
+            predicates[0] = 1;
+            predicates[1] = 1;
+            vkUnmapMemory(device, occlusion.predicateMemory);
+        }
+}
+
+void VulkanApp::computeLocalBounds(const std::vector<Vertex>& vertices, glm::vec3& localMin, glm::vec3& localMax) {
+        localMin = glm::vec3(std::numeric_limits<float>::max());
+        localMax = glm::vec3(-std::numeric_limits<float>::max());
+        for (const Vertex& vertex : vertices) {
+            localMin = glm::min(localMin, vertex.pos);
+            localMax = glm::max(localMax, vertex.pos);
+        }
+}
+
+VulkanApp::VolumeBounds VulkanApp::projectVolumeBounds(const glm::mat4& modelViewProj, const glm::vec3& localMin, const glm::vec3& localMax) const {
+        // screen-space rectangle and depth range covered by the 8 projected corners of the volume's local bounding box
+        VolumeBounds bounds{};
+        bounds.scissor.offset = { 0, 0 };
+        bounds.scissor.extent = swapChainExtent;
+        bounds.minDepth = 0.0f;
+        bounds.maxDepth = 1.0f;
+
+        glm::vec3 ndcMin = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 ndcMax = glm::vec3(-std::numeric_limits<float>::max());
+        uint32_t cornersBehind = 0;
+        for (uint32_t corner = 0; corner < 8; corner++) {
+            glm::vec3 localPos = glm::vec3(
+                (corner & 1) ? localMax.x : localMin.x,
+                (corner & 2) ? localMax.y : localMin.y,
+                (corner & 4) ? localMax.z : localMin.z);
+            glm::vec4 clipPos = modelViewProj * glm::vec4(localPos, 1.0f);
+            if (clipPos.w <= 0.0f) {
+                cornersBehind++;
+                continue;
+            }
+            glm::vec3 ndc = glm::vec3(clipPos) / clipPos.w;
+            ndcMin = glm::min(ndcMin, ndc);
+            ndcMax = glm::max(ndcMax, ndc);
+        }
+        if (cornersBehind == 8) {
+            // entirely behind the camera: nothing to rasterize
+            bounds.scissor.extent = { 0, 0 };
+            return bounds;
+        }
+        if (cornersBehind > 0) {
+            // some corners are behind the camera: their projection wraps around, keep the full screen and depth range
+            return bounds;
+        }
+
+        // NDC [-1, 1] -> pixels (y is already flipped by the projection), clamped to the framebuffer
+        float width = static_cast<float>(swapChainExtent.width);
+        float height = static_cast<float>(swapChainExtent.height);
+        int32_t x0 = static_cast<int32_t>(std::floor(glm::clamp(ndcMin.x * 0.5f + 0.5f, 0.0f, 1.0f) * width));
+        int32_t y0 = static_cast<int32_t>(std::floor(glm::clamp(ndcMin.y * 0.5f + 0.5f, 0.0f, 1.0f) * height));
+        int32_t x1 = static_cast<int32_t>(std::ceil(glm::clamp(ndcMax.x * 0.5f + 0.5f, 0.0f, 1.0f) * width));
+        int32_t y1 = static_cast<int32_t>(std::ceil(glm::clamp(ndcMax.y * 0.5f + 0.5f, 0.0f, 1.0f) * height));
+        bounds.scissor.offset = { x0, y0 };
+        bounds.scissor.extent = { static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0) };
+
+        // depth bounds must lie in [0, 1] (without VK_EXT_depth_range_unrestricted)
+        bounds.minDepth = glm::clamp(ndcMin.z, 0.0f, 1.0f);
+        bounds.maxDepth = glm::clamp(ndcMax.z, 0.0f, 1.0f);
+        return bounds;
+}
+
+bool VulkanApp::isOccludedHiZ(const VolumeBounds& bounds) const {
+        // the read-back level of the pyramid (farthest depth per texel): the volume is hidden if its nearest point lies behind
+        // the farthest depth0 value of every texel its rectangle touches
+        const VkRect2D& rect = bounds.scissor;
+        if (rect.extent.width == 0 || rect.extent.height == 0) {
+            return false; // off screen for the pyramid's camera: no depth to test against
+        }
+        // (partially) outside of the pyramid's view, or crossing its camera plane (full screen): may be visible by now
+        if (rect.offset.x <= 0 || rect.offset.y <= 0
+            || rect.offset.x + rect.extent.width >= swapChainExtent.width || rect.offset.y + rect.extent.height >= swapChainExtent.height) {
+            return false;
+        }
+
+        // pixels -> texels of the level (level 0 is half resolution; the last row/column covers the leftover pixels)
+        uint32_t shift = hiZ.readbackLevel + 1;
+        const VkExtent2D& extent = hiZ.extents[hiZ.readbackLevel];
+        uint32_t x0 = std::min(static_cast<uint32_t>(rect.offset.x) >> shift, extent.width - 1);
+        uint32_t y0 = std::min(static_cast<uint32_t>(rect.offset.y) >> shift, extent.height - 1);
+        uint32_t x1 = std::min((static_cast<uint32_t>(rect.offset.x) + rect.extent.width - 1) >> shift, extent.width - 1);
+        uint32_t y1 = std::min((static_cast<uint32_t>(rect.offset.y) + rect.extent.height - 1) >> shift, extent.height - 1);
+        float farthest = 0.0f;
+        for (uint32_t y = y0; y <= y1; y++) {
+            for (uint32_t x = x0; x <= x1; x++) {
+                farthest = std::max(farthest, hiZ.snapshotDepths[y * extent.width + x]);
+            }
+        }
+        return bounds.minDepth > farthest;
+}
+
+VulkanApp::VolumeBounds VulkanApp::fullScreenBounds() const {
+        VolumeBounds bounds{};
+        bounds.scissor.offset = { 0, 0 };
+        bounds.scissor.extent = swapChainExtent;
+        bounds.minDepth = 0.0f;
+        bounds.maxDepth = 1.0f;
+        return bounds;
+}
+
+void VulkanApp::selectDepthReconstruction() {
+        if (settings.matrixDepthReconstruction) {
+            analyticDepthReconstruction = VK_FALSE;
+            std::cout << "depth reconstruction: inverse matrices (--matrix-depth)" << '\n';
+            return;
+        }
+
+        // the camera's matrices, built as simulateFrameState() builds uboFrame (without running the update stage: its side
+        // effects on the sort, decal, cluster and benchmark state stay out of startup)
+        glm::vec3 camPos = camera.position;
+        glm::mat4 view = glm::lookAt(camPos, camPos + camera.forward, camera.up);
+        glm::mat4 proj = glm::perspective(glm::radians(camera.fovY), swapChainExtent.width / (float)swapChainExtent.height, camera.nearPlane, camera.farPlane);
+        proj[1][1] *= -1;
+        glm::mat4 viewProj = proj * view;
+        glm::mat4 invViewProj = glm::inverse(viewProj);
+        glm::vec2 projParams = glm::vec2(proj[2][2], proj[3][2]);
+
+        // float precision of the two formulas: 1 sample per 8x8 pixels, at several depths between near and far plane
+        const uint32_t gridWidth = swapChainExtent.width / 8;
+        const uint32_t gridHeight = swapChainExtent.height / 8;
+        const float depths[] = { 0.05f, 0.5f, 0.9f, 0.99f, 0.999f };
+        double maxError = 0.0;
+        double maxRelativeError = 0.0;
+        for (uint32_t y = 0; y < gridHeight; y++) {
+            for (uint32_t x = 0; x < gridWidth; x++) {
+                glm::vec2 ndc = glm::vec2((x + 0.5f) / gridWidth, (y + 0.5f) / gridHeight) * 2.0f - 1.0f;
+
+                // view ray as the vertex shader computes it, for a point on this pixel
+                glm::vec4 vertexWorld = invViewProj * glm::vec4(ndc, 0.5f, 1.0f);
+                vertexWorld /= vertexWorld.w;
+                glm::vec4 vertexClip = viewProj * vertexWorld;
+                glm::vec3 viewRay = (glm::vec3(vertexWorld) - camPos) / vertexClip.w;
+
+                for (float depth : depths) {
+                    // reference: unproject with the inverse view-projection
+                    glm::vec4 reference = invViewProj * glm::vec4(ndc, depth, 1.0f);
+                    glm::vec3 referencePos = glm::vec3(reference) / reference.w;
+
+                    // analytic: linearized depth along the view ray
+                    float viewDepth = projParams.y / (depth + projParams.x);
+                    glm::vec3 analyticPos = camPos + viewRay * viewDepth;
+
+                    double error = glm::length(analyticPos - referencePos);
+                    maxError = std::max(maxError, error);
+                    maxRelativeError = std::max(maxRelativeError, error / std::max(glm::length(referencePos - camPos), 1e-6f));
+                }
+            }
+        }
+
+        // (float precision of the reference unprojection, relative to the distance from the camera).
+        // a precision check of the formulas on the CPU, not of the shaders: nothing is rendered or read back
+        const double tolerance = 1e-3;
+        std::cout << "depth linearization precision (CPU, analytic vs inverse-matrix formula): max error " << maxError << " (relative " << maxRelativeError << ", tolerance " << tolerance << ")" << '\n';
+        if (maxRelativeError > tolerance) {
+            analyticDepthReconstruction = VK_FALSE;
+            std::cout << "depth reconstruction: analytic path out of tolerance, using inverse matrices" << '\n';
+        }
+        else {
+            std::cout << "depth reconstruction: analytic" << '\n';
+        }
+}
+
+const std::string& VulkanApp::getSceneFragShaderPath() const {
+        // deferred shading: G-buffer output, lit by the lighting subpass. clustered: walks the fragment's cluster light list
+        if (deferred.enabled) {
+            return SHADER_FRAG_PATH_0_GBUFFER;
+        }
+        if (clustered.enabled) {
+            return shadow.enabled ? SHADER_FRAG_PATH_0_CLUSTERED_SHADOWS : SHADER_FRAG_PATH_0_CLUSTERED;
+        }
+        // multiview stereo: specular from the fragment's eye
+        if (multiview.enabled) {
+            return shadow.enabled ? SHADER_FRAG_PATH_0_SHADOWS_MULTIVIEW : SHADER_FRAG_PATH_0_MULTIVIEW;
+        }
+        return shadow.enabled ? SHADER_FRAG_PATH_0_SHADOWS : SHADER_FRAG_PATH_0;
+}
+
+const std::string& VulkanApp::getCompositionFragShaderPath() const {
+        // separate render passes: col0 sampled (texelFetch). bloom (separate render passes only): adds bloom level 0
+        if (settings.multiPass) {
+            return bloom.enabled ? SHADER_FRAG_PATH_3_SAMPLED_BLOOM : SHADER_FRAG_PATH_3_SAMPLED;
+        }
+        return SHADER_FRAG_PATH_3;
+}
+
+void VulkanApp::createGraphicsPipelineScene() {
+
+        /*Summary:
+        -> programmable shader stages
+        -> fixed function stages
+            - vertex input
+            - input assembler
+            - input assembler
+            - rasterizer
+            - viewport
+            - color blending
+        -> pipeline layout (uniform layout)
+        -> render pass (attachments and subpasses)
+
+        */
+        //1. Shader Loading 
+        const std::vector<char>& vertShaderCode = shaderCode.at(multiview.enabled ? SHADER_VERT_PATH_0_MULTIVIEW : SHADER_VERT_PATH_0); // loaded by loadShaderCode()
+        const std::vector<char>& fragShaderCode = shaderCode.at(getSceneFragShaderPath());
+
+        // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
+        // Thus, shader modules can be deleted when leaving pipeline-creation scope.
+
+        //2. Shader Modules setup
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        // shader function to call (entry point)
+        vertShaderStageInfo.pName = "main";
+        vertShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+
+        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragShaderStageInfo.module = fragShaderModule;
+        // shader function to call (entry point)
+        fragShaderStageInfo.pName = "main";
+        fragShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+
+        //3. Shader Stages 
+        VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
+
+        //4. Vertex Input
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        auto bindingDescription = Vertex::getBindingDescription();
+        auto attributeDescriptions = Vertex::getAttributeDescriptions();
+
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription; // describing vertex data bindings
+        vertexInputInfo.vertexAttributeDescriptionCount = 4;
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data(); // describing vertex data attributes
+
+        //5. Input AssembLer
+            // Topology:
+            /*
+            VK_PRIMITIVE_TOPOLOGY_POINT_LIST: points from vertices
+            VK_PRIMITIVE_TOPOLOGY_LINE_LIST : line from every 2 vertices without reuse
+            VK_PRIMITIVE_TOPOLOGY_LINE_STRIP : the end vertex of every line is used as start vertex for the next line
+            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : triangle from every 3 vertices without reuse
+            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : the second and third vertex of every triangle are used as first two vertices of the next triangle
+            */
+
+            // PrimitiveRestartEnable:
+            //VK_TRUE: Can break up lines and triangles in the _STRIP topology method, using 0xFFFF
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        //6. Viewport
+            // Transform
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)swapChainExtent.width;
+        viewport.height = (float)swapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        // Scissor (Clipping)
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = swapChainExtent;
+
+        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportStateCreateInfo.viewportCount = 1;
+        viewportStateCreateInfo.pViewports = &viewport;
+        viewportStateCreateInfo.scissorCount = 1;
+        viewportStateCreateInfo.pScissors = &scissor;
+
+        //7. Rasterizer (Rasterize fragments, perform depth-testing, face-culling and scissor-test.)
+            // polygonMode: can rasterize polygon fill, edges (wireframe), or points.
+                // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
+                // VK_POLYGON_MODE_LINE : polygon edges are drawn as lines
+                // VK_POLYGON_MODE_POINT : polygon vertices are drawn as points
+
+        VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
+        rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizerCreateInfo.depthClampEnable = VK_FALSE; // VK_TRUE = clamp (instead of discard) frags outside near/far plane.
+        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE; // VK_TRUE = dicard all geometry
+        rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizerCreateInfo.lineWidth = 1.0f;
+        rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT; // backface / frontface / both culling
+        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // vertex order to define front facing polygons
+
+        rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
+        rasterizerCreateInfo.depthBiasConstantFactor = 0.0f; // add constant offset to depth
+        rasterizerCreateInfo.depthBiasClamp = 0.0f;
+        rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
+
+        //8. Multisampling
+        VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
+        multisamplingCreateinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisamplingCreateinfo.sampleShadingEnable = VK_FALSE;
+        multisamplingCreateinfo.rasterizationSamples = msaa.samples; // col0MS/depth0MS with settings.msaaSamples, otherwise 1
+        multisamplingCreateinfo.minSampleShading = 1.0f;
+        multisamplingCreateinfo.pSampleMask = nullptr;
+        multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
+        multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
+
+        //9. Depth Stencil settings
+        VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
+        depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
+        depthStencilStateCreateInfo.depthWriteEnable = VK_TRUE;
+        depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+        // depth pre-pass: depth0 already holds the nearest surface, only the fragments that wrote it pass (invariant gl_Position)
+        if (settings.depthPrepass) {
+            depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
+            depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_EQUAL;
+        }
+
+        // can discard fragments outside a pre-defined range
+        depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.minDepthBounds = 0.0f;
+        depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
+
+        depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.front = {};
+        depthStencilStateCreateInfo.back = {};
+
+        //10. Color Blending 
+        // src = output's frag,  dst = attachment's frag   
+         
+            // RGB = srcCol *  srcBlend <op> dstCol * dstBlend
+            // A = srcAlpha * srcBlend <op> dstAlpha * dstBlend
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        // bit flag for masking specific channels of the framebuffer:
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        // color and alpha blend settings
+
+        colorBlendAttachment.blendEnable = VK_FALSE; // disable color blending
+        // deferred shading: gAlbedo and gNormal, both written without blending
+        std::array<VkPipelineColorBlendAttachmentState, 2> gbufferBlendAttachments = { colorBlendAttachment, colorBlendAttachment };
+
+        VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
+        colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlendingCreateInfo.logicOpEnable = VK_FALSE; // VK_FALSE: Enabled bitwise combination alpha blending
+        colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
+
+        colorBlendingCreateInfo.attachmentCount = 1;
+        colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
+        if (deferred.enabled) {
+            colorBlendingCreateInfo.attachmentCount = static_cast<uint32_t>(gbufferBlendAttachments.size());
+            colorBlendingCreateInfo.pAttachments = gbufferBlendAttachments.data();
+        }
+        colorBlendingCreateInfo.blendConstants[0] = 0.0f;
+        colorBlendingCreateInfo.blendConstants[1] = 0.0f;
+        colorBlendingCreateInfo.blendConstants[2] = 0.0f;
+        colorBlendingCreateInfo.blendConstants[3] = 0.0f;
+
+        //11. Dynamic States 
+            // Pipeline structs to be changed in runtime
+        VkDynamicState dynamicStates[] = {
+            VK_DYNAMIC_STATE_VIEWPORT, //viewport size
+            VK_DYNAMIC_STATE_LINE_WIDTH
+        };
+
+        VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
+        dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicStateCreateInfo.dynamicStateCount = 2;
+        dynamicStateCreateInfo.pDynamicStates = dynamicStates;
+
+        //12. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        // set 0: frame, set 1: scene, (set 2: clustered lights), (set 3: shadow map, also read by the shadow map pass)
+        pipelineLayoutCreateInfo.setLayoutCount = shadow.enabled ? 4 : (clustered.enabled ? 3 : 2);
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.scene, descriptorSetLayouts.clusters, descriptorSetLayouts.shadows };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
+
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.scene);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+
+        // Graphics Pipeline Struct
+        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+        // programmable shader stages
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stageCount = 2; // amount of shader stages
+        pipelineCreateInfo.pStages = shaderStagesCreateInfo;
+
+        // fixed function stages
+        pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
+        pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+        pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+        pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+        pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
+        pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+        pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
+        pipelineCreateInfo.pDynamicState = nullptr;
+
+        // uniform pipeline layout
+        pipelineCreateInfo.layout = pipelineLayouts.scene;
+
+        // render passes
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget("scene", pipelineCreateInfo, renderTarget);
+
+        // create pipeline deriving from existing pipeline
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        // create pipeline(s)
+        // (device, VkPipelineCache, pipelineInfos, nullptr, graphicsPipeline)
+        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.scene);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create graphics pipeline");
+        }
+
+        std::cout << "graphics pipeline created" << '\n';
+
+        // position-only vertex stream (depthPrepass.positionBuffer) of the depth pre-pass and shadow map pipelines
+        VkVertexInputBindingDescription positionBindingDescription{};
+        positionBindingDescription.binding = 0;
+        positionBindingDescription.stride = sizeof(glm::vec3);
+        positionBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        VkVertexInputAttributeDescription positionAttributeDescription = attributeDescriptions[0]; // location 0: pos
+        positionAttributeDescription.offset = 0;
+        VkPipelineVertexInputStateCreateInfo depthVertexInputInfo = vertexInputInfo;
+        depthVertexInputInfo.vertexBindingDescriptionCount = 1;
+        depthVertexInputInfo.pVertexBindingDescriptions = &positionBindingDescription;
+        depthVertexInputInfo.vertexAttributeDescriptionCount = 1;
+        depthVertexInputInfo.pVertexAttributeDescriptions = &positionAttributeDescription;
+
+        // Depth pre-pass pipeline: position-only vertex stream, vertex shader only, depth test LESS with writes, no color writes
+        if (settings.depthPrepass) {
+            VkShaderModule depthVertShaderModule = createShaderModule(shaderCode.at(multiview.enabled ? SHADER_VERT_PATH_0_DEPTH_MULTIVIEW : SHADER_VERT_PATH_0_DEPTH));
+            VkPipelineShaderStageCreateInfo depthShaderStageInfo = vertShaderStageInfo;
+            depthShaderStageInfo.module = depthVertShaderModule;
+
+            VkPipelineDepthStencilStateCreateInfo depthDepthStencilStateCreateInfo = depthStencilStateCreateInfo;
+            depthDepthStencilStateCreateInfo.depthWriteEnable = VK_TRUE;
+            depthDepthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+
+            // the subpass has no color attachments (the dynamic rendering backend maps col0 with a zero write mask)
+            VkPipelineColorBlendAttachmentState depthColorBlendAttachment{};
+            depthColorBlendAttachment.colorWriteMask = 0;
+            depthColorBlendAttachment.blendEnable = VK_FALSE;
+            VkPipelineColorBlendStateCreateInfo depthColorBlendingCreateInfo = colorBlendingCreateInfo;
+            depthColorBlendingCreateInfo.attachmentCount = 0;
+            depthColorBlendingCreateInfo.pAttachments = &depthColorBlendAttachment;
+
+            VkGraphicsPipelineCreateInfo depthPipelineCreateInfo = pipelineCreateInfo;
+            depthPipelineCreateInfo.pNext = nullptr;
+            depthPipelineCreateInfo.stageCount = 1; // no fragment shader
+            depthPipelineCreateInfo.pStages = &depthShaderStageInfo;
+            depthPipelineCreateInfo.pVertexInputState = &depthVertexInputInfo;
+            depthPipelineCreateInfo.pDepthStencilState = &depthDepthStencilStateCreateInfo;
+            depthPipelineCreateInfo.pColorBlendState = &depthColorBlendingCreateInfo;
+
+            PipelineRenderTarget depthRenderTarget{};
+            setPipelineRenderTarget("depthPrepass", depthPipelineCreateInfo, depthRenderTarget);
+
+            pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &depthPipelineCreateInfo, nullptr, &pipelines.depthPrepass);
+            if (pipelineCreated != VK_SUCCESS) {
+                throw std::runtime_error("failed to create graphics pipeline");
+            }
+
+            std::cout << "graphics pipeline created" << '\n';
+            vkDestroyShaderModule(device, depthVertShaderModule, nullptr);
+        }
+
+        // Shadow map pipeline: position-only vertex stream projected with the light (-DSHADOW_CASTER), vertex shader only,
+        // in the shadow render pass (shadow map extent, single sample). both faces are drawn (the scene mesh is not closed),
+        // the slope-scaled depth bias keeps lit surfaces from shadowing themselves
+        if (shadow.enabled) {
+            VkShaderModule shadowVertShaderModule = createShaderModule(shaderCode.at(SHADER_VERT_PATH_0_SHADOW));
+            VkPipelineShaderStageCreateInfo shadowShaderStageInfo = vertShaderStageInfo;
+            shadowShaderStageInfo.module = shadowVertShaderModule;
+
+            VkViewport shadowViewport{};
+            shadowViewport.x = 0.0f;
+            shadowViewport.y = 0.0f;
+            shadowViewport.width = static_cast<float>(shadow.extent.width);
+            shadowViewport.height = static_cast<float>(shadow.extent.height);
+            shadowViewport.minDepth = 0.0f;
+            shadowViewport.maxDepth = 1.0f;
+            VkRect2D shadowScissor{};
+            shadowScissor.offset = { 0, 0 };
+            shadowScissor.extent = shadow.extent;
+            VkPipelineViewportStateCreateInfo shadowViewportStateCreateInfo = viewportStateCreateInfo;
+            shadowViewportStateCreateInfo.pViewports = &shadowViewport;
+            shadowViewportStateCreateInfo.pScissors = &shadowScissor;
+
+            VkPipelineRasterizationStateCreateInfo shadowRasterizerCreateInfo = rasterizerCreateInfo;
+            shadowRasterizerCreateInfo.cullMode = VK_CULL_MODE_NONE;
+            shadowRasterizerCreateInfo.depthBiasEnable = VK_TRUE;
+            shadowRasterizerCreateInfo.depthBiasConstantFactor = 1.25f;
+            shadowRasterizerCreateInfo.depthBiasClamp = 0.0f;
+            shadowRasterizerCreateInfo.depthBiasSlopeFactor = 1.75f;
+
+            VkPipelineMultisampleStateCreateInfo shadowMultisamplingCreateInfo = multisamplingCreateinfo;
+            shadowMultisamplingCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+            VkPipelineDepthStencilStateCreateInfo shadowDepthStencilStateCreateInfo = depthStencilStateCreateInfo;
+            shadowDepthStencilStateCreateInfo.depthWriteEnable = VK_TRUE;
+            shadowDepthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+
+            VkPipelineColorBlendStateCreateInfo shadowColorBlendingCreateInfo = colorBlendingCreateInfo;
+            shadowColorBlendingCreateInfo.attachmentCount = 0; // depth-only render pass
+            shadowColorBlendingCreateInfo.pAttachments = nullptr;
+
+            VkGraphicsPipelineCreateInfo shadowPipelineCreateInfo = pipelineCreateInfo;
+            shadowPipelineCreateInfo.pNext = nullptr;
+            shadowPipelineCreateInfo.stageCount = 1; // no fragment shader
+            shadowPipelineCreateInfo.pStages = &shadowShaderStageInfo;
+            shadowPipelineCreateInfo.pVertexInputState = &depthVertexInputInfo;
+            shadowPipelineCreateInfo.pViewportState = &shadowViewportStateCreateInfo;
+            shadowPipelineCreateInfo.pRasterizationState = &shadowRasterizerCreateInfo;
+            shadowPipelineCreateInfo.pMultisampleState = &shadowMultisamplingCreateInfo;
+            shadowPipelineCreateInfo.pDepthStencilState = &shadowDepthStencilStateCreateInfo;
+            shadowPipelineCreateInfo.pColorBlendState = &shadowColorBlendingCreateInfo;
+            shadowPipelineCreateInfo.renderPass = shadow.renderPass;
+            shadowPipelineCreateInfo.subpass = shadow.graph.getSubpassIndex("shadow");
+
+            pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &shadowPipelineCreateInfo, nullptr, &pipelines.shadow);
+            if (pipelineCreated != VK_SUCCESS) {
+                throw std::runtime_error("failed to create graphics pipeline");
+            }
+
+            std::cout << "graphics pipeline created" << '\n';
+            vkDestroyShaderModule(device, shadowVertShaderModule, nullptr);
+        }
+
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        vkDestroyShaderModule(device, fragShaderModule, nullptr);
+
+}
+
+void VulkanApp::createGraphicsPipelineFX() {
+
+        //1. Shader Loading 
+        const std::vector<char>& vertShaderCode = shaderCode.at(multiview.enabled ? SHADER_VERT_PATH_1_MULTIVIEW : SHADER_VERT_PATH_1); // loaded by loadShaderCode()
+        std::string fragShaderPath = settings.multiPass ? SHADER_FRAG_PATH_1_SAMPLED : SHADER_FRAG_PATH_1;
+        if (oit.enabled) {
+            fragShaderPath = SHADER_FRAG_PATH_1_OIT; // accumulation + revealage outputs
+        }
+        if (multiview.enabled) {
+            fragShaderPath = oit.enabled ? SHADER_FRAG_PATH_1_OIT_MULTIVIEW : SHADER_FRAG_PATH_1_MULTIVIEW;
+        }
+        const std::vector<char>& fragShaderCode = shaderCode.at(fragShaderPath);
+
+        // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
+        // Thus, shader modules can be deleted when leaving pipeline-creation scope.
+
+        //2. Shader Modules setup
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        // shader function to call (entry point)
+        vertShaderStageInfo.pName = "main";
+        vertShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+
+        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragShaderStageInfo.module = fragShaderModule;
+        // shader function to call (entry point)
+        fragShaderStageInfo.pName = "main";
+        // constant_id = 0: ANALYTIC_DEPTH (scene position reconstruction from the depth input)
+        VkSpecializationMapEntry specializationEntry{};
+        specializationEntry.constantID = 0;
+        specializationEntry.offset = 0;
+        specializationEntry.size = sizeof(VkBool32);
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = 1;
+        specializationInfo.pMapEntries = &specializationEntry;
+        specializationInfo.dataSize = sizeof(VkBool32);
+        specializationInfo.pData = &analyticDepthReconstruction;
+        fragShaderStageInfo.pSpecializationInfo = &specializationInfo; // can set values for shader constants 
+
+        //3. Shader Stages 
+        VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
+
+        //4. Vertex Input
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        auto bindingDescription = Vertex::getBindingDescription();
+        auto attributeDescriptions = Vertex::getAttributeDescriptions();
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription; // describing vertex data bindings
+        vertexInputInfo.vertexAttributeDescriptionCount = 4;
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data(); // describing vertex data attributes
+
+        //5. Input AssembLer
+            // Topology:
+            /*
+            VK_PRIMITIVE_TOPOLOGY_POINT_LIST: points from vertices
+            VK_PRIMITIVE_TOPOLOGY_LINE_LIST : line from every 2 vertices without reuse
+            VK_PRIMITIVE_TOPOLOGY_LINE_STRIP : the end vertex of every line is used as start vertex for the next line
+            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : triangle from every 3 vertices without reuse
+            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : the second and third vertex of every triangle are used as first two vertices of the next triangle
+            */
+
+        // PrimitiveRestartEnable:
+            //VK_TRUE: Can break up lines and triangles in the _STRIP topology method, using 0xFFFF
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        //6. Viewport
+            // Transform
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)swapChainExtent.width;
+        viewport.height = (float)swapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        // Scissor (Clipping)
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = swapChainExtent;
+
+        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportStateCreateInfo.viewportCount = 1;
+        viewportStateCreateInfo.pViewports = &viewport;
+        viewportStateCreateInfo.scissorCount = 1;
+        viewportStateCreateInfo.pScissors = &scissor;
+
+        //7. Rasterizer (Rasterize fragments, perform depth-testing, face-culling and scissor-test.)
+            // polygonMode: can rasterize polygon fill, edges (wireframe), or points.
+                // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
+                // VK_POLYGON_MODE_LINE : polygon edges are drawn as lines
+                // VK_POLYGON_MODE_POINT : polygon vertices are drawn as points
+
+        VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
+        rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizerCreateInfo.depthClampEnable = VK_FALSE; // VK_TRUE = clamp (instead of discard) frags outside near/far plane.
+        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE; // VK_TRUE = dicard all geometry
+        rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizerCreateInfo.lineWidth = 1.0f;
+        rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT; // backface / frontface / both culling
+        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // vertex order to define front facing polygons
+
+        rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
+        rasterizerCreateInfo.depthBiasConstantFactor = 0.0f; // add constant offset to depth
+        rasterizerCreateInfo.depthBiasClamp = 0.0f;
+        rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
+
+        //8. Multisampling
+        VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
+        multisamplingCreateinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisamplingCreateinfo.sampleShadingEnable = VK_FALSE;
+        multisamplingCreateinfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multisamplingCreateinfo.minSampleShading = 1.0f;
+        multisamplingCreateinfo.pSampleMask = nullptr;
+        multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
+        multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
+
+        //9. Depth and Stencil write/test
+        VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
+        depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
+        depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
+        depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+
+        // can discard fragments outside a pre-defined range
+        depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.minDepthBounds = 0.0f;
+        depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
+
+        depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.front = {};
+        depthStencilStateCreateInfo.back = {};
+
+        //10. Color Blending
+        // src = output's frag,  dst = attachment's frag   
+
+            // RGB = srcCol *  srcBlend <op> dstCol * dstBlend
+            // A = srcAlpha * srcBlend <op> dstAlpha * dstBlend
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        // bit flag for masking specific channels of the framebuffer:
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        
+        // color and alpha blend settings
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        // srcCol * srcAlpha + dstCol * 1-srcAlpha
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        // srcAlpha * 1 + dstAlpha * 0
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+
+        // OIT: both blends are commutative, so the draw order does not matter
+        std::array<VkPipelineColorBlendAttachmentState, 2> oitBlendAttachments{};
+        // oitAccum: srcCol * 1 + dstCol * 1 (sum of weighted premultiplied colors and weighted alphas)
+        oitBlendAttachments[0] = colorBlendAttachment;
+        oitBlendAttachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        oitBlendAttachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        oitBlendAttachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        oitBlendAttachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        // oitReveal: srcCol * 0 + dstCol * (1 - srcCol), with srcCol = alpha (product of the fragments' transmittance)
+        oitBlendAttachments[1] = colorBlendAttachment;
+        oitBlendAttachments[1].colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+        oitBlendAttachments[1].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+        oitBlendAttachments[1].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+
+        VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
+        colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlendingCreateInfo.logicOpEnable = VK_FALSE; // VK_FALSE: Enabled bitwise combination alpha blending
+        colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
+
+        colorBlendingCreateInfo.attachmentCount = 1;
+        colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
+        if (oit.enabled) {
+            colorBlendingCreateInfo.attachmentCount = static_cast<uint32_t>(oitBlendAttachments.size());
+            colorBlendingCreateInfo.pAttachments = oitBlendAttachments.data();
+        }
+        colorBlendingCreateInfo.blendConstants[0] = 0.0f;
+        colorBlendingCreateInfo.blendConstants[1] = 0.0f;
+        colorBlendingCreateInfo.blendConstants[2] = 0.0f;
+        colorBlendingCreateInfo.blendConstants[3] = 0.0f;
+
+        //11. Dynamic States 
+            // Pipeline structs to be changed in runtime
+            // scissor: the sphere's projected screen-space bounds, set per frame (no depth bounds: the sphere's outline
+            // is shaded whatever the scene depth behind it)
+        VkDynamicState dynamicStates[] = {
+            VK_DYNAMIC_STATE_SCISSOR
+        };
+
+        VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
+        dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicStateCreateInfo.dynamicStateCount = 1;
+        dynamicStateCreateInfo.pDynamicStates = dynamicStates;
+
+        //12. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 3; // FX pipeline has three descriptor sets (frame, fx0, fx1)
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.fx0,  descriptorSetLayouts.fx1 };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
+
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.fx);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+
+        // Graphics Pipeline Struct
+        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+        // programmable shader stages
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stageCount = 2; // amount of shader stages
+        pipelineCreateInfo.pStages = shaderStagesCreateInfo;
+
+        // fixed function stages
+        pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
+        pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+        pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+        pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+        pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
+        pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+        pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
+        pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+
+        // uniform pipeline layout
+        pipelineCreateInfo.layout = pipelineLayouts.fx;
+
+        // render passes (OIT: the fx subpass between composition and resolve)
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget(oit.enabled ? "fx" : "composition", pipelineCreateInfo, renderTarget);
+
+        // create pipeline deriving from existing pipeline
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        // create pipeline(s)
+        // (device, VkPipelineCache, pipelineInfos, nullptr, graphicsPipeline)
+        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.fx);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create graphics pipeline");
+        }
+
+        std::cout << "graphics pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        vkDestroyShaderModule(device, fragShaderModule, nullptr);
+
+}
+
+void VulkanApp::createGraphicsPipelineDecal() {
+
+    //1. Shader Loading 
+    const std::vector<char>& vertShaderCode = shaderCode.at(multiview.enabled ? SHADER_VERT_PATH_2_MULTIVIEW : SHADER_VERT_PATH_2); // loaded by loadShaderCode()
+    const std::vector<char>& fragShaderCode = shaderCode.at(multiview.enabled ? SHADER_FRAG_PATH_2_MULTIVIEW : settings.multiPass ? SHADER_FRAG_PATH_2_SAMPLED : SHADER_FRAG_PATH_2);
+
+    // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
+    // Thus, shader modules can be deleted when leaving pipeline-creation scope.
+
+    //2. Shader Modules setup
+    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageInfo.module = vertShaderModule;
+    // shader function to call (entry point)
+    vertShaderStageInfo.pName = "main";
+    vertShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+
+    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragShaderStageInfo.module = fragShaderModule;
+    // shader function to call (entry point)
+    fragShaderStageInfo.pName = "main";
+    // constant_id = 0: ANALYTIC_DEPTH (scene position reconstruction from the depth input)
+    VkSpecializationMapEntry specializationEntry{};
+    specializationEntry.constantID = 0;
+    specializationEntry.offset = 0;
+    specializationEntry.size = sizeof(VkBool32);
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = 1;
+    specializationInfo.pMapEntries = &specializationEntry;
+    specializationInfo.dataSize = sizeof(VkBool32);
+    specializationInfo.pData = &analyticDepthReconstruction;
+    fragShaderStageInfo.pSpecializationInfo = &specializationInfo; // can set values for shader constants 
+
+    //3. Shader Stages 
+    VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
+
+    //4. Vertex Input
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    auto bindingDescription = Vertex::getBindingDescription();
+    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription; // describing vertex data bindings
+    vertexInputInfo.vertexAttributeDescriptionCount = 4;
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data(); // describing vertex data attributes
+
+    //5. Input AssembLer
+        // Topology:
+        /*
+        VK_PRIMITIVE_TOPOLOGY_POINT_LIST: points from vertices
+        VK_PRIMITIVE_TOPOLOGY_LINE_LIST : line from every 2 vertices without reuse
+        VK_PRIMITIVE_TOPOLOGY_LINE_STRIP : the end vertex of every line is used as start vertex for the next line
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : triangle from every 3 vertices without reuse
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : the second and third vertex of every triangle are used as first two vertices of the next triangle
+        */
+
+        // PrimitiveRestartEnable:
+            //VK_TRUE: Can break up lines and triangles in the _STRIP topology method, using 0xFFFF
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    //6. Viewport
+        // Transform
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)swapChainExtent.width;
+    viewport.height = (float)swapChainExtent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    // Scissor (Clipping)
+    VkRect2D scissor{};
+    scissor.offset = { 0, 0 };
+    scissor.extent = swapChainExtent;
+
+    VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+    viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportStateCreateInfo.viewportCount = 1;
+    viewportStateCreateInfo.pViewports = &viewport;
+    viewportStateCreateInfo.scissorCount = 1;
+    viewportStateCreateInfo.pScissors = &scissor;
+
+    //7. Rasterizer (Rasterize fragments, perform depth-testing, face-culling and scissor-test.)
+        // polygonMode: can rasterize polygon fill, edges (wireframe), or points.
+            // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
+            // VK_POLYGON_MODE_LINE : polygon edges are drawn as lines
+            // VK_POLYGON_MODE_POINT : polygon vertices are drawn as points
+
+    VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
+    rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizerCreateInfo.depthClampEnable = VK_FALSE; // VK_TRUE = clamp (instead of discard) frags outside near/far plane.
+    rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE; // VK_TRUE = dicard all geometry
+    rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizerCreateInfo.lineWidth = 1.0f;
+    rasterizerCreateInfo.cullMode = VK_CULL_MODE_FRONT_BIT; // backface / frontface / both culling
+    rasterizerCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // vertex order to define front facing polygons
+
+    rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
+    rasterizerCreateInfo.depthBiasConstantFactor = 0.0f; // add constant offset to depth
+    rasterizerCreateInfo.depthBiasClamp = 0.0f;
+    rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
+
+    //8. Multisampling
+    VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
+    multisamplingCreateinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisamplingCreateinfo.sampleShadingEnable = VK_FALSE;
+    multisamplingCreateinfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisamplingCreateinfo.minSampleShading = 1.0f;
+    multisamplingCreateinfo.pSampleMask = nullptr;
+    multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
+    multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
+
+    //9. Depth and Stencil write/test
+    VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
+    depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
+    depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
+    depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_GREATER_OR_EQUAL;
+
+    // can discard fragments outside a pre-defined range
+    // scene depth outside of the box's depth range can't be inside the box: rejected before the fragment shader runs
+    depthStencilStateCreateInfo.depthBoundsTestEnable = volumeDraws.depthBoundsTest ? VK_TRUE : VK_FALSE;
+    depthStencilStateCreateInfo.minDepthBounds = 0.0f;
+    depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
+
+    // stencil mask: only shade pixels the marking draw (pipelines.decalStencil) left non-zero, i.e. where scene geometry lies
+    // inside the box; every shaded pixel is reset to 0 (passOp) for the next decal
+    VkStencilOpState decalStencilOp{};
+    decalStencilOp.failOp = VK_STENCIL_OP_KEEP;
+    decalStencilOp.passOp = VK_STENCIL_OP_ZERO;
+    decalStencilOp.depthFailOp = VK_STENCIL_OP_ZERO;
+    decalStencilOp.compareOp = VK_COMPARE_OP_NOT_EQUAL;
+    decalStencilOp.compareMask = 0xff;
+    decalStencilOp.writeMask = 0xff;
+    decalStencilOp.reference = 0;
+    depthStencilStateCreateInfo.stencilTestEnable = volumeDraws.decalStencil ? VK_TRUE : VK_FALSE;
+    depthStencilStateCreateInfo.front = decalStencilOp;
+    depthStencilStateCreateInfo.back = decalStencilOp;
+
+    //10. Color Blending
+    // src = output's frag,  dst = attachment's frag   
+
+        // RGB = srcCol *  srcBlend <op> dstCol * dstBlend
+        // A = srcAlpha * srcBlend <op> dstAlpha * dstBlend
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    // bit flag for masking specific channels of the framebuffer:
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    // color and alpha blend settings
+    colorBlendAttachment.blendEnable = VK_TRUE;
+    // srcCol * srcAlpha + dstCol * 1-srcAlpha
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    // srcAlpha * 1 + dstAlpha * 0
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+
+    VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
+    colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlendingCreateInfo.logicOpEnable = VK_FALSE; // VK_FALSE: Enabled bitwise combination alpha blending
+    colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
+
+    colorBlendingCreateInfo.attachmentCount = 1;
+    colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
+    colorBlendingCreateInfo.blendConstants[0] = 0.0f;
+    colorBlendingCreateInfo.blendConstants[1] = 0.0f;
+    colorBlendingCreateInfo.blendConstants[2] = 0.0f;
+    colorBlendingCreateInfo.blendConstants[3] = 0.0f;
+
+    //11. Dynamic States 
+        // Pipeline structs to be changed in runtime
+        // scissor and depth bounds: the box's projected screen-space bounds and depth range, set per frame
+    std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_SCISSOR };
+    if (volumeDraws.depthBoundsTest) {
+        dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_BOUNDS);
+    }
+
+    VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
+    dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicStateCreateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicStateCreateInfo.pDynamicStates = dynamicStates.data();
+
+    //12. Pipeline Layout (descriptor set layouts)
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 3; // decal pipeline has three descriptor sets (frame, fx0, fx1)
+    VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.fx0,  descriptorSetLayouts.fx1 };
+    pipelineLayoutCreateInfo.pSetLayouts = layouts;
+
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+    pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+    VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.decal);
+    if (pipelineLayoutCreated != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline layout");
+    }
+
+
+    // Graphics Pipeline Struct
+    VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+    // programmable shader stages
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stageCount = 2; // amount of shader stages
+    pipelineCreateInfo.pStages = shaderStagesCreateInfo;
+
+    // fixed function stages
+    pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
+    pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+    pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+    pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+    pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
+    pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+    pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
+    pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+
+    // uniform pipeline layout
+    pipelineCreateInfo.layout = pipelineLayouts.decal;
+
+    // render passes
+    PipelineRenderTarget renderTarget{};
+    setPipelineRenderTarget("composition", pipelineCreateInfo, renderTarget);
+
+    // create pipeline deriving from existing pipeline
+    pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineCreateInfo.basePipelineIndex = -1;
+
+    // create pipeline(s)
+    // (device, VkPipelineCache, pipelineInfos, nullptr, graphicsPipeline)
+    VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.decal);
+    if (pipelineCreated != VK_SUCCESS) {
+        throw std::runtime_error("failed to create graphics pipeline");
+    }
+
+    std::cout << "graphics pipeline created" << '\n';
+
+    // Stencil marking pipeline (z-fail): both faces of the box, vertex shader only, no color writes.
+    // Faces behind the scene surface fail the depth test: back faces increment, front faces decrement,
+    // so the stencil ends up non-zero only where the scene surface lies inside the box (also with the camera inside the box)
+    if (volumeDraws.decalStencil) {
+        VkPipelineRasterizationStateCreateInfo stencilRasterizerCreateInfo = rasterizerCreateInfo;
+        stencilRasterizerCreateInfo.cullMode = VK_CULL_MODE_NONE;
+
+        VkPipelineDepthStencilStateCreateInfo stencilDepthStencilStateCreateInfo = depthStencilStateCreateInfo;
+        stencilDepthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+        VkStencilOpState markStencilOp{};
+        markStencilOp.failOp = VK_STENCIL_OP_KEEP;
+        markStencilOp.passOp = VK_STENCIL_OP_KEEP;
+        markStencilOp.compareOp = VK_COMPARE_OP_ALWAYS;
+        markStencilOp.compareMask = 0xff;
+        markStencilOp.writeMask = 0xff;
+        markStencilOp.reference = 0;
+        stencilDepthStencilStateCreateInfo.front = markStencilOp;
+        stencilDepthStencilStateCreateInfo.front.depthFailOp = VK_STENCIL_OP_DECREMENT_AND_WRAP;
+        stencilDepthStencilStateCreateInfo.back = markStencilOp;
+        stencilDepthStencilStateCreateInfo.back.depthFailOp = VK_STENCIL_OP_INCREMENT_AND_WRAP;
+
+        VkPipelineColorBlendAttachmentState stencilColorBlendAttachment{};
+        stencilColorBlendAttachment.colorWriteMask = 0;
+        stencilColorBlendAttachment.blendEnable = VK_FALSE;
+        VkPipelineColorBlendStateCreateInfo stencilColorBlendingCreateInfo = colorBlendingCreateInfo;
+        stencilColorBlendingCreateInfo.pAttachments = &stencilColorBlendAttachment;
+
+        VkGraphicsPipelineCreateInfo stencilPipelineCreateInfo = pipelineCreateInfo;
+        stencilPipelineCreateInfo.pNext = nullptr;
+        stencilPipelineCreateInfo.stageCount = 1; // no fragment shader
+        stencilPipelineCreateInfo.pRasterizationState = &stencilRasterizerCreateInfo;
+        stencilPipelineCreateInfo.pDepthStencilState = &stencilDepthStencilStateCreateInfo;
+        stencilPipelineCreateInfo.pColorBlendState = &stencilColorBlendingCreateInfo;
+
+        PipelineRenderTarget stencilRenderTarget{};
+        setPipelineRenderTarget("composition", stencilPipelineCreateInfo, stencilRenderTarget);
+
+        pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &stencilPipelineCreateInfo, nullptr, &pipelines.decalStencil);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create graphics pipeline");
+        }
+
+        std::cout << "graphics pipeline created" << '\n';
+    }
+
+    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    vkDestroyShaderModule(device, fragShaderModule, nullptr);
+
+}
+
+void VulkanApp::createGraphicsPipelineDecalTiles() {
+        if (settings.volumeDecals) {
+            return; // single decal box drawn by pipelines.decal
+        }
+        // tiled decals: one quad per active screen tile, all decals of the tile blended in the fragment shader
+        //1. Shader Loading 
+        const std::vector<char>& vertShaderCode = shaderCode.at(SHADER_VERT_PATH_4); // loaded by loadShaderCode()
+        const std::vector<char>& fragShaderCode = shaderCode.at(settings.multiPass ? SHADER_FRAG_PATH_4_SAMPLED : SHADER_FRAG_PATH_4);
+
+        //2. Shader Modules setup
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        vertShaderStageInfo.pName = "main";
+        vertShaderStageInfo.pSpecializationInfo = nullptr;
+
+        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragShaderStageInfo.module = fragShaderModule;
+        fragShaderStageInfo.pName = "main";
+        // constant_id = 0: ANALYTIC_DEPTH (scene position reconstruction from the depth input)
+        VkSpecializationMapEntry specializationEntry{};
+        specializationEntry.constantID = 0;
+        specializationEntry.offset = 0;
+        specializationEntry.size = sizeof(VkBool32);
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = 1;
+        specializationInfo.pMapEntries = &specializationEntry;
+        specializationInfo.dataSize = sizeof(VkBool32);
+        specializationInfo.pData = &analyticDepthReconstruction;
+        fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+        //3. Shader Stages 
+        VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
+
+        //4. Vertex Input
+            // none: tile quads are generated from gl_VertexIndex/gl_InstanceIndex
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 0;
+        vertexInputInfo.pVertexBindingDescriptions = nullptr;
+        vertexInputInfo.vertexAttributeDescriptionCount = 0;
+        vertexInputInfo.pVertexAttributeDescriptions = nullptr;
+
+        //5. Input AssembLer
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        //6. Viewport
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)swapChainExtent.width;
+        viewport.height = (float)swapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = swapChainExtent;
+
+        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportStateCreateInfo.viewportCount = 1;
+        viewportStateCreateInfo.pViewports = &viewport;
+        viewportStateCreateInfo.scissorCount = 1;
+        viewportStateCreateInfo.pScissors = &scissor;
+
+        //7. Rasterizer
+        VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
+        rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizerCreateInfo.depthClampEnable = VK_FALSE;
+        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+        rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizerCreateInfo.lineWidth = 1.0f;
+        rasterizerCreateInfo.cullMode = VK_CULL_MODE_NONE; // screen-space quads
+        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
+        rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
+
+        //8. Multisampling
+        VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
+        multisamplingCreateinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisamplingCreateinfo.sampleShadingEnable = VK_FALSE;
+        multisamplingCreateinfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multisamplingCreateinfo.minSampleShading = 1.0f;
+        multisamplingCreateinfo.pSampleMask = nullptr;
+        multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
+        multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
+
+        //9. Depth and Stencil write/test
+            // none: the shader reads the scene depth itself and tests it against each decal box
+        VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
+        depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencilStateCreateInfo.depthTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
+        depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+        depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.minDepthBounds = 0.0f;
+        depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
+        depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
+
+        //10. Color Blending
+            // the shader composites all decals of a pixel with premultiplied alpha: dstCol * (1 - srcAlpha) + srcCol
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+
+        VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
+        colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
+        colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
+        colorBlendingCreateInfo.attachmentCount = 1;
+        colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
+
+        //11. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 3; // set 0: frame, set 1: decal storage buffers, set 2: col0/depth0 inputs (fx1)
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.decal, descriptorSetLayouts.fx1 };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.decalTiles);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        // Graphics Pipeline Struct
+        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stageCount = 2;
+        pipelineCreateInfo.pStages = shaderStagesCreateInfo;
+        pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
+        pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+        pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+        pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+        pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
+        pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+        pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
+        pipelineCreateInfo.pDynamicState = nullptr;
+        pipelineCreateInfo.layout = pipelineLayouts.decalTiles;
+
+        // render passes
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget("composition", pipelineCreateInfo, renderTarget);
+
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.decalTiles);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create graphics pipeline");
+        }
+
+        std::cout << "graphics pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        vkDestroyShaderModule(device, fragShaderModule, nullptr);
+}
+
+void VulkanApp::createComputePipelineFxSort() {
+        if (!settings.gpuSort) {
+            return; // CPU sort in the update stage
+        }
+        //1. Shader Loading 
+        const std::vector<char>& compShaderCode = shaderCode.at(SHADER_COMP_PATH_FX_SORT); // loaded by loadShaderCode()
+
+        //2. Shader Modules setup
+        VkShaderModule compShaderModule = createShaderModule(compShaderCode);
+
+        // constant_id = 0: INSTANCE_COUNT
+        uint32_t instanceCount = static_cast<uint32_t>(fxInstances.instances.size());
+        VkSpecializationMapEntry specializationEntry{};
+        specializationEntry.constantID = 0;
+        specializationEntry.offset = 0;
+        specializationEntry.size = sizeof(uint32_t);
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = 1;
+        specializationInfo.pMapEntries = &specializationEntry;
+        specializationInfo.dataSize = sizeof(uint32_t);
+        specializationInfo.pData = &instanceCount;
+
+        VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+        compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        compShaderStageInfo.module = compShaderModule;
+        compShaderStageInfo.pName = "main";
+        compShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+        //3. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 2; // set 0: frame, set 1: fx instances and sort buffers
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.fxSort };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.fxSort);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        // Compute Pipeline Struct
+        VkComputePipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage = compShaderStageInfo;
+        pipelineCreateInfo.layout = pipelineLayouts.fxSort;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkResult pipelineCreated = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.fxSort);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create compute pipeline");
+        }
+
+        std::cout << "compute pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
+
+void VulkanApp::createComputePipelineFxCull() {
+        if (!settings.gpuCulling) {
+            return; // direct fx draw of all instances
+        }
+        //1. Shader Loading 
+        // (Hi-Z: the variant that also tests the instances against the depth pyramid)
+        const std::vector<char>& compShaderCode = shaderCode.at(hiZ.enabled ? SHADER_COMP_PATH_FX_CULL_HI_Z : SHADER_COMP_PATH_FX_CULL); // loaded by loadShaderCode()
+
+        //2. Shader Modules setup
+        VkShaderModule compShaderModule = createShaderModule(compShaderCode);
+
+        // constant_id = 0: INSTANCE_COUNT, 1: INDEX_COUNT (of the draw command), 2: BOUNDS_RADIUS
+        // (bounding sphere of the fx mesh around its origin, the point the instance scale is applied to)
+        struct CullSpecialization {
+            uint32_t instanceCount;
+            uint32_t indexCount;
+            float boundsRadius;
+        } specializationData;
+        specializationData.instanceCount = static_cast<uint32_t>(fxInstances.instances.size());
+        specializationData.indexCount = static_cast<uint32_t>(indicesFX.size());
+        specializationData.boundsRadius = std::max(glm::length(volumeDraws.fxLocalMin), glm::length(volumeDraws.fxLocalMax));
+        std::array<VkSpecializationMapEntry, 3> specializationEntries{};
+        specializationEntries[0] = { 0, offsetof(CullSpecialization, instanceCount), sizeof(uint32_t) };
+        specializationEntries[1] = { 1, offsetof(CullSpecialization, indexCount), sizeof(uint32_t) };
+        specializationEntries[2] = { 2, offsetof(CullSpecialization, boundsRadius), sizeof(float) };
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+        specializationInfo.pMapEntries = specializationEntries.data();
+        specializationInfo.dataSize = sizeof(specializationData);
+        specializationInfo.pData = &specializationData;
+
+        VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+        compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        compShaderStageInfo.module = compShaderModule;
+        compShaderStageInfo.pName = "main";
+        compShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+        //3. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        // set 0: frame, set 1: fx instances, draw order and cull outputs, (Hi-Z) set 2: pyramid and cull statistics
+        pipelineLayoutCreateInfo.setLayoutCount = hiZ.enabled ? 3 : 2;
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.fxCull, descriptorSetLayouts.hiZCull };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
+        // (Hi-Z) camera of the pyramid
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(HiZCullPushConstants);
+        pipelineLayoutCreateInfo.pushConstantRangeCount = hiZ.enabled ? 1 : 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = hiZ.enabled ? &pushConstantRange : nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.fxCull);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        // Compute Pipeline Struct
+        VkComputePipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage = compShaderStageInfo;
+        pipelineCreateInfo.layout = pipelineLayouts.fxCull;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkResult pipelineCreated = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.fxCull);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create compute pipeline");
+        }
+
+        std::cout << "compute pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
+
+void VulkanApp::createComputePipelineHiZ() {
+        if (!hiZ.enabled) {
+            return; // no depth pyramid
+        }
+        //1. Shader Loading 
+        const std::vector<char>& compShaderCode = shaderCode.at(SHADER_COMP_PATH_HI_Z); // loaded by loadShaderCode()
+
+        //2. Shader Modules setup
+        VkShaderModule compShaderModule = createShaderModule(compShaderCode);
+
+        VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+        compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        compShaderStageInfo.module = compShaderModule;
+        compShaderStageInfo.pName = "main";
+        compShaderStageInfo.pSpecializationInfo = nullptr;
+
+        //3. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 1; // set 0: source and destination level (no frame set)
+        pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayouts.hiZBuild;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.hiZBuild);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        // Compute Pipeline Struct
+        VkComputePipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage = compShaderStageInfo;
+        pipelineCreateInfo.layout = pipelineLayouts.hiZBuild;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkResult pipelineCreated = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.hiZBuild);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create compute pipeline");
+        }
+
+        std::cout << "compute pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
+
+void VulkanApp::createComputePipelineAutoExposure() {
+        if (!autoExposure.enabled) {
+            return; // no auto exposure
+        }
+        //1. Shader Loading 
+        const std::vector<char>& compShaderCode = shaderCode.at(SHADER_COMP_PATH_AUTO_EXPOSURE); // loaded by loadShaderCode()
+
+        //2. Shader Modules setup
+        VkShaderModule compShaderModule = createShaderModule(compShaderCode);
+
+        VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+        compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        compShaderStageInfo.module = compShaderModule;
+        compShaderStageInfo.pName = "main";
+        compShaderStageInfo.pSpecializationInfo = nullptr;
+
+        //3. Pipeline Layout (descriptor set layouts, push constants)
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(AutoExposurePushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 1; // set 0: luminance copy, result, state (no frame set)
+        pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayouts.autoExposure;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.autoExposure);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        // Compute Pipeline Struct
+        VkComputePipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage = compShaderStageInfo;
+        pipelineCreateInfo.layout = pipelineLayouts.autoExposure;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkResult pipelineCreated = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.autoExposure);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create compute pipeline");
+        }
+
+        std::cout << "compute pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, compShaderModule, nullptr);
+}
+
+void VulkanApp::createComputePipelinesBloom() {
+        if (!bloom.enabled) {
+            return; // no bloom
+        }
+        //1. Pipeline Layout (descriptor set layouts, push constants), shared by the bright pass, downsample and upsample pipelines
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(BloomPushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 1; // set 0: source, destination level (no frame set)
+        pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayouts.bloom;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.bloom);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        //2. Shader Loading, Shader Modules setup and Compute Pipelines (one per shader variant)
+        std::array<std::pair<const std::string*, VkPipeline*>, 3> variants = { {
+            { &SHADER_COMP_PATH_BLOOM_BRIGHT, &pipelines.bloomBright },
+            { &SHADER_COMP_PATH_BLOOM_DOWN, &pipelines.bloomDown },
+            { &SHADER_COMP_PATH_BLOOM_UP, &pipelines.bloomUp }
+        } };
+        for (const auto& variant : variants) {
+            const std::vector<char>& compShaderCode = shaderCode.at(*variant.first); // loaded by loadShaderCode()
+            VkShaderModule compShaderModule = createShaderModule(compShaderCode);
+
+            VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+            compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            compShaderStageInfo.module = compShaderModule;
+            compShaderStageInfo.pName = "main";
+            compShaderStageInfo.pSpecializationInfo = nullptr;
+
+            VkComputePipelineCreateInfo pipelineCreateInfo{};
+            pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipelineCreateInfo.stage = compShaderStageInfo;
+            pipelineCreateInfo.layout = pipelineLayouts.bloom;
+            pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+            pipelineCreateInfo.basePipelineIndex = -1;
+
+            VkResult pipelineCreated = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, variant.second);
+            if (pipelineCreated != VK_SUCCESS) {
+                throw std::runtime_error("failed to create compute pipeline");
+            }
+
+            vkDestroyShaderModule(device, compShaderModule, nullptr);
+        }
+
+        std::cout << "compute pipeline created" << '\n';
+}
+
+void VulkanApp::createGraphicsPipelineOcclusionProxy() {
+        if (!occlusion.enabled) {
+            return; // no occlusion queries
+        }
+        // occlusion proxies: the volumes' bounding boxes, depth-tested against depth0 in the composition subpass.
+        // no fragment shader, no color or depth writes: only the occlusion query sees the samples passing the depth test
+        //1. Shader Loading 
+        const std::vector<char>& vertShaderCode = shaderCode.at(SHADER_VERT_PATH_OCCLUSION_PROXY); // loaded by loadShaderCode()
+
+        //2. Shader Modules setup
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+
+        // constant_id = 0..5: fx instances' world-space bounds (min xyz, max xyz), 6..11: decal box's local bounds
+        std::array<float, 12> specializationData = {
+            fxInstances.worldMin.x, fxInstances.worldMin.y, fxInstances.worldMin.z,
+            fxInstances.worldMax.x, fxInstances.worldMax.y, fxInstances.worldMax.z,
+            volumeDraws.decalLocalMin.x, volumeDraws.decalLocalMin.y, volumeDraws.decalLocalMin.z,
+            volumeDraws.decalLocalMax.x, volumeDraws.decalLocalMax.y, volumeDraws.decalLocalMax.z
+        };
+        std::array<VkSpecializationMapEntry, 12> specializationEntries{};
+        for (uint32_t entry = 0; entry < specializationEntries.size(); entry++) {
+            specializationEntries[entry] = { entry, static_cast<uint32_t>(entry * sizeof(float)), sizeof(float) };
+        }
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+        specializationInfo.pMapEntries = specializationEntries.data();
+        specializationInfo.dataSize = sizeof(specializationData);
+        specializationInfo.pData = specializationData.data();
+
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        vertShaderStageInfo.pName = "main";
+        vertShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+        //3. Shader Stages 
+        VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo };
+
+        //4. Vertex Input
+            // none: the box corners come from gl_VertexIndex
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 0;
+        vertexInputInfo.pVertexBindingDescriptions = nullptr;
+        vertexInputInfo.vertexAttributeDescriptionCount = 0;
+        vertexInputInfo.pVertexAttributeDescriptions = nullptr;
+
+        //5. Input AssembLer
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        //6. Viewport
+            // full-screen scissor: the box only covers its own projection anyway
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)swapChainExtent.width;
+        viewport.height = (float)swapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = swapChainExtent;
+
+        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
         viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewportStateCreateInfo.viewportCount = 1;
         viewportStateCreateInfo.pViewports = &viewport;
         viewportStateCreateInfo.scissorCount = 1;
         viewportStateCreateInfo.pScissors = &scissor;
 
-        //7. Rasterizer (Rasterize fragments, perform depth-testing, face-culling and scissor-test.)
-            // polygonMode: can rasterize polygon fill, edges (wireframe), or points.
-                // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
-                // VK_POLYGON_MODE_LINE : polygon edges are drawn as lines
-                // VK_POLYGON_MODE_POINT : polygon vertices are drawn as points
-
+        //7. Rasterizer
+            // no culling: front faces in front of the scene are enough, whatever the winding
         VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
         rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizerCreateInfo.depthClampEnable = VK_FALSE; // VK_TRUE = clamp (instead of discard) frags outside near/far plane.
-        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE; // VK_TRUE = dicard all geometry
+        rasterizerCreateInfo.depthClampEnable = VK_FALSE;
+        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
         rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
         rasterizerCreateInfo.lineWidth = 1.0f;
-        rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT; // backface / frontface / both culling
-        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // vertex order to define front facing polygons
-
+        rasterizerCreateInfo.cullMode = VK_CULL_MODE_NONE;
+        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
         rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
-        rasterizerCreateInfo.depthBiasConstantFactor = 0.0f; // add constant offset to depth
-        rasterizerCreateInfo.depthBiasClamp = 0.0f;
-        rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
 
         //8. Multisampling
         VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
@@ -1665,82 +5437,228 @@ void VulkanApp::createGraphicsPipelineScene() {
         multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
         multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
 
-        //9. Depth Stencil settings
+        //9. Depth and Stencil write/test
+            // tested against depth0 as the fx draw is, never written
         VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
         depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
         depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
-        depthStencilStateCreateInfo.depthWriteEnable = VK_TRUE;
+        depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
         depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
-
-        // can discard fragments outside a pre-defined range
         depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
         depthStencilStateCreateInfo.minDepthBounds = 0.0f;
         depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
-
         depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
-        depthStencilStateCreateInfo.front = {};
-        depthStencilStateCreateInfo.back = {};
 
-        //10. Color Blending 
-        // src = output's frag,  dst = attachment's frag   
-         
-            // RGB = srcCol *  srcBlend <op> dstCol * dstBlend
-            // A = srcAlpha * srcBlend <op> dstAlpha * dstBlend
+        //10. Color Blending
+            // no color writes
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = 0;
+        colorBlendAttachment.blendEnable = VK_FALSE;
+
+        VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
+        colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
+        colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
+        colorBlendingCreateInfo.attachmentCount = 1;
+        colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
+
+        //11. Dynamic States 
+            // none
+
+        //12. Pipeline Layout (descriptor set layouts)
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 2; // set 0: frame, set 1: fx0 (uboFX places the decal box), compatible with the fx layout
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.fx0 };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.occlusionProxy);
+        if (pipelineLayoutCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        // Graphics Pipeline Struct
+        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stageCount = 1;
+        pipelineCreateInfo.pStages = shaderStagesCreateInfo;
+        pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
+        pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+        pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+        pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+        pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
+        pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+        pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
+        pipelineCreateInfo.pDynamicState = nullptr;
+        pipelineCreateInfo.layout = pipelineLayouts.occlusionProxy;
+
+        // render passes
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget("composition", pipelineCreateInfo, renderTarget);
+
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.occlusionProxy);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create graphics pipeline");
+        }
+
+        std::cout << "graphics pipeline created" << '\n';
+
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+}
+
+void VulkanApp::createGraphicsPipelineOitResolve() {
+        if (!oit.enabled) {
+            return; // fx blended in the composition subpass
+        }
+        // OIT resolve: screen quad over the fx bounds, average color of the accumulated fx fragments blended over col1
+        //1. Shader Loading 
+        const std::vector<char>& vertShaderCode = shaderCode.at(SHADER_VERT_PATH_3); // loaded by loadShaderCode()
+        const std::vector<char>& fragShaderCode = shaderCode.at(SHADER_FRAG_PATH_OIT_RESOLVE);
+
+        //2. Shader Modules setup
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        vertShaderStageInfo.pName = "main";
+        vertShaderStageInfo.pSpecializationInfo = nullptr;
+
+        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragShaderStageInfo.module = fragShaderModule;
+        fragShaderStageInfo.pName = "main";
+        fragShaderStageInfo.pSpecializationInfo = nullptr;
+
+        //3. Shader Stages 
+        VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
+
+        //4. Vertex Input (screen quad, as the composition pipeline)
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        auto bindingDescription = Vertex::getBindingDescription();
+        auto attributeDescriptions = Vertex::getAttributeDescriptions();
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.vertexAttributeDescriptionCount = 4;
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+        //5. Input AssembLer
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        //6. Viewport
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)swapChainExtent.width;
+        viewport.height = (float)swapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = swapChainExtent;
 
+        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportStateCreateInfo.viewportCount = 1;
+        viewportStateCreateInfo.pViewports = &viewport;
+        viewportStateCreateInfo.scissorCount = 1;
+        viewportStateCreateInfo.pScissors = &scissor;
+
+        //7. Rasterizer
+        VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
+        rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizerCreateInfo.depthClampEnable = VK_FALSE;
+        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+        rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizerCreateInfo.lineWidth = 1.0f;
+        rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
+        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
+        rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
+
+        //8. Multisampling
+        VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
+        multisamplingCreateinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisamplingCreateinfo.sampleShadingEnable = VK_FALSE;
+        multisamplingCreateinfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multisamplingCreateinfo.minSampleShading = 1.0f;
+        multisamplingCreateinfo.pSampleMask = nullptr;
+        multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
+        multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
+
+        //9. Depth and Stencil write/test
+            // none: the resolve subpass has no depth attachment
+        VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
+        depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencilStateCreateInfo.depthTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
+        depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
+        depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
+        depthStencilStateCreateInfo.minDepthBounds = 0.0f;
+        depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
+        depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
+
+        //10. Color Blending
+            // srcCol * srcAlpha + dstCol * (1 - srcAlpha), with srcAlpha = 1 - revealage
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-        // bit flag for masking specific channels of the framebuffer:
         colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        // color and alpha blend settings
-
-        colorBlendAttachment.blendEnable = VK_FALSE; // disable color blending
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
 
         VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
         colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlendingCreateInfo.logicOpEnable = VK_FALSE; // VK_FALSE: Enabled bitwise combination alpha blending
+        colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
         colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
-
         colorBlendingCreateInfo.attachmentCount = 1;
         colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
-        colorBlendingCreateInfo.blendConstants[0] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[1] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[2] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[3] = 0.0f;
 
         //11. Dynamic States 
-            // Pipeline structs to be changed in runtime
+            // scissor: the fx draw's screen-space bounds (nothing was accumulated outside of them)
         VkDynamicState dynamicStates[] = {
-            VK_DYNAMIC_STATE_VIEWPORT, //viewport size
-            VK_DYNAMIC_STATE_LINE_WIDTH
+            VK_DYNAMIC_STATE_SCISSOR
         };
 
         VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
         dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicStateCreateInfo.dynamicStateCount = 2;
+        dynamicStateCreateInfo.dynamicStateCount = 1;
         dynamicStateCreateInfo.pDynamicStates = dynamicStates;
 
         //12. Pipeline Layout (descriptor set layouts)
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
         pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutCreateInfo.setLayoutCount = 1;
-        pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayouts.scene;
-
+        pipelineLayoutCreateInfo.setLayoutCount = 2; // set 0: frame, set 1: oitAccum/oitReveal inputs
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.oitResolve };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
         pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
         pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
 
-        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.scene);
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.oitResolve);
         if (pipelineLayoutCreated != VK_SUCCESS) {
             throw std::runtime_error("failed to create pipeline layout");
         }
 
-
         // Graphics Pipeline Struct
         VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
-        // programmable shader stages
         pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineCreateInfo.stageCount = 2; // amount of shader stages
+        pipelineCreateInfo.stageCount = 2;
         pipelineCreateInfo.pStages = shaderStagesCreateInfo;
-
-        // fixed function stages
         pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
         pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
         pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
@@ -1748,22 +5666,17 @@ void VulkanApp::createGraphicsPipelineScene() {
         pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
         pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
         pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
-        pipelineCreateInfo.pDynamicState = nullptr;
-
-        // uniform pipeline layout
-        pipelineCreateInfo.layout = pipelineLayouts.scene;
+        pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+        pipelineCreateInfo.layout = pipelineLayouts.oitResolve;
 
         // render passes
-        pipelineCreateInfo.renderPass = renderPass;
-        pipelineCreateInfo.subpass = 0; // index of subpass
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget("oitResolve", pipelineCreateInfo, renderTarget);
 
-        // create pipeline deriving from existing pipeline
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
         pipelineCreateInfo.basePipelineIndex = -1;
 
-        // create pipeline(s)
-        // (device, VkPipelineCache, pipelineInfos, nullptr, graphicsPipeline)
-        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.scene);
+        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.oitResolve);
         if (pipelineCreated != VK_SUCCESS) {
             throw std::runtime_error("failed to create graphics pipeline");
         }
@@ -1772,17 +5685,16 @@ void VulkanApp::createGraphicsPipelineScene() {
 
         vkDestroyShaderModule(device, vertShaderModule, nullptr);
         vkDestroyShaderModule(device, fragShaderModule, nullptr);
-
 }
 
-void VulkanApp::createGraphicsPipelineFX() {
-
+void VulkanApp::createGraphicsPipelineLighting() {
+        if (!deferred.enabled) {
+            return; // scene shaded forward in the scene subpass
+        }
+        // deferred lighting: one screen-space quad per visible light, reading the G-buffer at its own pixel, added to col0
         //1. Shader Loading 
-        static std::vector<char> vertShaderCode = readFile(SHADER_VERT_PATH_1);
-        static std::vector<char> fragShaderCode = readFile(SHADER_FRAG_PATH_1);
-
-        // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
-        // Thus, shader modules can be deleted when leaving pipeline-creation scope.
+        const std::vector<char>& vertShaderCode = shaderCode.at(SHADER_VERT_PATH_LIGHTING); // loaded by loadShaderCode()
+        const std::vector<char>& fragShaderCode = shaderCode.at(SHADER_FRAG_PATH_LIGHTING);
 
         //2. Shader Modules setup
         VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
@@ -1792,50 +5704,45 @@ void VulkanApp::createGraphicsPipelineFX() {
         vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
         vertShaderStageInfo.module = vertShaderModule;
-        // shader function to call (entry point)
         vertShaderStageInfo.pName = "main";
-        vertShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+        vertShaderStageInfo.pSpecializationInfo = nullptr;
 
         VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
         fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
         fragShaderStageInfo.module = fragShaderModule;
-        // shader function to call (entry point)
         fragShaderStageInfo.pName = "main";
-        fragShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
+        // constant_id = 0: ANALYTIC_DEPTH (scene position reconstruction from the depth input)
+        VkSpecializationMapEntry specializationEntry{};
+        specializationEntry.constantID = 0;
+        specializationEntry.offset = 0;
+        specializationEntry.size = sizeof(VkBool32);
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = 1;
+        specializationInfo.pMapEntries = &specializationEntry;
+        specializationInfo.dataSize = sizeof(VkBool32);
+        specializationInfo.pData = &analyticDepthReconstruction;
+        fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
         //3. Shader Stages 
         VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
 
         //4. Vertex Input
+            // none: light quads are generated from gl_VertexIndex and the light's screen rectangle
         VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-        auto bindingDescription = Vertex::getBindingDescription();
-        auto attributeDescriptions = Vertex::getAttributeDescriptions();
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription; // describing vertex data bindings
-        vertexInputInfo.vertexAttributeDescriptionCount = 4;
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data(); // describing vertex data attributes
+        vertexInputInfo.vertexBindingDescriptionCount = 0;
+        vertexInputInfo.pVertexBindingDescriptions = nullptr;
+        vertexInputInfo.vertexAttributeDescriptionCount = 0;
+        vertexInputInfo.pVertexAttributeDescriptions = nullptr;
 
         //5. Input AssembLer
-            // Topology:
-            /*
-            VK_PRIMITIVE_TOPOLOGY_POINT_LIST: points from vertices
-            VK_PRIMITIVE_TOPOLOGY_LINE_LIST : line from every 2 vertices without reuse
-            VK_PRIMITIVE_TOPOLOGY_LINE_STRIP : the end vertex of every line is used as start vertex for the next line
-            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : triangle from every 3 vertices without reuse
-            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : the second and third vertex of every triangle are used as first two vertices of the next triangle
-            */
-
-        // PrimitiveRestartEnable:
-            //VK_TRUE: Can break up lines and triangles in the _STRIP topology method, using 0xFFFF
         VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         inputAssembly.primitiveRestartEnable = VK_FALSE;
 
         //6. Viewport
-            // Transform
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
@@ -1844,7 +5751,6 @@ void VulkanApp::createGraphicsPipelineFX() {
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
 
-        // Scissor (Clipping)
         VkRect2D scissor{};
         scissor.offset = { 0, 0 };
         scissor.extent = swapChainExtent;
@@ -1856,25 +5762,16 @@ void VulkanApp::createGraphicsPipelineFX() {
         viewportStateCreateInfo.scissorCount = 1;
         viewportStateCreateInfo.pScissors = &scissor;
 
-        //7. Rasterizer (Rasterize fragments, perform depth-testing, face-culling and scissor-test.)
-            // polygonMode: can rasterize polygon fill, edges (wireframe), or points.
-                // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
-                // VK_POLYGON_MODE_LINE : polygon edges are drawn as lines
-                // VK_POLYGON_MODE_POINT : polygon vertices are drawn as points
-
+        //7. Rasterizer
         VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
         rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizerCreateInfo.depthClampEnable = VK_FALSE; // VK_TRUE = clamp (instead of discard) frags outside near/far plane.
-        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE; // VK_TRUE = dicard all geometry
+        rasterizerCreateInfo.depthClampEnable = VK_FALSE;
+        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
         rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
         rasterizerCreateInfo.lineWidth = 1.0f;
-        rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT; // backface / frontface / both culling
-        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // vertex order to define front facing polygons
-
+        rasterizerCreateInfo.cullMode = VK_CULL_MODE_NONE; // screen-space quads
+        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
         rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
-        rasterizerCreateInfo.depthBiasConstantFactor = 0.0f; // add constant offset to depth
-        rasterizerCreateInfo.depthBiasClamp = 0.0f;
-        rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
 
         //8. Multisampling
         VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
@@ -1887,90 +5784,58 @@ void VulkanApp::createGraphicsPipelineFX() {
         multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
 
         //9. Depth and Stencil write/test
+            // none: depth0 is read as an input attachment (background pixels are discarded in the fragment shader)
         VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
         depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-        depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
+        depthStencilStateCreateInfo.depthTestEnable = VK_FALSE;
         depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
         depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
-
-        // can discard fragments outside a pre-defined range
         depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
         depthStencilStateCreateInfo.minDepthBounds = 0.0f;
         depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
-
         depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
-        depthStencilStateCreateInfo.front = {};
-        depthStencilStateCreateInfo.back = {};
 
         //10. Color Blending
-        // src = output's frag,  dst = attachment's frag   
-
-            // RGB = srcCol *  srcBlend <op> dstCol * dstBlend
-            // A = srcAlpha * srcBlend <op> dstAlpha * dstBlend
-
+            // additive: every light's contribution is summed into col0 (cleared to black), alpha kept at the clear value
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-        // bit flag for masking specific channels of the framebuffer:
         colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        
-        // color and alpha blend settings
         colorBlendAttachment.blendEnable = VK_TRUE;
-        // srcCol * srcAlpha + dstCol * 1-srcAlpha
-        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
         colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-        // srcAlpha * 1 + dstAlpha * 0
-        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
         colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
 
         VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
         colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlendingCreateInfo.logicOpEnable = VK_FALSE; // VK_FALSE: Enabled bitwise combination alpha blending
+        colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
         colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
-
         colorBlendingCreateInfo.attachmentCount = 1;
         colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
-        colorBlendingCreateInfo.blendConstants[0] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[1] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[2] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[3] = 0.0f;
 
         //11. Dynamic States 
-            // Pipeline structs to be changed in runtime
-        VkDynamicState dynamicStates[] = {
-            VK_DYNAMIC_STATE_VIEWPORT, //viewport size
-            VK_DYNAMIC_STATE_LINE_WIDTH
-        };
-
-        VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
-        dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicStateCreateInfo.dynamicStateCount = 2;
-        dynamicStateCreateInfo.pDynamicStates = dynamicStates;
+            // none: the light rectangles come from the storage buffer
 
         //12. Pipeline Layout (descriptor set layouts)
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
         pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutCreateInfo.setLayoutCount = 2; // FX pipeline has two descriptor sets (fx0, fx1)
-        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.fx0,  descriptorSetLayouts.fx1 };
+        pipelineLayoutCreateInfo.setLayoutCount = 2; // set 0: frame, set 1: G-buffer inputs, visible lights
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.lighting };
         pipelineLayoutCreateInfo.pSetLayouts = layouts;
-
         pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
         pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
 
-        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.fx);
+        VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.lighting);
         if (pipelineLayoutCreated != VK_SUCCESS) {
             throw std::runtime_error("failed to create pipeline layout");
         }
 
-
         // Graphics Pipeline Struct
         VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
-        // programmable shader stages
         pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineCreateInfo.stageCount = 2; // amount of shader stages
+        pipelineCreateInfo.stageCount = 2;
         pipelineCreateInfo.pStages = shaderStagesCreateInfo;
-
-        // fixed function stages
         pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
         pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
         pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
@@ -1979,260 +5844,24 @@ void VulkanApp::createGraphicsPipelineFX() {
         pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
         pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
         pipelineCreateInfo.pDynamicState = nullptr;
-
-        // uniform pipeline layout
-        pipelineCreateInfo.layout = pipelineLayouts.fx;
+        pipelineCreateInfo.layout = pipelineLayouts.lighting;
 
         // render passes
-        pipelineCreateInfo.renderPass = renderPass;
-        pipelineCreateInfo.subpass = 1; // index of subpass
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget("lighting", pipelineCreateInfo, renderTarget);
 
-        // create pipeline deriving from existing pipeline
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-        pipelineCreateInfo.basePipelineIndex = -1;
-
-        // create pipeline(s)
-        // (device, VkPipelineCache, pipelineInfos, nullptr, graphicsPipeline)
-        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.fx);
-        if (pipelineCreated != VK_SUCCESS) {
-            throw std::runtime_error("failed to create graphics pipeline");
-        }
-
-        std::cout << "graphics pipeline created" << '\n';
-
-        vkDestroyShaderModule(device, vertShaderModule, nullptr);
-        vkDestroyShaderModule(device, fragShaderModule, nullptr);
-
-}
-
-void VulkanApp::createGraphicsPipelineDecal() {
-
-    //1. Shader Loading 
-    static std::vector<char> vertShaderCode = readFile(SHADER_VERT_PATH_2);
-    static std::vector<char> fragShaderCode = readFile(SHADER_FRAG_PATH_2);
-
-    // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
-    // Thus, shader modules can be deleted when leaving pipeline-creation scope.
-
-    //2. Shader Modules setup
-    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
-
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    // shader function to call (entry point)
-    vertShaderStageInfo.pName = "main";
-    vertShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    // shader function to call (entry point)
-    fragShaderStageInfo.pName = "main";
-    fragShaderStageInfo.pSpecializationInfo = nullptr; // can set values for shader constants 
-
-    //3. Shader Stages 
-    VkPipelineShaderStageCreateInfo shaderStagesCreateInfo[] = { vertShaderStageInfo, fragShaderStageInfo };
-
-    //4. Vertex Input
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription; // describing vertex data bindings
-    vertexInputInfo.vertexAttributeDescriptionCount = 4;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data(); // describing vertex data attributes
-
-    //5. Input AssembLer
-        // Topology:
-        /*
-        VK_PRIMITIVE_TOPOLOGY_POINT_LIST: points from vertices
-        VK_PRIMITIVE_TOPOLOGY_LINE_LIST : line from every 2 vertices without reuse
-        VK_PRIMITIVE_TOPOLOGY_LINE_STRIP : the end vertex of every line is used as start vertex for the next line
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : triangle from every 3 vertices without reuse
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP : the second and third vertex of every triangle are used as first two vertices of the next triangle
-        */
-
-        // PrimitiveRestartEnable:
-            //VK_TRUE: Can break up lines and triangles in the _STRIP topology method, using 0xFFFF
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    //6. Viewport
-        // Transform
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)swapChainExtent.width;
-    viewport.height = (float)swapChainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    // Scissor (Clipping)
-    VkRect2D scissor{};
-    scissor.offset = { 0, 0 };
-    scissor.extent = swapChainExtent;
-
-    VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
-    viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportStateCreateInfo.viewportCount = 1;
-    viewportStateCreateInfo.pViewports = &viewport;
-    viewportStateCreateInfo.scissorCount = 1;
-    viewportStateCreateInfo.pScissors = &scissor;
-
-    //7. Rasterizer (Rasterize fragments, perform depth-testing, face-culling and scissor-test.)
-        // polygonMode: can rasterize polygon fill, edges (wireframe), or points.
-            // VK_POLYGON_MODE_FILL: fill the area of the polygon with fragments
-            // VK_POLYGON_MODE_LINE : polygon edges are drawn as lines
-            // VK_POLYGON_MODE_POINT : polygon vertices are drawn as points
-
-    VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
-    rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizerCreateInfo.depthClampEnable = VK_FALSE; // VK_TRUE = clamp (instead of discard) frags outside near/far plane.
-    rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE; // VK_TRUE = dicard all geometry
-    rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizerCreateInfo.lineWidth = 1.0f;
-    rasterizerCreateInfo.cullMode = VK_CULL_MODE_FRONT_BIT; // backface / frontface / both culling
-    rasterizerCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE; // vertex order to define front facing polygons
-
-    rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
-    rasterizerCreateInfo.depthBiasConstantFactor = 0.0f; // add constant offset to depth
-    rasterizerCreateInfo.depthBiasClamp = 0.0f;
-    rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
-
-    //8. Multisampling
-    VkPipelineMultisampleStateCreateInfo multisamplingCreateinfo{};
-    multisamplingCreateinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisamplingCreateinfo.sampleShadingEnable = VK_FALSE;
-    multisamplingCreateinfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-    multisamplingCreateinfo.minSampleShading = 1.0f;
-    multisamplingCreateinfo.pSampleMask = nullptr;
-    multisamplingCreateinfo.alphaToCoverageEnable = VK_FALSE;
-    multisamplingCreateinfo.alphaToOneEnable = VK_FALSE;
-
-    //9. Depth and Stencil write/test
-    VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{};
-    depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
-    depthStencilStateCreateInfo.depthWriteEnable = VK_FALSE;
-    depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_GREATER_OR_EQUAL;
-
-    // can discard fragments outside a pre-defined range
-    depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
-    depthStencilStateCreateInfo.minDepthBounds = 0.0f;
-    depthStencilStateCreateInfo.maxDepthBounds = 1.0f;
-
-    depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
-    depthStencilStateCreateInfo.front = {};
-    depthStencilStateCreateInfo.back = {};
-
-    //10. Color Blending
-    // src = output's frag,  dst = attachment's frag   
-
-        // RGB = srcCol *  srcBlend <op> dstCol * dstBlend
-        // A = srcAlpha * srcBlend <op> dstAlpha * dstBlend
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    // bit flag for masking specific channels of the framebuffer:
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-
-    // color and alpha blend settings
-    colorBlendAttachment.blendEnable = VK_TRUE;
-    // srcCol * srcAlpha + dstCol * 1-srcAlpha
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    // srcAlpha * 1 + dstAlpha * 0
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-
-    VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
-    colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlendingCreateInfo.logicOpEnable = VK_FALSE; // VK_FALSE: Enabled bitwise combination alpha blending
-    colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
-
-    colorBlendingCreateInfo.attachmentCount = 1;
-    colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
-    colorBlendingCreateInfo.blendConstants[0] = 0.0f;
-    colorBlendingCreateInfo.blendConstants[1] = 0.0f;
-    colorBlendingCreateInfo.blendConstants[2] = 0.0f;
-    colorBlendingCreateInfo.blendConstants[3] = 0.0f;
-
-    //11. Dynamic States 
-        // Pipeline structs to be changed in runtime
-    VkDynamicState dynamicStates[] = {
-        VK_DYNAMIC_STATE_VIEWPORT, //viewport size
-        VK_DYNAMIC_STATE_LINE_WIDTH
-    };
-
-    VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
-    dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicStateCreateInfo.dynamicStateCount = 2;
-    dynamicStateCreateInfo.pDynamicStates = dynamicStates;
-
-    //12. Pipeline Layout (descriptor set layouts)
-    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
-    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutCreateInfo.setLayoutCount = 2; // FX pipeline has two descriptor sets (fx0, fx1)
-    VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.fx0,  descriptorSetLayouts.fx1 };
-    pipelineLayoutCreateInfo.pSetLayouts = layouts;
-
-    pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-    pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
-
-    VkResult pipelineLayoutCreated = vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayouts.decal);
-    if (pipelineLayoutCreated != VK_SUCCESS) {
-        throw std::runtime_error("failed to create pipeline layout");
-    }
-
-
-    // Graphics Pipeline Struct
-    VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
-    // programmable shader stages
-    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineCreateInfo.stageCount = 2; // amount of shader stages
-    pipelineCreateInfo.pStages = shaderStagesCreateInfo;
-
-    // fixed function stages
-    pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
-    pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
-    pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-    pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
-    pipelineCreateInfo.pMultisampleState = &multisamplingCreateinfo;
-    pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
-    pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
-    pipelineCreateInfo.pDynamicState = nullptr;
-
-    // uniform pipeline layout
-    pipelineCreateInfo.layout = pipelineLayouts.decal;
-
-    // render passes
-    pipelineCreateInfo.renderPass = renderPass;
-    pipelineCreateInfo.subpass = 1; // index of subpass
-
-    // create pipeline deriving from existing pipeline
-    pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineCreateInfo.basePipelineIndex = -1;
-
-    // create pipeline(s)
-    // (device, VkPipelineCache, pipelineInfos, nullptr, graphicsPipeline)
-    VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.decal);
-    if (pipelineCreated != VK_SUCCESS) {
-        throw std::runtime_error("failed to create graphics pipeline");
-    }
+        pipelineCreateInfo.basePipelineIndex = -1;
 
-    std::cout << "graphics pipeline created" << '\n';
+        VkResult pipelineCreated = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipelines.lighting);
+        if (pipelineCreated != VK_SUCCESS) {
+            throw std::runtime_error("failed to create graphics pipeline");
+        }
 
-    vkDestroyShaderModule(device, vertShaderModule, nullptr);
-    vkDestroyShaderModule(device, fragShaderModule, nullptr);
+        std::cout << "graphics pipeline created" << '\n';
 
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        vkDestroyShaderModule(device, fragShaderModule, nullptr);
 }
 
 void VulkanApp::createGraphicsPipelineComposition() {
@@ -2250,8 +5879,8 @@ void VulkanApp::createGraphicsPipelineComposition() {
 
         */
         //1. Shader Loading 
-        static std::vector<char> vertShaderCode = readFile(SHADER_VERT_PATH_3);
-        static std::vector<char> fragShaderCode = readFile(SHADER_FRAG_PATH_3);
+        const std::vector<char>& vertShaderCode = shaderCode.at(SHADER_VERT_PATH_3); // loaded by loadShaderCode()
+        const std::vector<char>& fragShaderCode = shaderCode.at(getCompositionFragShaderPath());
 
         // SPIR-V shaders get compiled to machine code, using ShaderModules, when pipeline is created.
         // Thus, shader modules can be deleted when leaving pipeline-creation scope.
@@ -2405,8 +6034,9 @@ void VulkanApp::createGraphicsPipelineComposition() {
             // Global uniforms layout
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
         pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutCreateInfo.setLayoutCount = 1;
-        pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayouts.composition;
+        pipelineLayoutCreateInfo.setLayoutCount = 2; // set 0: frame, set 1: composition
+        VkDescriptorSetLayout layouts[] = { descriptorSetLayouts.frame, descriptorSetLayouts.composition };
+        pipelineLayoutCreateInfo.pSetLayouts = layouts;
         pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
         pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
 
@@ -2454,8 +6084,8 @@ void VulkanApp::createGraphicsPipelineComposition() {
         pipelineCreateInfo.layout = pipelineLayouts.composition;
 
         // render passes
-        pipelineCreateInfo.renderPass = renderPass;
-        pipelineCreateInfo.subpass = 1; // index of subpass
+        PipelineRenderTarget renderTarget{};
+        setPipelineRenderTarget("composition", pipelineCreateInfo, renderTarget);
 
         // create pipeline deriving from existing pipeline
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
@@ -2490,188 +6120,342 @@ VkShaderModule VulkanApp::createShaderModule(const std::vector<char>& code) {
         return shaderModule;
 }
 
-void VulkanApp::createRenderPass() {
-        //1. Attachments 
+void VulkanApp::declareRenderGraph(bool separateRenderPasses, RenderGraph& sceneGraph, RenderGraph& compositionGraph) {
+        // Attachments and passes, declared by use. Load/store ops, layouts, transient usage, subpass dependencies
+        // and framebuffers are derived by the render graph (see RenderGraph.h)
+        // separateRenderPasses: scene and composition are two render passes, so col0/depth0 leave tile memory in between:
+        // they are stored by the scene pass, transitioned by an explicit barrier, then sampled (and depth0 loaded) by the composition pass
+        sceneGraph = RenderGraph();
+        compositionGraph = RenderGraph();
+        RenderGraph& lastGraph = separateRenderPasses ? compositionGraph : sceneGraph;
+        // multiview stereo: every subpass renders both eyes, one attachment layer per view
+        const uint32_t viewMask = multiview.enabled ? multiview.viewMask : 0;
+        sceneGraph.setViewMask(viewMask);
+        compositionGraph.setViewMask(viewMask);
+        VkPhysicalDeviceProperties deviceProperties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        compositionGraph.setStoreOpNone(deviceProperties.apiVersion >= VK_MAKE_VERSION(1, 3, 0));
+        // multisampled scene: the resolve at the end of the scene subpass is the first write of col0/depth0
+        bool msaaScene = msaa.enabled && !separateRenderPasses;
+
+        //1. Attachments
         // ------------------------
-        VkAttachmentDescription col0{};
+        RenderGraphAttachmentInfo col0{};
+        col0.name = "col0";
         col0.format = VK_FORMAT_R32G32B32A32_SFLOAT; // 32bit-per-channel floating point attachment (to store values higher than 1.0) for HDR rendering
         // (tonemapping applied before outputting to swapchain image)
-        col0.samples = VK_SAMPLE_COUNT_1_BIT;
-        // loadOp - attachment's content operation, at begining of subpass
-        col0.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear the values to a constant  
-        // storeOp - attachment's content operation, at end of subpass
-        col0.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // Store for reading in subpass1
-        col0.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        col0.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        col0.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // dont care about previous layout, will transition in subpasses
-        col0.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription depth0{};
+        col0.clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+        col0.clearOnFirstWrite = !msaaScene; // the resolve covers every pixel
+        if (separateRenderPasses) {
+            col0.persistent = true; // sampled by the composition pass
+            col0.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            // the next frame's clear has to wait for this frame's composition reads
+            col0.externalSrcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            col0.externalSrcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        }
+        if (bloom.enabled) {
+            // bloom (separate render passes only): sampled by the bright pass between the passes (recordBloom, after the barrier to
+            // SHADER_READ_ONLY_OPTIMAL), the next frame's clear waits for that read
+            col0.externalSrcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        }
+        if (autoExposure.enabled) {
+            // auto exposure: blitted into the luminance copy after the render pass (recordLuminanceCopy; separate render passes:
+            // from SHADER_READ_ONLY_OPTIMAL), the next frame's clear waits for that read
+            if (!separateRenderPasses) {
+                col0.persistent = true;
+                col0.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+                col0.externalDstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                col0.externalDstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            }
+            col0.externalSrcStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        sceneGraph.addAttachment(col0);
+
+        RenderGraphAttachmentInfo depth0{};
+        depth0.name = "depth0";
         depth0.format = findSupportedDepthFormat();
-        depth0.samples = VK_SAMPLE_COUNT_1_BIT;
-        depth0.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear the values to a constant  
-        depth0.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // Store for reading in subpass1 
-        depth0.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        depth0.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;;
-        depth0.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // dont care about previous layout, will transition in subpasses
-        depth0.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL; //VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-        VkAttachmentDescription col1{};
-        col1.format = swapChainImageFormat; 
-        col1.samples = VK_SAMPLE_COUNT_1_BIT;
-        col1.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear the values to a constant  
-        col1.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // Store for presentation
-        col1.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        col1.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        col1.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // dont care about previous layout, will transition in subpasses
+        depth0.clearValue.depthStencil = { 1.0f, 0 };
+        depth0.clearOnFirstWrite = !msaaScene; // (the decal stencil is still cleared, it is not resolved)
+        if (separateRenderPasses) {
+            depth0.persistent = true; // sampled, and depth-tested against, by the composition pass
+            depth0.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            depth0.externalSrcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            // (the composition pass's store op and decal stencil mask write it too)
+            depth0.externalSrcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            if (hiZ.enabled) {
+                // (and for the Hi-Z reduction after the composition pass)
+                depth0.externalSrcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            }
+            sceneGraph.addAttachment(depth0);
+
+            // composition pass: loads the stored depth0, read-only. Nothing to store: DONT_CARE, unless the Hi-Z reduction samples it
+            // after the pass (then STORE_OP_NONE keeps it without a write, on Vulkan 1.3 devices)
+            RenderGraphAttachmentInfo depth0Input = depth0;
+            depth0Input.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            depth0Input.externalSrcStageMask = 0;
+            depth0Input.externalSrcAccessMask = 0;
+            depth0Input.readAfterPass = hiZ.enabled;
+            if (hiZ.enabled) {
+                depth0Input.externalDstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+                depth0Input.externalDstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            }
+            compositionGraph.addAttachment(depth0Input);
+        }
+        else if (hiZ.enabled) {
+            // Hi-Z: depth0 is stored and sampled by the pyramid reduction after the render pass,
+            // which the next frame's first use has to wait for
+            RenderGraphAttachmentInfo depth0Stored = depth0;
+            depth0Stored.persistent = true;
+            depth0Stored.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            depth0Stored.externalDstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            depth0Stored.externalDstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            depth0Stored.externalSrcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            depth0Stored.externalSrcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            sceneGraph.addAttachment(depth0Stored);
+        }
+        else {
+            sceneGraph.addAttachment(depth0);
+        }
+
+        // multisampled scene color/depth: only written by the scene subpass and resolved at its end (never stored)
+        if (msaaScene) {
+            RenderGraphAttachmentInfo col0MS = col0;
+            col0MS.name = "col0MS";
+            col0MS.samples = msaa.samples;
+            col0MS.clearOnFirstWrite = true;
+            sceneGraph.addAttachment(col0MS);
+
+            RenderGraphAttachmentInfo depth0MS = depth0;
+            depth0MS.name = "depth0MS";
+            depth0MS.samples = msaa.samples;
+            depth0MS.clearOnFirstWrite = true;
+            sceneGraph.addAttachment(depth0MS);
+        }
+
+        RenderGraphAttachmentInfo col1{};
+        col1.name = "col1";
+        col1.format = swapChainImageFormat;
+        col1.clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+        col1.persistent = true; // presented after the render pass
         col1.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        if (multiview.enabled) {
+            // multiview stereo: blitted into the swapchain image after the render pass (recordStereoBlit)
+            col1.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            col1.externalDstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            col1.externalDstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            col1.externalSrcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        lastGraph.addAttachment(col1);
+
+        // weighted blended OIT: accumulation and revealage, written by the fx subpass and read by the resolve subpass
+        bool oitPasses = oit.enabled && !separateRenderPasses;
+        if (oitPasses) {
+            RenderGraphAttachmentInfo oitAccum{};
+            oitAccum.name = "oitAccum";
+            oitAccum.format = VK_FORMAT_R16G16B16A16_SFLOAT; // weighted sums exceed 1.0
+            oitAccum.clearValue.color = { {0.0f, 0.0f, 0.0f, 0.0f} };
+            sceneGraph.addAttachment(oitAccum);
+
+            RenderGraphAttachmentInfo oitReveal{};
+            oitReveal.name = "oitReveal";
+            oitReveal.format = VK_FORMAT_R8_UNORM;
+            oitReveal.clearValue.color = { {1.0f, 0.0f, 0.0f, 0.0f} }; // nothing in front: fully revealed
+            sceneGraph.addAttachment(oitReveal);
+        }
 
-        std::array<VkAttachmentDescription, 3> attachments = { col0, depth0, col1 };
+        // deferred shading: G-buffer written by the scene subpass and read by the lighting subpass (never stored)
+        if (deferred.enabled) {
+            RenderGraphAttachmentInfo gAlbedo{};
+            gAlbedo.name = "gAlbedo";
+            gAlbedo.format = VK_FORMAT_R8G8B8A8_UNORM; // albedo, specular material
+            gAlbedo.clearValue.color = { {0.0f, 0.0f, 0.0f, 0.0f} };
+            sceneGraph.addAttachment(gAlbedo);
+
+            RenderGraphAttachmentInfo gNormal{};
+            gNormal.name = "gNormal";
+            gNormal.format = VK_FORMAT_R16G16_SFLOAT; // octahedral normal (color attachment support is mandatory)
+            gNormal.clearValue.color = { {0.0f, 0.0f, 0.0f, 0.0f} };
+            sceneGraph.addAttachment(gNormal);
+        }
 
-        //2. Subpasses
+        //2. Passes (one subpass each, in declaration order)
         // ------------
-        // Define input/output attachments, and their target image layout for the subpass
-        // 
-        // Subpass 0
-        // ---------
-        VkAttachmentReference col0_out{};
-        col0_out.attachment = 0;
-        /// col0 -> transition to layout_color_attachment
-        col0_out.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkAttachmentReference depth0_out{};
-        depth0_out.attachment = 1;
-        // depth0 -> transition to layout_depth_stencil_attachment
-        depth0_out.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription subpass0{};
-        subpass0.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // graphics or compute subpass
-        subpass0.colorAttachmentCount = 1;
-        subpass0.pInputAttachments = nullptr;
-        subpass0.pColorAttachments = &col0_out;
-        subpass0.pDepthStencilAttachment = &depth0_out;
-
-        // Subpass 1
-        // ---------
-        VkAttachmentReference col0_in{};
-        col0_in.attachment = 0;
-        // col0 -> transition to layout_shader_read_only
-        col0_in.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference depth0_in{};
-        depth0_in.attachment = 1;
-        // depth0 -> transition to layout_shader_read_only
-        depth0_in.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference inputAttachments[] = { col0_in, depth0_in };
-
-        VkAttachmentReference col1_out{};
-        col1_out.attachment = 2;
-        // col1 -> transition to layout_color_attachment
-        col1_out.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription subpass1{};
-        subpass1.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // graphics or compute subpass
-        subpass1.inputAttachmentCount = 2;
-        subpass1.pInputAttachments = inputAttachments;
-        subpass1.colorAttachmentCount = 1;
-        subpass1.pColorAttachments = &col1_out;
-        subpass1.pDepthStencilAttachment = &depth0_in;
-
-        VkSubpassDescription subpasses[] = { subpass0, subpass1 };
-
-        //Dependencies:
-        // synchronization of attachment layout transitions + operations which access the attachments.
-        // 
-        // 1. block layout transition, until previous subpass operations (which access attachments) are finished.
-        // 2. block subpass operations (which access attachments) until layout transition is finished.
-
-        VkSubpassDependency dependency0{};
-
-        dependency0.srcSubpass = VK_SUBPASS_EXTERNAL;
-        dependency0.dstSubpass = 0;
-
-        // block (out)col0 first layout transition (to "VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL"), until begin's load/clear operation is finished.
-        // block (out)depth0 first layout transition (to "VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL"), until begin's load/clear operation is finished.
-        dependency0.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-        dependency0.srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-        // block subpass0 color read/write operation (in "output" stage of pipeline), until layout transition is finished.
-        // block subpass0 depth read/write operation (in "early fragment-test" stage of pipeline), until layout transition is finished.
-        dependency0.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        dependency0.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-
-        VkSubpassDependency dependency1{};
-        dependency1.srcSubpass = 0;
-        dependency1.dstSubpass = 1;
-
-        // block (in)col0 final layout transition (to "VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL"), until subpass0 output operation is finished. (color output stage)
-        // block (in)depth0 final layout transition (to "VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL"), until subpass0 depth-write operation is finished. (early test stage)
-        // block (out)col1 first layout transition ("to VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL"), until subpass0 output operation is finished.
-        dependency1.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        dependency1.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-        // block supbass1 col0 read operation (in "fragment shader" stage of pipeline), until layout transition is finished.
-        // block supbass1 depth0 read operation (in "fragment shader" stage of pipeline), until layout transition is finished.
-        // block supbass1 col1 write operation (in "output" stage of pipeline), until layout transition is finished.
-        dependency1.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
-        dependency1.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
-        VkSubpassDependency dependency2{};
-        dependency2.srcSubpass = 1;
-        dependency2.dstSubpass = VK_SUBPASS_EXTERNAL;
-
-        // block col1 final layout transition (to "VK_IMAGE_LAYOUT_PRESENT_SRC_KHR"), until subpass1 ouptut operation is finished.
-        dependency2.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        dependency2.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        // block ending's col1 read operation, until layout transition is finished.
-        dependency2.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-        dependency2.dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-
-        VkSubpassDependency dependencies[] = { dependency0, dependency1 };
-
-        //3. Render Pass
-        // -------------
-        VkRenderPassCreateInfo renderPassCreateInfo{};
-        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        renderPassCreateInfo.pAttachments = attachments.data();
-        renderPassCreateInfo.subpassCount = 2;
-        renderPassCreateInfo.pSubpasses = subpasses;
-        renderPassCreateInfo.dependencyCount = 2;
-        renderPassCreateInfo.pDependencies = dependencies;
+        // scene draw to offscreen attachment
+        RenderGraphPassInfo scenePass{};
+        scenePass.name = "scene";
+        scenePass.colorOutputs = { "col0" };
+        scenePass.depthOutput = "depth0";
+        if (deferred.enabled) {
+            scenePass.colorOutputs = { "gAlbedo", "gNormal" };
+        }
+        if (msaaScene) {
+            scenePass.colorOutputs = { "col0MS" };
+            scenePass.depthOutput = "depth0MS";
+            scenePass.resolveOutputs = { "col0" };
+            scenePass.depthResolveOutput = "depth0";
+        }
+
+        if (settings.depthPrepass) {
+            // depth-only draw of the scene before it is shaded: the first write of the scene's depth attachment
+            // (the scene pass keeps it as a depth output: EQUAL test without writes, same layout, and the msaa depth resolve)
+            RenderGraphPassInfo depthPrepassPass{};
+            depthPrepassPass.name = "depthPrepass";
+            depthPrepassPass.depthOutput = scenePass.depthOutput;
+            sceneGraph.addPass(depthPrepassPass);
+        }
+        sceneGraph.addPass(scenePass);
+
+        if (deferred.enabled) {
+            // lighting: one additive quad per visible light over the G-buffer, the first write of col0
+            RenderGraphPassInfo lightingPass{};
+            lightingPass.name = "lighting";
+            lightingPass.inputAttachments = { "gAlbedo", "gNormal", "depth0" };
+            lightingPass.colorOutputs = { "col0" };
+            sceneGraph.addPass(lightingPass);
+        }
 
-        VkResult renderPassCreated = vkCreateRenderPass(device, &renderPassCreateInfo, nullptr, &renderPass);
-        if (renderPassCreated != VK_SUCCESS) {
-            throw std::runtime_error("failed to create render pass");
+        // composition, fx and decal draws: read col0/depth0 as input attachments (or sampled textures), output to swapchain image
+        RenderGraphPassInfo compositionPass{};
+        compositionPass.name = "composition";
+        if (!separateRenderPasses) {
+            compositionPass.inputAttachments = { "col0", "depth0" };
+        }
+        compositionPass.depthInput = "depth0";
+        compositionPass.colorOutputs = { "col1" };
+        // decal stencil mask (cleared at the start of the render pass, never stored)
+        compositionPass.stencilWrite = volumeDraws.decalStencil;
+        lastGraph.addPass(compositionPass);
+
+        if (oitPasses) {
+            // fx draws, in any order: depth-tested against depth0, col0/depth0 read like in the composition pass
+            RenderGraphPassInfo fxPass{};
+            fxPass.name = "fx";
+            fxPass.inputAttachments = { "col0", "depth0" };
+            fxPass.depthInput = "depth0";
+            fxPass.colorOutputs = { "oitAccum", "oitReveal" };
+            // same depth0 layout as the composition pass, so the fx1 descriptors stay valid in both (no stencil is written here)
+            fxPass.stencilWrite = volumeDraws.decalStencil;
+            sceneGraph.addPass(fxPass);
+
+            // resolve: average fx color, blended over col1 by the revealage
+            RenderGraphPassInfo oitResolvePass{};
+            oitResolvePass.name = "oitResolve";
+            oitResolvePass.inputAttachments = { "oitAccum", "oitReveal" };
+            oitResolvePass.colorOutputs = { "col1" };
+            sceneGraph.addPass(oitResolvePass);
         }
+}
 
+void VulkanApp::createRenderPass() {
+        if (dynamicRendering.enabled) {
+            // no VkRenderPass: load/store ops and clear values still come from the graph, at vkCmdBeginRendering
+            renderGraph.printSummary(std::cout, swapChainExtent);
+            return;
+        }
+        renderPass = renderGraph.createRenderPass(device);
+        renderGraph.printSummary(std::cout, swapChainExtent);
+        if (settings.multiPass) {
+            separatePasses.compositionRenderPass = separatePasses.compositionGraph.createRenderPass(device);
+            separatePasses.compositionGraph.printSummary(std::cout, swapChainExtent);
+        }
 }
 
 void VulkanApp::createFramebuffers() {
+        if (dynamicRendering.enabled) {
+            return; // image views are passed to vkCmdBeginRendering directly
+        }
         // create framebuffer for each swapchain view
-        swapChainFramebuffers.resize(swapChainImageViews.size());
-
-        for (size_t i = 0; i < swapChainImageViews.size(); i++) {
-            VkImageView attachments[] = {
-                offscreenImageView, depthImageView, swapChainImageViews[i]
-            };
+        renderGraph.bindImageViews("col0", { offscreenImageView });
+        renderGraph.bindImageViews("depth0", { depthStencilImageView });
+        if (msaa.enabled) {
+            renderGraph.bindImageViews("col0MS", { msaa.colorView });
+            renderGraph.bindImageViews("depth0MS", { msaa.depthView });
+        }
+        if (oit.enabled) {
+            renderGraph.bindImageViews("oitAccum", { oit.accumView });
+            renderGraph.bindImageViews("oitReveal", { oit.revealView });
+        }
+        if (deferred.enabled) {
+            renderGraph.bindImageViews("gAlbedo", { deferred.albedoView });
+            renderGraph.bindImageViews("gNormal", { deferred.normalView });
+        }
+        if (settings.multiPass) {
+            renderGraph.createFramebuffers(device, renderPass, swapChainExtent, static_cast<uint32_t>(swapChainImageViews.size()), swapChainFramebuffers);
 
-            VkFramebufferCreateInfo framebufferInfo{};
-            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            framebufferInfo.renderPass = renderPass;
-            framebufferInfo.attachmentCount = 3;
-            framebufferInfo.pAttachments = attachments;
-            framebufferInfo.width = swapChainExtent.width;
-            framebufferInfo.height = swapChainExtent.height;
-            framebufferInfo.layers = 1;
+            separatePasses.compositionGraph.bindImageViews("depth0", { depthStencilImageView });
+            separatePasses.compositionGraph.bindImageViews("col1", swapChainImageViews);
+            separatePasses.compositionGraph.createFramebuffers(device, separatePasses.compositionRenderPass, swapChainExtent, static_cast<uint32_t>(swapChainImageViews.size()), separatePasses.compositionFramebuffers);
+        }
+        else if (multiview.enabled) {
+            // multiview stereo: the 2-layer output is the same for every swapchain image (blitted after the render pass)
+            renderGraph.bindImageViews("col1", { multiview.outputView });
+            renderGraph.createFramebuffers(device, renderPass, swapChainExtent, static_cast<uint32_t>(swapChainImageViews.size()), swapChainFramebuffers);
+        }
+        else {
+            renderGraph.bindImageViews("col1", swapChainImageViews);
+            renderGraph.createFramebuffers(device, renderPass, swapChainExtent, static_cast<uint32_t>(swapChainImageViews.size()), swapChainFramebuffers);
+        }
+        std::cout << "framebuffers created: " << swapChainFramebuffers.size() << '\n';
+}
 
-            VkResult framebufferCreated = vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapChainFramebuffers[i]);
-            if (framebufferCreated != VK_SUCCESS) {
-                throw std::runtime_error("failed to create framebuffer");
-            }
+VkRenderPass VulkanApp::getPassRenderPass(const std::string& pass) {
+        if (settings.multiPass && pass == "composition") {
+            return separatePasses.compositionRenderPass;
+        }
+        return renderPass;
+}
 
-            std::cout << "framebuffer created: framebuffer_" << std::to_string(i) << '\n';
+uint32_t VulkanApp::getPassSubpassIndex(const std::string& pass) {
+        if (settings.multiPass && pass == "composition") {
+            return separatePasses.compositionGraph.getSubpassIndex(pass);
+        }
+        return renderGraph.getSubpassIndex(pass);
+}
 
+void VulkanApp::setPipelineRenderTarget(const std::string& pass, VkGraphicsPipelineCreateInfo& pipelineCreateInfo, PipelineRenderTarget& target) {
+        if (!dynamicRendering.enabled) {
+            pipelineCreateInfo.renderPass = getPassRenderPass(pass);
+            pipelineCreateInfo.subpass = getPassSubpassIndex(pass); // index of subpass
+            return;
         }
+
+        // the rendering has both color attachments (col0, col1) bound for its whole duration:
+        // attachment locations select which one the fragment shader writes, input attachment indices which ones it reads
+        bool composition = (pass == "composition");
+        target.colorFormats = { VK_FORMAT_R32G32B32A32_SFLOAT, swapChainImageFormat };
+        target.colorLocations = { composition ? VK_ATTACHMENT_UNUSED : 0u, composition ? 0u : VK_ATTACHMENT_UNUSED };
+        target.colorInputIndices = { composition ? 0u : VK_ATTACHMENT_UNUSED, VK_ATTACHMENT_UNUSED };
+        target.depthInputIndex = 1; // subpassInput inputDepthAttachment (input_attachment_index = 1)
+
+        target.inputIndices.sType = VK_STRUCTURE_TYPE_RENDERING_INPUT_ATTACHMENT_INDEX_INFO_KHR;
+        target.inputIndices.colorAttachmentCount = static_cast<uint32_t>(target.colorInputIndices.size());
+        target.inputIndices.pColorAttachmentInputIndices = target.colorInputIndices.data();
+        target.inputIndices.pDepthInputAttachmentIndex = composition ? &target.depthInputIndex : nullptr;
+        target.inputIndices.pStencilInputAttachmentIndex = nullptr;
+
+        target.locations.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_LOCATION_INFO_KHR;
+        target.locations.pNext = &target.inputIndices;
+        target.locations.colorAttachmentCount = static_cast<uint32_t>(target.colorLocations.size());
+        target.locations.pColorAttachmentLocations = target.colorLocations.data();
+
+        target.rendering.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+        target.rendering.pNext = &target.locations;
+        target.rendering.viewMask = 0;
+        target.rendering.colorAttachmentCount = static_cast<uint32_t>(target.colorFormats.size());
+        target.rendering.pColorAttachmentFormats = target.colorFormats.data();
+        target.rendering.depthAttachmentFormat = findSupportedDepthFormat();
+        target.rendering.stencilAttachmentFormat = volumeDraws.decalStencil ? findSupportedDepthFormat() : VK_FORMAT_UNDEFINED;
+
+        // one blend state per color attachment of the rendering (the unmapped attachment is never written)
+        target.colorBlend = *pipelineCreateInfo.pColorBlendState;
+        target.colorBlendAttachments = { target.colorBlend.pAttachments[0], target.colorBlend.pAttachments[0] };
+        target.colorBlend.attachmentCount = static_cast<uint32_t>(target.colorBlendAttachments.size());
+        target.colorBlend.pAttachments = target.colorBlendAttachments.data();
+
+        pipelineCreateInfo.pNext = &target.rendering;
+        pipelineCreateInfo.pColorBlendState = &target.colorBlend;
+        pipelineCreateInfo.renderPass = VK_NULL_HANDLE;
+        pipelineCreateInfo.subpass = 0;
 }
 
 void VulkanApp::createGraphicsCommandPool() {
@@ -2680,6 +6464,8 @@ void VulkanApp::createGraphicsCommandPool() {
         VkCommandPoolCreateInfo graphicsPoolCreateInfo{};
         graphicsPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
         graphicsPoolCreateInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamilyIndex.value();
+        // graphicsCommandBuffer[] are re-recorded every frame (recordCommandBuffer())
+        graphicsPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
         VkResult graphicsCommandPoolCreated = vkCreateCommandPool(device, &graphicsPoolCreateInfo, nullptr, &graphicsCommandPool);
         if (graphicsCommandPoolCreated != VK_SUCCESS) {
@@ -2703,9 +6489,9 @@ void VulkanApp::createTransferCommandPool() {
 }
 
 // create command buffers (per swap image), and record commands
-void VulkanApp::recordCommandBuffers() {
-        uint32_t swapchainImageCount = (uint32_t)swapChainFramebuffers.size();
-        graphicsCommandBuffer.resize(swapchainImageCount); //create command buffer per swapchain framebuffer
+void VulkanApp::createGraphicsCommandBuffers() {
+        uint32_t swapchainImageCount = (uint32_t)swapChainImages.size();
+        graphicsCommandBuffer.resize(swapchainImageCount); //create command buffer per swapchain image
 
         VkCommandBufferAllocateInfo gCommandBuffersAllocateInfo{};
         gCommandBuffersAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -2720,115 +6506,429 @@ void VulkanApp::recordCommandBuffers() {
         if (graphicsCommandBuffersAllocated != VK_SUCCESS) {
             throw std::runtime_error("failed to allocate graphics command buffers from command pool");
         }
-        std::cout << "graphics command buffers allocated from graphics pool. buffers count: " << std::to_string(graphicsCommandBuffer.size()) << '\n';
+        // (recorded every frame by recordCommandBuffer(), which prints nothing: it runs inside the benchmark's render stage timings)
+        std::cout << "graphics command buffers allocated from graphics pool. buffers count: " << std::to_string(graphicsCommandBuffer.size())
+            << " (re-recorded every frame)" << '\n';
+}
+
+void VulkanApp::recordShadowPass(uint32_t i, const FrameState& state) {
+        // cached: the map still holds the scene as seen from this frame's light, nothing to record
+        // (the light and the scene mesh are the only inputs: fx instances and decals do not cast shadows)
+        shadow.frames++;
+        if (shadow.cached && !settings.disableShadowCache
+            && state.uboShadow.viewProj == shadow.cachedViewProj && state.uboScene.model == shadow.cachedSceneModel) {
+            return;
+        }
+
+        // the render pass clears the map (the previous frames' reads are waited for by its external dependency),
+        // and leaves it in SHADER_READ_ONLY_OPTIMAL for the scene subpass
+        VkRenderPassBeginInfo shadowPassInfo{};
+        shadowPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        shadowPassInfo.renderPass = shadow.renderPass;
+        shadowPassInfo.framebuffer = shadow.framebuffer;
+        shadowPassInfo.renderArea.offset = { 0, 0 };
+        shadowPassInfo.renderArea.extent = shadow.extent;
+        std::vector<VkClearValue> clearValues = shadow.graph.getClearValues();
+        shadowPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        shadowPassInfo.pClearValues = clearValues.data();
+        vkCmdBeginRenderPass(graphicsCommandBuffer[i], &shadowPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        // scene mesh from the position-only stream: model (set 1) and light view-projection (set 3)
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.shadow);
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 1, 1, &descriptorSets.scene[i], 0, nullptr);
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 3, 1, &descriptorSets.shadows[i], 0, nullptr);
+        VkDeviceSize positionOffset = 0;
+        vkCmdBindVertexBuffers(graphicsCommandBuffer[i], 0, 1, &depthPrepass.positionBuffer, &positionOffset);
+        vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer0, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(graphicsCommandBuffer[i], static_cast<uint32_t>(indicesScene.size()), 1, 0, 0, 0);
+
+        vkCmdEndRenderPass(graphicsCommandBuffer[i]);
+
+        shadow.cached = true;
+        shadow.cachedViewProj = state.uboShadow.viewProj;
+        shadow.cachedSceneModel = state.uboScene.model;
+        shadow.renders++;
+}
+
+void VulkanApp::recordStereoBlit(uint32_t i) {
+        // multiview stereo: the eye layers of col1 (TRANSFER_SRC after the render pass) side by side into the swapchain image,
+        // each squeezed to half the width (half-width side-by-side, as taken by stereo displays)
+        VkImageMemoryBarrier toTransfer{};
+        toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        toTransfer.srcAccessMask = 0; // (acquire semaphore waited at COLOR_ATTACHMENT_OUTPUT)
+        toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        toTransfer.image = swapChainImages[i];
+        toTransfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        toTransfer.subresourceRange.baseMipLevel = 0;
+        toTransfer.subresourceRange.levelCount = 1;
+        toTransfer.subresourceRange.baseArrayLayer = 0;
+        toTransfer.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+        const int32_t width = static_cast<int32_t>(swapChainExtent.width);
+        const int32_t height = static_cast<int32_t>(swapChainExtent.height);
+        std::array<VkImageBlit, 2> regions{};
+        for (uint32_t eye = 0; eye < multiview.viewCount; eye++) {
+            VkImageBlit& region = regions[eye];
+            region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.srcSubresource.mipLevel = 0;
+            region.srcSubresource.baseArrayLayer = eye;
+            region.srcSubresource.layerCount = 1;
+            region.srcOffsets[1] = { width, height, 1 };
+            region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.dstSubresource.mipLevel = 0;
+            region.dstSubresource.baseArrayLayer = 0;
+            region.dstSubresource.layerCount = 1;
+            region.dstOffsets[0] = { static_cast<int32_t>(eye) * width / 2, 0, 0 };
+            region.dstOffsets[1] = { static_cast<int32_t>(eye + 1) * width / 2, height, 1 };
+        }
+        vkCmdBlitImage(graphicsCommandBuffer[i], multiview.outputImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImages[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()), regions.data(), VK_FILTER_LINEAR);
+
+        VkImageMemoryBarrier toPresent = toTransfer;
+        toPresent.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toPresent.dstAccessMask = 0;
+        toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &toPresent);
+}
+
+void VulkanApp::recordCommandBuffer(uint32_t i, const FrameState& state) {
+        // recorded per frame (by drawFrame(), once the image's previous submission finished):
+        // the fx/decal draws use the frame's volume bounds as dynamic scissor/depth bounds
+        VkCommandBufferBeginInfo commandBufferBeginInfo{};
+        commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        commandBufferBeginInfo.pInheritanceInfo = nullptr;
+
+        VkResult commandBufferBeganRecording = vkBeginCommandBuffer(graphicsCommandBuffer[i], &commandBufferBeginInfo);
+        if (commandBufferBeganRecording != VK_SUCCESS) {
+            throw std::runtime_error("failed to begin recording command buffer");
+        }
 
-        for (uint32_t i = 0; i < swapchainImageCount; i++) {
-            VkCommandBufferBeginInfo commandBufferBeginInfo{};
-            commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            commandBufferBeginInfo.flags = 0;
-            commandBufferBeginInfo.pInheritanceInfo = nullptr;
+        // GPU frame time: timestamp before the first and after the last command
+        if (gpuTimings.queryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(graphicsCommandBuffer[i], gpuTimings.queryPool, i * 4, 4);
+            vkCmdWriteTimestamp(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, gpuTimings.queryPool, i * 4);
+        }
+        // fragment shader invocations of the fx, decal and scene draws (queries can only be reset outside of the render pass)
+        if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3, 3);
+        }
+        // occlusion queries of the fx/decal proxies; conditional rendering: the predicates the previous command buffer copied
+        // (transfer writes) are read by this one's fx/decal draws
+        if (occlusion.enabled) {
+            vkCmdResetQueryPool(graphicsCommandBuffer[i], occlusion.queryPool, i * 2, 2);
+        }
+        if (occlusion.conditionalRendering) {
+            VkMemoryBarrier predicateBarrier{};
+            predicateBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            predicateBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            predicateBarrier.dstAccessMask = VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT,
+                0, 1, &predicateBarrier, 0, nullptr, 0, nullptr);
+        }
+        // bloom: the pyramid is cleared once (the upsamples add to the levels they write), then stays in GENERAL layout
+        if (bloom.enabled && !bloom.initialized) {
+            VkImageMemoryBarrier clearBarrier{};
+            clearBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            clearBarrier.srcAccessMask = 0;
+            clearBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            clearBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            clearBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            clearBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            clearBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            clearBarrier.image = bloom.image;
+            clearBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, static_cast<uint32_t>(bloom.levelViews.size()), 0, 1 };
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &clearBarrier);
+
+            VkClearColorValue black = { {0.0f, 0.0f, 0.0f, 0.0f} };
+            vkCmdClearColorImage(graphicsCommandBuffer[i], bloom.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &black, 1, &clearBarrier.subresourceRange);
+
+            VkImageMemoryBarrier generalBarrier = clearBarrier;
+            generalBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            generalBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            generalBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            generalBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &generalBarrier);
+            bloom.initialized = true;
+        }
 
-            VkResult commandBufferBeganRecording = vkBeginCommandBuffer(graphicsCommandBuffer[i], &commandBufferBeginInfo);
-            if (commandBufferBeganRecording != VK_SUCCESS) {
-                throw std::runtime_error("failed to begin recording command buffer");
+        // fx sort (compute): back-to-front draw order of the fx instances, read by the fx vertex shader
+        if (settings.gpuSort) {
+            std::array<VkDescriptorSet, 2> fxSortDescriptorSets = { descriptorSets.frame[i], descriptorSets.fxSort[i] };
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.fxSort, 0, static_cast<uint32_t>(fxSortDescriptorSets.size()), fxSortDescriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.fxSort);
+            vkCmdDispatch(graphicsCommandBuffer[i], 1, 1, 1); // one workgroup sorts all instances
+
+            VkMemoryBarrier sortBarrier{};
+            sortBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            sortBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            sortBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            // (read by the fx vertex shader, or by the cull dispatch)
+            VkPipelineStageFlags sortReaders = settings.gpuCulling ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, sortReaders,
+                0, 1, &sortBarrier, 0, nullptr, 0, nullptr);
+        }
+        // fx cull (compute): visible instances of the draw order, and the fx draw's indirect command and count
+        if (settings.gpuCulling) {
+            std::array<VkDescriptorSet, 2> fxCullDescriptorSets = { descriptorSets.frame[i], descriptorSets.fxCull[i] };
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.fxCull, 0, static_cast<uint32_t>(fxCullDescriptorSets.size()), fxCullDescriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.fxCull);
+            if (hiZ.enabled) {
+                // the previous frame's pyramid (its reduction is earlier in the queue): written -> sampled.
+                // before the first one it is undefined: GENERAL for the descriptors, not tested (valid = 0)
+                VkImageMemoryBarrier pyramidBarrier{};
+                pyramidBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                pyramidBarrier.srcAccessMask = hiZ.built ? VK_ACCESS_SHADER_WRITE_BIT : 0;
+                pyramidBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                pyramidBarrier.oldLayout = hiZ.built ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+                pyramidBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+                pyramidBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                pyramidBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                pyramidBarrier.image = hiZ.image;
+                pyramidBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, static_cast<uint32_t>(hiZ.levelViews.size()), 0, 1 };
+                vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0, 0, nullptr, 0, nullptr, 1, &pyramidBarrier);
+
+                vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.fxCull, 2, 1, &descriptorSets.hiZCull[i], 0, nullptr);
+                HiZCullPushConstants pushConstants{};
+                pushConstants.viewProj = hiZ.viewProj;
+                pushConstants.valid = hiZ.built ? 1 : 0;
+                vkCmdPushConstants(graphicsCommandBuffer[i], pipelineLayouts.fxCull, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
             }
-            std::cout << "started recording command buffer " << std::to_string(i) << '\n';
+            vkCmdDispatch(graphicsCommandBuffer[i], 1, 1, 1); // one workgroup culls and compacts all instances
+
+            VkMemoryBarrier cullBarrier{};
+            cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+        }
+        if (gpuTimings.queryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, gpuTimings.queryPool, i * 4 + 1);
+        }
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = dynamicRendering.enabled ? VK_NULL_HANDLE : swapChainFramebuffers[i]; // (unused by the dynamic rendering backend)
+        renderPassInfo.renderArea.offset = { 0, 0 };
+        renderPassInfo.renderArea.extent = swapChainExtent;
 
-            VkRenderPassBeginInfo renderPassInfo{};
-            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderPassInfo.renderPass = renderPass;
-            renderPassInfo.framebuffer = swapChainFramebuffers[i];
-            renderPassInfo.renderArea.offset = { 0, 0 };
-            renderPassInfo.renderArea.extent = swapChainExtent;
+        // Define color of "VK_ATTACHMENT_LOAD_OP_CLEAR", used in attachment's load operation (declared per attachment in declareRenderGraph())
+        std::vector<VkClearValue> clearValues = renderGraph.getClearValues();
 
-            // Define color of "VK_ATTACHMENT_LOAD_OP_CLEAR", used in attachment's load operation
-            std::array<VkClearValue, 3> clearValues = {};
-            clearValues[0] = { {0.0f, 0.0f, 0.0f, 1.0f} };
-            clearValues[1] = { 1.0f, 0 };
-            clearValues[2] = { {0.0f, 0.0f, 0.0f, 1.0f} };
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
 
-            renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-            renderPassInfo.pClearValues = clearValues.data();
+        VkBuffer vertexBuffers[] = { vertexBuffer0, vertexBuffer1, vertexBuffer2, vertexBuffer3 };
+        VkDeviceSize readOffset_Bytes[] = { 0, 0, 0, 0 };
+        uint32_t bufferBinding[] = { 0, 0, 0, 0 };
+        uint32_t bufferBindingCount[] = { 1, 1, 1, 1 };
 
-            VkBuffer vertexBuffers[] = { vertexBuffer0, vertexBuffer1, vertexBuffer2, vertexBuffer3 };
-            VkDeviceSize readOffset_Bytes[] = { 0, 0, 0, 0 };
-            uint32_t bufferBinding[] = { 0, 0, 0, 0 };
-            uint32_t bufferBindingCount[] = { 1, 1, 1, 1 };
+        // bind the frame descriptor set once: set 0 of every pipeline layout is descriptorSets.frame's layout,
+        // so it stays bound across the pipeline and set 1/2 binds below
+            // layout(set = 0, binding = 0) uniform uboFrame
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 0, 1, &descriptorSets.frame[i], 0, nullptr);
+
+        // shadow map pass (its own render pass, before the main one): only when the cached map is out of date
+        if (shadow.enabled) {
+            recordShadowPass(i, state);
+        }
 
-            // record command: begin render pass (target command buffer, render pass info, primary/secondart buffer)
-                // VK_SUBPASS_CONTENTS_INLINE: Render pass commands using primary command buffer
-                // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: Render pass commands using secondary command buffer
+        // record command: begin render pass (target command buffer, render pass info, primary/secondart buffer)
+            // VK_SUBPASS_CONTENTS_INLINE: Render pass commands using primary command buffer
+            // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: Render pass commands using secondary command buffer
+        if (dynamicRendering.enabled) {
+            beginDynamicRendering(graphicsCommandBuffer[i], i);
+        }
+        else {
             vkCmdBeginRenderPass(graphicsCommandBuffer[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        }
+
 
+        // Subpass 0
+        // ------------
+        // scene draw to offscreen attachment
+        // 
+        // bind scene descriptor set
+            // (set = 1, binding = 0)
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 1, 1, &descriptorSets.scene[i], 0, nullptr);
+        // clustered forward shading: lights and the frame's cluster light lists
+            // (set = 2, binding = 0..2)
+        if (clustered.enabled) {
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 2, 1, &descriptorSets.clusters[i], 0, nullptr);
+        }
+        // shadow map and its light
+            // (set = 3, binding = 0..1)
+        if (shadow.enabled) {
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 3, 1, &descriptorSets.shadows[i], 0, nullptr);
+        }
 
-            // Subpass 0
-            // ------------
-            // scene draw to offscreen attachment
-            // 
-            // bind scene descriptor set
-                // (set = 0, binding = 0)
-            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.scene, 0, 1, &descriptorSets.scene[i], 0, nullptr);
+        // depth pre-pass subpass: scene depth from the position-only stream (no fragment shader),
+        // then the scene subpass below only shades the fragments that pass its EQUAL test
+        // (the dynamic rendering backend draws both in the same rendering: depth tests are ordered within it)
+        if (settings.depthPrepass) {
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.depthPrepass);
+            VkDeviceSize positionOffset = 0;
+            vkCmdBindVertexBuffers(graphicsCommandBuffer[i], 0, 1, &depthPrepass.positionBuffer, &positionOffset);
+            vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer0, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(graphicsCommandBuffer[i], static_cast<uint32_t>(indicesScene.size()), 1, 0, 0, 0);
+            if (!dynamicRendering.enabled) {
+                vkCmdNextSubpass(graphicsCommandBuffer[i], VK_SUBPASS_CONTENTS_INLINE);
+            }
+        }
 
-            // record command: bind pipeline (target command buffer, pipline type (graphics/compute), pipeline)
-            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.scene);
+        // record command: bind pipeline (target command buffer, pipline type (graphics/compute), pipeline)
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.scene);
 
-            vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[0], bufferBindingCount[0], &vertexBuffers[0], &readOffset_Bytes[0]);
-            VkDeviceSize indexBufferByteOffset = 0;
-            vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer0, indexBufferByteOffset, VK_INDEX_TYPE_UINT32);
+        vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[0], bufferBindingCount[0], &vertexBuffers[0], &readOffset_Bytes[0]);
+        VkDeviceSize indexBufferByteOffset = 0;
+        vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer0, indexBufferByteOffset, VK_INDEX_TYPE_UINT32);
   
-            uint32_t indexCount = static_cast<uint32_t>(indicesScene.size());
-            uint32_t instanceCount = 1;
-            uint32_t firstIndexOffset = 0;
-            uint32_t vertexOffset = 0;
-            uint32_t firstInstanceOffset = 0;
-            vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, firstIndexOffset, vertexOffset, firstInstanceOffset);
+        uint32_t indexCount = static_cast<uint32_t>(indicesScene.size());
+        uint32_t instanceCount = 1;
+        uint32_t firstIndexOffset = 0;
+        uint32_t vertexOffset = 0;
+        uint32_t firstInstanceOffset = 0;
+        if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+            vkCmdBeginQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3 + 2, 0);
+        }
+        vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, firstIndexOffset, vertexOffset, firstInstanceOffset);
+        if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+            vkCmdEndQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3 + 2);
+        }
+
+        // deferred lighting subpass: one additive quad per visible light (culled on the CPU by cullLights()) into col0
+            // layout (set = 1, binding = 0..2) gAlbedo/gNormal/depth0 inputs, (binding = 3) visible lights
+        if (deferred.enabled) {
+            vkCmdNextSubpass(graphicsCommandBuffer[i], VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.lighting, 1, 1, &descriptorSets.lighting[i], 0, nullptr);
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.lighting);
+            const uint32_t visibleLightCount = static_cast<uint32_t>(state.visibleLights.size());
+            if (visibleLightCount > 0) {
+                vkCmdDraw(graphicsCommandBuffer[i], 6, visibleLightCount, 0, 0);
+            }
+        }
+
+
+        //Subpass 1
+        // -------------
+        if (settings.multiPass) {
+            // separate render passes: col0/depth0 were stored, transition them for sampling (depth0 also stays bound for depth tests)
+            vkCmdEndRenderPass(graphicsCommandBuffer[i]);
 
+            VkFormat depthFormat = findSupportedDepthFormat();
+            std::array<VkImageMemoryBarrier, 2> inputBarriers{};
+            inputBarriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            inputBarriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            inputBarriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            inputBarriers[0].oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            inputBarriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            inputBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            inputBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            inputBarriers[0].image = offscreenImage;
+            inputBarriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            inputBarriers[0].subresourceRange.baseMipLevel = 0;
+            inputBarriers[0].subresourceRange.levelCount = 1;
+            inputBarriers[0].subresourceRange.baseArrayLayer = 0;
+            inputBarriers[0].subresourceRange.layerCount = 1;
+
+            inputBarriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            inputBarriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            inputBarriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            inputBarriers[1].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            inputBarriers[1].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            inputBarriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            inputBarriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            inputBarriers[1].image = depthImage;
+            inputBarriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+            if (formatSupportsStencil(depthFormat)) {
+                inputBarriers[1].subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT; // layout transitions cover both aspects
+            }
+            inputBarriers[1].subresourceRange.baseMipLevel = 0;
+            inputBarriers[1].subresourceRange.levelCount = 1;
+            inputBarriers[1].subresourceRange.baseArrayLayer = 0;
+            inputBarriers[1].subresourceRange.layerCount = 1;
+
+            // (bloom: col0 is also read by the bright pass)
+            VkPipelineStageFlags inputReaders = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            if (bloom.enabled) {
+                inputReaders |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            }
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i],
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                inputReaders,
+                0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(inputBarriers.size()), inputBarriers.data());
+
+            // bloom: this frame's chain, added by the composition pass below
+            if (bloom.enabled) {
+                recordBloom(i);
+            }
 
-            //Subpass 1
-            // -------------
+            std::vector<VkClearValue> compositionClearValues = separatePasses.compositionGraph.getClearValues();
+            VkRenderPassBeginInfo compositionPassInfo{};
+            compositionPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            compositionPassInfo.renderPass = separatePasses.compositionRenderPass;
+            compositionPassInfo.framebuffer = separatePasses.compositionFramebuffers[i];
+            compositionPassInfo.renderArea.offset = { 0, 0 };
+            compositionPassInfo.renderArea.extent = swapChainExtent;
+            compositionPassInfo.clearValueCount = static_cast<uint32_t>(compositionClearValues.size());
+            compositionPassInfo.pClearValues = compositionClearValues.data();
+            vkCmdBeginRenderPass(graphicsCommandBuffer[i], &compositionPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        }
+        else if (dynamicRendering.enabled) {
+            nextDynamicRenderingPass(graphicsCommandBuffer[i]);
+        }
+        else {
             // increment active subpass index
             vkCmdNextSubpass(graphicsCommandBuffer[i], VK_SUBPASS_CONTENTS_INLINE);
+        }
 
-            // fullscreen quad draw
+        // fullscreen quad draw
 
-            // bind composition descriptor set
-                // (set = 0, binding = 0)
-            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.composition, 0, 1, &descriptorSets.composition[i], 0, nullptr);
-            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.composition);
-            vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[3], bufferBindingCount[3], &vertexBuffers[3], &readOffset_Bytes[3]);
-            const uint32_t vertexCount2 = static_cast<uint32_t>(verticesScreenQuad.size());
-            vkCmdDraw(graphicsCommandBuffer[i], vertexCount2, 1, 0, 0);
+        // bind composition descriptor set
+            // (set = 1, binding = 0)
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.composition, 1, 1, &descriptorSets.composition[i], 0, nullptr);
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.composition);
+        vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[3], bufferBindingCount[3], &vertexBuffers[3], &readOffset_Bytes[3]);
+        const uint32_t vertexCount2 = static_cast<uint32_t>(verticesScreenQuad.size());
+        vkCmdDraw(graphicsCommandBuffer[i], vertexCount2, 1, 0, 0);
 
+        // occlusion proxies: tested against depth0 here, their results decide the next recorded frame's fx/decal draws
+        if (occlusion.enabled) {
+            recordOcclusionProxies(i, state);
+        }
 
-            // fx draw
-            // -------
-            // binding fx descriptor set 0
-                // layout (set = 0, binding = 0) uniform uboFX
-            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.fx, 0, 1, &descriptorSets.fx0[i], 0, nullptr);
-            // binding fx descriptor set 1
-                // layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
-                // layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputDepthAttachment;
-            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.fx, 1, 1, &descriptorSets.fx1[i], 0, nullptr);
-            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.fx);
-            vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[1], bufferBindingCount[1], &vertexBuffers[1], &readOffset_Bytes[1]);
-            vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer1, indexBufferByteOffset, VK_INDEX_TYPE_UINT32);
-            indexCount = static_cast<uint32_t>(indicesFX.size());
-            instanceCount = 1;
-            firstIndexOffset = 0;
-            vertexOffset = 0;
-            firstInstanceOffset = 0;
-            vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, firstIndexOffset, vertexOffset, firstInstanceOffset);
-
-            // decal draw
-            // ------------
-            // binding fx descriptor set 0
-                // layout (set = 0, binding = 0) uniform uboDecal
-            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.decal, 0, 1, &descriptorSets.fx0[i], 0, nullptr);
-            // binding fx descriptor set 1
-                // layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputColorAttachment;
-                // layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputDepthAttachment;
-            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.decal, 1, 1, &descriptorSets.fx1[i], 0, nullptr);
-            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.decal);
+
+        // fx draw (blended over col1 here, unless it goes to the OIT subpasses below)
+        // -------
+        if (!oit.enabled) {
+            recordFxDraw(i, state);
+        }
+
+        // decal draw
+        // ------------
+        if (settings.volumeDecals && state.decalBounds.scissor.extent.width > 0 && state.decalBounds.scissor.extent.height > 0) {
+            // volume decal: the first decal's box only (skipped when its bounds are empty: behind the camera, or Hi-Z occluded)
+            // pipelineLayouts.decal is created from the same set layouts as pipelineLayouts.fx: the fx sets serve both pipelines
+            std::array<VkDescriptorSet, 2> fxDescriptorSets = { descriptorSets.fx0[i], descriptorSets.fx1[i] };
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.decal, 1, static_cast<uint32_t>(fxDescriptorSets.size()), fxDescriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, volumeDraws.decalStencil ? pipelines.decalStencil : pipelines.decal);
+            // only rasterize the box's projected screen-space bounds, and only shade pixels whose scene depth lies in the box's depth range
+            // (scissor and depth bounds are dynamic state: they stay set for the shading draw after the stencil marking draw)
+            vkCmdSetScissor(graphicsCommandBuffer[i], 0, 1, &state.decalBounds.scissor);
+            if (volumeDraws.depthBoundsTest) {
+                vkCmdSetDepthBounds(graphicsCommandBuffer[i], state.decalBounds.minDepth, state.decalBounds.maxDepth);
+            }
             vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[2], bufferBindingCount[2], &vertexBuffers[2], &readOffset_Bytes[2]);
             vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer2, indexBufferByteOffset, VK_INDEX_TYPE_UINT32);
             indexCount = static_cast<uint32_t>(indicesDecal.size());
@@ -2836,18 +6936,631 @@ void VulkanApp::recordCommandBuffers() {
             firstIndexOffset = 0;
             vertexOffset = 0;
             firstInstanceOffset = 0;
-            vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, firstIndexOffset, vertexOffset, firstInstanceOffset);
+            // (occlusion queries: both draws predicated on the decal proxy)
+            bool decalVisible = beginOcclusionCondition(i, 1);
+            if (volumeDraws.decalStencil && decalVisible) {
+                // mark the pixels whose scene surface lies inside the box, then shade only those
+                vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, firstIndexOffset, vertexOffset, firstInstanceOffset);
+                vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.decal);
+            }
+            if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+                vkCmdBeginQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3 + 1, 0);
+            }
+            if (decalVisible) {
+                vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, firstIndexOffset, vertexOffset, firstInstanceOffset);
+            }
+            if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+                vkCmdEndQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3 + 1);
+            }
+            endOcclusionCondition(i);
+        }
+        else {
+            // tiled decals: one quad per screen tile with at least one decal (binned on the CPU by binDecals()),
+            // the fragment shader blends the tile's decal list
+                // layout (set = 1, binding = 0..3) buffers decals, tiles, decalIndices, activeTiles
+                // set 2 (fx1): col0/depth0 inputs, rebound because set 1's layout differs from the fx layout
+            std::array<VkDescriptorSet, 2> decalDescriptorSets = { descriptorSets.decal[i], descriptorSets.fx1[i] };
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.decalTiles, 1, static_cast<uint32_t>(decalDescriptorSets.size()), decalDescriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.decalTiles);
+            const uint32_t activeTileCount = static_cast<uint32_t>(state.decalBins.activeTiles.size());
+            if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+                vkCmdBeginQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3 + 1, 0);
+            }
+            if (activeTileCount > 0) {
+                vkCmdDraw(graphicsCommandBuffer[i], 6, activeTileCount, 0, 0);
+            }
+            if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+                vkCmdEndQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3 + 1);
+            }
+        }
+
+        // weighted blended OIT
+        // ------------
+        if (oit.enabled) {
+            // fx subpass: all fields accumulated in any order
+            vkCmdNextSubpass(graphicsCommandBuffer[i], VK_SUBPASS_CONTENTS_INLINE);
+            recordFxDraw(i, state);
+
+            // resolve subpass: screen quad over the fx bounds
+                // layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputAccumAttachment;
+                // layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputRevealAttachment;
+            vkCmdNextSubpass(graphicsCommandBuffer[i], VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.oitResolve, 1, 1, &descriptorSets.oitResolve[i], 0, nullptr);
+            vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.oitResolve);
+            vkCmdSetScissor(graphicsCommandBuffer[i], 0, 1, &state.fxBounds.scissor);
+            vkCmdBindVertexBuffers(graphicsCommandBuffer[i], bufferBinding[3], bufferBindingCount[3], &vertexBuffers[3], &readOffset_Bytes[3]);
+            vkCmdDraw(graphicsCommandBuffer[i], vertexCount2, 1, 0, 0);
+        }
 
-            // end render pass
+        // end render pass
+        if (dynamicRendering.enabled) {
+            endDynamicRendering(graphicsCommandBuffer[i], i);
+        }
+        else {
             vkCmdEndRenderPass(graphicsCommandBuffer[i]);
+        }
+
+        // multiview stereo: both eyes side by side into the swapchain image
+        if (multiview.enabled) {
+            recordStereoBlit(i);
+        }
+
+        // auto exposure: quarter-resolution copy of col0 (--no-async-compute: and the dispatch)
+        if (autoExposure.enabled) {
+            recordLuminanceCopy(i);
+        }
+
+        // occlusion queries (conditional rendering): this frame's proxy results -> predicates of the next command buffer's draws
+        if (occlusion.conditionalRendering) {
+            recordOcclusionPredicates(i);
+        }
+
+        if (gpuTimings.queryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, gpuTimings.queryPool, i * 4 + 2);
+        }
+
+        // Hi-Z: depth pyramid of this frame's depth0, tested against by the next frame
+        if (hiZ.enabled) {
+            recordHiZBuild(i, state);
+        }
+        if (gpuTimings.queryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, gpuTimings.queryPool, i * 4 + 3);
+        }
+
+        // finish recording command buffer 
+        VkResult commandBufferRecorded = vkEndCommandBuffer(graphicsCommandBuffer[i]);
+        if (commandBufferRecorded != VK_SUCCESS) {
+            throw std::runtime_error("failed to record command buffer");
+        }
+}
+
+void VulkanApp::recordFxDraw(uint32_t i, const FrameState& state) {
+        // all force fields in one instanced draw
+        // binding fx descriptor sets 0 and 1
+            // layout (set = 1, binding = 0) uniform uboFX
+            // layout (std430, set = 1, binding = 1) readonly buffer fxInstances
+            // layout(input_attachment_index = 0, set = 2, binding = 0) uniform subpassInput inputColorAttachment;
+            // layout(input_attachment_index = 1, set = 2, binding = 1) uniform subpassInput inputDepthAttachment;
+        std::array<VkDescriptorSet, 2> fxDescriptorSets = { descriptorSets.fx0[i], descriptorSets.fx1[i] };
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.fx, 1, static_cast<uint32_t>(fxDescriptorSets.size()), fxDescriptorSets.data(), 0, nullptr);
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.fx);
+        // only rasterize the fields' projected screen-space bounds
+        vkCmdSetScissor(graphicsCommandBuffer[i], 0, 1, &state.fxBounds.scissor);
+        VkDeviceSize readOffset_Bytes = 0;
+        vkCmdBindVertexBuffers(graphicsCommandBuffer[i], 0, 1, &vertexBuffer1, &readOffset_Bytes);
+        vkCmdBindIndexBuffer(graphicsCommandBuffer[i], indicesBuffer1, 0, VK_INDEX_TYPE_UINT32);
+        if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+            vkCmdBeginQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3, 0);
+        }
+        // (occlusion queries: predicated on the fx proxy, or left out if the latest read-back result hid it)
+        bool fxVisible = beginOcclusionCondition(i, 0);
+        if (fxVisible && settings.gpuCulling) {
+            // command (visible instance count) and draw count written by the cull dispatch: no draw at all if nothing is visible
+            if (fxCull.drawIndirectCount) {
+                vkCmdDrawIndexedIndirectCount(graphicsCommandBuffer[i], fxCull.buffers[i], 0, fxCull.buffers[i], fxCull.countOffset, 1, sizeof(VkDrawIndexedIndirectCommand));
+            }
+            else {
+                vkCmdDrawIndexedIndirect(graphicsCommandBuffer[i], fxCull.buffers[i], 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+            }
+        }
+        else if (fxVisible) {
+            uint32_t indexCount = static_cast<uint32_t>(indicesFX.size());
+            uint32_t instanceCount = static_cast<uint32_t>(fxInstances.instances.size());
+            vkCmdDrawIndexed(graphicsCommandBuffer[i], indexCount, instanceCount, 0, 0, 0);
+        }
+        endOcclusionCondition(i);
+        if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+            vkCmdEndQuery(graphicsCommandBuffer[i], volumeDraws.statisticsPool, i * 3);
+        }
+}
+
+void VulkanApp::recordOcclusionProxies(uint32_t i, const FrameState& state) {
+        // proxy 0: bounds of all fx instances, proxy 1: the volume decal's box (instance index selects the box in the vertex shader).
+        // a proxy that can't be tested (simulateFrameState()) leaves its query unused: its volume is drawn by the next frame
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayouts.occlusionProxy, 1, 1, &descriptorSets.fx0[i], 0, nullptr);
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.occlusionProxy);
+        for (uint32_t proxy = 0; proxy < 2; proxy++) {
+            bool volumeDrawn = (proxy == 0) || settings.volumeDecals; // (tiled decals have no proxy)
+            occlusion.tested[i][proxy] = volumeDrawn && state.occlusionTestable[proxy];
+            if (!occlusion.tested[i][proxy]) {
+                continue;
+            }
+            vkCmdBeginQuery(graphicsCommandBuffer[i], occlusion.queryPool, i * 2 + proxy, 0);
+            vkCmdDraw(graphicsCommandBuffer[i], 36, 1, 0, proxy); // 12 triangles of the box
+            vkCmdEndQuery(graphicsCommandBuffer[i], occlusion.queryPool, i * 2 + proxy);
+        }
+}
+
+void VulkanApp::recordOcclusionPredicates(uint32_t i) {
+        // this command buffer's draws read the predicates before they are overwritten (execution dependency)
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 0, nullptr);
+        for (uint32_t proxy = 0; proxy < 2; proxy++) {
+            VkDeviceSize offset = proxy * sizeof(uint32_t);
+            if (occlusion.tested[i][proxy]) {
+                // 32-bit sample count (waits for the query): 0 skips the draw
+                vkCmdCopyQueryPoolResults(graphicsCommandBuffer[i], occlusion.queryPool, i * 2 + proxy, 1, occlusion.predicateBuffer, offset,
+                    sizeof(uint32_t), VK_QUERY_RESULT_WAIT_BIT);
+            }
+            else {
+                vkCmdFillBuffer(graphicsCommandBuffer[i], occlusion.predicateBuffer, offset, sizeof(uint32_t), 1); // not tested: draw
+            }
+        }
+}
+
+bool VulkanApp::beginOcclusionCondition(uint32_t i, uint32_t proxy) {
+        if (!occlusion.enabled) {
+            return true;
+        }
+        if (occlusion.conditionalRendering) {
+            VkConditionalRenderingBeginInfoEXT conditionalRenderingInfo{};
+            conditionalRenderingInfo.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+            conditionalRenderingInfo.buffer = occlusion.predicateBuffer;
+            conditionalRenderingInfo.offset = proxy * sizeof(uint32_t);
+            conditionalRenderingInfo.flags = 0;
+            occlusion.cmdBeginConditionalRendering(graphicsCommandBuffer[i], &conditionalRenderingInfo);
+            return true;
+        }
+        if (occlusion.hidden[proxy]) {
+            occlusion.skippedDraws[proxy]++;
+            return false;
+        }
+        return true;
+}
+
+void VulkanApp::endOcclusionCondition(uint32_t i) {
+        if (occlusion.conditionalRendering) {
+            occlusion.cmdEndConditionalRendering(graphicsCommandBuffer[i]);
+        }
+}
+
+void VulkanApp::recordHiZBuild(uint32_t i, const FrameState& state) {
+        // depth pyramid of this frame's depth0 (read-only layout after the render pass), level by level:
+        // every level reads the previous one (level 0: depth0), so each dispatch waits for the one before
+        // (the cull dispatch of this command buffer read the previous pyramid: execution dependency before overwriting it)
+        VkMemoryBarrier readBarrier{};
+        readBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        readBarrier.srcAccessMask = 0;
+        readBarrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &readBarrier, 0, nullptr, 0, nullptr);
+
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.hiZBuild);
+        for (size_t level = 0; level < hiZ.levelViews.size(); level++) {
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.hiZBuild, 0, 1, &descriptorSets.hiZBuild[level], 0, nullptr);
+            const VkExtent2D& extent = hiZ.extents[level];
+            vkCmdDispatch(graphicsCommandBuffer[i], (extent.width + 7) / 8, (extent.height + 7) / 8, 1); // 8x8 texels per workgroup
+
+            VkMemoryBarrier levelBarrier{};
+            levelBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0, 1, &levelBarrier, 0, nullptr, 0, nullptr);
+        }
+
+        // coarse level -> read-back buffer (decal tests on the CPU), before the fx cull counts behind it
+        const VkExtent2D& readbackExtent = hiZ.extents[hiZ.readbackLevel];
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, hiZ.readbackLevel, 0, 1 };
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { readbackExtent.width, readbackExtent.height, 1 };
+        vkCmdCopyImageToBuffer(graphicsCommandBuffer[i], hiZ.image, VK_IMAGE_LAYOUT_GENERAL, hiZ.readbackBuffers[i], 1, &region);
+
+        // (read by readHiZResults() once the image's fence signals)
+        VkMemoryBarrier hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+        // the next recorded command buffer tests against this pyramid, with this frame's camera
+        hiZ.readbackViewProj[i] = state.uboFrame.viewProj;
+        hiZ.readbackPending[i] = true;
+        hiZ.viewProj = state.uboFrame.viewProj;
+        hiZ.built = true;
+}
+
+void VulkanApp::recordBloom(uint32_t i) {
+        // bloom pyramid from col0 (sampled layout), level by level: every dispatch reads the level the previous one wrote
+        // (the previous composition read level 0, the previous chain wrote it: execution dependency before overwriting it)
+        if (bloom.queryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(graphicsCommandBuffer[i], bloom.queryPool, i * 2, 2);
+            vkCmdWriteTimestamp(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, bloom.queryPool, i * 2);
+        }
+        VkMemoryBarrier readBarrier{};
+        readBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        readBarrier.srcAccessMask = 0;
+        readBarrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &readBarrier, 0, nullptr, 0, nullptr);
+
+        VkMemoryBarrier levelBarrier{};
+        levelBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        const uint32_t levels = static_cast<uint32_t>(bloom.levelViews.size());
+
+        // bright pass: col0 -> level 0
+        BloomPushConstants pushConstants{ bloom.threshold, bloom.knee };
+        vkCmdPushConstants(graphicsCommandBuffer[i], pipelineLayouts.bloom, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BloomPushConstants), &pushConstants);
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.bloomBright);
+        vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.bloom, 0, 1, &descriptorSets.bloom[0], 0, nullptr);
+        vkCmdDispatch(graphicsCommandBuffer[i], (bloom.extents[0].width + 7) / 8, (bloom.extents[0].height + 7) / 8, 1); // 8x8 texels per workgroup
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &levelBarrier, 0, nullptr, 0, nullptr);
+
+        // downsamples: level n - 1 -> level n
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.bloomDown);
+        for (uint32_t level = 1; level < levels; level++) {
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.bloom, 0, 1, &descriptorSets.bloom[level], 0, nullptr);
+            vkCmdDispatch(graphicsCommandBuffer[i], (bloom.extents[level].width + 7) / 8, (bloom.extents[level].height + 7) / 8, 1);
+            vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                0, 1, &levelBarrier, 0, nullptr, 0, nullptr);
+        }
 
-            // finish recording command buffer 
-            VkResult commandBufferRecorded = vkEndCommandBuffer(graphicsCommandBuffer[i]);
-            if (commandBufferRecorded != VK_SUCCESS) {
-                throw std::runtime_error("failed to record command buffer");
+        // upsamples: level n + 1 -> level n (added to it), down to level 0
+        vkCmdBindPipeline(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.bloomUp);
+        for (uint32_t level = levels - 1; level-- > 0;) {
+            vkCmdBindDescriptorSets(graphicsCommandBuffer[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.bloom, 0, 1, &descriptorSets.bloom[levels * 2 - 2 - level], 0, nullptr);
+            vkCmdDispatch(graphicsCommandBuffer[i], (bloom.extents[level].width + 7) / 8, (bloom.extents[level].height + 7) / 8, 1);
+            if (level > 0) {
+                vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0, 1, &levelBarrier, 0, nullptr, 0, nullptr);
             }
-            std::cout << "finished recording command buffer " << std::to_string(i) << '\n';
+        }
+
+        // level 0 -> sampled by the composition pass recorded next
+        VkMemoryBarrier compositionBarrier{};
+        compositionBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        compositionBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        compositionBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0, 1, &compositionBarrier, 0, nullptr, 0, nullptr);
+
+        if (bloom.queryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, bloom.queryPool, i * 2 + 1);
+        }
+}
+
+void VulkanApp::recordLuminanceCopy(uint32_t i) {
+        // auto exposure: col0 (layer 0) downsampled into the image's luminance copy. nearest filtering: linear blits of
+        // R32G32B32A32_SFLOAT are not guaranteed by the format features
+        VkImageMemoryBarrier copyBarriers[2]{};
+        copyBarriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        copyBarriers[0].srcAccessMask = 0; // (the previous dispatch reading it finished: read back before this recording)
+        copyBarriers[0].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        copyBarriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        copyBarriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        copyBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        copyBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        copyBarriers[0].image = autoExposure.images[i];
+        copyBarriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyBarriers[0].subresourceRange.baseMipLevel = 0;
+        copyBarriers[0].subresourceRange.levelCount = 1;
+        copyBarriers[0].subresourceRange.baseArrayLayer = 0;
+        copyBarriers[0].subresourceRange.layerCount = 1;
+        // separate render passes: col0 was left sampled by the composition pass and the bloom bright pass
+        // (the render pass dependency covers the other paths)
+        copyBarriers[1] = copyBarriers[0];
+        copyBarriers[1].srcAccessMask = 0;
+        copyBarriers[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        copyBarriers[1].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        copyBarriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        copyBarriers[1].image = offscreenImage;
+        uint32_t barrierCount = settings.multiPass ? 2 : 1;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, barrierCount, copyBarriers);
+
+        VkImageBlit region{};
+        region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.srcSubresource.mipLevel = 0;
+        region.srcSubresource.baseArrayLayer = 0;
+        region.srcSubresource.layerCount = 1;
+        region.srcOffsets[1] = { static_cast<int32_t>(swapChainExtent.width), static_cast<int32_t>(swapChainExtent.height), 1 };
+        region.dstSubresource = region.srcSubresource;
+        region.dstOffsets[1] = { static_cast<int32_t>(autoExposure.extent.width), static_cast<int32_t>(autoExposure.extent.height), 1 };
+        vkCmdBlitImage(graphicsCommandBuffer[i], offscreenImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, autoExposure.images[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &region, VK_FILTER_NEAREST);
+
+        // sampled by the dispatch (async: on the compute queue, after the graphics timeline signal of this submission)
+        VkImageMemoryBarrier toSampled = copyBarriers[0];
+        toSampled.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toSampled.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        toSampled.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        toSampled.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(graphicsCommandBuffer[i], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &toSampled);
+
+        // --no-async-compute: the dispatch right behind the copy, read back when the image's fence has signalled
+        if (!autoExposure.async) {
+            recordAutoExposure(graphicsCommandBuffer[i], i);
+            autoExposure.pendingFrames[i] = 1;
+        }
+}
+
+void VulkanApp::recordAutoExposure(VkCommandBuffer commandBuffer, uint32_t i) {
+        if (autoExposure.queryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(commandBuffer, autoExposure.queryPool, i * 2, 2);
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, autoExposure.queryPool, i * 2);
+        }
+
+        // the state buffer: the previous dispatch's exposure (an earlier submission to the same queue)
+        VkMemoryBarrier stateBarrier{};
+        stateBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        stateBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        stateBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &stateBarrier, 0, nullptr, 0, nullptr);
+
+        // adaptation: exponential in the time since the previous dispatch (frame-rate independent)
+        auto now = std::chrono::high_resolution_clock::now();
+        AutoExposurePushConstants pushConstants{};
+        if (autoExposure.dispatched) {
+            float deltaTime = std::chrono::duration<float>(now - autoExposure.lastDispatchTime).count();
+            pushConstants.rate = 1.0f - std::exp(-std::min(deltaTime, 0.25f) * autoExposure.speed);
+            pushConstants.reset = 0;
+        }
+        else {
+            pushConstants.rate = 1.0f;
+            pushConstants.reset = 1;
+        }
+        autoExposure.lastDispatchTime = now;
+        autoExposure.dispatched = true;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.autoExposure);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayouts.autoExposure, 0, 1, &descriptorSets.autoExposure[i], 0, nullptr);
+        vkCmdPushConstants(commandBuffer, pipelineLayouts.autoExposure, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(AutoExposurePushConstants), &pushConstants);
+        vkCmdDispatch(commandBuffer, 1, 1, 1);
+
+        // result read back by the host (readAutoExposure)
+        VkMemoryBarrier resultBarrier{};
+        resultBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        resultBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        resultBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &resultBarrier, 0, nullptr, 0, nullptr);
+
+        if (autoExposure.queryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, autoExposure.queryPool, i * 2 + 1);
+        }
+}
+
+void VulkanApp::submitAutoExposure(uint32_t i, uint64_t frameValue) {
+        // the image's compute command buffer is free: its previous submission was read back (readAutoExposure) before this frame
+        VkCommandBuffer commandBuffer = autoExposure.commandBuffers[i];
+        VkCommandBufferBeginInfo commandBufferBeginInfo{};
+        commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("failed to begin recording command buffer");
+        }
+        recordAutoExposure(commandBuffer, i);
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to record command buffer");
+        }
+
+        // waits for this frame's copy (graphics timeline), signals its result (compute timeline): nothing on the graphics
+        // queue waits for the compute timeline, the next frames' scene subpasses run alongside the dispatch
+        VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+        timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineSubmitInfo.waitSemaphoreValueCount = 1;
+        timelineSubmitInfo.pWaitSemaphoreValues = &frameValue;
+        timelineSubmitInfo.signalSemaphoreValueCount = 1;
+        timelineSubmitInfo.pSignalSemaphoreValues = &frameValue;
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineSubmitInfo;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &autoExposure.graphicsTimeline;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &autoExposure.computeTimeline;
+        if (vkQueueSubmit(computeQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit auto exposure command buffer");
+        }
+        autoExposure.pendingFrames[i] = frameValue;
+}
+
+void VulkanApp::beginDynamicRendering(VkCommandBuffer commandBuffer, uint32_t swapImageID) {
+        // transitions a render pass would do through its attachment descriptions and external dependencies:
+        // col0/depth0 (contents discarded) -> local-read layout, written as attachments and read as input attachments on tile
+        // swapchain image (contents discarded) -> color attachment
+        std::array<VkImageMemoryBarrier, 3> imageBarriers{};
+        for (VkImageMemoryBarrier& barrier : imageBarriers) {
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+        }
+        // (previous frame's writes and input reads have to finish before the transition)
+        imageBarriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        imageBarriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+        imageBarriers[0].newLayout = VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+        imageBarriers[0].image = offscreenImage;
+        imageBarriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+
+        VkFormat depthFormat = findSupportedDepthFormat();
+        imageBarriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        imageBarriers[1].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+        imageBarriers[1].newLayout = VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+        imageBarriers[1].image = depthImage;
+        imageBarriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (formatSupportsStencil(depthFormat)) {
+            imageBarriers[1].subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+
+        // (waits for imageAvailableSemaphore, which the submit waits for at the color attachment output stage)
+        imageBarriers[2].srcAccessMask = 0;
+        imageBarriers[2].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        imageBarriers[2].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        imageBarriers[2].image = swapChainImages[swapImageID];
+        imageBarriers[2].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+
+        VkPipelineStageFlags attachmentStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        // (Hi-Z: depth0 was last read by the previous frame's pyramid reduction)
+        VkPipelineStageFlags previousStages = attachmentStages | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | (hiZ.enabled ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : 0);
+        vkCmdPipelineBarrier(commandBuffer,
+            previousStages,
+            attachmentStages | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+        // attachments, with the load/store ops and clear values the render graph derived for the render pass backend
+        std::array<VkRenderingAttachmentInfoKHR, 2> colorAttachments{};
+        colorAttachments[0].sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        colorAttachments[0].imageView = offscreenImageView;
+        colorAttachments[0].imageLayout = VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+        colorAttachments[0].resolveMode = VK_RESOLVE_MODE_NONE;
+        colorAttachments[0].loadOp = renderGraph.getLoadOp("col0");
+        colorAttachments[0].storeOp = renderGraph.getStoreOp("col0");
+        colorAttachments[0].clearValue = renderGraph.getClearValue("col0");
+
+        colorAttachments[1].sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        colorAttachments[1].imageView = swapChainImageViews[swapImageID];
+        colorAttachments[1].imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachments[1].resolveMode = VK_RESOLVE_MODE_NONE;
+        colorAttachments[1].loadOp = renderGraph.getLoadOp("col1");
+        colorAttachments[1].storeOp = renderGraph.getStoreOp("col1");
+        colorAttachments[1].clearValue = renderGraph.getClearValue("col1");
+
+        VkRenderingAttachmentInfoKHR depthAttachment{};
+        depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        depthAttachment.imageView = depthStencilImageView;
+        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+        depthAttachment.resolveMode = VK_RESOLVE_MODE_NONE;
+        depthAttachment.loadOp = renderGraph.getLoadOp("depth0");
+        depthAttachment.storeOp = renderGraph.getStoreOp("depth0");
+        depthAttachment.clearValue = renderGraph.getClearValue("depth0");
+
+        // decal stencil mask: same view as the depth attachment
+        VkRenderingAttachmentInfoKHR stencilAttachment = depthAttachment;
+        stencilAttachment.loadOp = renderGraph.getStencilLoadOp("depth0");
+        stencilAttachment.storeOp = renderGraph.getStencilStoreOp("depth0");
+
+        VkRenderingInfoKHR renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        renderingInfo.renderArea.offset = { 0, 0 };
+        renderingInfo.renderArea.extent = swapChainExtent;
+        renderingInfo.layerCount = 1;
+        renderingInfo.viewMask = 0;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
+        renderingInfo.pColorAttachments = colorAttachments.data();
+        renderingInfo.pDepthAttachment = &depthAttachment;
+        renderingInfo.pStencilAttachment = volumeDraws.decalStencil ? &stencilAttachment : nullptr;
+        dynamicRendering.cmdBeginRendering(commandBuffer, &renderingInfo);
+
+        // scene: fragment output location 0 -> col0
+        uint32_t sceneLocations[] = { 0, VK_ATTACHMENT_UNUSED };
+        VkRenderingAttachmentLocationInfoKHR locationInfo{};
+        locationInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_LOCATION_INFO_KHR;
+        locationInfo.colorAttachmentCount = 2;
+        locationInfo.pColorAttachmentLocations = sceneLocations;
+        dynamicRendering.cmdSetRenderingAttachmentLocations(commandBuffer, &locationInfo);
+}
+
+void VulkanApp::nextDynamicRenderingPass(VkCommandBuffer commandBuffer) {
+        // local-read barrier (replaces the subpass dependency): scene's col0/depth0 writes -> composition's input attachment reads.
+        // only a by-region memory barrier is allowed inside the rendering, so the data can stay on tile
+        VkMemoryBarrier localReadBarrier{};
+        localReadBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        localReadBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        localReadBarrier.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            VK_DEPENDENCY_BY_REGION_BIT, 1, &localReadBarrier, 0, nullptr, 0, nullptr);
+
+        // composition: fragment output location 0 -> col1 (swapchain image)
+        uint32_t compositionLocations[] = { VK_ATTACHMENT_UNUSED, 0 };
+        VkRenderingAttachmentLocationInfoKHR locationInfo{};
+        locationInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_LOCATION_INFO_KHR;
+        locationInfo.colorAttachmentCount = 2;
+        locationInfo.pColorAttachmentLocations = compositionLocations;
+        dynamicRendering.cmdSetRenderingAttachmentLocations(commandBuffer, &locationInfo);
+
+        // col0 -> input_attachment_index 0, depth0 -> input_attachment_index 1 (as declared in the shaders)
+        uint32_t colorInputIndices[] = { 0, VK_ATTACHMENT_UNUSED };
+        uint32_t depthInputIndex = 1;
+        VkRenderingInputAttachmentIndexInfoKHR inputIndexInfo{};
+        inputIndexInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INPUT_ATTACHMENT_INDEX_INFO_KHR;
+        inputIndexInfo.colorAttachmentCount = 2;
+        inputIndexInfo.pColorAttachmentInputIndices = colorInputIndices;
+        inputIndexInfo.pDepthInputAttachmentIndex = &depthInputIndex;
+        inputIndexInfo.pStencilInputAttachmentIndex = nullptr;
+        dynamicRendering.cmdSetRenderingInputAttachmentIndices(commandBuffer, &inputIndexInfo);
+}
 
+void VulkanApp::endDynamicRendering(VkCommandBuffer commandBuffer, uint32_t swapImageID) {
+        dynamicRendering.cmdEndRendering(commandBuffer);
+
+        // swapchain image -> present
+        VkImageMemoryBarrier presentBarrier{};
+        presentBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        presentBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        presentBarrier.dstAccessMask = 0;
+        presentBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        presentBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        presentBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        presentBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        presentBarrier.image = swapChainImages[swapImageID];
+        presentBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        presentBarrier.subresourceRange.baseMipLevel = 0;
+        presentBarrier.subresourceRange.levelCount = 1;
+        presentBarrier.subresourceRange.baseArrayLayer = 0;
+        presentBarrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &presentBarrier);
+
+        // Hi-Z: depth0 -> read-only, sampled by the pyramid reduction (the render graph's final layout of the stored depth0)
+        if (hiZ.enabled) {
+            VkImageMemoryBarrier depthBarrier{};
+            depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            depthBarrier.oldLayout = VK_IMAGE_LAYOUT_RENDERING_LOCAL_READ_KHR;
+            depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            depthBarrier.image = depthImage;
+            depthBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+            if (formatSupportsStencil(findSupportedDepthFormat())) {
+                depthBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+            }
+            depthBarrier.subresourceRange.baseMipLevel = 0;
+            depthBarrier.subresourceRange.levelCount = 1;
+            depthBarrier.subresourceRange.baseArrayLayer = 0;
+            depthBarrier.subresourceRange.layerCount = 1;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
         }
 }
 
@@ -2859,7 +7572,7 @@ void VulkanApp::createSyncObjects() {
         semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
         cmdbuffersExecutionFence.resize(MAX_FRAMES_IN_FLIGHT);
-        uint32_t swapchainImageCount = (uint32_t)swapChainFramebuffers.size();
+        uint32_t swapchainImageCount = (uint32_t)swapChainImages.size();
         swapchainImageFence.resize(swapchainImageCount, VK_NULL_HANDLE);
 
         VkFenceCreateInfo fenceCreateInfo{}; // CPU-GPU synchronization (block CPU exection, using GPU signals)
@@ -3108,6 +7821,29 @@ void VulkanApp::createVertexBuffers() {
         vkDestroyBuffer(device, stagingBuffer3, nullptr);
         vkFreeMemory(device, stagingBufferMemory3, nullptr);
 
+        // ---------------------
+        // depth pre-pass and shadow map: scene positions only (12 instead of sizeof(Vertex) bytes per vertex fetched)
+        if (settings.depthPrepass || shadow.enabled) {
+            std::vector<glm::vec3> positions(verticesScene.size());
+            for (size_t v = 0; v < verticesScene.size(); v++) {
+                positions[v] = verticesScene[v].pos;
+            }
+            VkDeviceSize positionsSize = sizeof(positions[0]) * positions.size();
+            VkBuffer stagingBufferPositions;
+            VkDeviceMemory stagingBufferMemoryPositions;
+            createGraphicsBuffer(positionsSize, stagingBufferUsageBitflags, stagingBufferMemPropertiesBitflags, stagingBufferPositions, stagingBufferMemoryPositions);
+
+            void* dataPositions;
+            vkMapMemory(device, stagingBufferMemoryPositions, 0, positionsSize, 0, &dataPositions);
+            memcpy(dataPositions, positions.data(), (size_t)positionsSize);
+            vkUnmapMemory(device, stagingBufferMemoryPositions);
+
+            createGraphicsBuffer(positionsSize, bufferUsageBitflags, memPropertiesBitflags, depthPrepass.positionBuffer, depthPrepass.positionMemory);
+            copyBuffer(stagingBufferPositions, depthPrepass.positionBuffer, positionsSize);
+            vkDestroyBuffer(device, stagingBufferPositions, nullptr);
+            vkFreeMemory(device, stagingBufferMemoryPositions, nullptr);
+        }
+
 }
 
 void VulkanApp::createIndexBuffers() {
@@ -3166,194 +7902,303 @@ void VulkanApp::createIndexBuffers() {
         memcpy(data2, indicesDecal.data(), (size_t)buffer2Size);
         vkUnmapMemory(device, stagingBufferMemory2);
 
-        createGraphicsBuffer(buffer2Size, bufferUsageBitflags, memPropertiesBitflags, indicesBuffer2, indicesBufferMemory2);
-        copyBuffer(stagingBuffer2, indicesBuffer2, buffer2Size);
-        vkDestroyBuffer(device, stagingBuffer2, nullptr);
-        vkFreeMemory(device, stagingBufferMemory2, nullptr);
-}
-
-void VulkanApp::loadObjs() {
-        tinyobj::attrib_t attribScene; 
-        std::vector<tinyobj::shape_t> shapesScene;
-        std::vector<tinyobj::material_t> materialsScene;
-        std::string warn0, err0;
-        bool sceneObjLoaded = tinyobj::LoadObj(&attribScene, &shapesScene, &materialsScene, &warn0, &err0, MODEL_PATH_0.c_str());
-        if (!sceneObjLoaded) {
-            throw std::runtime_error(warn0 + err0);
-        }
-        std::cout << "scene.obj loaded" << '\n';
-        // for every triangle
-        for (const auto& shape : shapesScene) {
-            int ind = 0;
-            // for every unique vertex/index
-            for (const auto& index : shape.mesh.indices) {
-                Vertex vertex{};
-
-                // access attrib_t.vertices float array:
-                float posx = attribScene.vertices[3 * index.vertex_index + 0];
-                float posy = attribScene.vertices[3 * index.vertex_index + 1];
-                float posz = attribScene.vertices[3 * index.vertex_index + 2];
-                vertex.pos = glm::vec3(posx, posy, posz);
-
-                float uvx = attribScene.texcoords[2 * index.texcoord_index + 0];
-                float uvy = attribScene.texcoords[2 * index.texcoord_index + 1];
-                vertex.uv = glm::vec2(uvx, uvy);
-
-
-                float normalx = attribScene.normals[3 * index.normal_index + 0];
-                float normaly = attribScene.normals[3 * index.normal_index + 1];
-                float normalz = attribScene.normals[3 * index.normal_index + 2];
-                vertex.normal = glm::vec3(normalx, normaly, normalz);
+        createGraphicsBuffer(buffer2Size, bufferUsageBitflags, memPropertiesBitflags, indicesBuffer2, indicesBufferMemory2);
+        copyBuffer(stagingBuffer2, indicesBuffer2, buffer2Size);
+        vkDestroyBuffer(device, stagingBuffer2, nullptr);
+        vkFreeMemory(device, stagingBufferMemory2, nullptr);
+}
 
-                vertex.color = glm::vec3(1.0f, 1.0f, 1.0f);
-                verticesScene.push_back(vertex);
-                indicesScene.push_back(ind);
-                ind += 1;
+void VulkanApp::loadShaderCode() {
+        // read all SPIR-V files once, so pipeline creation doesn't touch the file system
+        // (composition/fx/decal/tiled decal fragment shaders in their sampled-texture variant, if rendering separate render passes)
+        std::vector<std::string> shaderPaths = {
+            SHADER_VERT_PATH_0, getSceneFragShaderPath(),
+            SHADER_VERT_PATH_1, settings.multiPass ? SHADER_FRAG_PATH_1_SAMPLED : SHADER_FRAG_PATH_1,
+            SHADER_VERT_PATH_2, settings.multiPass ? SHADER_FRAG_PATH_2_SAMPLED : SHADER_FRAG_PATH_2,
+            SHADER_VERT_PATH_3, getCompositionFragShaderPath()
+        };
+        if (!settings.volumeDecals) {
+            shaderPaths.push_back(SHADER_VERT_PATH_4);
+            shaderPaths.push_back(settings.multiPass ? SHADER_FRAG_PATH_4_SAMPLED : SHADER_FRAG_PATH_4);
+        }
+        if (settings.gpuSort) {
+            shaderPaths.push_back(SHADER_COMP_PATH_FX_SORT);
+        }
+        if (settings.gpuCulling) {
+            shaderPaths.push_back(hiZ.enabled ? SHADER_COMP_PATH_FX_CULL_HI_Z : SHADER_COMP_PATH_FX_CULL);
+        }
+        if (hiZ.enabled) {
+            shaderPaths.push_back(SHADER_COMP_PATH_HI_Z);
+        }
+        if (autoExposure.enabled) {
+            shaderPaths.push_back(SHADER_COMP_PATH_AUTO_EXPOSURE);
+        }
+        if (bloom.enabled) {
+            shaderPaths.push_back(SHADER_COMP_PATH_BLOOM_BRIGHT);
+            shaderPaths.push_back(SHADER_COMP_PATH_BLOOM_DOWN);
+            shaderPaths.push_back(SHADER_COMP_PATH_BLOOM_UP);
+        }
+        if (settings.depthPrepass) {
+            shaderPaths.push_back(SHADER_VERT_PATH_0_DEPTH);
+        }
+        if (shadow.enabled) {
+            shaderPaths.push_back(SHADER_VERT_PATH_0_SHADOW);
+        }
+        if (occlusion.enabled) {
+            shaderPaths.push_back(SHADER_VERT_PATH_OCCLUSION_PROXY);
+        }
+        if (oit.enabled) {
+            shaderPaths.push_back(SHADER_FRAG_PATH_1_OIT);
+            shaderPaths.push_back(SHADER_FRAG_PATH_OIT_RESOLVE);
+        }
+        if (deferred.enabled) {
+            shaderPaths.push_back(SHADER_VERT_PATH_LIGHTING);
+            shaderPaths.push_back(SHADER_FRAG_PATH_LIGHTING);
+        }
+        if (multiview.enabled) {
+            shaderPaths.push_back(SHADER_VERT_PATH_0_MULTIVIEW);
+            shaderPaths.push_back(shadow.enabled ? SHADER_FRAG_PATH_0_SHADOWS_MULTIVIEW : SHADER_FRAG_PATH_0_MULTIVIEW);
+            shaderPaths.push_back(SHADER_VERT_PATH_1_MULTIVIEW);
+            shaderPaths.push_back(oit.enabled ? SHADER_FRAG_PATH_1_OIT_MULTIVIEW : SHADER_FRAG_PATH_1_MULTIVIEW);
+            shaderPaths.push_back(SHADER_VERT_PATH_2_MULTIVIEW);
+            shaderPaths.push_back(SHADER_FRAG_PATH_2_MULTIVIEW);
+            if (settings.depthPrepass) {
+                shaderPaths.push_back(SHADER_VERT_PATH_0_DEPTH_MULTIVIEW);
             }
         }
+        for (const std::string& path : shaderPaths) {
+            shaderCode[path] = readFile(path);
+        }
+        std::cout << "shader code loaded" << '\n';
+}
 
-        tinyobj::attrib_t attribSphere;
-        std::vector<tinyobj::shape_t> shapesSphere;
-        std::vector<tinyobj::material_t> materialsSphere;
-        std::string warn1, err1;
-        bool sphereObjLoaded = tinyobj::LoadObj(&attribSphere, &shapesSphere, &materialsSphere, &warn1, &err1, MODEL_PATH_1.c_str());
-        if (!sphereObjLoaded) {
-            throw std::runtime_error(warn1 + err1);
+void VulkanApp::loadObj(const std::string& path, glm::vec3 color, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        bool objLoaded = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str());
+        if (!objLoaded) {
+            throw std::runtime_error(warn + err);
         }
-        std::cout << "sphere.obj loaded" << '\n';
-        for (const auto& shape : shapesSphere) {
+        std::cout << path << " loaded" << '\n';
+        // for every triangle
+        for (const auto& shape : shapes) {
             int ind = 0;
             // for every unique vertex/index
             for (const auto& index : shape.mesh.indices) {
                 Vertex vertex{};
 
                 // access attrib_t.vertices float array:
-                float posx = attribSphere.vertices[3 * index.vertex_index + 0];
-                float posy = attribSphere.vertices[3 * index.vertex_index + 1];
-                float posz = attribSphere.vertices[3 * index.vertex_index + 2];
+                float posx = attrib.vertices[3 * index.vertex_index + 0];
+                float posy = attrib.vertices[3 * index.vertex_index + 1];
+                float posz = attrib.vertices[3 * index.vertex_index + 2];
                 vertex.pos = glm::vec3(posx, posy, posz);
 
-                float uvx = attribSphere.texcoords[2 * index.texcoord_index + 0];
-                float uvy = attribSphere.texcoords[2 * index.texcoord_index + 1];
+                float uvx = attrib.texcoords[2 * index.texcoord_index + 0];
+                float uvy = attrib.texcoords[2 * index.texcoord_index + 1];
                 vertex.uv = glm::vec2(uvx, uvy);
 
-                float normalx = attribSphere.normals[3 * index.normal_index + 0];
-                float normaly = attribSphere.normals[3 * index.normal_index + 1];
-                float normalz = attribSphere.normals[3 * index.normal_index + 2];
+                float normalx = attrib.normals[3 * index.normal_index + 0];
+                float normaly = attrib.normals[3 * index.normal_index + 1];
+                float normalz = attrib.normals[3 * index.normal_index + 2];
                 vertex.normal = glm::vec3(normalx, normaly, normalz);
 
-                vertex.color = glm::vec3(0.0f, 0.0f, 1.0f);
-                verticesFX.push_back(vertex);
-                indicesFX.push_back(ind);
+                vertex.color = color;
+                vertices.push_back(vertex);
+                indices.push_back(ind);
                 ind += 1;
             }
         }
+}
 
-        tinyobj::attrib_t attribCube;
-        std::vector<tinyobj::shape_t> shapesCube;
-        std::vector<tinyobj::material_t> materialsCube;
-        std::string warn2, err2;
-        bool cubeObjLoaded = tinyobj::LoadObj(&attribCube, &shapesCube, &materialsCube, &warn2, &err2, MODEL_PATH_2.c_str());
-        if (!cubeObjLoaded) {
-            throw std::runtime_error(warn2 + err2);
-        }
-        std::cout << "cube.obj loaded" << '\n';
-        for (const auto& shape : shapesCube) {
-            int ind = 0;
-            // for every unique vertex/index
-            for (const auto& index : shape.mesh.indices) {
-                Vertex vertex{};
-
-                // access attrib_t.vertices float array:
-                float posx = attribCube.vertices[3 * index.vertex_index + 0];
-                float posy = attribCube.vertices[3 * index.vertex_index + 1];
-                float posz = attribCube.vertices[3 * index.vertex_index + 2];
-                vertex.pos = glm::vec3(posx, posy, posz);
-
-                float uvx = attribCube.texcoords[2 * index.texcoord_index + 0];
-                float uvy = attribCube.texcoords[2 * index.texcoord_index + 1];
-                vertex.uv = glm::vec2(uvx, uvy);
-
-                float normalx = attribCube.normals[3 * index.normal_index + 0];
-                float normaly = attribCube.normals[3 * index.normal_index + 1];
-                float normalz = attribCube.normals[3 * index.normal_index + 2];
-                vertex.normal = glm::vec3(normalx, normaly, normalz);
+void VulkanApp::initVulkan() {
+        /* Startup as a task graph, executed on a work-stealing job system.
+        -> device chain: instance -> surface -> physical device -> logical device -> swapchain
+        -> file loading (objs, texture decode, SPIR-V) has no device dependency, and overlaps the device chain
+        -> pipelines only depend on render pass, set layouts and shader code, and are created in parallel
+        -> everything using graphicsCommandPool or graphicsQueue (texture upload, vertex/index buffer copies, command buffer allocation)
+           is chained, since pool and queue must be externally synchronized
+        -> window-system calls (surface, swapchain extent) stay on the main thread
+        */
+        TaskGraph startup;
+        typedef TaskGraph::TaskID TaskID;
 
-                vertex.color = glm::vec3(0.0f, 0.0f, 1.0f);
-                verticesDecal.push_back(vertex);
-                indicesDecal.push_back(ind);
-                ind += 1;
+        TaskID instanceTask = startup.addTask("createInstance", [this] {
+            createInstance();
+            if (enableExtensionLayers) {
+                loadExtensionFunctions();
             }
+        });
+        TaskID debugMessengerTask = startup.addTask("setupDebugMessenger", [this] { setupDebugMessenger(); }, { instanceTask });
+        TaskID surfaceTask = startup.addMainThreadTask("createSurface", [this] { createSurface(); }, { instanceTask });
+        TaskID physicalDeviceTask = startup.addTask("pickPhysicalDevice", [this] { pickPhysicalDevice(); }, { surfaceTask, debugMessengerTask });
+        TaskID deviceTask = startup.addTask("createLogicalDeviceAndQueues", [this] { createLogicalDeviceAndQueues(); }, { physicalDeviceTask });
+        TaskID swapChainTask = startup.addMainThreadTask("createSwapChain", [this] { createSwapChain(); }, { deviceTask });
+        TaskID commandPoolTask = startup.addTask("createGraphicsCommandPool", [this] { createGraphicsCommandPool(); }, { deviceTask });
+
+        // file loading
+        TaskID sceneObjTask = startup.addTask("loadObj scene", [this] {
+            loadObj(MODEL_PATH_0, glm::vec3(1.0f, 1.0f, 1.0f), verticesScene, indicesScene);
+            computeLocalBounds(verticesScene, shadow.sceneLocalMin, shadow.sceneLocalMax);
+        });
+        TaskID fxObjTask = startup.addTask("loadObj fx", [this] {
+            loadObj(MODEL_PATH_1, glm::vec3(0.0f, 0.0f, 1.0f), verticesFX, indicesFX);
+            computeLocalBounds(verticesFX, volumeDraws.fxLocalMin, volumeDraws.fxLocalMax);
+        });
+        TaskID decalObjTask = startup.addTask("loadObj decal", [this] {
+            loadObj(MODEL_PATH_2, glm::vec3(0.0f, 0.0f, 1.0f), verticesDecal, indicesDecal);
+            computeLocalBounds(verticesDecal, volumeDraws.decalLocalMin, volumeDraws.decalLocalMax);
+        });
+        TaskID textureDecodeTask = startup.addTask("decodeTexture", [this] { decodeTexture(); });
+        TaskID decalsTask = startup.addTask("createDecals", [this] { createDecals(); });
+        TaskID lightsTask = startup.addTask("createLights", [this] { createLights(); });
+        TaskID fxInstancesTask = startup.addTask("createFxInstances", [this] { createFxInstances(); }, { fxObjTask });
+        TaskID shaderCodeTask = startup.addTask("loadShaderCode", [this] { loadShaderCode(); });
+
+        // images (attachment usage comes from the render graph)
+        TaskID renderGraphTask = startup.addTask("declareRenderGraph", [this] { declareRenderGraph(settings.multiPass, renderGraph, separatePasses.compositionGraph); }, { swapChainTask });
+        TaskID imageResourcesTask = startup.addTask("createImageResources", [this] { createImageResources(); }, { renderGraphTask });
+        TaskID depthResourcesTask = startup.addTask("createDepthResources", [this] { createDepthResources(); }, { renderGraphTask });
+        TaskID textureUploadTask = startup.addTask("createTextureImageResources", [this] {
+            createTransferCommandBuffer();
+            createTextureImageResources();
+            submitTransferCommandBuffer();
+        }, { commandPoolTask, textureDecodeTask });
+        TaskID samplerTask = startup.addTask("createTextureSampler", [this] { createTextureSampler(); }, { deviceTask });
+
+        // render pass and pipelines
+        TaskID renderPassTask = startup.addTask("createRenderPass", [this] { createRenderPass(); }, { renderGraphTask });
+        TaskID setLayoutsTask = startup.addTask("createDescriptorSetLayouts", [this] { createDescriptorSetLayouts(); }, { deviceTask });
+        std::vector<TaskID> pipelineDependencies = { renderPassTask, setLayoutsTask, shaderCodeTask };
+        TaskID shadowResourcesTask = startup.addTask("createShadowResources", [this] { createShadowResources(); }, { deviceTask, swapChainTask });
+        TaskID scenePipelineTask = startup.addTask("createGraphicsPipelineScene", [this] { createGraphicsPipelineScene(); }, { renderPassTask, setLayoutsTask, shaderCodeTask, shadowResourcesTask });
+        // (camera matrices only: needs the swapchain extent for the aspect ratio)
+        TaskID depthReconstructionTask = startup.addTask("selectDepthReconstruction", [this] { selectDepthReconstruction(); }, { swapChainTask });
+        std::vector<TaskID> depthReconstructionPipelineDependencies = { renderPassTask, setLayoutsTask, shaderCodeTask, depthReconstructionTask };
+        TaskID fxPipelineTask = startup.addTask("createGraphicsPipelineFX", [this] { createGraphicsPipelineFX(); }, depthReconstructionPipelineDependencies);
+        TaskID decalPipelineTask = startup.addTask("createGraphicsPipelineDecal", [this] { createGraphicsPipelineDecal(); }, depthReconstructionPipelineDependencies);
+        TaskID decalTilesPipelineTask = startup.addTask("createGraphicsPipelineDecalTiles", [this] { createGraphicsPipelineDecalTiles(); }, depthReconstructionPipelineDependencies);
+        TaskID fxSortPipelineTask = startup.addTask("createComputePipelineFxSort", [this] { createComputePipelineFxSort(); }, { shaderCodeTask, setLayoutsTask, fxInstancesTask });
+        TaskID fxCullPipelineTask = startup.addTask("createComputePipelineFxCull", [this] { createComputePipelineFxCull(); }, { shaderCodeTask, setLayoutsTask, fxInstancesTask });
+        TaskID hiZPipelineTask = startup.addTask("createComputePipelineHiZ", [this] { createComputePipelineHiZ(); }, { shaderCodeTask, setLayoutsTask });
+        TaskID autoExposurePipelineTask = startup.addTask("createComputePipelineAutoExposure", [this] { createComputePipelineAutoExposure(); }, { shaderCodeTask, setLayoutsTask });
+        TaskID bloomPipelineTask = startup.addTask("createComputePipelinesBloom", [this] { createComputePipelinesBloom(); }, { shaderCodeTask, setLayoutsTask });
+        TaskID occlusionProxyPipelineTask = startup.addTask("createGraphicsPipelineOcclusionProxy", [this] { createGraphicsPipelineOcclusionProxy(); }, { renderPassTask, setLayoutsTask, shaderCodeTask, fxInstancesTask, decalObjTask });
+        TaskID compositionPipelineTask = startup.addTask("createGraphicsPipelineComposition", [this] { createGraphicsPipelineComposition(); }, pipelineDependencies);
+        TaskID oitResolvePipelineTask = startup.addTask("createGraphicsPipelineOitResolve", [this] { createGraphicsPipelineOitResolve(); }, pipelineDependencies);
+        TaskID lightingPipelineTask = startup.addTask("createGraphicsPipelineLighting", [this] { createGraphicsPipelineLighting(); }, depthReconstructionPipelineDependencies);
+        TaskID framebuffersTask = startup.addTask("createFramebuffers", [this] { createFramebuffers(); }, { renderPassTask, imageResourcesTask, depthResourcesTask });
+
+        // buffers (copies go through graphicsCommandPool/graphicsQueue: chained after the texture upload)
+        TaskID vertexBuffersTask = startup.addTask("createVertexBuffers", [this] { createVertexBuffers(); }, { textureUploadTask, sceneObjTask, fxObjTask, decalObjTask });
+        TaskID indexBuffersTask = startup.addTask("createIndexBuffers", [this] { createIndexBuffers(); }, { vertexBuffersTask });
+        TaskID uniformBuffersTask = startup.addTask("createUniformBuffers", [this] { createUniformBuffers(); }, { swapChainTask });
+        TaskID decalBuffersTask = startup.addTask("createDecalBuffers", [this] { createDecalBuffers(); }, { swapChainTask, decalsTask });
+        TaskID fxInstanceBufferTask = startup.addTask("createFxInstanceBuffer", [this] { createFxInstanceBuffer(); }, { deviceTask, fxInstancesTask });
+        TaskID fxSortBuffersTask = startup.addTask("createFxSortBuffers", [this] { createFxSortBuffers(); }, { swapChainTask, fxInstancesTask });
+        TaskID fxCullBuffersTask = startup.addTask("createFxCullBuffers", [this] { createFxCullBuffers(); }, { swapChainTask, fxInstancesTask });
+        TaskID hiZResourcesTask = startup.addTask("createHiZResources", [this] { createHiZResources(); }, { swapChainTask });
+        TaskID autoExposureResourcesTask = startup.addTask("createAutoExposureResources", [this] { createAutoExposureResources(); }, { swapChainTask });
+        TaskID bloomResourcesTask = startup.addTask("createBloomResources", [this] { createBloomResources(); }, { swapChainTask });
+        TaskID lightBuffersTask = startup.addTask("createLightBuffers", [this] { createLightBuffers(); }, { swapChainTask, lightsTask });
+        TaskID clusterBuffersTask = startup.addTask("createClusterBuffers", [this] { createClusterBuffers(); }, { swapChainTask, lightsTask });
+
+        // descriptors
+        TaskID descriptorPoolTask = startup.addTask("createDescriptorPool", [this] { createDescriptorPool(); }, { swapChainTask });
+        TaskID descriptorSetsTask = startup.addTask("createDescriptorSets", [this] { createDescriptorSets(); },
+            { descriptorPoolTask, setLayoutsTask, uniformBuffersTask, decalBuffersTask, fxInstanceBufferTask, fxSortBuffersTask, fxCullBuffersTask, hiZResourcesTask, autoExposureResourcesTask, bloomResourcesTask, lightBuffersTask, clusterBuffersTask, shadowResourcesTask, imageResourcesTask, depthResourcesTask, textureUploadTask, samplerTask });
+        TaskID queryPoolTask = startup.addTask("createTimestampQueryPool", [this] { createTimestampQueryPool(); }, { swapChainTask });
+        TaskID statisticsPoolTask = startup.addTask("createStatisticsQueryPool", [this] { createStatisticsQueryPool(); }, { swapChainTask });
+        TaskID occlusionQueriesTask = startup.addTask("createOcclusionQueries", [this] { createOcclusionQueries(); }, { swapChainTask });
+
+        startup.addTask("createGraphicsCommandBuffers", [this] { createGraphicsCommandBuffers(); },
+            { indexBuffersTask, framebuffersTask, descriptorSetsTask, scenePipelineTask, fxPipelineTask, decalPipelineTask, decalTilesPipelineTask, fxSortPipelineTask, fxCullPipelineTask, hiZPipelineTask, autoExposurePipelineTask, bloomPipelineTask, occlusionProxyPipelineTask, compositionPipelineTask, oitResolvePipelineTask, lightingPipelineTask, queryPoolTask, statisticsPoolTask, occlusionQueriesTask });
+        startup.addTask("createSyncObjects", [this] { createSyncObjects(); }, { framebuffersTask });
+
+        if (settings.serialStartup) {
+            startup.runSerial();
+        }
+        else {
+            // the main thread runs tasks too, so one worker less than hardware threads
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            JobSystem jobSystem(hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+            startup.run(jobSystem);
         }
+        startup.printReport(std::cout);
 }
 
-void VulkanApp::initVulkan() {
-        createInstance();
-        if (enableExtensionLayers) {
-            loadExtensionFunctions();
-        }
-        setupDebugMessenger();
-        createSurface();
-        pickPhysicalDevice();
-        createLogicalDeviceAndQueues();
-        createSwapChain();
-        //createTransferCommandPool();
-        createGraphicsCommandPool();
-        createTransferCommandBuffer();
-        createImageResources();
-        createDepthResources();
-        createTextureImageResources();
-        submitTransferCommandBuffer();
-        createRenderPass();
-        createDescriptorSetLayouts();
-        createGraphicsPipelineScene();
-        createGraphicsPipelineFX();
-        createGraphicsPipelineDecal();
-        createGraphicsPipelineComposition();
-        createFramebuffers();
-        createTextureSampler();
-
-        loadObjs();
-        createVertexBuffers();
-        createIndexBuffers();
-        createUniformBuffers();
-        createDescriptorPool();
-        createDescriptorSets();
-        recordCommandBuffers();
-
-        createSyncObjects();
-
-}
-
-void VulkanApp::updateUniformBuffers(uint32_t currentImage) {
+glm::mat4 VulkanApp::fitShadowFrustum(const glm::mat4& sceneModel) const {
+        // bounding sphere of the scene mesh's box, placed by the model matrix (radius scaled by its largest axis)
+        glm::vec3 center = glm::vec3(sceneModel * glm::vec4(0.5f * (shadow.sceneLocalMin + shadow.sceneLocalMax), 1.0f));
+        float scale = std::max({ glm::length(glm::vec3(sceneModel[0])), glm::length(glm::vec3(sceneModel[1])), glm::length(glm::vec3(sceneModel[2])) });
+        float radius = 0.5f * glm::length(shadow.sceneLocalMax - shadow.sceneLocalMin) * scale;
+
+        // perspective from the (point) light toward the sphere's center, with the narrowest field of view containing it
+        glm::vec3 toCenter = center - shadow.lightPosition;
+        float distance = glm::length(toCenter);
+        glm::vec3 direction = distance > 0.0f ? toCenter / distance : glm::vec3(0.0f, 0.0f, 1.0f);
+        glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::mat4 view = glm::lookAt(shadow.lightPosition, shadow.lightPosition + direction, up);
+
+        const float maxFov = glm::radians(120.0f); // light inside the sphere: only the part in front of it casts shadows
+        float fov = distance > radius ? std::min(2.0f * std::asin(radius / distance), maxFov) : maxFov;
+        float farPlane = distance + radius;
+        float nearPlane = std::max(distance - radius, farPlane * 0.001f);
+        // no y flip: the shader maps light clip space to the map's uv itself, and the map is only ever sampled
+        return glm::perspective(fov, 1.0f, nearPlane, farPlane) * view;
+}
+
+void VulkanApp::simulateFrameState(FrameState& state) {
+        // update stage: compute everything the frame needs on the CPU, without touching GPU resources
         static auto startTime = std::chrono::high_resolution_clock::now();
         auto currentTime = std::chrono::high_resolution_clock::now();
         float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
         float t = sin(time);
         t = t * 0.5 + 0.5; //[0,1]
 
-        glm::mat4 cam0View = glm::lookAt(glm::vec3(0.0f, 1.0f, -4.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        glm::mat cam0Proj = glm::perspective(glm::radians(45.0f), swapChainExtent.width / (float)swapChainExtent.height, 0.001f, 10.0f);
+        state.frameIndex = frameTimings.updatedFrames;
+        state.time = time;
 
-        UniformBufferObjectScene uboScene{};
+        // camera/global uniforms, shared by all pipelines (set 0)
+        UniformBufferObjectFrame& uboFrame = state.uboFrame;
+        glm::vec3 cam0Pos = camera.position;
+        uboFrame.view = glm::lookAt(cam0Pos, cam0Pos + camera.forward, camera.up);
+        uboFrame.proj = glm::perspective(glm::radians(camera.fovY), swapChainExtent.width / (float)swapChainExtent.height, camera.nearPlane, camera.farPlane);
+        // flip y coordinates
+        uboFrame.proj[1][1] *= -1;
+        uboFrame.viewProj = uboFrame.proj * uboFrame.view;
+        // inverses used by the fx/decal fragment shaders to reconstruct positions from depth
+        uboFrame.invViewProj = glm::inverse(uboFrame.viewProj);
+        uboFrame.invProj = glm::inverse(uboFrame.proj);
+        uboFrame.camPos = glm::vec4(cam0Pos, 1.0f);
+        uboFrame.camDir = glm::vec4(glm::normalize(camera.forward), 0.0f);
+        // analytic path: view depth = B / (depth + A), world position = camPos + viewRay * view depth
+        uboFrame.projParams = glm::vec4(uboFrame.proj[2][2], uboFrame.proj[3][2], 0.0f, 0.0f);
+        uboFrame.res = glm::vec2(swapChainExtent.width, swapChainExtent.height);
+        uboFrame.time = time;
+        uboFrame.exposure = exposure;
+        // multiview stereo: eye cameras for the render pass, uboFrame becomes the culling camera enclosing both
+        if (multiview.enabled) {
+            simulateEyeCameras(state);
+        }
+
+        // per-object uniforms
+        UniformBufferObjectScene& uboScene = state.uboScene;
         glm::mat4 trans = glm::mat4(1.0f);
         trans = glm::translate(trans, glm::vec3(0.0f, 0.0f, 0.0f));
         //trans = glm::rotate(trans, glm::radians(90.0f), glm::vec3(0.0, 0.0, 1.0));
         trans = glm::scale(trans, glm::vec3(1.0f, 1.0f, 1.0f));
         uboScene.model = trans;
-        uboScene.view = cam0View;
-        uboScene.proj = cam0Proj;
-        // flip y coordinates
-        uboScene.proj[1][1] *= -1;
+        uboScene.normalMatrix = glm::transpose(glm::inverse(uboScene.model));
 
-        // return host-accessible pointer to range of GPU memory, at given offset, for UBO's resoure address (for current swapchain image)
-        void* data0;
-        vkMapMemory(device, uniformBuffersSceneMemory[currentImage], 0, sizeof(uboScene), 0, &data0);
-        // copy "ubo" data to gpu memory (at "data" address)
-        memcpy(data0, &uboScene, sizeof(uboScene));
-        vkUnmapMemory(device, uniformBuffersSceneMemory[currentImage]);
+        // shadow map light: the frustum follows the scene's placement (recordShadowPass() compares it with the cached map's)
+        if (shadow.enabled) {
+            state.uboShadow.viewProj = fitShadowFrustum(uboScene.model);
+            state.uboShadow.position = glm::vec4(shadow.lightPosition, 1.0f);
+        }
 
-        UniformBufferObjectFX uboFX{};
+        UniformBufferObjectFX& uboFX = state.uboFX;
         trans = glm::mat4(1.0f);
         float transOffset = 0.0f + 0.5f * t;
         trans = glm::translate(trans, glm::vec3(0.0f, 0.0f, 0.0f));
@@ -3362,20 +8207,310 @@ void VulkanApp::updateUniformBuffers(uint32_t currentImage) {
         float scaleOffset = 1.0f + 0.25f * t;
         trans = glm::scale(trans, glm::vec3(scaleOffset, scaleOffset, scaleOffset));
         uboFX.model = trans;
-        uboFX.view = cam0View;
-        uboFX.proj = cam0Proj;
-        uboFX.proj[1][1] *= -1;
+        uboFX.invModel = glm::inverse(uboFX.model);
+
+        // screen-space bounds of the fx instances (world-space bounds of all of them, constant) and the decal box (placed with uboFX.model)
+        if (settings.disableVolumeBounds) {
+            state.fxBounds = fullScreenBounds();
+            state.decalBounds = fullScreenBounds();
+        }
+        else {
+            glm::mat4 modelViewProj = uboFrame.viewProj * uboFX.model;
+            state.fxBounds = projectVolumeBounds(uboFrame.viewProj, fxInstances.worldMin, fxInstances.worldMax);
+            state.decalBounds = projectVolumeBounds(modelViewProj, volumeDraws.decalLocalMin, volumeDraws.decalLocalMax);
+        }
+
+        // occlusion queries: a proxy box is only tested if it lies in front of the near plane and reaches the screen
+        // (a box the near plane cuts through loses the faces around the camera, and would report a volume covering it as hidden)
+        if (occlusion.enabled) {
+            auto proxyTestable = [](const VolumeBounds& bounds) {
+                return bounds.scissor.extent.width > 0 && bounds.scissor.extent.height > 0 && bounds.minDepth > 0.0f;
+            };
+            state.occlusionTestable[0] = proxyTestable(projectVolumeBounds(uboFrame.viewProj, fxInstances.worldMin, fxInstances.worldMax));
+            state.occlusionTestable[1] = proxyTestable(projectVolumeBounds(uboFrame.viewProj * uboFX.model, volumeDraws.decalLocalMin, volumeDraws.decalLocalMax));
+        }
+
+        // Hi-Z: the volume decal is skipped (empty scissor) if the latest read-back pyramid hides its box
+        state.occludedDecals = 0;
+        if (hiZ.enabled && settings.volumeDecals && state.decalBounds.scissor.extent.width > 0) {
+            std::lock_guard<std::mutex> lock(hiZ.snapshotMutex);
+            if (hiZ.snapshotValid && isOccludedHiZ(projectVolumeBounds(hiZ.snapshotViewProj * uboFX.model, volumeDraws.decalLocalMin, volumeDraws.decalLocalMax))) {
+                state.decalBounds.scissor.extent = { 0, 0 };
+                state.occludedDecals++;
+            }
+        }
+
+        // back-to-front order of the fx instances (compute sort: recorded into the command buffer instead, OIT: unsorted)
+        if (!settings.gpuSort) {
+            sortFxInstances(state);
+        }
+
+        // tiled decals: decal 0 is placed like the decal box
+        tiledDecals.manager.setModel(0, uboFX.model);
+        if (!settings.volumeDecals) {
+            binDecals(uboFrame.viewProj, state);
+        }
+
+        // deferred lighting: one quad per light whose bounds reach the screen
+        if (deferred.enabled) {
+            cullLights(uboFrame.viewProj, state);
+        }
+        // clustered forward shading: light lists per view-space cluster
+        if (clustered.enabled) {
+            clusterLights(uboFrame.viewProj, cam0Pos, glm::vec3(uboFrame.camDir), state);
+        }
+}
+
+void VulkanApp::sortFxInstances(FrameState& state) {
+        if (oit.enabled) {
+            // order-independent blending: instance order as draw order, nothing to sort
+            if (state.fxOrder.size() != fxInstances.instances.size()) {
+                state.fxOrder.resize(fxInstances.instances.size());
+                for (size_t f = 0; f < state.fxOrder.size(); f++) {
+                    state.fxOrder[f] = static_cast<uint32_t>(f);
+                }
+            }
+            return;
+        }
+        auto sortStart = std::chrono::high_resolution_clock::now();
+
+        // view depth of each instance's animated center (fxInstanceCenter() in fxInstance.glsl), keys inverted: descending depth
+        glm::vec3 camPos = glm::vec3(state.uboFrame.camPos);
+        glm::vec3 camDir = glm::vec3(state.uboFrame.camDir);
+        size_t count = fxInstances.instances.size();
+        fxSort.keys.resize(count);
+        state.fxOrder.resize(count);
+        for (size_t f = 0; f < count; f++) {
+            const FxInstanceData& instance = fxInstances.instances[f];
+            float wave = std::sin(instance.animation.y * state.time + instance.animation.z);
+            glm::vec3 center = glm::vec3(instance.positionScale) + glm::vec3(0.0f, 0.0f, instance.animation.w * wave);
+            fxSort.keys[f] = ~RadixSort::floatKey(glm::dot(center - camPos, camDir));
+            state.fxOrder[f] = static_cast<uint32_t>(f);
+        }
+        fxSort.sorter.sort(fxSort.keys, state.fxOrder);
+
+        fxSort.cpuSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - sortStart).count();
+        fxSort.cpuFrames++;
+}
+
+void VulkanApp::binDecals(const glm::mat4& viewProj, FrameState& state) {
+        const DecalManager& manager = tiledDecals.manager;
+        state.decalRects.resize(manager.getDecalCount());
+        // Hi-Z: decals hidden by the latest read-back pyramid get an empty rectangle (not binned), tested with the pyramid's camera
+        std::unique_lock<std::mutex> hiZLock(hiZ.snapshotMutex, std::defer_lock);
+        if (hiZ.enabled) {
+            hiZLock.lock();
+        }
+        bool hiZTest = hiZ.enabled && hiZ.snapshotValid;
+        for (uint32_t d = 0; d < manager.getDecalCount(); d++) {
+            const glm::mat4& model = manager.getDecal(d).model;
+            glm::mat4 modelViewProj = viewProj * model;
+            state.decalRects[d] = projectVolumeBounds(modelViewProj, volumeDraws.decalLocalMin, volumeDraws.decalLocalMax).scissor;
+            if (hiZTest && state.decalRects[d].extent.width > 0
+                && isOccludedHiZ(projectVolumeBounds(hiZ.snapshotViewProj * model, volumeDraws.decalLocalMin, volumeDraws.decalLocalMax))) {
+                state.decalRects[d] = VkRect2D{};
+                state.occludedDecals++;
+            }
+        }
+        if (hiZLock.owns_lock()) {
+            hiZLock.unlock();
+        }
+        manager.binDecals(state.decalRects, swapChainExtent, state.decalBins);
+}
+
+void VulkanApp::cullLights(const glm::mat4& viewProj, FrameState& state) {
+        // (the vector keeps its capacity between frames: no allocations once the frame-state slots are warm)
+        state.visibleLights.clear();
+        for (const LightGpuData& light : lights) {
+            VkRect2D rect = fullScreenBounds().scissor;
+            if (light.positionRadius.w > 0.0f && !settings.disableVolumeBounds) {
+                rect = projectLightBounds(viewProj, light);
+                if (rect.extent.width == 0 || rect.extent.height == 0) {
+                    continue; // behind the camera or off screen
+                }
+            }
+            LightGpuData visible = light;
+            visible.screenRect = glm::vec4(rect.offset.x, rect.offset.y, rect.offset.x + rect.extent.width, rect.offset.y + rect.extent.height);
+            state.visibleLights.push_back(visible);
+        }
+}
+
+VkRect2D VulkanApp::projectLightBounds(const glm::mat4& viewProj, const LightGpuData& light) const {
+        // the cube around the light's sphere of influence
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(light.positionRadius));
+        model = glm::scale(model, glm::vec3(light.positionRadius.w));
+        return projectVolumeBounds(viewProj * model, glm::vec3(-1.0f), glm::vec3(1.0f)).scissor;
+}
+
+void VulkanApp::clusterLights(const glm::mat4& viewProj, const glm::vec3& camPos, const glm::vec3& camDir, FrameState& state) {
+        auto clusterStart = std::chrono::high_resolution_clock::now();
+
+        // light 0 (global) shades every fragment outside of the cluster lists: left unassigned (empty rectangle)
+        clustered.bounds.resize(lights.size());
+        for (size_t l = 0; l < lights.size(); l++) {
+            const LightGpuData& light = lights[l];
+            LightClusterBounds& bounds = clustered.bounds[l];
+            bounds.screenRect = VkRect2D{};
+            float radius = light.positionRadius.w;
+            if (radius <= 0.0f) {
+                continue;
+            }
+            bounds.screenRect = settings.disableVolumeBounds ? fullScreenBounds().scissor : projectLightBounds(viewProj, light);
+            float viewDepth = glm::dot(glm::vec3(light.positionRadius) - camPos, camDir);
+            bounds.minDepth = viewDepth - radius;
+            bounds.maxDepth = viewDepth + radius;
+        }
+        LightClusters::assignLights(clustered.bounds, swapChainExtent, state.lightClusters);
+
+        clustered.cpuSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - clusterStart).count();
+        clustered.lightEntries += state.lightClusters.lightIndices.size();
+        clustered.frames++;
+}
 
-        uboFX.res = glm::vec2(WIDTH, HEIGHT);
+void VulkanApp::updateCamera() {
+        // camera input is polled on the main thread (GLFW), before the frame state is simulated
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        float deltaSeconds = std::chrono::duration<float>(currentTime - camera.lastUpdateTime).count();
+        camera.lastUpdateTime = currentTime;
+
+        glm::vec3 forward = glm::normalize(camera.forward);
+        glm::vec3 right = glm::normalize(glm::cross(forward, camera.up));
+        glm::vec3 move = glm::vec3(0.0f);
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) move += forward;
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) move -= forward;
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) move += right;
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) move -= right;
+        if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) move += camera.up;
+        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) move -= camera.up;
+        if (glm::length(move) > 0.0f) {
+            camera.position += glm::normalize(move) * camera.speed * deltaSeconds;
+        }
+}
+
+void VulkanApp::simulateEyeCameras(FrameState& state) const {
+        // parallel eye cameras: the camera moved by half the eye separation along its right direction, same projection
+        // (no vertical parallax, the convergence is left to the display)
+        UniformBufferObjectFrame& uboFrame = state.uboFrame;
+        const glm::vec3 camPos = glm::vec3(uboFrame.camPos);
+        const glm::vec3 forward = glm::vec3(uboFrame.camDir);
+        const glm::vec3 right = glm::normalize(glm::cross(forward, camera.up));
+        for (uint32_t eye = 0; eye < multiview.viewCount; eye++) {
+            UniformBufferObjectFrame& uboEye = state.uboViews[eye];
+            uboEye = uboFrame;
+            glm::vec3 eyePos = camPos + right * ((eye == 0 ? -0.5f : 0.5f) * multiview.eyeSeparation);
+            uboEye.view = glm::lookAt(eyePos, eyePos + forward, camera.up);
+            uboEye.viewProj = uboEye.proj * uboEye.view;
+            uboEye.invViewProj = glm::inverse(uboEye.viewProj);
+            uboEye.camPos = glm::vec4(eyePos, 1.0f);
+        }
+
+        // culling camera (fx/decal bounds, sort, GPU culling, light culling): pulled back along the view direction until its
+        // side planes enclose both eye frusta (half the separation / tan(fovX/2), proj[0][0] = 1 / tan(fovX/2)),
+        // far plane moved out by the same distance
+        const float pullBack = 0.5f * multiview.eyeSeparation * uboFrame.proj[0][0];
+        const glm::vec3 cullPos = camPos - forward * pullBack;
+        uboFrame.proj = glm::perspective(glm::radians(camera.fovY), uboFrame.res.x / uboFrame.res.y, camera.nearPlane, camera.farPlane + pullBack);
+        // flip y coordinates
+        uboFrame.proj[1][1] *= -1;
+        uboFrame.view = glm::lookAt(cullPos, cullPos + forward, camera.up);
+        uboFrame.viewProj = uboFrame.proj * uboFrame.view;
+        uboFrame.invViewProj = glm::inverse(uboFrame.viewProj);
+        uboFrame.invProj = glm::inverse(uboFrame.proj);
+        uboFrame.camPos = glm::vec4(cullPos, 1.0f);
+        uboFrame.projParams = glm::vec4(uboFrame.proj[2][2], uboFrame.proj[3][2], 0.0f, 0.0f);
+}
+
+void VulkanApp::uploadFrameState(const FrameState& state, uint32_t currentImage) {
+        // return host-accessible pointer to range of GPU memory, at given offset, for UBO's resoure address (for current swapchain image)
+        void* dataFrame;
+        vkMapMemory(device, uniformBuffersFrameMemory[currentImage], 0, frameUniformSize(), 0, &dataFrame);
+        UniformBufferObjectFrame uboFrame = state.uboFrame;
+        if (autoExposure.enabled) {
+            uboFrame.exposure = autoExposure.exposure; // latest read-back (render stage state, not part of the frame state)
+        }
+        memcpy(dataFrame, &uboFrame, sizeof(uboFrame));
+        if (multiview.enabled) {
+            memcpy(static_cast<char*>(dataFrame) + sizeof(state.uboFrame), state.uboViews.data(), sizeof(state.uboViews));
+        }
+        vkUnmapMemory(device, uniformBuffersFrameMemory[currentImage]);
+
+        void* data0;
+        vkMapMemory(device, uniformBuffersSceneMemory[currentImage], 0, sizeof(state.uboScene), 0, &data0);
+        // copy "ubo" data to gpu memory (at "data" address)
+        memcpy(data0, &state.uboScene, sizeof(state.uboScene));
+        vkUnmapMemory(device, uniformBuffersSceneMemory[currentImage]);
 
         void* data1;
-        vkMapMemory(device, uniformBuffersFXMemory[currentImage], 0, sizeof(uboFX), 0, &data1);
+        vkMapMemory(device, uniformBuffersFXMemory[currentImage], 0, sizeof(state.uboFX), 0, &data1);
         // copy "ubo" data to gpu memory (at "data" address)
-        memcpy(data1, &uboFX, sizeof(uboFX));
+        memcpy(data1, &state.uboFX, sizeof(state.uboFX));
         vkUnmapMemory(device, uniformBuffersFXMemory[currentImage]);
 
+        if (shadow.enabled) {
+            void* dataShadow;
+            vkMapMemory(device, shadow.uniformMemory[currentImage], 0, sizeof(state.uboShadow), 0, &dataShadow);
+            memcpy(dataShadow, &state.uboShadow, sizeof(state.uboShadow));
+            vkUnmapMemory(device, shadow.uniformMemory[currentImage]);
+        }
 
-    }
+        if (!settings.gpuSort) {
+            void* dataOrder;
+            vkMapMemory(device, fxSort.memory[currentImage], 0, VK_WHOLE_SIZE, 0, &dataOrder);
+            memcpy(dataOrder, state.fxOrder.data(), state.fxOrder.size() * sizeof(uint32_t));
+            vkUnmapMemory(device, fxSort.memory[currentImage]);
+        }
+
+        if (!settings.volumeDecals) {
+            // tiled decals: the 4 ranges of the decal storage buffer
+            const DecalBins& bins = state.decalBins;
+            const void* sources[] = { bins.decals.data(), bins.tileRanges.data(), bins.decalIndices.data(), bins.activeTiles.data() };
+            VkDeviceSize sizes[] = {
+                bins.decals.size() * sizeof(DecalGpuData),
+                bins.tileRanges.size() * sizeof(glm::uvec2),
+                bins.decalIndices.size() * sizeof(uint32_t),
+                bins.activeTiles.size() * sizeof(uint32_t)
+            };
+            char* dataDecals;
+            vkMapMemory(device, tiledDecals.memory[currentImage], 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&dataDecals));
+            for (size_t range = 0; range < tiledDecals.offsets.size(); range++) {
+                if (sizes[range] == 0) {
+                    continue;
+                }
+                memcpy(dataDecals + tiledDecals.offsets[range], sources[range], static_cast<size_t>(sizes[range]));
+            }
+            vkUnmapMemory(device, tiledDecals.memory[currentImage]);
+
+            tiledDecals.activeTiles += bins.activeTiles.size();
+            tiledDecals.tileEntries += bins.decalIndices.size();
+            tiledDecals.frames++;
+        }
+        if (hiZ.enabled) {
+            hiZ.decalsOccluded += state.occludedDecals;
+            hiZ.decalFrames++;
+        }
+
+        if (deferred.enabled && !state.visibleLights.empty()) {
+            void* dataLights;
+            vkMapMemory(device, deferred.lightMemory[currentImage], 0, VK_WHOLE_SIZE, 0, &dataLights);
+            memcpy(dataLights, state.visibleLights.data(), state.visibleLights.size() * sizeof(LightGpuData));
+            vkUnmapMemory(device, deferred.lightMemory[currentImage]);
+
+            deferred.visibleLights += state.visibleLights.size();
+            deferred.frames++;
+        }
+
+        if (clustered.enabled) {
+            // cluster ranges, then the light lists
+            const LightClusterGrid& grid = state.lightClusters;
+            char* dataClusters;
+            vkMapMemory(device, clustered.memory[currentImage], 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&dataClusters));
+            memcpy(dataClusters, grid.clusterRanges.data(), grid.clusterRanges.size() * sizeof(glm::uvec2));
+            if (!grid.lightIndices.empty()) {
+                memcpy(dataClusters + clustered.indicesOffset, grid.lightIndices.data(), grid.lightIndices.size() * sizeof(uint32_t));
+            }
+            vkUnmapMemory(device, clustered.memory[currentImage]);
+        }
+}
 
 void VulkanApp::checkFenceStatus() {
         while (blocked == true) {
@@ -3384,10 +8519,10 @@ void VulkanApp::checkFenceStatus() {
         }
     }
 
-void VulkanApp::drawFrame() {
+void VulkanApp::drawFrame(const FrameState& state) {
 
-        std::cout << "drawing frame..... " << '\n';
-        std::cout << "target frame " << std::to_string(frameID) << '\n';
+        // (no per-frame console output: this runs inside the loop the --benchmark frame timings measure)
+        auto frameStartTime = std::chrono::high_resolution_clock::now();
 
         // block until the frame's cmd buffer exectuion fence signals
             // note: fences created in already "signaled" state, to avoid initial block
@@ -3397,18 +8532,25 @@ void VulkanApp::drawFrame() {
         // fetch next available swapchain image ID, and signal imageAvailableSemaphore[frameID]
         // --------------------------------------------------------------------
         vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphore[frameID], VK_NULL_HANDLE, &swapImageID);
-        std::cout << "target swapchain image " << std::to_string(swapImageID) << '\n';
 
         // block until swapchainiImageFence[swapImageID] signals ( when previously subtmitted cmd buffer finished rendering to this swapchain image )
             // note: swapchain-image fences initialize as null handle, to avoid initial block
         if (swapchainImageFence[swapImageID] != VK_NULL_HANDLE) {
             vkWaitForFences(device, 1, &swapchainImageFence[swapImageID], VK_TRUE, UINT64_MAX);
+            // the previous submission of this image's command buffer finished: its timestamps/statistics are available
+            readGpuTimestamps(swapImageID);
+            readVolumeStatistics(swapImageID);
+            readHiZResults(swapImageID);
+            readOcclusionResults(swapImageID);
+            readAutoExposure(swapImageID);
         }
+        auto unblockedTime = std::chrono::high_resolution_clock::now();
 	
 	// swapchainImageFence[swapImageID] will signal when this frame's command buffer finishes executing
         swapchainImageFence[swapImageID] = cmdbuffersExecutionFence[frameID]; 
 
-        updateUniformBuffers(swapImageID);
+        uploadFrameState(state, swapImageID);
+        recordCommandBuffer(swapImageID, state);
 
 
         // Submit commandbuffers to queue:
@@ -3434,9 +8576,19 @@ void VulkanApp::drawFrame() {
         submitInfo.pCommandBuffers = &graphicsCommandBuffer[swapImageID];
 
         // specify semaphore(s) to signal when cmd buffer finishes execution (in order to safely present)
-        VkSemaphore signalSemaphores[] = { renderingFinishedSemaphore[frameID] };
-        submitInfo.signalSemaphoreCount = 1;
+        // async auto exposure: also the graphics timeline, at this frame's value (its luminance copy is written)
+        uint64_t frameValue = autoExposure.async ? ++autoExposure.submittedFrames : 0;
+        VkSemaphore signalSemaphores[] = { renderingFinishedSemaphore[frameID], autoExposure.graphicsTimeline };
+        uint64_t signalValues[] = { 0, frameValue }; // (ignored for the binary semaphore)
+        submitInfo.signalSemaphoreCount = autoExposure.async ? 2 : 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
+        VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+        timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineSubmitInfo.signalSemaphoreValueCount = 2;
+        timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+        if (autoExposure.async) {
+            submitInfo.pNext = &timelineSubmitInfo;
+        }
 
         // unsignal frame's fence
         vkResetFences(device, 1, &cmdbuffersExecutionFence[frameID]);
@@ -3448,8 +8600,11 @@ void VulkanApp::drawFrame() {
         if (commandBufferSubmitted_GraphicsQueue != VK_SUCCESS) {
             throw std::runtime_error("failed to submit command buffer to graphics queue");
         }
-        std::cout << "submitted command buffer to graphics queue" << '\n';
-        std::cout << "fence: cmdbufferExecFence " << std::to_string(frameID) << " will signal when execution is done" << '\n';
+
+        // async auto exposure: the dispatch on the compute queue, behind this frame's copy
+        if (autoExposure.async) {
+            submitAutoExposure(swapImageID, frameValue);
+        }
 
 
         // Present swapchain image 
@@ -3474,21 +8629,400 @@ void VulkanApp::drawFrame() {
             throw std::runtime_error("failed to present swapchain image to window surface");
         }
 
-        std::cout << "presented swapchain image to window sufface (swapchain-image " << std::to_string(swapImageID) << ")" << '\n';
         // loop current frame id (currrentFrame = 0, 1)
         frameID = (frameID + 1) % MAX_FRAMES_IN_FLIGHT;
+
+        // render stage timings (only touched by the thread calling drawFrame)
+        auto frameEndTime = std::chrono::high_resolution_clock::now();
+        frameTimings.renderSeconds += std::chrono::duration<double>(frameEndTime - frameStartTime).count();
+        frameTimings.renderBlockedSeconds += std::chrono::duration<double>(unblockedTime - frameStartTime).count();
+        double frameEndSeconds = std::chrono::duration<double>(frameEndTime.time_since_epoch()).count();
+        if (renderedFrames == 0) {
+            frameTimings.firstFrameTime = frameEndSeconds;
+        }
+        frameTimings.lastFrameTime = frameEndSeconds;
+        renderedFrames++;
     }
 
-void VulkanApp::mainLoop() {
-        while (!glfwWindowShouldClose(window)) {
-            drawFrame();
+bool VulkanApp::benchmarkFinished() {
+        return settings.benchmarkFrames > 0 && renderedFrames >= settings.benchmarkFrames;
+}
+
+void VulkanApp::mainLoopSerial() {
+        // update and render-submission stages run back-to-back on the main thread
+        FrameState state{};
+        while (!glfwWindowShouldClose(window) && !benchmarkFinished()) {
+            auto updateStartTime = std::chrono::high_resolution_clock::now();
+            glfwPollEvents();
+            updateCamera();
+            simulateFrameState(state);
+            frameTimings.updateSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - updateStartTime).count();
+            frameTimings.updatedFrames++;
+
+            drawFrame(state);
+        }
+}
+
+void VulkanApp::publishFrameState() {
+        // hand the freshly written snapshot to the render stage.
+        // block until the render stage took the previous snapshot, so the update stage runs at most one frame ahead.
+        std::unique_lock<std::mutex> lock(frameStates.mutex);
+        frameStates.stateConsumedCondition.wait(lock, [this] { return !frameStates.stateReady || frameStates.stop; });
+        std::swap(frameStates.writeSlot, frameStates.readySlot);
+        frameStates.stateReady = true;
+        lock.unlock();
+        frameStates.stateReadyCondition.notify_one();
+}
+
+void VulkanApp::renderLoop() {
+        // render-submission stage: take the latest snapshot, upload it, submit and present
+        try {
+            while (true) {
+                std::unique_lock<std::mutex> lock(frameStates.mutex);
+                frameStates.stateReadyCondition.wait(lock, [this] { return frameStates.stateReady || frameStates.stop; });
+                if (frameStates.stop) {
+                    break;
+                }
+                std::swap(frameStates.readSlot, frameStates.readySlot);
+                frameStates.stateReady = false;
+                lock.unlock();
+                frameStates.stateConsumedCondition.notify_one();
+
+                drawFrame(frameStates.slots[frameStates.readSlot]);
+            }
+        }
+        catch (...) {
+            renderThreadException = std::current_exception();
+            std::lock_guard<std::mutex> lock(frameStates.mutex);
+            frameStates.stop = true;
+            frameStates.stateConsumedCondition.notify_one();
+        }
+}
+
+void VulkanApp::mainLoopPipelined() {
+        // update stage stays on the main thread (GLFW event polling must happen on the main thread),
+        // render-submission stage runs on its own thread. All per-frame Vulkan calls are made by the render thread.
+        renderThread = std::thread(&VulkanApp::renderLoop, this);
+
+        while (!glfwWindowShouldClose(window) && !benchmarkFinished()) {
+            auto updateStartTime = std::chrono::high_resolution_clock::now();
             glfwPollEvents();
+            updateCamera();
+            simulateFrameState(frameStates.slots[frameStates.writeSlot]);
+            frameTimings.updateSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - updateStartTime).count();
+            frameTimings.updatedFrames++;
+
+            publishFrameState();
+            std::lock_guard<std::mutex> lock(frameStates.mutex);
+            if (frameStates.stop) {
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(frameStates.mutex);
+            frameStates.stop = true;
+        }
+        frameStates.stateReadyCondition.notify_one();
+        renderThread.join();
+
+        if (renderThreadException) {
+            vkDeviceWaitIdle(device);
+            std::rethrow_exception(renderThreadException);
+        }
+}
+
+void VulkanApp::mainLoop() {
+        if (settings.pipelinedFrames) {
+            mainLoopPipelined();
+        }
+        else {
+            mainLoopSerial();
         }
 
         // block until device finishes work (avoid exiting loop/application while device is executing work asynchronously)
         vkDeviceWaitIdle(device);
+
+        if (settings.benchmarkFrames > 0) {
+            printFrameTimings();
+        }
     }
 
+void VulkanApp::readGpuTimestamps(uint32_t swapImageID) {
+        if (gpuTimings.queryPool == VK_NULL_HANDLE) {
+            return;
+        }
+        uint64_t timestamps[4] = { 0, 0, 0, 0 };
+        VkResult resultsRead = vkGetQueryPoolResults(device, gpuTimings.queryPool, swapImageID * 4, 4, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (resultsRead != VK_SUCCESS) {
+            return; // VK_NOT_READY: skip this frame
+        }
+        gpuTimings.gpuSeconds += (timestamps[3] - timestamps[0]) * gpuTimings.timestampPeriod * 1e-9;
+        gpuTimings.sortSeconds += (timestamps[1] - timestamps[0]) * gpuTimings.timestampPeriod * 1e-9;
+        gpuTimings.hiZSeconds += (timestamps[3] - timestamps[2]) * gpuTimings.timestampPeriod * 1e-9;
+        gpuTimings.gpuFrames++;
+
+        // bloom chain (same command buffer, same fence)
+        if (bloom.queryPool != VK_NULL_HANDLE) {
+            uint64_t bloomTimestamps[2] = { 0, 0 };
+            VkResult bloomResultsRead = vkGetQueryPoolResults(device, bloom.queryPool, swapImageID * 2, 2, sizeof(bloomTimestamps), bloomTimestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (bloomResultsRead == VK_SUCCESS) {
+                bloom.gpuSeconds += (bloomTimestamps[1] - bloomTimestamps[0]) * gpuTimings.timestampPeriod * 1e-9;
+                bloom.gpuFrames++;
+            }
+        }
+}
+
+void VulkanApp::readVolumeStatistics(uint32_t swapImageID) {
+        if (volumeDraws.statisticsPool == VK_NULL_HANDLE) {
+            return;
+        }
+        uint64_t invocations[3] = { 0, 0, 0 };
+        VkResult resultsRead = vkGetQueryPoolResults(device, volumeDraws.statisticsPool, swapImageID * 3, 3, sizeof(invocations), invocations, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (resultsRead != VK_SUCCESS) {
+            return; // VK_NOT_READY: skip this frame
+        }
+        volumeDraws.fxInvocations += invocations[0];
+        volumeDraws.decalInvocations += invocations[1];
+        volumeDraws.sceneInvocations += invocations[2];
+        volumeDraws.frames++;
+}
+
+void VulkanApp::readHiZResults(uint32_t swapImageID) {
+        if (!hiZ.enabled || !hiZ.readbackPending[swapImageID]) {
+            return;
+        }
+        hiZ.readbackPending[swapImageID] = false;
+        const char* data = static_cast<const char*>(hiZ.readbackMapped[swapImageID]);
+
+        // fx cull dispatch: instances outside the frustum, instances inside it but hidden by the pyramid
+        uint32_t counts[2] = { 0, 0 };
+        memcpy(counts, data + hiZ.statisticsOffset, sizeof(counts));
+        hiZ.fxFrustumCulled += counts[0];
+        hiZ.fxOccluded += counts[1];
+        hiZ.fxFrames++;
+
+        // read-back level -> snapshot for the update stage's decal tests
+        const VkExtent2D& extent = hiZ.extents[hiZ.readbackLevel];
+        std::lock_guard<std::mutex> lock(hiZ.snapshotMutex);
+        hiZ.snapshotDepths.resize(static_cast<size_t>(extent.width) * extent.height);
+        memcpy(hiZ.snapshotDepths.data(), data, hiZ.snapshotDepths.size() * sizeof(float));
+        hiZ.snapshotViewProj = hiZ.readbackViewProj[swapImageID];
+        hiZ.snapshotValid = true;
+}
+
+void VulkanApp::readOcclusionResults(uint32_t swapImageID) {
+        if (!occlusion.enabled) {
+            return;
+        }
+        // samples of each proxy the image's previous command buffer tested (CPU readback: the draws of the next recorded frames
+        // follow these results, the most recent ones the fences allow; conditional rendering only counts them for the report)
+        for (uint32_t proxy = 0; proxy < 2; proxy++) {
+            if (!occlusion.tested[swapImageID][proxy]) {
+                occlusion.hidden[proxy] = false;
+                continue;
+            }
+            uint64_t samples = 0;
+            VkResult resultRead = vkGetQueryPoolResults(device, occlusion.queryPool, swapImageID * 2 + proxy, 1, sizeof(samples), &samples, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (resultRead != VK_SUCCESS) {
+                continue; // VK_NOT_READY: keep the previous result
+            }
+            occlusion.hidden[proxy] = (samples == 0);
+            occlusion.testedFrames[proxy]++;
+            if (samples == 0) {
+                occlusion.hiddenFrames[proxy]++;
+            }
+        }
+}
+
+void VulkanApp::readAutoExposure(uint32_t swapImageID) {
+        if (!autoExposure.enabled || autoExposure.pendingFrames[swapImageID] == 0) {
+            return;
+        }
+        // async: the dispatch behind the image's previous frame (submitted frames ago, normally long finished)
+        if (autoExposure.async) {
+            VkSemaphoreWaitInfo waitInfo{};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &autoExposure.computeTimeline;
+            waitInfo.pValues = &autoExposure.pendingFrames[swapImageID];
+            vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+        }
+        autoExposure.pendingFrames[swapImageID] = 0;
+
+        const float* result = static_cast<const float*>(autoExposure.resultMapped[swapImageID]);
+        autoExposure.meanLogLuminance = result[0];
+        autoExposure.exposure = result[1];
+        autoExposure.readbacks++;
+
+        if (autoExposure.queryPool != VK_NULL_HANDLE) {
+            std::array<uint64_t, 2> timestamps{};
+            VkResult resultRead = vkGetQueryPoolResults(device, autoExposure.queryPool, swapImageID * 2, 2, sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (resultRead == VK_SUCCESS) {
+                autoExposure.dispatchSeconds += static_cast<double>(timestamps[1] - timestamps[0]) * autoExposure.timestampPeriod * 1e-9;
+                autoExposure.timedDispatches++;
+            }
+        }
+}
+
+void VulkanApp::printFrameTimings() {
+        uint64_t frames = renderedFrames;
+        if (frames < 2 || frameTimings.updatedFrames == 0) {
+            return;
+        }
+        double toMs = 1000.0;
+        double update = frameTimings.updateSeconds / frameTimings.updatedFrames * toMs;
+        double render = frameTimings.renderSeconds / frames * toMs;
+        double renderBlocked = frameTimings.renderBlockedSeconds / frames * toMs;
+        double renderBusy = render - renderBlocked;
+        double interval = (frameTimings.lastFrameTime - frameTimings.firstFrameTime) / (frames - 1) * toMs;
+        // serial: both stages sit on the same thread; pipelined: the slower stage bounds the frame
+        double criticalPath = settings.pipelinedFrames ? std::max(update, renderBusy) : update + renderBusy;
+
+        std::cout << '\n' << "frame timings (" << (settings.pipelinedFrames ? "pipelined" : "serial") << ", " << std::to_string(frames) << " frames):" << '\n';
+        std::cout << "  update stage (poll + simulate):   " << update << " ms" << '\n';
+        std::cout << "  render stage (upload + submit):   " << renderBusy << " ms busy, " << renderBlocked << " ms blocked on fences/acquire" << '\n';
+        std::cout << "  cpu critical path per frame:      " << criticalPath << " ms" << '\n';
+        std::cout << "  frame interval:                   " << interval << " ms" << '\n';
+        std::cout << "  cpu headroom per frame:           " << (interval - criticalPath) << " ms" << '\n';
+
+        // render path: subpasses keep col0/depth0 on tile, separate render passes store and reload them
+        std::cout << "  render path:                      " << (settings.multiPass ? "separate render passes (sampled col0/depth0)" : "subpasses (input attachments)") << '\n';
+        if (multiview.enabled) {
+            std::cout << "  multiview stereo:                 " << multiview.viewCount << " views per draw (one attachment layer each), eye separation "
+                << multiview.eyeSeparation << ", blitted side by side" << '\n';
+        }
+        if (msaa.enabled) {
+            std::cout << "  scene multisampling:              " << msaa.samples << " samples, resolved in the scene subpass (col0MS/depth0MS never stored)" << '\n';
+        }
+        if (gpuTimings.gpuFrames > 0) {
+            std::cout << "  gpu frame time:                   " << gpuTimings.gpuSeconds / gpuTimings.gpuFrames * toMs << " ms" << '\n';
+        }
+        // auto exposure: async, the dispatch is timed on the compute queue, apart from the graphics submission
+        // (timestamps of different queues are not comparable: compare the gpu frame time against --no-async-compute)
+        if (autoExposure.enabled) {
+            const char* queue = !autoExposure.async ? "graphics command buffer (--no-async-compute)"
+                : (computeQueue == graphicsQueue) ? "compute queue (shares the graphics queue: no overlap)"
+                : (computeQueueIndex == 1) ? "compute queue (second queue of the graphics family)" : "compute queue (dedicated compute family)";
+            std::cout << "  auto exposure:                    " << queue << ", " << autoExposure.extent.width << "x" << autoExposure.extent.height << " luminance copy" << '\n';
+            if (autoExposure.timedDispatches > 0) {
+                std::cout << "  auto exposure dispatch (gpu):     " << autoExposure.dispatchSeconds / autoExposure.timedDispatches * toMs << " ms per frame"
+                    << (autoExposure.async ? " (on the compute queue, timed apart from the gpu frame time)" : " (part of the gpu frame time)") << '\n';
+            }
+            if (autoExposure.readbacks > 0) {
+                std::cout << "  exposure:                         " << autoExposure.exposure << " (mean luminance " << std::exp2(autoExposure.meanLogLuminance) << ", "
+                    << autoExposure.readbacks << " results read back)" << '\n';
+            }
+        }
+        // bloom: texture traffic of the chain estimated from the level sizes (every texel read once per dispatch that samples its level:
+        // bright pass every col0 texel of 16 bytes, RGBA16F levels 8 bytes, upsamples also read their own level), bounded by level 0's size
+        if (bloom.enabled) {
+            double bytes = 0.0;
+            const size_t levels = bloom.extents.size();
+            for (size_t level = 0; level < levels; level++) {
+                double texels = static_cast<double>(bloom.extents[level].width) * bloom.extents[level].height;
+                bytes += (level == 0) ? texels * (bloom.downscale * bloom.downscale * 16.0 + 8.0) : bloom.extents[level - 1].width * static_cast<double>(bloom.extents[level - 1].height) * 8.0 + texels * 8.0;
+                if (level + 1 < levels) {
+                    bytes += bloom.extents[level + 1].width * static_cast<double>(bloom.extents[level + 1].height) * 8.0 + texels * 16.0;
+                }
+            }
+            bytes += static_cast<double>(bloom.extents[0].width) * bloom.extents[0].height * 8.0; // composition
+            std::cout << "  bloom:                            " << (settings.fastBloom ? "performance" : "quality") << " preset, " << levels << " levels from "
+                << bloom.extents[0].width << "x" << bloom.extents[0].height << ", ~" << bytes / (1024.0 * 1024.0) << " MB texture traffic per frame"
+                << (settings.multiPass ? "" : " (added one frame late)") << '\n';
+            if (bloom.gpuFrames > 0) {
+                std::cout << "  bloom chain (gpu):                " << bloom.gpuSeconds / bloom.gpuFrames * toMs << " ms per frame" << '\n';
+            }
+        }
+        // fragments shaded by the fx/decal volume draws (compare against --no-volume-bounds)
+        if (volumeDraws.frames > 0) {
+            std::cout << "  volume bounds:                    " << (settings.disableVolumeBounds ? "off (full-screen scissor)" : (volumeDraws.depthBoundsTest ? "scissor + decal depth bounds" : "scissor")) << '\n';
+            std::cout << "  decal stencil mask:               " << (volumeDraws.decalStencil ? "on" : "off") << '\n';
+            std::cout << "  fx instances:                     " << fxInstances.instances.size() << " (one instanced draw)" << '\n';
+            if (oit.enabled) {
+                std::cout << "  fx blending:                      weighted blended OIT (unsorted, fx + resolve subpasses)" << '\n';
+            }
+            else if (settings.gpuSort && gpuTimings.gpuFrames > 0) {
+                std::cout << (settings.gpuCulling ? "  fx sort + cull (gpu):             " : "  fx sort (gpu radix sort):         ") << gpuTimings.sortSeconds / gpuTimings.gpuFrames * toMs << " ms per frame" << '\n';
+            }
+            else if (fxSort.cpuFrames > 0) {
+                std::cout << "  fx sort (cpu radix sort):         " << fxSort.cpuSeconds / fxSort.cpuFrames * toMs << " ms per frame" << '\n';
+            }
+            // GPU-driven: the visible count never comes back to the CPU (compare the fx fragment invocations against the direct draw)
+            if (settings.gpuCulling) {
+                std::cout << "  fx draw:                          gpu-driven (compute frustum " << (hiZ.enabled ? "+ hi-z " : "") << "cull, " << (fxCull.drawIndirectCount ? "vkCmdDrawIndexedIndirectCount" : "vkCmdDrawIndexedIndirect") << ")" << '\n';
+            }
+            // Hi-Z: draws culled against the previous frame's depth pyramid (compare the gpu frame time against a run without --hiz)
+            if (hiZ.fxFrames > 0) {
+                std::cout << "  fx instances culled (hi-z):       " << hiZ.fxFrustumCulled / hiZ.fxFrames << " outside the frustum, "
+                    << hiZ.fxOccluded / hiZ.fxFrames << " occluded per frame" << '\n';
+            }
+            if (hiZ.decalFrames > 0) {
+                std::cout << "  decals occluded (hi-z):           " << hiZ.decalsOccluded / hiZ.decalFrames << " per frame (not "
+                    << (settings.volumeDecals ? "drawn" : "binned") << ")" << '\n';
+            }
+            if (hiZ.enabled && gpuTimings.gpuFrames > 0) {
+                std::cout << "  hi-z pyramid build (gpu):         " << gpuTimings.hiZSeconds / gpuTimings.gpuFrames * toMs << " ms per frame ("
+                    << hiZ.levelViews.size() << " levels)" << '\n';
+            }
+            // occlusion queries: frames whose proxy passed no sample, and so skipped the draw of the next frame
+            // (conditional rendering skips on the GPU: compare the fragment invocations and gpu frame time without --occlusion-queries)
+            if (occlusion.enabled) {
+                std::cout << "  occlusion queries:                " << (occlusion.conditionalRendering ? "conditional rendering" : "cpu readback") << '\n';
+                const char* labels[] = { "  fx proxy hidden (occlusion):      ", "  decal proxy hidden (occlusion):   " };
+                for (uint32_t proxy = 0; proxy < 2; proxy++) {
+                    if (occlusion.testedFrames[proxy] == 0) {
+                        continue;
+                    }
+                    std::cout << labels[proxy] << occlusion.hiddenFrames[proxy] << " of " << occlusion.testedFrames[proxy] << " tested frames";
+                    if (!occlusion.conditionalRendering) {
+                        std::cout << ", " << occlusion.skippedDraws[proxy] << " draws skipped";
+                    }
+                    std::cout << '\n';
+                }
+            }
+            std::cout << "  fx fragment invocations:          " << volumeDraws.fxInvocations / volumeDraws.frames << " per frame" << '\n';
+            std::cout << "  decal fragment invocations:       " << volumeDraws.decalInvocations / volumeDraws.frames << " per frame" << '\n';
+            // scene: with the depth pre-pass only the visible fragments are shaded (compare against the pixel count for the overdraw)
+            std::cout << "  scene fragment invocations:       " << volumeDraws.sceneInvocations / volumeDraws.frames << " per frame"
+                << (settings.depthPrepass ? " (after the depth pre-pass)" : "") << '\n';
+        }
+        // tiled decals: draw instances (active tiles) and decal list entries the fragment shader walks per frame
+        if (tiledDecals.frames > 0) {
+            std::cout << "  tiled decals:                     " << tiledDecals.manager.getDecalCount() << " decals, "
+                << tiledDecals.activeTiles / tiledDecals.frames << " of " << DecalManager::getTileCount(swapChainExtent) << " tiles active, "
+                << tiledDecals.tileEntries / tiledDecals.frames << " tile entries per frame" << '\n';
+        }
+        // deferred shading: light quads drawn by the lighting subpass per frame (the rest were culled on the CPU)
+        if (deferred.frames > 0) {
+            std::cout << "  deferred lighting:                " << lights.size() << " lights, "
+                << deferred.visibleLights / deferred.frames << " visible per frame (G-buffer subpass + lighting subpass)" << '\n';
+        }
+        // clustered forward shading: light list entries the scene shader can walk per frame, and the CPU assignment time
+        if (clustered.frames > 0) {
+            std::cout << "  clustered lighting:               " << lights.size() << " lights, " << LightClusters::getClusterCount() << " clusters, "
+                << clustered.lightEntries / clustered.frames << " cluster entries per frame, "
+                << clustered.cpuSeconds / clustered.frames * toMs << " ms cpu assignment per frame" << '\n';
+        }
+        // shadow map: how many of the frames had to re-render it
+        if (shadow.frames > 0) {
+            std::cout << "  shadow map:                       " << shadow.renders << " renders in " << shadow.frames << " frames"
+                << (settings.disableShadowCache ? " (cache disabled)" : " (cached while the light and the scene stay put)") << '\n';
+        }
+
+        // attachment traffic of both layouts, from their declarations
+        RenderGraph subpassScene, subpassComposition;
+        RenderGraph separateScene, separateComposition;
+        declareRenderGraph(false, subpassScene, subpassComposition);
+        declareRenderGraph(true, separateScene, separateComposition);
+        double toMB = 1.0 / (1024.0 * 1024.0);
+        VkDeviceSize subpassBytes = subpassScene.estimateBandwidth(swapChainExtent);
+        VkDeviceSize separateBytes = separateScene.estimateBandwidth(swapChainExtent) + separateComposition.estimateBandwidth(swapChainExtent);
+        std::cout << "  attachment traffic, subpasses:     " << subpassBytes * toMB << " MB/frame" << '\n';
+        std::cout << "  attachment traffic, render passes: " << separateBytes * toMB << " MB/frame"
+            << " (+ col0/depth0 texture reads by the composition pass)" << '\n';
+}
+
 void VulkanApp::cleanup() {
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
@@ -3504,6 +9038,28 @@ void VulkanApp::cleanup() {
         for (auto framebuffer : swapChainFramebuffers) {
             vkDestroyFramebuffer(device, framebuffer, nullptr);
         }
+        for (auto framebuffer : separatePasses.compositionFramebuffers) {
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+        if (volumeDraws.statisticsPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, volumeDraws.statisticsPool, nullptr);
+        }
+        if (gpuTimings.queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, gpuTimings.queryPool, nullptr);
+        }
+        if (occlusion.queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, occlusion.queryPool, nullptr);
+        }
+        if (autoExposure.queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, autoExposure.queryPool, nullptr);
+        }
+        if (bloom.queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, bloom.queryPool, nullptr);
+        }
+        if (occlusion.predicateBuffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device, occlusion.predicateBuffer, nullptr);
+            vkFreeMemory(device, occlusion.predicateMemory, nullptr);
+        }
 
         vkDestroyBuffer(device, vertexBuffer0, nullptr);
         vkDestroyBuffer(device, vertexBuffer1, nullptr);
@@ -3517,9 +9073,72 @@ void VulkanApp::cleanup() {
         vkFreeMemory(device, indicesBufferMemory0, nullptr);
         vkFreeMemory(device, indicesBufferMemory1, nullptr);
 
+        if (fxInstances.mapped != nullptr) {
+            vkUnmapMemory(device, fxInstances.memory);
+        }
+        if (depthPrepass.positionBuffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device, depthPrepass.positionBuffer, nullptr);
+            vkFreeMemory(device, depthPrepass.positionMemory, nullptr);
+        }
+        vkDestroyBuffer(device, fxInstances.buffer, nullptr);
+        vkFreeMemory(device, fxInstances.memory, nullptr);
+        for (size_t i = 0; i < fxSort.buffers.size(); i++) {
+            vkDestroyBuffer(device, fxSort.buffers[i], nullptr);
+            vkFreeMemory(device, fxSort.memory[i], nullptr);
+        }
+        for (size_t i = 0; i < fxCull.buffers.size(); i++) {
+            vkDestroyBuffer(device, fxCull.buffers[i], nullptr);
+            vkFreeMemory(device, fxCull.memory[i], nullptr);
+        }
+        for (size_t i = 0; i < hiZ.readbackBuffers.size(); i++) {
+            vkUnmapMemory(device, hiZ.readbackMemory[i]);
+            vkDestroyBuffer(device, hiZ.readbackBuffers[i], nullptr);
+            vkFreeMemory(device, hiZ.readbackMemory[i], nullptr);
+        }
+        for (VkImageView levelView : hiZ.levelViews) {
+            vkDestroyImageView(device, levelView, nullptr);
+        }
+        if (hiZ.enabled) {
+            vkDestroyImageView(device, hiZ.view, nullptr);
+            vkDestroyImage(device, hiZ.image, nullptr);
+            vkFreeMemory(device, hiZ.memory, nullptr);
+            vkDestroySampler(device, hiZ.sampler, nullptr);
+        }
+        for (size_t i = 0; i < autoExposure.images.size(); i++) {
+            vkDestroyImageView(device, autoExposure.views[i], nullptr);
+            vkDestroyImage(device, autoExposure.images[i], nullptr);
+            vkFreeMemory(device, autoExposure.imageMemory[i], nullptr);
+            vkUnmapMemory(device, autoExposure.resultMemory[i]);
+            vkDestroyBuffer(device, autoExposure.resultBuffers[i], nullptr);
+            vkFreeMemory(device, autoExposure.resultMemory[i], nullptr);
+        }
+        if (autoExposure.enabled) {
+            vkDestroySampler(device, autoExposure.sampler, nullptr);
+            vkDestroyBuffer(device, autoExposure.stateBuffer, nullptr);
+            vkFreeMemory(device, autoExposure.stateMemory, nullptr);
+        }
+        if (autoExposure.async) {
+            vkDestroyCommandPool(device, autoExposure.commandPool, nullptr);
+            vkDestroySemaphore(device, autoExposure.graphicsTimeline, nullptr);
+            vkDestroySemaphore(device, autoExposure.computeTimeline, nullptr);
+        }
+        for (VkImageView levelView : bloom.levelViews) {
+            vkDestroyImageView(device, levelView, nullptr);
+        }
+        if (bloom.enabled) {
+            vkDestroyImage(device, bloom.image, nullptr);
+            vkFreeMemory(device, bloom.memory, nullptr);
+            vkDestroySampler(device, bloom.sampler, nullptr);
+        }
+        for (size_t i = 0; i < tiledDecals.buffers.size(); i++) {
+            vkDestroyBuffer(device, tiledDecals.buffers[i], nullptr);
+            vkFreeMemory(device, tiledDecals.memory[i], nullptr);
+        }
         for (size_t i = 0; i < swapChainImages.size(); i++) {
+            vkDestroyBuffer(device, uniformBuffersFrame[i], nullptr);
             vkDestroyBuffer(device, uniformBuffersScene[i], nullptr);
             vkDestroyBuffer(device, uniformBuffersFX[i], nullptr);
+            vkFreeMemory(device, uniformBuffersFrameMemory[i], nullptr);
             vkFreeMemory(device, uniformBuffersSceneMemory[i], nullptr);
             vkFreeMemory(device, uniformBuffersFXMemory[i], nullptr);
         }
@@ -3527,23 +9146,119 @@ void VulkanApp::cleanup() {
             vkDestroyImageView(device, imageView, nullptr);
         }
         vkDestroySampler(device, textureSampler, nullptr);
+        if (separatePasses.inputSampler != VK_NULL_HANDLE) {
+            vkDestroySampler(device, separatePasses.inputSampler, nullptr);
+        }
         vkDestroyImageView(device, offscreenImageView, nullptr);
         vkFreeMemory(device, offscreenImageMemory, nullptr);
+        if (multiview.enabled) {
+            vkDestroyImageView(device, multiview.outputView, nullptr);
+            vkDestroyImage(device, multiview.outputImage, nullptr);
+            vkFreeMemory(device, multiview.outputMemory, nullptr);
+        }
+        if (oit.enabled) {
+            vkDestroyImageView(device, oit.accumView, nullptr);
+            vkDestroyImage(device, oit.accumImage, nullptr);
+            vkFreeMemory(device, oit.accumMemory, nullptr);
+            vkDestroyImageView(device, oit.revealView, nullptr);
+            vkDestroyImage(device, oit.revealImage, nullptr);
+            vkFreeMemory(device, oit.revealMemory, nullptr);
+        }
+        if (msaa.enabled) {
+            vkDestroyImageView(device, msaa.colorView, nullptr);
+            vkDestroyImage(device, msaa.colorImage, nullptr);
+            vkFreeMemory(device, msaa.colorMemory, nullptr);
+            vkDestroyImageView(device, msaa.depthView, nullptr);
+            vkDestroyImage(device, msaa.depthImage, nullptr);
+            vkFreeMemory(device, msaa.depthMemory, nullptr);
+        }
+        if (deferred.enabled) {
+            vkDestroyImageView(device, deferred.albedoView, nullptr);
+            vkDestroyImage(device, deferred.albedoImage, nullptr);
+            vkFreeMemory(device, deferred.albedoMemory, nullptr);
+            vkDestroyImageView(device, deferred.normalView, nullptr);
+            vkDestroyImage(device, deferred.normalImage, nullptr);
+            vkFreeMemory(device, deferred.normalMemory, nullptr);
+        }
+        for (size_t i = 0; i < deferred.lightBuffers.size(); i++) {
+            vkDestroyBuffer(device, deferred.lightBuffers[i], nullptr);
+            vkFreeMemory(device, deferred.lightMemory[i], nullptr);
+        }
+        for (size_t i = 0; i < clustered.buffers.size(); i++) {
+            vkDestroyBuffer(device, clustered.buffers[i], nullptr);
+            vkFreeMemory(device, clustered.memory[i], nullptr);
+        }
+        if (clustered.lightBuffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device, clustered.lightBuffer, nullptr);
+            vkFreeMemory(device, clustered.lightMemory, nullptr);
+        }
+        for (size_t i = 0; i < shadow.uniformBuffers.size(); i++) {
+            vkDestroyBuffer(device, shadow.uniformBuffers[i], nullptr);
+            vkFreeMemory(device, shadow.uniformMemory[i], nullptr);
+        }
+        if (shadow.image != VK_NULL_HANDLE) {
+            vkDestroySampler(device, shadow.sampler, nullptr);
+            vkDestroyFramebuffer(device, shadow.framebuffer, nullptr);
+            vkDestroyImageView(device, shadow.view, nullptr);
+            vkDestroyImage(device, shadow.image, nullptr);
+            vkFreeMemory(device, shadow.memory, nullptr);
+            vkDestroyRenderPass(device, shadow.renderPass, nullptr);
+        }
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.frame, nullptr);
         vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.scene, nullptr);
         vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.composition, nullptr);
         vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.fx0, nullptr);
         vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.fx1, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.decal, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.fxSort, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.fxCull, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.hiZBuild, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.hiZCull, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.oitResolve, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.lighting, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.clusters, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.shadows, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.autoExposure, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayouts.bloom, nullptr);
         vkDestroyDescriptorPool(device, descriptorPool, nullptr);
 
         vkDestroyPipeline(device, pipelines.scene, nullptr);
+        vkDestroyPipeline(device, pipelines.depthPrepass, nullptr);
+        vkDestroyPipeline(device, pipelines.shadow, nullptr);
         vkDestroyPipeline(device, pipelines.composition, nullptr);
         vkDestroyPipeline(device, pipelines.fx, nullptr);
         vkDestroyPipeline(device, pipelines.decal, nullptr);
+        vkDestroyPipeline(device, pipelines.decalStencil, nullptr);
+        vkDestroyPipeline(device, pipelines.decalTiles, nullptr);
+        vkDestroyPipeline(device, pipelines.fxSort, nullptr);
+        vkDestroyPipeline(device, pipelines.fxCull, nullptr);
+        vkDestroyPipeline(device, pipelines.hiZBuild, nullptr);
+        vkDestroyPipeline(device, pipelines.occlusionProxy, nullptr);
+        vkDestroyPipeline(device, pipelines.oitResolve, nullptr);
+        vkDestroyPipeline(device, pipelines.lighting, nullptr);
+        vkDestroyPipeline(device, pipelines.autoExposure, nullptr);
+        vkDestroyPipeline(device, pipelines.bloomBright, nullptr);
+        vkDestroyPipeline(device, pipelines.bloomDown, nullptr);
+        vkDestroyPipeline(device, pipelines.bloomUp, nullptr);
         vkDestroyPipelineLayout(device, pipelineLayouts.scene, nullptr);
         vkDestroyPipelineLayout(device, pipelineLayouts.composition, nullptr);
         vkDestroyPipelineLayout(device, pipelineLayouts.fx, nullptr);
         vkDestroyPipelineLayout(device, pipelineLayouts.decal, nullptr);
-        vkDestroyRenderPass(device, renderPass, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.decalTiles, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.fxSort, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.fxCull, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.hiZBuild, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.occlusionProxy, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.oitResolve, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.lighting, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.autoExposure, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayouts.bloom, nullptr);
+        if (renderPass != VK_NULL_HANDLE) {
+            vkDestroyRenderPass(device, renderPass, nullptr);
+        }
+        if (separatePasses.compositionRenderPass != VK_NULL_HANDLE) {
+            vkDestroyRenderPass(device, separatePasses.compositionRenderPass, nullptr);
+        }
         vkDestroySwapchainKHR(device, swapChain, nullptr);
         vkDestroyDevice(device, nullptr);
         if (enableExtensionLayers) {